@@ -2,7 +2,11 @@
 # ======================================================
 xH_FILES  += adts.h
 xH_FILES  += adts_rbt.h
+xH_FILES  += adts_mpmc.h
+xH_FILES  += adts_mpsc.h
+xH_FILES  += adts_spsc.h
 xH_FILES  += adts_eyec.h
+xH_FILES  += adts_wait.h
 xH_FILES  += adts_bits.h
 xH_FILES  += adts_hash.h
 xH_FILES  += adts_heap.h
@@ -13,20 +17,34 @@ xH_FILES  += adts_sort.h
 xH_FILES  += adts_time.h
 xH_FILES  += adts_tree.h
 xH_FILES  += adts_trie.h
+xH_FILES  += adts_mcast.h
 xH_FILES  += adts_graph.h
 xH_FILES  += adts_stack.h
 xH_FILES  += adts_queue.h
+xH_FILES  += adts_lfstack.h
+xH_FILES  += adts_wsdeque.h
+xH_FILES  += adts_timerwheel.h
+xH_FILES  += adts_multiqueue.h
+xH_FILES  += adts_radixheap.h
+xH_FILES  += adts_topk.h
+xH_FILES  += adts_theap.h
+xH_FILES  += adts_minmaxheap.h
 xH_FILES  += adts_sanity.h
 xH_FILES  += adts_memory.h
 xH_FILES  += adts_cycles.h
 xH_FILES  += adts_hexdump.h
 xH_FILES  += adts_display.h
+xH_FILES  += adts_mem_file.h
 xH_FILES  += adts_snapshot.h
 
 # ======================================================
 xC_FILES  += adts_rbt.c
 xC_FILES  += adts_test.c
+xC_FILES  += adts_mpmc.c
+xC_FILES  += adts_mpsc.c
+xC_FILES  += adts_spsc.c
 xC_FILES  += adts_eyec.c
+xC_FILES  += adts_wait.c
 xC_FILES  += adts_bits.c
 xC_FILES  += adts_hash.c
 xC_FILES  += adts_heap.c
@@ -37,11 +55,21 @@ xC_FILES  += adts_sort.c
 xC_FILES  += adts_time.c
 xC_FILES  += adts_tree.c
 xC_FILES  += adts_trie.c
+xC_FILES  += adts_mcast.c
 xC_FILES  += adts_graph.c
 xC_FILES  += adts_stack.c
 xC_FILES  += adts_queue.c
+xC_FILES  += adts_lfstack.c
+xC_FILES  += adts_wsdeque.c
+xC_FILES  += adts_timerwheel.c
+xC_FILES  += adts_multiqueue.c
+xC_FILES  += adts_radixheap.c
+xC_FILES  += adts_topk.c
+xC_FILES  += adts_theap.c
+xC_FILES  += adts_minmaxheap.c
 xC_FILES  += adts_memory.c
 xC_FILES  += adts_cycles.c
 xC_FILES  += adts_hexdump.c
+xC_FILES  += adts_mem_file.c
 xC_FILES  += adts_snapshot.c
 
@@ -4,17 +4,32 @@
 #include <adts_heap.h>
 #include <adts_list.h>
 #include <adts_sort.h>
+#include <adts_wait.h>
+#include <adts_mpmc.h>
+#include <adts_mpsc.h>
+#include <adts_spsc.h>
 #include <adts_time.h>
 #include <adts_hash.h>
 #include <adts_math.h>
 #include <adts_meas.h>
 #include <adts_tree.h>
 #include <adts_trie.h>
+#include <adts_mcast.h>
+#include <adts_lfstack.h>
+#include <adts_wsdeque.h>
+#include <adts_timerwheel.h>
+#include <adts_multiqueue.h>
+#include <adts_radixheap.h>
+#include <adts_topk.h>
+#include <adts_theap.h>
+#include <adts_minmaxheap.h>
 #include <adts_graph.h>
 #include <adts_queue.h>
 #include <adts_stack.h>
+#include <adts_memory.h>
 #include <adts_cycles.h>
 #include <adts_hexdump.h>
 #include <adts_display.h>
+#include <adts_mem_file.h>
 #include <adts_snapshot.h>
 
@@ -3,6 +3,7 @@
 
 #include <errno.h>
 #include <assert.h>
+#include <stdlib.h>
 #include <string.h>
 #include <limits.h>
 #include <stdbool.h>
@@ -10,6 +11,7 @@
 
 /* Toolbox */
 #include <adts_graph.h>
+#include <adts_memory.h>
 #include <adts_sanity.h>
 #include <adts_private.h>
 #include <adts_display.h>
@@ -39,6 +41,7 @@ typedef struct {
     size_t         edges;    /* also known as arcs */
     graph_node_t **adjlist;
     adts_sanity_t  sanity;
+    adts_mem_t     mem;
 } graph_t;
 
 
@@ -93,17 +96,19 @@ void
 adts_graph_destroy( adts_graph_t *p_adts_graph )
 {
     graph_t       *p_graph  = (graph_t *) p_adts_graph;
+    adts_mem_t     mem      = p_graph->mem;
     adts_sanity_t *p_sanity = &(p_graph->sanity);
 
     adts_sanity_entry(p_sanity);
 
     for (int32_t i = 0; i < p_graph->vertices; i++) {
-        free(p_graph->adjlist[i]);
+        adts_mem_put(&(mem), p_graph->adjlist[i], sizeof(adts_graph_node_t));
         p_graph->adjlist[i] = NULL;
     }
 
-    free(p_graph->adjlist);
-    free(p_graph);
+    adts_mem_put(&(mem), p_graph->adjlist,
+                 sizeof(p_graph->adjlist[0]) * p_graph->vertices);
+    adts_mem_put(&(mem), p_graph, sizeof(*p_adts_graph));
 
     /* No adts_sanity_exit() since we've freed the memory */
 
@@ -113,21 +118,35 @@ adts_graph_destroy( adts_graph_t *p_adts_graph )
 
 /*
  ****************************************************************************
- *
  ****************************************************************************
  */
 adts_graph_t *
 adts_graph_create( size_t vertices )
+{
+    return adts_graph_create_ext(vertices, NULL);
+} /* adts_graph_create() */
+
+
+/*
+ ****************************************************************************
+ ****************************************************************************
+ */
+adts_graph_t *
+adts_graph_create_ext( size_t                  vertices,
+                       const adts_allocator_t *p_allocator )
 {
     bool               valid_nodes       = false;
     size_t             bytes             = 0;
     int32_t            rc                = 0;
     int32_t            idx               = 0;
     graph_t           *p_graph           = NULL;
+    adts_mem_t         mem               = {0};
     adts_graph_t      *p_adts_graph      = NULL;
     adts_graph_node_t *p_adts_graph_node = NULL;
 
-    p_adts_graph  = adts_mem_zalloc(sizeof(*p_adts_graph));
+    adts_mem_init_ext(&(mem), ADTS_MEM_TYPE_GRAPH, p_allocator);
+
+    p_adts_graph  = adts_mem_get(&(mem), sizeof(*p_adts_graph));
     if (NULL == p_adts_graph) {
         rc = ENOMEM;
         goto exception;
@@ -137,7 +156,7 @@ adts_graph_create( size_t vertices )
     p_graph->vertices = vertices;
 
     bytes = sizeof(p_adts_graph_node) * vertices;
-    p_graph->adjlist = calloc(1, bytes);
+    p_graph->adjlist = adts_mem_get(&(mem), bytes);
     if (NULL == p_graph->adjlist) {
         rc = ENOMEM;
         goto exception;
@@ -146,7 +165,7 @@ adts_graph_create( size_t vertices )
     for (idx = 0; idx < vertices; idx++) {
         graph_node_t *p_node = NULL;
 
-        p_node = calloc(1, sizeof(*p_adts_graph_node));
+        p_node = adts_mem_get(&(mem), sizeof(*p_adts_graph_node));
         if (NULL == p_node) {
             rc = ENOMEM;
             goto exception;
@@ -160,26 +179,29 @@ adts_graph_create( size_t vertices )
         p_graph->adjlist[idx] = p_node;
     }
 
+    p_graph->mem = mem;
+
 exception:
     if (rc) {
         if (valid_nodes) {
             for (int32_t i = idx - 1; i >= 0; i--) {
-                free(p_graph->adjlist[i]);
+                adts_mem_put(&(mem), p_graph->adjlist[i],
+                             sizeof(*p_adts_graph_node));
             }
         }
 
         if (p_graph) {
-        	if (p_graph->adjlist) {
-            	free(p_graph->adjlist);
-				p_graph->adjlist = NULL;
-        	}
-            free(p_graph);
+            if (p_graph->adjlist) {
+                adts_mem_put(&(mem), p_graph->adjlist, bytes);
+                p_graph->adjlist = NULL;
+            }
+            adts_mem_put(&(mem), p_graph, sizeof(*p_adts_graph));
             p_graph = NULL;
         }
     }
 
     return p_graph;
-} /* adts_graph_create() */
+} /* adts_graph_create_ext() */
 
 
 
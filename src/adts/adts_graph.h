@@ -3,6 +3,7 @@
 #include <string.h>
 #include <stdbool.h>
 #include <inttypes.h>
+#include <adts_memory.h>
 
 /**
  **************************************************************************
@@ -29,6 +30,17 @@ typedef struct {
 } adts_graph_node_t;
 
 
+void
+adts_graph_destroy( adts_graph_t *p_adts_graph );
+
+adts_graph_t *
+adts_graph_create( size_t vertices );
+
+adts_graph_t *
+adts_graph_create_ext( size_t                  vertices,
+                       const adts_allocator_t *p_allocator );
+
+
 void
 utest_adts_graph( void );
 
@@ -2,14 +2,21 @@
 
 #include <errno.h>
 #include <assert.h>
+#include <stdlib.h>
 #include <string.h>
 #include <limits.h>
 #include <stdbool.h>
 #include <inttypes.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
 
 /* Toolbox */
 #include <adts_math.h>
 #include <adts_hash.h>
+#include <adts_time.h>
+#include <adts_memory.h>
 #include <adts_sanity.h>
 #include <adts_private.h>
 #include <adts_hexdump.h>
@@ -98,6 +105,7 @@ typedef struct hash_s {
     volatile bool         resizing;
     hash_node_t         **workspace;
     adts_sanity_t         sanity;
+    adts_mem_t            mem;
 } hash_t;
 
 
@@ -218,6 +226,7 @@ hash_display_worker( hash_t          *p_hash,
     adts_hash_stats_t  *p_stats  = &(p_hash->pub.stats);
     adts_hash_resize_t *p_resize = &(p_hash->pub.resize);
     adts_hash_create_t *p_params = &(p_hash->params);
+    adts_mem_stats_t   *p_mem    = &(p_hash->mem.stats);
 
     printf("\n");
     printf("---------------------------------------------------------------\n");
@@ -246,6 +255,9 @@ hash_display_worker( hash_t          *p_hash,
     printf("pub.elems_curr          = %i\n", p_hash->pub.elems_curr);
     printf("pub.elems_limit         = %i\n", p_hash->pub.elems_limit);
 
+    printf("mem.bytes_curr          = %zu\n", p_mem->bytes_curr);
+    printf("mem.bytes_peak          = %zu\n", p_mem->bytes_peak);
+
     if (private) {
         printf("p_hash->resizing        = %i\n", p_hash->resizing);
         printf("p_hash->workspace       = %i\n", p_hash->workspace);
@@ -393,7 +405,7 @@ hash_resize( hash_t           *p_hash,
     /* p_new used to handle error case and preserve the workspace */
     limit_new = hash_resize_limit(p_hash->pub.elems_limit, op);
     bytes     = limit_new * sizeof(p_hash->workspace[0]);
-    p_new     = adts_mem_zalloc(bytes);
+    p_new     = adts_mem_get(&(p_hash->mem), bytes);
     if (NULL == p_new) {
         rc = ENOMEM;
         goto exception;
@@ -416,9 +428,11 @@ hash_resize( hash_t           *p_hash,
     /* clear and free the old hashtbl workspace */
     bytes = p_hash->pub.elems_limit * sizeof(p_hash->workspace[0]);
     memset(p_hash->workspace, 0, bytes);
-    free(p_hash->workspace);
+    adts_mem_put(&(p_hash->mem), p_hash->workspace, bytes);
 
-    /* all is good, transition new hashtbl into old hashtbl memspace */
+    /* all is good, transition new hashtbl into old hashtbl memspace.  The
+     * memory accounting is current in the old hashtbl only. */
+    new.mem = p_hash->mem;
     memcpy(p_hash, &(new), sizeof(*p_hash));
 
 exception:
@@ -778,6 +792,23 @@ adts_hash_entries( const adts_hash_t *p_adts_hash )
 } /* adts_hash_entries() */
 
 
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_hash_mem_usage( const adts_hash_t *p_adts_hash,
+                     adts_mem_stats_t  *p_out )
+{
+    hash_t *p_hash = (hash_t *) p_adts_hash;
+
+    adts_mem_usage(&(p_hash->mem), p_out);
+
+    return;
+} /* adts_hash_mem_usage() */
+
+
 /*
  ****************************************************************************
  *
@@ -898,6 +929,7 @@ adts_hash_destroy( adts_hash_t *p_adts_hash )
 {
     hash_t        *p_hash   = (hash_t *) p_adts_hash;
     size_t         bytes    = 0;
+    adts_mem_t     mem      = p_hash->mem;
     adts_sanity_t *p_sanity = &(p_hash->sanity);
 
     adts_sanity_entry(p_sanity);
@@ -907,12 +939,12 @@ adts_hash_destroy( adts_hash_t *p_adts_hash )
      * bytes of the workspace */
     bytes = p_hash->pub.elems_limit * sizeof(p_hash->workspace[0]);
     memset(p_hash->workspace, 0, bytes);
-    free(p_hash->workspace);
+    adts_mem_put(&(mem), p_hash->workspace, bytes);
 
     /* Ensure proper cleanup to avoid false positives on accidental reuse */
     bytes = sizeof(*p_hash);
     memset(p_hash, 0, bytes);
-    free(p_hash);
+    adts_mem_put(&(mem), p_hash, sizeof(*p_adts_hash));
 
     /* No adts_sanity_exit() since we've freed the memory */
 
@@ -931,6 +963,7 @@ adts_hash_create( const adts_hash_create_t *p_op )
     hash_t       *p_hash      = NULL;
     size_t        elems       = 0;
     int32_t       rc          = 0;
+    adts_mem_t    mem         = {0};
     hash_node_t  *p_elems     = NULL;
     adts_hash_t  *p_adts_hash = NULL;
 
@@ -950,14 +983,16 @@ adts_hash_create( const adts_hash_create_t *p_op )
         goto exception;
     }
 
-    p_adts_hash = adts_mem_zalloc(sizeof(*p_hash));
+    adts_mem_init_ext(&(mem), ADTS_MEM_TYPE_HASH, p_op->p_allocator);
+
+    p_adts_hash = adts_mem_get(&(mem), sizeof(*p_adts_hash));
     if (NULL == p_adts_hash) {
         rc = ENOMEM;
         goto exception;
     }
 
 
-    p_elems = adts_mem_zalloc(elems * sizeof(p_hash->workspace[0]));
+    p_elems = adts_mem_get(&(mem), elems * sizeof(p_hash->workspace[0]));
     if (NULL == p_elems) {
         rc = ENOMEM;
         goto exception;
@@ -968,16 +1003,17 @@ adts_hash_create( const adts_hash_create_t *p_op )
 
     p_hash->workspace       = p_elems;
     p_hash->pub.elems_limit = elems;
+    p_hash->mem             = mem;
 
 exception:
     if (rc) {
         if (p_elems) {
-            free(p_elems);
+            adts_mem_put(&(mem), p_elems, elems * sizeof(p_hash->workspace[0]));
 			p_elems = NULL;
         }
 
         if (p_adts_hash) {
-            free(p_adts_hash);
+            adts_mem_put(&(mem), p_adts_hash, sizeof(*p_adts_hash));
 			p_adts_hash = NULL;
         }
     }
@@ -1073,6 +1109,235 @@ utest_hash_generate_collisions( adts_hash_t   *p_hash,
 } /* utest_hash_generate_collisions() */
 
 
+/*
+ ****************************************************************************
+ * \details
+ *   Report the instance footprint, including workspace slack, as the
+ *   hashtbl population increases.  Nodes are consumer owned and therefore
+ *   not part of the hashtbl footprint.
+ *
+ ****************************************************************************
+ */
+static void
+utest_hash_footprint( void )
+{
+    size_t                   elems  = 1 << 16;
+    int32_t                  rc     = 0;
+    adts_hash_t             *p_hash = NULL;
+    adts_hash_node_t        *p_node = NULL;
+    adts_mem_stats_t         inst   = {0};
+    adts_mem_stats_t         before = {0};
+    adts_mem_stats_t         family = {0};
+    adts_hash_create_t       op     = {0};
+    adts_hash_node_public_t  input  = {0};
+
+    (void) adts_mem_stats(ADTS_MEM_TYPE_HASH, &(before));
+
+    p_node = calloc(elems, sizeof(*p_node));
+    assert(p_node);
+
+    op.p_func = utest_hash_function;
+    p_hash    = adts_hash_create(&op);
+    assert(p_hash);
+
+    for (size_t idx = 1; idx <= elems; idx++) {
+        input.p_data = p_node;
+        input.bytes  = sizeof(*p_node);
+        input.p_key  = (void *) idx;
+
+        rc = adts_hash_insert(p_hash, &(p_node[idx - 1]), &(input));
+        assert(0 == rc);
+        if (0 == (idx & (idx - 1))) {
+            adts_hash_mem_usage(p_hash, &(inst));
+            CDISPLAY("elems: %8zu  bytes: %10zu  peak: %10zu  bytes/elem: %8.2f",
+                     idx,
+                     inst.bytes_curr,
+                     inst.bytes_peak,
+                     (double) inst.bytes_curr / (double) idx);
+        }
+    }
+
+    adts_hash_destroy(p_hash);
+    free(p_node);
+
+    (void) adts_mem_stats(ADTS_MEM_TYPE_HASH, &(family));
+    CDISPLAY("family   bytes: %10zu  peak: %10zu",
+             family.bytes_curr, family.bytes_peak);
+    assert(before.bytes_curr == family.bytes_curr);
+
+    return;
+} /* utest_hash_footprint() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Workspace bytes of the TLB reach benchmark.  64MB keeps the default
+ *   utest run short, define 1 << 30 for the 1GB profile.
+ *
+ ****************************************************************************
+ */
+#ifndef UTEST_HASH_TLB_BYTES
+#define UTEST_HASH_TLB_BYTES (64ul << 20)
+#endif
+
+#define UTEST_HASH_TLB_FINDS (1 << 22)
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+static size_t
+utest_hash_tlb_function( adts_hash_t *p_hash,
+                         const void  *p_key )
+{
+    size_t idx = (size_t) p_key % p_hash->pub.elems_limit;
+
+    return idx;
+} /* utest_hash_tlb_function() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Data TLB read miss counter for the calling thread.  Returns -1 when
+ *   perf events are unavailable, e.g. within a container.
+ *
+ ****************************************************************************
+ */
+static int32_t
+utest_hash_tlb_counter( void )
+{
+    struct perf_event_attr attr = {0};
+
+    attr.size           = sizeof(attr);
+    attr.type           = PERF_TYPE_HW_CACHE;
+    attr.config         = (PERF_COUNT_HW_CACHE_DTLB) |
+                          (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                          (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attr.disabled       = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+
+    return syscall(__NR_perf_event_open, &(attr), 0, -1, -1, 0);
+} /* utest_hash_tlb_counter() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Random finds across a fixed size workspace, first with base pages and
+ *   then with THP advised workspace.  The table is populated at 1/16th
+ *   load such that most probes terminate on an empty slot, thus the
+ *   measured cost is dominated by the workspace access itself.
+ *
+ ****************************************************************************
+ */
+static void
+utest_hash_tlb( void )
+{
+    size_t                   elems   = UTEST_HASH_TLB_BYTES / sizeof(void *);
+    size_t                   nodes   = elems / 16;
+    int32_t                  rc      = 0;
+    adts_hash_t             *p_hash  = NULL;
+    adts_hash_node_t        *p_node  = NULL;
+    adts_mem_config_t        config  = {0};
+    adts_mem_config_t        bench   = {0};
+    adts_hash_create_t       op      = {0};
+    adts_hash_node_public_t  input   = {0};
+
+    adts_mem_config_get(&(config));
+
+    p_node = calloc(nodes, sizeof(*p_node));
+    assert(p_node);
+
+    op.options                    = ADTS_HASH_OPTS_DISABLE_RESIZE;
+    op.opts.disable_resize.elems  = elems;
+    op.p_func                     = utest_hash_tlb_function;
+
+    for (int32_t thp = 0; thp <= 1; thp++) {
+        int32_t   fd     = -1;
+        uint64_t  seed   = 0x9e3779b97f4a7c15ull;
+        uint64_t  key    = 0;
+        uint64_t  start  = 0;
+        uint64_t  stop   = 0;
+        uint64_t  misses = 0;
+        size_t    hits   = 0;
+
+        bench     = config;
+        bench.thp = thp;
+        rc = adts_mem_config_set(&(bench));
+        assert(0 == rc);
+
+        p_hash = adts_hash_create(&op);
+        assert(p_hash);
+
+        /* 1/16th load writes each workspace page, faulting it in */
+        for (size_t idx = 0; idx < nodes; idx++) {
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+
+            input.p_data = &(p_node[idx]);
+            input.bytes  = sizeof(*p_node);
+            input.p_key  = (void *) seed;
+            rc = adts_hash_insert(p_hash, &(p_node[idx]), &(input));
+            assert(0 == rc);
+        }
+
+        fd = utest_hash_tlb_counter();
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+
+        seed  = 0x9e3779b97f4a7c15ull;
+        start = adts_tstamp();
+        for (size_t cnt = 0; cnt < UTEST_HASH_TLB_FINDS; cnt++) {
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+
+            /* Replay the inserted keys, then random misses */
+            key   = (cnt < nodes) ? seed : (seed | 1ull << 63);
+            hits += (NULL != adts_hash_find(p_hash, (void *) key));
+        }
+        stop  = adts_tstamp();
+
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (sizeof(misses) != read(fd, &(misses), sizeof(misses))) {
+                misses = 0;
+            }
+            close(fd);
+        }
+
+        if (fd >= 0) {
+            CDISPLAY("thp: %d  workspace: %6zuMB  finds: %u  hits: %zu  ns/find: %6.2f  dtlb_miss: %"PRIu64,
+                     thp, UTEST_HASH_TLB_BYTES >> 20, UTEST_HASH_TLB_FINDS,
+                     hits,
+                     (double) (stop - start) / UTEST_HASH_TLB_FINDS,
+                     misses);
+        }else {
+            CDISPLAY("thp: %d  workspace: %6zuMB  finds: %u  hits: %zu  ns/find: %6.2f  dtlb_miss: n/a",
+                     thp, UTEST_HASH_TLB_BYTES >> 20, UTEST_HASH_TLB_FINDS,
+                     hits,
+                     (double) (stop - start) / UTEST_HASH_TLB_FINDS);
+        }
+
+        adts_hash_destroy(p_hash);
+    }
+
+    rc = adts_mem_config_set(&(config));
+    assert(0 == rc);
+    free(p_node);
+
+    return;
+} /* utest_hash_tlb() */
+
+
 /*
  ****************************************************************************
  * test control
@@ -1531,6 +1796,12 @@ utest_control( void )
     //test grow -> find
     //test shrink -> find
 
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: hash footprint");
+
+        utest_hash_footprint();
+    }
 
     return;
 } /* utest_control() */
@@ -1546,6 +1817,7 @@ void
 utest_adts_hash( void )
 {
 	utest_control();
+    utest_hash_tlb();
 
     return;
 } /* utest_adts_hash() */
@@ -3,6 +3,7 @@
 #include <string.h>
 #include <stdbool.h>
 #include <inttypes.h>
+#include <adts_memory.h>
 #include <adts_snapshot.h>
 
 /**
@@ -108,6 +109,7 @@ typedef struct {
             size_t elems; /**< static number of entries - ideally prime */
         } disable_resize;
     } opts;
+    const adts_allocator_t *p_allocator; /**< NULL selects the default */
 } adts_hash_create_t;
 
 
@@ -178,6 +180,10 @@ adts_hash_is_not_empty( const adts_hash_t *p_adts_hash );
 size_t
 adts_hash_entries( const adts_hash_t *p_adts_hash );
 
+void
+adts_hash_mem_usage( const adts_hash_t *p_adts_hash,
+                     adts_mem_stats_t  *p_out );
+
 void
 adts_hash_display_worker( adts_hash_t     *p_adts_hash,
                           char            *p_msg,
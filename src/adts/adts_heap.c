@@ -1,13 +1,18 @@
 
 #include <errno.h>
 #include <assert.h>
+#include <stdlib.h>
+#include <stddef.h>
 #include <string.h>
 #include <limits.h>
 #include <stdbool.h>
 #include <inttypes.h>
+#include <pthread.h>
 
 /* Toolbox */
 #include <adts_heap.h>
+#include <adts_time.h>
+#include <adts_memory.h>
 #include <adts_sanity.h>
 #include <adts_private.h>
 #include <adts_display.h>
@@ -42,24 +47,59 @@ typedef struct {
     void   *p_data; /**< consumer datapointer */
     size_t  bytes;  /**< data bytes for p_data */
     int64_t key;    /**< Key used to perform min or max heap ordering */
+    size_t  idx;    /**< workspace index, HEAP_IDX_NONE when not a member */
 } heap_node_t;
 
 
 /*
  ****************************************************************************
  * \details
- *   The heap workspace is an array of pointers, thus reserve as:
- *      32bit:
- *        1024 entries = pagesize / ptr size
+ *   Workspace entry.  The key is kept inline next to the node pointer,
+ *   thus a comparison never dereferences a consumer node.  The key is
+ *   stored in an unsigned, min ordered, form:
+ *     - MIN:  key with the sign bit flipped
+ *     - MAX:  key with every other bit flipped
  *
- *      64bit:
- *        512  entries = pagesize / ptr size
+ *   so that both heap types sift with the same unsigned less-than.
  *
- *   which is 0.5 4k page in 32bit mode and 1 4k page in 64bit mode.
+ ****************************************************************************
+ */
+typedef struct {
+    uint64_t     ukey;   /**< ordering key, see heap_ukey() */
+    heap_node_t *p_node; /**< consumer node */
+} heap_entry_t;
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   The heap workspace is an array of heap_entry_t, reserve one 4k page
+ *   worth of entries.  The workspace allocation carries one additional
+ *   cacheline of slack such that the children of a node, which follow
+ *   one another, start on a cacheline boundary.  With the default 4-ary
+ *   layout every sibling group is exactly one cacheline.
+ *
+ ****************************************************************************
+ */
+#define HEAP_DEFAULT_ELEMS  (4096 / sizeof(heap_entry_t))
+#define HEAP_DEFAULT_ARITY  (4)
+#define HEAP_ARITY_MAX      (16)
+#define HEAP_SIGN_BIT       (1ULL << 63)
+#define HEAP_IDX_NONE       (SIZE_MAX)
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Threaded build limits.  A level is only split across workers when
+ *   every worker receives at least HEAP_BUILD_SLICE_MIN entries, thus the
+ *   narrow upper levels are always heapified by the caller.
  *
  ****************************************************************************
  */
-#define HEAP_DEFAULT_ELEMS (4096 / sizeof(void *))
+#define HEAP_BUILD_THREADS_MAX (64)
+#define HEAP_BUILD_SLICE_MIN   (1 << 14)
+#define HEAP_BUILD_LEVELS_MAX  (64)
 
 
 /*
@@ -70,9 +110,13 @@ typedef struct {
 typedef struct {
     size_t            elems_curr;
     size_t            elems_limit;
-    heap_node_t     **workspace;
+    heap_entry_t     *workspace;  /**< cacheline adjusted, within p_raw */
+    void             *p_raw;      /**< workspace allocation */
+    uint64_t          key_mask;   /**< key to ukey transform, per type */
+    uint32_t          shift;      /**< log2(arity) */
     adts_sanity_t     sanity;
     adts_heap_type_t  type;
+    adts_mem_t        mem;
 } heap_t;
 
 
@@ -89,6 +133,102 @@ typedef struct {
  * #        #####  #     #  #####     #      ###   ####### #     #  #####
 ******************************************************************************/
 
+/*
+ ****************************************************************************
+ * \details
+ *   Workspace allocation bytes for a given entry limit.
+ *
+ ****************************************************************************
+ */
+static inline size_t
+heap_workspace_bytes( size_t elems )
+{
+    return (elems * sizeof(heap_entry_t)) + ADTS_CACHELINE_BYTES;
+} /* heap_workspace_bytes() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Position entry 0 such that entry 1, the first child of the root, and
+ *   thereby every subsequent sibling group, is cacheline aligned.
+ *
+ ****************************************************************************
+ */
+static inline heap_entry_t *
+heap_workspace_align( void *p_raw )
+{
+    uintptr_t first = (uintptr_t) p_raw + sizeof(heap_entry_t);
+    size_t    pad   = (size_t) (-first) & (ADTS_CACHELINE_BYTES - 1);
+
+    return (heap_entry_t *) ((char *) p_raw + pad);
+} /* heap_workspace_align() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Key to unsigned min ordered key, see heap_entry_t.
+ *
+ ****************************************************************************
+ */
+static inline uint64_t
+heap_ukey( const heap_t *p_heap,
+           int64_t       key )
+{
+    return ((uint64_t) key) ^ p_heap->key_mask;
+} /* heap_ukey() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Resize the workspace to limit_new entries, which must hold the current
+ *   population.  ADTS consumer is responsible for serialization.
+ *
+ ****************************************************************************
+ */
+static int32_t
+heap_resize_limit( heap_t *p_heap,
+                   size_t  limit_new )
+{
+    size_t        bytes     = 0;
+    size_t        bytes_old = 0;
+    size_t        pad_old   = 0;
+    int32_t       rc        = 0;
+    char         *p_tmp     = NULL;
+    heap_entry_t *p_ws      = NULL;
+
+    assert(limit_new >= p_heap->elems_curr);
+
+    /* p_tmp used to handle error case and preserve the workspace */
+    bytes     = heap_workspace_bytes(limit_new);
+    bytes_old = heap_workspace_bytes(p_heap->elems_limit);
+    pad_old   = (size_t) ((char *) p_heap->workspace - (char *) p_heap->p_raw);
+    p_tmp     = adts_mem_resize(&(p_heap->mem), p_heap->p_raw,
+                                bytes_old, bytes);
+    if (NULL == p_tmp) {
+        rc = ENOMEM;
+        goto exception;
+    }
+
+    /* A moved allocation may land at a different cacheline offset */
+    p_ws = heap_workspace_align(p_tmp);
+    if ((char *) p_ws != (p_tmp + pad_old)) {
+        memmove(p_ws, p_tmp + pad_old,
+                p_heap->elems_curr * sizeof(p_heap->workspace[0]));
+    }
+
+    /* Set the new heap properties */
+    p_heap->p_raw       = p_tmp;
+    p_heap->workspace   = p_ws;
+    p_heap->elems_limit = limit_new;
+
+exception:
+    return rc;
+} /* heap_resize_limit() */
+
+
 /*
  ****************************************************************************
  * \details
@@ -101,10 +241,7 @@ static int32_t
 heap_resize( heap_t           *p_heap,
              heap_resize_op_t  op )
 {
-    size_t        limit_new = p_heap->elems_limit;
-    size_t        bytes     = 0;
-    int32_t       rc        = 0;
-    heap_node_t *p_tmp      = NULL;
+    size_t limit_new = p_heap->elems_limit;
 
     switch (op) {
         case HEAP_GROW:
@@ -118,20 +255,7 @@ heap_resize( heap_t           *p_heap,
             assert(0);
     }
 
-    /* p_tmp used to handle error case and preserve the workspace */
-    bytes = limit_new * sizeof(p_heap->workspace[0]);
-    p_tmp = realloc(p_heap->workspace, bytes);
-    if (NULL == p_tmp) {
-        rc = ENOMEM;
-        goto exception;
-    }
-
-    /* Set the new heap properties */
-    p_heap->workspace   = p_tmp;
-    p_heap->elems_limit = limit_new;
-
-exception:
-    return rc;
+    return heap_resize_limit(p_heap, limit_new);
 } /* heap_resize() */
 
 
@@ -166,130 +290,135 @@ heap_resize_shrink_candidate( heap_t *p_heap )
 
 /*
  ****************************************************************************
- *
+ * \details
+ *   Place entry at idx, or above, moving larger parents down into the
+ *   hole rather than swapping.  Parent of idx is (idx - 1) / arity.
  *
  ****************************************************************************
  */
-static inline bool
-heap_node_swap_candidate( heap_t      *p_heap,
-                          heap_node_t *p_parent,
-                          heap_node_t *p_child )
+static inline void
+heap_adjust_up( heap_t       *p_heap,
+                size_t        idx,
+                heap_entry_t  entry )
 {
-    bool             rc = false;
-    adts_heap_type_t op = p_heap->type;
+    heap_entry_t   *ws    = p_heap->workspace;
+    const uint32_t  shift = p_heap->shift;
 
-    switch (op) {
-        case ADTS_HEAP_MAX:
-            rc = (p_parent->key <= p_child->key);
-            break;
-        case ADTS_HEAP_MIN:
-            rc = (p_parent->key >= p_child->key);
+    while (likely(idx)) {
+        size_t parent = (idx - 1) >> shift;
+
+        if (ws[parent].ukey <= entry.ukey) {
             break;
-        default:
-            assert(0); /* sanity */
+        }
+
+        ws[idx]             = ws[parent];
+        ws[idx].p_node->idx = idx;
+        idx                 = parent;
     }
 
-    return rc;
-} /* heap_node_swap_candidate() */
+    ws[idx]           = entry;
+    entry.p_node->idx = idx;
+
+    return;
+} /* heap_adjust_up() */
 
 
 /*
  ****************************************************************************
- *
+ * \details
+ *   Place entry at idx, or below, moving the least child up into the hole
+ *   while it is less than entry.  Children of idx are
+ *   (idx * arity) + 1 .. (idx * arity) + arity, one sibling group.
  *
  ****************************************************************************
  */
-static void
-heap_adjust_up( heap_t *p_heap )
+static inline void
+heap_adjust_down( heap_t       *p_heap,
+                  size_t        idx,
+                  heap_entry_t  entry )
 {
-    size_t       elems    = p_heap->elems_curr;
-    size_t       idx      = elems - 1;
-    heap_node_t *p_child  = NULL;
-    heap_node_t *p_parent = NULL;
+    heap_entry_t   *ws    = p_heap->workspace;
+    const size_t    elems = p_heap->elems_curr;
+    const uint32_t  shift = p_heap->shift;
+    const size_t    arity = (size_t) 1 << shift;
 
-    if (unlikely(1 >= elems)) {
-        /* Nothing to do here */
-        goto exception;
-    }
+    for (;;) {
+        size_t   first = (idx << shift) + 1;
+        size_t   last  = 0;
+        size_t   idxc  = first;
+        uint64_t ukey  = 0;
 
-    p_child  = p_heap->workspace[idx];
-    p_parent = p_heap->workspace[idx/2];
-    while ((1 <= idx) && heap_node_swap_candidate(p_heap, p_parent, p_child)) {
-        heap_node_t *p_tmp = NULL;
+        if (unlikely(first >= elems)) {
+            /* leaf */
+            break;
+        }
+
+        last = MIN(first + arity, elems);
+        ukey = ws[first].ukey;
+        for (size_t c = first + 1; c < last; c++) {
+            /* select rather than branch, the outcome is unpredictable */
+            bool lt = (ws[c].ukey < ukey);
+
+            ukey = lt ? ws[c].ukey : ukey;
+            idxc = lt ? c : idxc;
+        }
 
-        /* swap parent and child array entries */
-        p_tmp                    = p_heap->workspace[idx];
-        p_heap->workspace[idx]   = p_heap->workspace[idx/2];
-        p_heap->workspace[idx/2] = p_tmp;
+        if (entry.ukey <= ukey) {
+            break;
+        }
 
-        /* Get index of next parent and child to compare */
-        idx     /= 2;
-        p_child  = p_heap->workspace[idx];
-        p_parent = p_heap->workspace[idx/2];
+        ws[idx]             = ws[idxc];
+        ws[idx].p_node->idx = idx;
+        idx                 = idxc;
     }
 
-exception:
+    ws[idx]           = entry;
+    entry.p_node->idx = idx;
+
     return;
-} /* heap_adjust_up() */
+} /* heap_adjust_down() */
 
 
 /*
  ****************************************************************************
- *
+ * \details
+ *   Place entry at idx, the vacated slot of a removed or re-keyed entry,
+ *   moving up or down as required relative to the prior ukey at idx.
  *
  ****************************************************************************
  */
-static void
-heap_adjust_down( heap_t *p_heap )
+static inline void
+heap_adjust( heap_t       *p_heap,
+             size_t        idx,
+             uint64_t      ukey_prev,
+             heap_entry_t  entry )
 {
-    size_t           idx   = 0;
-    int32_t          rc    = 0;
-    const size_t     elems = p_heap->elems_curr;
-    adts_heap_type_t op    = p_heap->type;
-
-    if (1 >= elems) {
-        /* nothing to do here */
-        goto exception;
+    if (entry.ukey < ukey_prev) {
+        heap_adjust_up(p_heap, idx, entry);
+    }else {
+        heap_adjust_down(p_heap, idx, entry);
     }
 
-    for (;;) {
-        size_t        idxc     = 0;      /* child index */
-        heap_node_t  *p_tmp    = NULL;
-        heap_node_t  *p_left   = NULL;
-        heap_node_t  *p_right  = NULL;
-        const size_t  left     = (idx * 2) + 1;
-        const size_t  right    = (idx * 2) + 2;
-
-        p_left   = (left  < elems) ? p_heap->workspace[left]  : NULL;
-        p_right  = (right < elems) ? p_heap->workspace[right] : NULL;
-        if (likely(p_left && p_right)) {
-            switch (op) {
-                case ADTS_HEAP_MIN:
-                    idxc = (p_left->key < p_right->key) ? left : right;
-                    break;
-                case ADTS_HEAP_MAX:
-                    idxc = (p_left->key > p_right->key) ? left : right;
-                    break;
-                default:
-                    assert(0); /* sanity */
-            }
-        }else if (p_left) {
-            idxc = left;
-        }else {
-            goto exception;
-        }
+    return;
+} /* heap_adjust() */
 
-        /* swap parent and child array entries */
-        p_tmp                   = p_heap->workspace[idx];
-        p_heap->workspace[idx]  = p_heap->workspace[idxc];
-        p_heap->workspace[idxc] = p_tmp;
 
-        idx = idxc;
-    }
+/*
+ ****************************************************************************
+ * \details
+ *   A node is a member when its recorded index refers back to it.
+ *
+ ****************************************************************************
+ */
+static inline bool
+heap_node_is_member( heap_t      *p_heap,
+                     heap_node_t *p_node )
+{
+    size_t idx = p_node->idx;
 
-exception:
-    return;
-} /* heap_adjust_down() */
+    return ((idx < p_heap->elems_curr) &&
+            (p_heap->workspace[idx].p_node == p_node));
+} /* heap_node_is_member() */
 
 
 /*
@@ -332,6 +461,23 @@ adts_heap_entries( adts_heap_t *p_adts_heap )
 } /* adts_heap_entries() */
 
 
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_heap_mem_usage( adts_heap_t      *p_adts_heap,
+                     adts_mem_stats_t *p_out )
+{
+    heap_t *p_heap = (heap_t *) p_adts_heap;
+
+    adts_mem_usage(&(p_heap->mem), p_out);
+
+    return;
+} /* adts_heap_mem_usage() */
+
+
 /*
  ****************************************************************************
  *
@@ -351,11 +497,11 @@ adts_heap_display( adts_heap_t *p_adts_heap )
     elems  = p_heap->elems_curr;
     digits = adts_digits_decimal(elems);
 
-    /* The heap implementation uses an array representation of a binary tree
+    /* The heap implementation uses an array representation of a d-ary tree
      * therefore we simply perform a display / decode of each entry as array
      * format.  Alternately we can perform a BFS display as future extension */
     for (size_t idx = 0; idx < elems; idx++) {
-        heap_node_t *p_node = p_heap->workspace[idx];
+        heap_node_t *p_node = p_heap->workspace[idx].p_node;
         printf("[%*d]  node: %p  vaddr: %p  bytes: %d  key: 0x%016llx %-lld \n",
                 digits,
                 idx,
@@ -381,7 +527,11 @@ adts_heap_node_t *
 adts_heap_peek( adts_heap_t *p_adts_heap )
 {
     heap_t      *p_heap = (heap_t *) p_adts_heap;
-    heap_node_t *p_node = p_heap->workspace[0];
+    heap_node_t *p_node = NULL;
+
+    if (likely(p_heap->elems_curr)) {
+        p_node = p_heap->workspace[0].p_node;
+    }
 
     return (adts_heap_node_t *) p_node;
 } /* adts_heap_peek() */
@@ -390,8 +540,6 @@ adts_heap_peek( adts_heap_t *p_adts_heap )
 /*
  ****************************************************************************
  *
- *  FIXME: Add resize shrink capability
- *
  ****************************************************************************
  */
 adts_heap_node_t *
@@ -415,18 +563,20 @@ adts_heap_pop( adts_heap_t *p_adts_heap )
         (void) heap_resize(p_heap, HEAP_SHRINK);
     }
 
-    /* Pop root from tree, and overwrite root with last node in tree */
-    p_node               = p_heap->workspace[0];
-    idx                  = elems - 1;
-    p_heap->workspace[0] = p_heap->workspace[idx];
+    /* Pop root from tree, and sift the last entry down from the root */
+    p_node      = p_heap->workspace[0].p_node;
+    p_node->idx = HEAP_IDX_NONE;
+    idx         = elems - 1;
 
     p_heap->elems_curr--;
 
-    heap_adjust_down(p_heap);
+    if (likely(idx)) {
+        heap_adjust_down(p_heap, 0, p_heap->workspace[idx]);
+    }
 
 exception:
     adts_sanity_exit(p_sanity);
-    return p_node;
+    return (adts_heap_node_t *) p_node;
 } /* adts_heap_pop() */
 
 
@@ -444,8 +594,8 @@ adts_heap_push( adts_heap_t       *p_adts_heap,
                 int64_t            key )
 {
     heap_t        *p_heap   = (heap_t *) p_adts_heap;
-    size_t         idx      = 0;
     int32_t        rc       = 0;
+    heap_entry_t   entry    = {0};
     heap_node_t   *p_node   = (heap_node_t *) p_adts_node_heap;
     adts_sanity_t *p_sanity = &(p_heap->sanity);
 
@@ -469,14 +619,13 @@ adts_heap_push( adts_heap_t       *p_adts_heap,
     p_node->bytes  = bytes;
     p_node->key    = key;
 
-    /* Insert this node at end of array */
-    idx                    = p_heap->elems_curr;
-    p_heap->workspace[idx] = p_node;
+    /* Insert this node at end of array and sift up */
+    entry.ukey   = heap_ukey(p_heap, key);
+    entry.p_node = p_node;
+    heap_adjust_up(p_heap, p_heap->elems_curr, entry);
 
     p_heap->elems_curr++;
 
-    heap_adjust_up(p_heap);
-
 exception:
     adts_sanity_exit(p_sanity);
     return rc;
@@ -485,122 +634,1136 @@ exception:
 
 /*
  ****************************************************************************
- *
+ * \details
+ *   Re-key a member node in place, O(log n).  The node moves toward the
+ *   root when the new key has higher priority, otherwise toward the
+ *   leaves.
  *
  ****************************************************************************
  */
-void
-adts_heap_destroy( adts_heap_t *p_adts_heap )
+int32_t
+adts_heap_update_key( adts_heap_t      *p_adts_heap,
+                      adts_heap_node_t *p_adts_node_heap,
+                      int64_t           key )
 {
     heap_t        *p_heap   = (heap_t *) p_adts_heap;
+    int32_t        rc       = 0;
+    size_t         idx      = 0;
+    uint64_t       prev     = 0;
+    heap_entry_t   entry    = {0};
+    heap_node_t   *p_node   = (heap_node_t *) p_adts_node_heap;
     adts_sanity_t *p_sanity = &(p_heap->sanity);
 
     adts_sanity_entry(p_sanity);
 
-    free(p_heap->workspace);
-    free(p_heap);
+    assert(p_node);
 
-    /* No adts_sanity_exit() since we've freed the memory */
+    if (unlikely(false == heap_node_is_member(p_heap, p_node))) {
+        rc = EINVAL;
+        goto exception;
+    }
 
-    return;
-} /* adts_heap_destroy() */
+    idx          = p_node->idx;
+    prev         = p_heap->workspace[idx].ukey;
+    p_node->key  = key;
+    entry.ukey   = heap_ukey(p_heap, key);
+    entry.p_node = p_node;
+    heap_adjust(p_heap, idx, prev, entry);
+
+exception:
+    adts_sanity_exit(p_sanity);
+    return rc;
+} /* adts_heap_update_key() */
 
 
 /*
  ****************************************************************************
- *
+ * \details
+ *   Remove a member node from any position, O(log n).  The last entry
+ *   fills the vacated slot and is sifted from there.
  *
  ****************************************************************************
  */
-adts_heap_t *
-adts_heap_create( adts_heap_type_t type )
+int32_t
+adts_heap_remove( adts_heap_t      *p_adts_heap,
+                  adts_heap_node_t *p_adts_node_heap )
 {
-    size_t       elems       = HEAP_DEFAULT_ELEMS;
-    int32_t      rc          = 0;
-    heap_t      *p_heap      = NULL;
-    heap_node_t *p_elems     = NULL;
-    adts_heap_t *p_adts_heap = NULL;
+    heap_t        *p_heap   = (heap_t *) p_adts_heap;
+    int32_t        rc       = 0;
+    size_t         idx      = 0;
+    size_t         last     = 0;
+    heap_node_t   *p_node   = (heap_node_t *) p_adts_node_heap;
+    adts_sanity_t *p_sanity = &(p_heap->sanity);
 
-    p_adts_heap = adts_mem_zalloc(sizeof(*p_adts_heap));
-    if (NULL == p_adts_heap) {
-        rc = ENOMEM;
+    adts_sanity_entry(p_sanity);
+
+    assert(p_node);
+
+    if (unlikely(false == heap_node_is_member(p_heap, p_node))) {
+        rc = EINVAL;
         goto exception;
     }
 
-    /* Array of pointers to heap_adts_node_t */
-    p_elems = calloc(elems, sizeof(*p_elems));
-    if (NULL == p_elems) {
-        rc = ENOMEM;
-        goto exception;
+    if (heap_resize_shrink_candidate(p_heap)) {
+        /* Do not error out.  Try again on next removal */
+        (void) heap_resize(p_heap, HEAP_SHRINK);
     }
 
-    p_heap              = (heap_t *) p_adts_heap;
-    p_heap->type        = type;
-    p_heap->workspace   = p_elems;
-    p_heap->elems_limit = elems;
+    idx         = p_node->idx;
+    last        = p_heap->elems_curr - 1;
+    p_node->idx = HEAP_IDX_NONE;
 
-exception:
-    if (rc) {
-        if (p_elems) {
-            free(p_elems);
-			p_elems = NULL;
-        }
+    p_heap->elems_curr--;
 
-        if (p_adts_heap) {
-            free(p_adts_heap);
-			p_adts_heap = NULL;
-        }
+    if (idx != last) {
+        heap_adjust(p_heap, idx, p_heap->workspace[idx].ukey,
+                    p_heap->workspace[last]);
     }
 
-    return p_adts_heap;
-} /* adts_heap_create() */
+exception:
+    adts_sanity_exit(p_sanity);
+    return rc;
+} /* adts_heap_remove() */
 
 
+/*
+ ****************************************************************************
+ * \details
+ *   Build work item.  A fill slice populates nodes and workspace entries
+ *   [lo, hi) of the build input, a sift slice heapifies workspace
+ *   entries [lo, hi), which lie within one level and thus root disjoint
+ *   subtrees.
+ *
+ ****************************************************************************
+ */
+typedef struct {
+    heap_t                  *p_heap;
+    const adts_heap_build_t *p_op;
+    size_t                   base; /**< population prior to the build */
+    size_t                   lo;
+    size_t                   hi;
+    bool                     fill;
+} heap_build_slice_t;
 
 
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+static void *
+heap_build_worker( void *p_arg )
+{
+    heap_build_slice_t      *p_slice = p_arg;
+    heap_t                  *p_heap  = p_slice->p_heap;
+    const adts_heap_build_t *p_op    = p_slice->p_op;
+    heap_entry_t            *ws      = p_heap->workspace;
+
+    if (p_slice->fill) {
+        for (size_t idx = p_slice->lo; idx < p_slice->hi; idx++) {
+            heap_node_t *p_node = (heap_node_t *) &(p_op->p_nodes[idx]);
+            size_t       pos    = p_slice->base + idx;
+
+            assert(p_op->pp_data[idx]);
+
+            p_node->p_data = p_op->pp_data[idx];
+            p_node->bytes  = p_op->bytes;
+            p_node->key    = p_op->p_keys[idx];
+            p_node->idx    = pos;
+            ws[pos].ukey   = heap_ukey(p_heap, p_node->key);
+            ws[pos].p_node = p_node;
+        }
+    }else {
+        /* descending, within a level order does not matter */
+        for (size_t idx = p_slice->hi; idx > p_slice->lo; idx--) {
+            heap_adjust_down(p_heap, idx - 1, ws[idx - 1]);
+        }
+    }
 
-/******************************************************************************
- * #     # #     #   ###   ####### ####### #######  #####  #######  #####
- * #     # ##    #    #       #       #    #       #     #    #    #     #
- * #     # # #   #    #       #       #    #       #          #    #
- * #     # #  #  #    #       #       #    #####    #####     #     #####
- * #     # #   # #    #       #       #    #             #    #          #
- * #     # #    ##    #       #       #    #       #     #    #    #     #
- *  #####  #     #   ###      #       #    #######  #####     #     #####
-******************************************************************************/
+    return NULL;
+} /* heap_build_worker() */
 
 
-/**
- **************************************************************************
- * \brief
- *   Compile time structure sanity
- *
+/*
+ ****************************************************************************
  * \details
- *   Sanitize the abstract data type interface.  Enforced in header file so
- *   as to catch improper usage/include by unauthorized callers.
+ *   Split [lo, hi) evenly across threads, the caller takes the first
+ *   slice.  Should a thread fail to start, its slice runs in the caller,
+ *   thus the build never fails for lack of threads.
  *
- **************************************************************************
+ ****************************************************************************
  */
 static void
-utest_heap_bytes( void )
+heap_build_run( const heap_build_slice_t *p_tmpl,
+                size_t                    lo,
+                size_t                    hi,
+                uint32_t                  threads )
 {
+    pthread_t          tid[ HEAP_BUILD_THREADS_MAX ]     = {0};
+    bool               started[ HEAP_BUILD_THREADS_MAX ] = {0};
+    heap_build_slice_t slice[ HEAP_BUILD_THREADS_MAX ];
+    const size_t       span = hi - lo;
+
+    for (uint32_t t = 0; t < threads; t++) {
+        slice[t]    = *p_tmpl;
+        slice[t].lo = lo + ((span * t) / threads);
+        slice[t].hi = lo + ((span * (t + 1)) / threads);
+    }
 
-    CDISPLAY("[%u]", sizeof(heap_t));
-    CDISPLAY("[%u]", sizeof(adts_heap_t));
+    for (uint32_t t = 1; t < threads; t++) {
+        started[t] = (0 == pthread_create(&(tid[t]), NULL,
+                                          heap_build_worker, &(slice[t])));
+        if (false == started[t]) {
+            (void) heap_build_worker(&(slice[t]));
+        }
+    }
 
-    _Static_assert(sizeof(heap_t) <= sizeof(adts_heap_t),
-        "Mismatch structs detected");
+    (void) heap_build_worker(&(slice[0]));
 
-    CDISPLAY("[%u]", sizeof(heap_node_t));
-    CDISPLAY("[%u]", sizeof(adts_heap_node_t));
+    for (uint32_t t = 1; t < threads; t++) {
+        if (started[t]) {
+            (void) pthread_join(tid[t], NULL);
+        }
+    }
+
+    return;
+} /* heap_build_run() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Bulk insert, O(entries) via bottom-up (Floyd) heapify:
+ *     - reserve the workspace once,
+ *     - append every input entry unordered,
+ *     - sift down each parent, deepest level first.
+ *
+ *   Existing members are retained and heapified along with the input.
+ *   Entries of one level root disjoint subtrees, thus wide levels are
+ *   split across threads with a join between levels.
+ *
+ ****************************************************************************
+ */
+int32_t
+adts_heap_build_ext( adts_heap_t             *p_adts_heap,
+                     const adts_heap_build_t *p_op )
+{
+    heap_t             *p_heap   = (heap_t *) p_adts_heap;
+    int32_t             rc       = 0;
+    uint32_t            threads  = 1;
+    uint32_t            levels   = 0;
+    size_t              total    = 0;
+    size_t              limit    = 0;
+    size_t              parent   = 0;
+    size_t              first[ HEAP_BUILD_LEVELS_MAX + 1 ] = {0};
+    heap_build_slice_t  tmpl     = {0};
+    adts_sanity_t      *p_sanity = &(p_heap->sanity);
+
+    adts_sanity_entry(p_sanity);
+
+    assert(p_op);
+
+    if (0 == p_op->elems) {
+        /* Nothing to do here */
+        goto exception;
+    }
+
+    assert(p_op->p_nodes);
+    assert(p_op->p_keys);
+    assert(p_op->pp_data);
+    assert(p_op->bytes);
+
+    if (p_op->threads) {
+        threads = MIN(p_op->threads, HEAP_BUILD_THREADS_MAX);
+    }
+
+    total = p_heap->elems_curr + p_op->elems;
+    if ((total < p_op->elems) ||
+        (total > ((SIZE_MAX / 2) / sizeof(heap_entry_t)))) {
+        rc = ENOMEM;
+        goto exception;
+    }
+
+    /* Single resize to the power of two which holds the result */
+    limit = p_heap->elems_limit;
+    while (limit < total) {
+        limit *= 2;
+    }
+    if (limit != p_heap->elems_limit) {
+        rc = heap_resize_limit(p_heap, limit);
+        if (rc) {
+            goto exception;
+        }
+    }
+
+    tmpl.p_heap = p_heap;
+    tmpl.p_op   = p_op;
+    tmpl.base   = p_heap->elems_curr;
+    tmpl.fill   = true;
+    if ((1 < threads) && ((p_op->elems / threads) >= HEAP_BUILD_SLICE_MIN)) {
+        heap_build_run(&(tmpl), 0, p_op->elems, threads);
+    }else {
+        heap_build_run(&(tmpl), 0, p_op->elems, 1);
+    }
+
+    p_heap->elems_curr = total;
+    if (2 > total) {
+        goto exception;
+    }
+
+    /* Level start indices down to the level of the last parent */
+    parent = (total - 2) >> p_heap->shift;
+    while ((levels < HEAP_BUILD_LEVELS_MAX) && (first[levels] <= parent)) {
+        first[levels + 1] = (first[levels] << p_heap->shift) + 1;
+        levels++;
+    }
+
+    tmpl.fill = false;
+    for (uint32_t l = levels; l > 0; l--) {
+        size_t lo = first[l - 1];
+        size_t hi = MIN(first[l], parent + 1);
+
+        if ((1 < threads) && (((hi - lo) / threads) >= HEAP_BUILD_SLICE_MIN)) {
+            heap_build_run(&(tmpl), lo, hi, threads);
+        }else {
+            heap_build_run(&(tmpl), lo, hi, 1);
+        }
+    }
+
+exception:
+    adts_sanity_exit(p_sanity);
+    return rc;
+} /* adts_heap_build_ext() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+int32_t
+adts_heap_build( adts_heap_t      *p_adts_heap,
+                 adts_heap_node_t *p_nodes,
+                 const int64_t    *p_keys,
+                 void * const     *pp_data,
+                 size_t            bytes,
+                 size_t            elems )
+{
+    adts_heap_build_t op = {0};
+
+    op.p_nodes = p_nodes;
+    op.p_keys  = p_keys;
+    op.pp_data = pp_data;
+    op.bytes   = bytes;
+    op.elems   = elems;
+
+    return adts_heap_build_ext(p_adts_heap, &(op));
+} /* adts_heap_build() */
+
+
+/*
+ ****************************************************************************
+ *
+ *
+ ****************************************************************************
+ */
+void
+adts_heap_destroy( adts_heap_t *p_adts_heap )
+{
+    size_t         bytes    = 0;
+    heap_t        *p_heap   = (heap_t *) p_adts_heap;
+    adts_mem_t     mem      = p_heap->mem;
+    adts_sanity_t *p_sanity = &(p_heap->sanity);
+
+    adts_sanity_entry(p_sanity);
+
+    bytes = heap_workspace_bytes(p_heap->elems_limit);
+    adts_mem_put(&(mem), p_heap->p_raw, bytes);
+    adts_mem_put(&(mem), p_heap, sizeof(*p_adts_heap));
+
+    /* No adts_sanity_exit() since we've freed the memory */
+
+    return;
+} /* adts_heap_destroy() */
+
+
+/*
+ ****************************************************************************
+ *
+ *
+ ****************************************************************************
+ */
+adts_heap_t *
+adts_heap_create( adts_heap_type_t type )
+{
+    adts_heap_create_t op = {0};
+
+    op.type = type;
+
+    return adts_heap_create_ext(&(op));
+} /* adts_heap_create() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+adts_heap_t *
+adts_heap_create_ext( const adts_heap_create_t *p_op )
+{
+    size_t        elems       = HEAP_DEFAULT_ELEMS;
+    size_t        arity       = HEAP_DEFAULT_ARITY;
+    size_t        bytes       = 0;
+    int32_t       rc          = 0;
+    heap_t       *p_heap      = NULL;
+    adts_mem_t    mem         = {0};
+    void         *p_raw       = NULL;
+    adts_heap_t  *p_adts_heap = NULL;
+
+    assert(p_op);
+    adts_mem_init_ext(&(mem), ADTS_MEM_TYPE_HEAP, p_op->p_allocator);
+
+    if (p_op->arity) {
+        arity = p_op->arity;
+    }
+
+    if ((2 > arity) || (HEAP_ARITY_MAX < arity) || (arity & (arity - 1))) {
+        /* arity must be a power of two in range */
+        rc = EINVAL;
+        goto exception;
+    }
+
+    if ((ADTS_HEAP_MIN != p_op->type) && (ADTS_HEAP_MAX != p_op->type)) {
+        rc = EINVAL;
+        goto exception;
+    }
+
+    p_adts_heap = adts_mem_get(&(mem), sizeof(*p_adts_heap));
+    if (NULL == p_adts_heap) {
+        rc = ENOMEM;
+        goto exception;
+    }
+
+    /* Array of heap_entry_t plus cacheline alignment slack */
+    bytes = heap_workspace_bytes(elems);
+    p_raw = adts_mem_get(&(mem), bytes);
+    if (NULL == p_raw) {
+        rc = ENOMEM;
+        goto exception;
+    }
+
+    p_heap              = (heap_t *) p_adts_heap;
+    p_heap->type        = p_op->type;
+    p_heap->p_raw       = p_raw;
+    p_heap->workspace   = heap_workspace_align(p_raw);
+    p_heap->elems_limit = elems;
+    p_heap->shift       = (uint32_t) __builtin_ctzl(arity);
+    p_heap->key_mask    = (ADTS_HEAP_MIN == p_op->type) ?
+                          HEAP_SIGN_BIT : ~HEAP_SIGN_BIT;
+    p_heap->mem         = mem;
+
+exception:
+    if (rc) {
+        if (p_raw) {
+            adts_mem_put(&(mem), p_raw, bytes);
+			p_raw = NULL;
+        }
+
+        if (p_adts_heap) {
+            adts_mem_put(&(mem), p_adts_heap, sizeof(*p_adts_heap));
+			p_adts_heap = NULL;
+        }
+    }
+
+    return p_adts_heap;
+} /* adts_heap_create_ext() */
+
+
+
+
+
+/******************************************************************************
+ * #     # #     #   ###   ####### ####### #######  #####  #######  #####
+ * #     # ##    #    #       #       #    #       #     #    #    #     #
+ * #     # # #   #    #       #       #    #       #          #    #
+ * #     # #  #  #    #       #       #    #####    #####     #     #####
+ * #     # #   # #    #       #       #    #             #    #          #
+ * #     # #    ##    #       #       #    #       #     #    #    #     #
+ *  #####  #     #   ###      #       #    #######  #####     #     #####
+******************************************************************************/
+
+
+/**
+ **************************************************************************
+ * \brief
+ *   Compile time structure sanity
+ *
+ * \details
+ *   Sanitize the abstract data type interface.  Enforced in header file so
+ *   as to catch improper usage/include by unauthorized callers.
+ *
+ **************************************************************************
+ */
+static void
+utest_heap_bytes( void )
+{
+
+    CDISPLAY("[%u]", sizeof(heap_t));
+    CDISPLAY("[%u]", sizeof(adts_heap_t));
+
+    _Static_assert(sizeof(heap_t) <= sizeof(adts_heap_t),
+        "Mismatch structs detected");
+
+    CDISPLAY("[%u]", sizeof(heap_node_t));
+    CDISPLAY("[%u]", sizeof(adts_heap_node_t));
 
     _Static_assert(sizeof(heap_node_t) <= sizeof(adts_heap_node_t),
         "Mismatch structs detected");
+    _Static_assert(offsetof(heap_node_t, key) ==
+                   offsetof(adts_heap_node_public_t, key),
+        "Mismatch structs detected");
 
     return;
 } /* utest_heap_bytes() */
 
 
+/*
+ ****************************************************************************
+ * \details
+ *   Report the instance footprint, including workspace slack, as the
+ *   heap population increases.  Nodes are consumer owned and therefore
+ *   not part of the heap footprint.
+ *
+ ****************************************************************************
+ */
+static void
+utest_heap_footprint( void )
+{
+    size_t            elems  = 1 << 20;
+    adts_heap_t      *p_heap = NULL;
+    adts_heap_node_t *p_node = NULL;
+    adts_mem_stats_t  inst   = {0};
+    adts_mem_stats_t  before = {0};
+    adts_mem_stats_t  family = {0};
+
+    (void) adts_mem_stats(ADTS_MEM_TYPE_HEAP, &(before));
+
+    p_node = calloc(elems, sizeof(*p_node));
+    assert(p_node);
+
+    p_heap = adts_heap_create(ADTS_HEAP_MIN);
+    assert(p_heap);
+
+    for (size_t idx = 1; idx <= elems; idx++) {
+        (void) adts_heap_push(p_heap, &(p_node[idx - 1]), p_node, 1, idx);
+        if (0 == (idx & (idx - 1))) {
+            adts_heap_mem_usage(p_heap, &(inst));
+            CDISPLAY("elems: %8zu  bytes: %10zu  peak: %10zu  bytes/elem: %8.2f",
+                     idx,
+                     inst.bytes_curr,
+                     inst.bytes_peak,
+                     (double) inst.bytes_curr / (double) idx);
+        }
+    }
+
+    adts_heap_destroy(p_heap);
+    free(p_node);
+
+    (void) adts_mem_stats(ADTS_MEM_TYPE_HEAP, &(family));
+    CDISPLAY("family   bytes: %10zu  peak: %10zu",
+             family.bytes_curr, family.bytes_peak);
+    assert(before.bytes_curr == family.bytes_curr);
+
+    return;
+} /* utest_heap_footprint() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Elements pushed by the resize cost benchmark, 1 << 22 is a 64MB
+ *   workspace at the final grow.
+ *
+ ****************************************************************************
+ */
+#ifndef UTEST_HEAP_RESIZE_ELEMS
+#define UTEST_HEAP_RESIZE_ELEMS (1 << 22)
+#endif
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Grow cost with and without mremap() of the mapped workspace.  Keys
+ *   ascend, thus the timed push is dominated by the grow itself.  Only
+ *   the pushes which trigger a grow are timed.
+ *
+ ****************************************************************************
+ */
+static void
+utest_heap_resize_cost( void )
+{
+    size_t                elems   = UTEST_HEAP_RESIZE_ELEMS;
+    adts_heap_t          *p_heap  = NULL;
+    adts_heap_node_t     *p_node  = NULL;
+    adts_mem_config_t     config  = {0};
+    adts_mem_config_t     bench   = {0};
+    adts_mem_map_stats_t  before  = {0};
+    adts_mem_map_stats_t  after   = {0};
+
+    adts_mem_config_get(&(config));
+
+    p_node = calloc(elems, sizeof(*p_node));
+    assert(p_node);
+
+    for (int32_t remap = 0; remap <= 1; remap++) {
+        uint64_t start = 0;
+        uint64_t delta = 0;
+        uint64_t total = 0;
+        uint64_t last  = 0;
+
+        bench       = config;
+        bench.remap = remap;
+        assert(0 == adts_mem_config_set(&(bench)));
+        adts_mem_map_stats(&(before));
+
+        p_heap = adts_heap_create(ADTS_HEAP_MIN);
+        assert(p_heap);
+
+        for (size_t idx = 1; idx <= elems; idx++) {
+            /* grow occurs on the push following a full pow2 workspace */
+            if ((idx > HEAP_DEFAULT_ELEMS) && (0 == ((idx - 1) & (idx - 2)))) {
+                start  = adts_tstamp();
+                (void) adts_heap_push(p_heap, &(p_node[idx - 1]), p_node, 1, idx);
+                delta  = adts_tstamp() - start;
+                total += delta;
+                last   = delta;
+            }else {
+                (void) adts_heap_push(p_heap, &(p_node[idx - 1]), p_node, 1, idx);
+            }
+        }
+
+        adts_heap_destroy(p_heap);
+        adts_mem_map_stats(&(after));
+
+        CDISPLAY("remap: %d  elems: %zu  grow total: %10"PRIu64"ns  final grow: %10"PRIu64"ns  remaps: %zu",
+                 remap, elems, total, last, after.remaps - before.remaps);
+    }
+
+    assert(0 == adts_mem_config_set(&(config)));
+    free(p_node);
+
+    return;
+} /* utest_heap_resize_cost() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Small PRNG for key generation, xorshift64.
+ *
+ ****************************************************************************
+ */
+static inline uint64_t
+utest_heap_rand( uint64_t *p_state )
+{
+    uint64_t x = *p_state;
+
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *p_state = x;
+
+    return x;
+} /* utest_heap_rand() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Pop order for every type and arity, random keys across the full
+ *   signed range including both extremes and duplicates.  Pushes and
+ *   pops are interleaved such that the workspace grows and shrinks.
+ *
+ ****************************************************************************
+ */
+static void
+utest_heap_order( void )
+{
+    size_t              elems   = 1 << 14;
+    uint64_t            seed    = 0x9e3779b97f4a7c15ULL;
+    adts_heap_node_t   *p_node  = NULL;
+    adts_heap_type_t    types[] = {ADTS_HEAP_MIN, ADTS_HEAP_MAX};
+    adts_heap_create_t  op      = {0};
+
+    /* nodes are not reused, the rounds push 1.25 * elems in total */
+    p_node = calloc(elems * 2, sizeof(*p_node));
+    assert(p_node);
+
+    /* invalid arity */
+    op.type  = ADTS_HEAP_MIN;
+    op.arity = 3;
+    assert(NULL == adts_heap_create_ext(&(op)));
+    op.arity = 32;
+    assert(NULL == adts_heap_create_ext(&(op)));
+
+    for (size_t t = 0; t < sizeof(types) / sizeof(types[0]); t++) {
+        for (size_t arity = 2; arity <= 16; arity *= 2) {
+            adts_heap_t *p_heap = NULL;
+            size_t       pushed = 0;
+            size_t       popped = 0;
+
+            op.type  = types[t];
+            op.arity = arity;
+            p_heap   = adts_heap_create_ext(&(op));
+            assert(p_heap);
+            assert(NULL == adts_heap_peek(p_heap));
+
+            /* fill to 3/4 then drain to 1/4, twice, then drain fully */
+            for (size_t round = 0; round < 3; round++) {
+                size_t  fill  = (round < 2) ? (elems * 3 / 4) : 0;
+                size_t  drain = (round < 2) ? (elems / 4) : 0;
+                int64_t prev  = 0;
+
+                while (adts_heap_entries(p_heap) < fill) {
+                    int64_t key = (int64_t) utest_heap_rand(&(seed));
+
+                    switch (pushed % 7) {
+                        case 0: key = INT64_MIN; break;
+                        case 1: key = INT64_MAX; break;
+                        case 2: key = key % 16;  break; /* duplicates */
+                        default: break;
+                    }
+                    assert(0 == adts_heap_push(p_heap, &(p_node[pushed]),
+                                               p_node, 1, key));
+                    pushed++;
+                }
+
+                for (size_t idx = 0; adts_heap_entries(p_heap) > drain; idx++) {
+                    const int64_t *p_key = NULL;
+
+                    assert(adts_heap_peek(p_heap) != NULL);
+                    /* heap_node_t.key is the consumers key */
+                    p_key = &(((const heap_node_t *) adts_heap_pop(p_heap))->key);
+                    if (idx) {
+                        if (ADTS_HEAP_MIN == types[t]) {
+                            assert(prev <= *p_key);
+                        }else {
+                            assert(prev >= *p_key);
+                        }
+                    }
+                    prev = *p_key;
+                    popped++;
+                }
+            }
+
+            assert(pushed == popped);
+            assert(adts_heap_is_empty(p_heap));
+            assert(NULL == adts_heap_pop(p_heap));
+            adts_heap_destroy(p_heap);
+        }
+    }
+
+    free(p_node);
+
+    return;
+} /* utest_heap_order() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Full invariant check: heap order, inline keys match the node keys,
+ *   and every node records its own index.
+ *
+ ****************************************************************************
+ */
+static void
+utest_heap_verify( adts_heap_t *p_adts_heap )
+{
+    heap_t       *p_heap = (heap_t *) p_adts_heap;
+    heap_entry_t *ws     = p_heap->workspace;
+
+    for (size_t idx = 0; idx < p_heap->elems_curr; idx++) {
+        assert(ws[idx].p_node->idx == idx);
+        assert(ws[idx].ukey == heap_ukey(p_heap, ws[idx].p_node->key));
+        if (idx) {
+            assert(ws[(idx - 1) >> p_heap->shift].ukey <= ws[idx].ukey);
+        }
+    }
+
+    return;
+} /* utest_heap_verify() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Random sequences of push, pop, update_key and remove against a
+ *   membership table.  Each pop is checked against a linear scan of the
+ *   members and the invariants are verified after every operation.
+ *
+ ****************************************************************************
+ */
+static void
+utest_heap_handles( void )
+{
+    #define UTEST_HANDLE_ELEMS (512)
+    #define UTEST_HANDLE_OPS   (1 << 15)
+    adts_heap_node_t    node[ UTEST_HANDLE_ELEMS ]   = {0};
+    bool                member[ UTEST_HANDLE_ELEMS ] = {0};
+    uint64_t            seed    = 0xd1b54a32d192ed03ULL;
+    adts_heap_type_t    types[] = {ADTS_HEAP_MIN, ADTS_HEAP_MAX};
+    adts_heap_create_t  op      = {0};
+
+    for (size_t t = 0; t < sizeof(types) / sizeof(types[0]); t++) {
+        for (size_t arity = 2; arity <= 16; arity *= 2) {
+            adts_heap_t *p_heap = NULL;
+            size_t       count  = 0;
+
+            memset(member, 0, sizeof(member));
+            op.type  = types[t];
+            op.arity = arity;
+            p_heap   = adts_heap_create_ext(&(op));
+            assert(p_heap);
+
+            for (size_t i = 0; i < UTEST_HANDLE_OPS; i++) {
+                uint64_t     r      = utest_heap_rand(&(seed));
+                size_t       h      = (r >> 8) % UTEST_HANDLE_ELEMS;
+                int64_t      key    = (int64_t) (r >> 32) % 1000 - 500;
+                heap_node_t *p_node = (heap_node_t *) &(node[h]);
+
+                switch (r % 5) {
+                    case 0:   /* push */
+                    case 1:
+                        if (false == member[h]) {
+                            assert(0 == adts_heap_push(p_heap, &(node[h]),
+                                                       node, 1, key));
+                            member[h] = true;
+                            count++;
+                        }
+                        break;
+
+                    case 2: { /* pop, must match the best member */
+                        heap_node_t *p_pop = NULL;
+                        bool         found = false;
+                        int64_t      best  = 0;
+
+                        for (size_t m = 0; m < UTEST_HANDLE_ELEMS; m++) {
+                            int64_t k = ((heap_node_t *) &(node[m]))->key;
+
+                            if (member[m] && ((false == found) ||
+                                ((ADTS_HEAP_MIN == types[t]) ? (k < best) : (k > best)))) {
+                                best  = k;
+                                found = true;
+                            }
+                        }
+
+                        p_pop = (heap_node_t *) adts_heap_pop(p_heap);
+                        if (found) {
+                            assert(p_pop);
+                            assert(best == p_pop->key);
+                            member[p_pop - (heap_node_t *) node] = false;
+                            count--;
+                        }else {
+                            assert(NULL == p_pop);
+                        }
+                        break;
+                    }
+
+                    case 3:   /* update_key, non members are rejected */
+                        if (member[h]) {
+                            assert(0 == adts_heap_update_key(p_heap, &(node[h]), key));
+                            assert(key == p_node->key);
+                        }else {
+                            assert(EINVAL == adts_heap_update_key(p_heap, &(node[h]), key));
+                        }
+                        break;
+
+                    case 4:   /* remove, non members are rejected */
+                        if (member[h]) {
+                            assert(0 == adts_heap_remove(p_heap, &(node[h])));
+                            member[h] = false;
+                            count--;
+                        }else {
+                            assert(EINVAL == adts_heap_remove(p_heap, &(node[h])));
+                        }
+                        break;
+                }
+
+                assert(count == adts_heap_entries(p_heap));
+                utest_heap_verify(p_heap);
+            }
+
+            adts_heap_destroy(p_heap);
+        }
+    }
+
+    return;
+} /* utest_heap_handles() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Bulk build into an empty heap, onto existing members, and threaded,
+ *   for both types.  Invariants are verified then the heap drained in
+ *   order.
+ *
+ ****************************************************************************
+ */
+static void
+utest_heap_build( void )
+{
+    size_t              elems   = 1 << 20;
+    uint64_t            seed    = 0x853c49e6748fea9bULL;
+    int64_t            *p_keys  = NULL;
+    void              **pp_data = NULL;
+    adts_heap_node_t   *p_node  = NULL;
+    adts_heap_type_t    types[] = {ADTS_HEAP_MIN, ADTS_HEAP_MAX};
+
+    p_keys  = calloc(elems, sizeof(*p_keys));
+    pp_data = calloc(elems, sizeof(*pp_data));
+    p_node  = calloc(elems, sizeof(*p_node));
+    assert(p_keys && pp_data && p_node);
+
+    for (size_t idx = 0; idx < elems; idx++) {
+        p_keys[idx]  = (int64_t) utest_heap_rand(&(seed));
+        pp_data[idx] = &(p_keys[idx]);
+    }
+
+    for (size_t t = 0; t < sizeof(types) / sizeof(types[0]); t++) {
+        for (uint32_t threads = 1; threads <= 4; threads *= 4) {
+            size_t             split  = elems / 3;
+            adts_heap_t       *p_heap = NULL;
+            adts_heap_build_t  bop    = {0};
+            heap_node_t       *p_prev = NULL;
+
+            p_heap = adts_heap_create(types[t]);
+            assert(p_heap);
+
+            /* empty build is a no-op */
+            assert(0 == adts_heap_build(p_heap, p_node, p_keys,
+                                        (void * const *) pp_data, 1, 0));
+            assert(adts_heap_is_empty(p_heap));
+
+            /* existing members, pushed, then bulk onto them */
+            for (size_t idx = 0; idx < split; idx++) {
+                assert(0 == adts_heap_push(p_heap, &(p_node[idx]),
+                                           pp_data[idx], 1, p_keys[idx]));
+            }
+
+            bop.p_nodes = &(p_node[split]);
+            bop.p_keys  = &(p_keys[split]);
+            bop.pp_data = (void * const *) &(pp_data[split]);
+            bop.bytes   = 1;
+            bop.elems   = elems - split;
+            bop.threads = threads;
+            assert(0 == adts_heap_build_ext(p_heap, &(bop)));
+            assert(elems == adts_heap_entries(p_heap));
+            utest_heap_verify(p_heap);
+
+            for (size_t idx = 0; idx < elems; idx++) {
+                heap_node_t *p_pop = (heap_node_t *) adts_heap_pop(p_heap);
+
+                assert(p_pop);
+                assert(p_pop->p_data == &(p_keys[p_pop - (heap_node_t *) p_node]));
+                if (p_prev) {
+                    if (ADTS_HEAP_MIN == types[t]) {
+                        assert(p_prev->key <= p_pop->key);
+                    }else {
+                        assert(p_prev->key >= p_pop->key);
+                    }
+                }
+                p_prev = p_pop;
+            }
+
+            assert(adts_heap_is_empty(p_heap));
+            adts_heap_destroy(p_heap);
+        }
+    }
+
+    free(p_node);
+    free(pp_data);
+    free(p_keys);
+
+    return;
+} /* utest_heap_build() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Elements for the build benchmark.  50M requires ~3.5GB of input and
+ *   workspace, thus the default is smaller.
+ *
+ ****************************************************************************
+ */
+#ifndef UTEST_HEAP_BUILD_ELEMS
+#define UTEST_HEAP_BUILD_ELEMS (1 << 23)
+#endif
+
+#ifndef UTEST_HEAP_BUILD_THREADS
+#define UTEST_HEAP_BUILD_THREADS (4)
+#endif
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Populate a heap from the same input via n pushes, a single threaded
+ *   build and a threaded build.  Keys are random.
+ *
+ ****************************************************************************
+ */
+static void
+utest_heap_build_rate( void )
+{
+    size_t              elems   = UTEST_HEAP_BUILD_ELEMS;
+    uint64_t            seed    = 0x94d049bb133111ebULL;
+    int64_t            *p_keys  = NULL;
+    void              **pp_data = NULL;
+    adts_heap_node_t   *p_node  = NULL;
+
+    p_keys  = calloc(elems, sizeof(*p_keys));
+    pp_data = calloc(elems, sizeof(*pp_data));
+    p_node  = calloc(elems, sizeof(*p_node));
+    assert(p_keys && pp_data && p_node);
+
+    for (size_t idx = 0; idx < elems; idx++) {
+        p_keys[idx]  = (int64_t) utest_heap_rand(&(seed));
+        pp_data[idx] = &(p_keys[idx]);
+    }
+
+    for (uint32_t mode = 0; mode < 3; mode++) {
+        adts_heap_t       *p_heap = NULL;
+        adts_heap_build_t  bop    = {0};
+        uint64_t           start  = 0;
+        uint64_t           delta  = 0;
+
+        p_heap = adts_heap_create(ADTS_HEAP_MIN);
+        assert(p_heap);
+
+        bop.p_nodes = p_node;
+        bop.p_keys  = p_keys;
+        bop.pp_data = (void * const *) pp_data;
+        bop.bytes   = 1;
+        bop.elems   = elems;
+        bop.threads = (2 == mode) ? UTEST_HEAP_BUILD_THREADS : 1;
+
+        start = adts_tstamp();
+        if (0 == mode) {
+            for (size_t idx = 0; idx < elems; idx++) {
+                (void) adts_heap_push(p_heap, &(p_node[idx]),
+                                      pp_data[idx], 1, p_keys[idx]);
+            }
+        }else {
+            assert(0 == adts_heap_build_ext(p_heap, &(bop)));
+        }
+        delta = adts_tstamp() - start;
+
+        CDISPLAY("elems: %10zu  %-6s threads: %2u  total: %8.2fms  per elem: %6.2fns",
+                 elems,
+                 (0 == mode) ? "push" : "build",
+                 bop.threads,
+                 (double) delta / 1000000.0,
+                 (double) delta / (double) elems);
+
+        adts_heap_destroy(p_heap);
+    }
+
+    free(p_node);
+    free(pp_data);
+    free(p_keys);
+
+    return;
+} /* utest_heap_build_rate() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Population range for the push / pop throughput benchmark, a decade
+ *   at a time.  100M elements requires ~5GB, thus the default stops at
+ *   10M; override UTEST_HEAP_RATE_ELEMS_MAX to extend.
+ *
+ ****************************************************************************
+ */
+#ifndef UTEST_HEAP_RATE_ELEMS_MIN
+#define UTEST_HEAP_RATE_ELEMS_MIN (10000)
+#endif
+
+#ifndef UTEST_HEAP_RATE_ELEMS_MAX
+#define UTEST_HEAP_RATE_ELEMS_MAX (10000000)
+#endif
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Push n random keys then pop all n, for arity 2, 4 and 8.  Reports
+ *   mean ns per push and per pop.  The pop sequence is verified ordered.
+ *
+ ****************************************************************************
+ */
+static void
+utest_heap_rate( void )
+{
+    adts_heap_node_t *p_node = NULL;
+
+    p_node = calloc(UTEST_HEAP_RATE_ELEMS_MAX, sizeof(*p_node));
+    assert(p_node);
+
+    for (size_t elems = UTEST_HEAP_RATE_ELEMS_MIN;
+         elems <= UTEST_HEAP_RATE_ELEMS_MAX;
+         elems *= 10) {
+        for (size_t arity = 2; arity <= 8; arity *= 2) {
+            adts_heap_t        *p_heap = NULL;
+            adts_heap_create_t  op     = {0};
+            uint64_t            seed   = 0x2545f4914f6cdd1dULL;
+            uint64_t            start  = 0;
+            uint64_t            push   = 0;
+            uint64_t            pop    = 0;
+            int64_t             prev   = INT64_MIN;
+
+            op.type  = ADTS_HEAP_MIN;
+            op.arity = arity;
+            p_heap   = adts_heap_create_ext(&(op));
+            assert(p_heap);
+
+            start = adts_tstamp();
+            for (size_t idx = 0; idx < elems; idx++) {
+                int64_t key = (int64_t) (utest_heap_rand(&(seed)) >> 1);
+
+                (void) adts_heap_push(p_heap, &(p_node[idx]), p_node, 1, key);
+            }
+            push = adts_tstamp() - start;
+
+            start = adts_tstamp();
+            for (size_t idx = 0; idx < elems; idx++) {
+                heap_node_t *p_pop = (heap_node_t *) adts_heap_pop(p_heap);
+
+                assert(prev <= p_pop->key);
+                prev = p_pop->key;
+            }
+            pop = adts_tstamp() - start;
+
+            CDISPLAY("elems: %10zu  arity: %2zu  push: %8.2fns  pop: %8.2fns",
+                     elems, arity,
+                     (double) push / (double) elems,
+                     (double) pop  / (double) elems);
+
+            adts_heap_destroy(p_heap);
+        }
+    }
+
+    free(p_node);
+
+    return;
+} /* utest_heap_rate() */
+
+
 /*
  ****************************************************************************
  * test control
@@ -742,6 +1905,13 @@ utest_control( void )
         (void) adts_heap_destroy(p_heap);
     }
 
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: heap footprint");
+
+        utest_heap_footprint();
+    }
+
     return;
 } /* utest_control() */
 
@@ -757,6 +1927,12 @@ void
 utest_adts_heap( void )
 {
     utest_control();
+    utest_heap_order();
+    utest_heap_handles();
+    utest_heap_build();
+    utest_heap_resize_cost();
+    utest_heap_rate();
+    utest_heap_build_rate();
 
     return;
 } /* utest_adts_heap() */
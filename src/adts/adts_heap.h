@@ -3,15 +3,20 @@
 #include <string.h>
 #include <stdbool.h>
 #include <inttypes.h>
+#include <adts_memory.h>
 
 
 /**
  **************************************************************************
  * \details
+ *   Array based d-ary heap of consumer owned nodes.  Keys are held inline
+ *   in the workspace alongside the node pointer, thus sifting does not
+ *   touch consumer nodes.  The default arity of 4 places every sibling
+ *   group within one cacheline.
  *
  **************************************************************************
  */
-#define ADTS_HEAP_BYTES      (64)
+#define ADTS_HEAP_BYTES      (128)
 #define ADTS_HEAP_NODE_BYTES (32)
 
 
@@ -27,7 +32,14 @@ typedef enum {
 } adts_heap_type_t;
 
 typedef struct {
-    const char reserved[ ADTS_HEAP_NODE_BYTES ];
+    void    *p_data;
+    size_t   bytes;
+    int64_t  key;
+} adts_heap_node_public_t;
+
+typedef union {
+    const char                    reserved[ ADTS_HEAP_NODE_BYTES ];
+    const adts_heap_node_public_t pub; /**< read only */
 } adts_heap_node_t;
 
 typedef struct {
@@ -35,6 +47,41 @@ typedef struct {
 } adts_heap_t;
 
 
+/**
+ **************************************************************************
+ * \details
+ *   heap create options, arity is a power of two from 2 to 16, 0 selects
+ *   the default of 4.  EINVAL otherwise.
+ *
+ **************************************************************************
+ */
+typedef struct {
+    adts_heap_type_t        type;        /**< min or max heap */
+    size_t                  arity;       /**< children per node */
+    const adts_allocator_t *p_allocator; /**< NULL selects the default */
+} adts_heap_create_t;
+
+
+/**
+ **************************************************************************
+ * \details
+ *   Bulk build input.  Entry i is node p_nodes[i] with key p_keys[i] and
+ *   data pp_data[i], every entry carries the same data bytes.  threads
+ *   of 0 or 1 builds in the caller, otherwise wide levels are split
+ *   across up to 64 threads including the caller.
+ *
+ **************************************************************************
+ */
+typedef struct {
+    adts_heap_node_t *p_nodes;
+    const int64_t    *p_keys;
+    void * const     *pp_data;
+    size_t            bytes;
+    size_t            elems;
+    uint32_t          threads;
+} adts_heap_build_t;
+
+
 /**
  **************************************************************************
  * \details
@@ -50,6 +97,10 @@ adts_heap_is_not_empty( adts_heap_t *p_adts_heap );
 size_t
 adts_heap_entries( adts_heap_t *p_adts_heap );
 
+void
+adts_heap_mem_usage( adts_heap_t      *p_adts_heap,
+                     adts_mem_stats_t *p_out );
+
 void
 adts_heap_display( adts_heap_t *p_adts_heap );
 
@@ -59,18 +110,66 @@ adts_heap_peek( adts_heap_t *p_adts_heap );
 adts_heap_node_t *
 adts_heap_pop( adts_heap_t *p_adts_heap );
 
+
+/**
+ **************************************************************************
+ * \details
+ *   Handle based services.  A node records its position while it is a
+ *   member of the heap, thus both are O(log n).  EINVAL when the node is
+ *   not a member, e.g. already popped or removed.
+ *   - adts_heap_update_key()  increase or decrease the key
+ *   - adts_heap_remove()      remove from any position
+ *
+ **************************************************************************
+ */
+int32_t
+adts_heap_update_key( adts_heap_t      *p_adts_heap,
+                      adts_heap_node_t *p_adts_node_heap,
+                      int64_t           key );
+
+int32_t
+adts_heap_remove( adts_heap_t      *p_adts_heap,
+                  adts_heap_node_t *p_adts_node_heap );
+
 int32_t
 adts_heap_push( adts_heap_t       *p_adts_heap,
                 adts_heap_node_t  *p_adts_node_heap,
                 void              *p_data,
                 size_t             bytes,
                 int64_t            key );
+
+
+/**
+ **************************************************************************
+ * \details
+ *   Bulk insert of elems nodes in O(entries) rather than O(n log n), the
+ *   workspace is resized at most once.  Existing members are retained.
+ *   ENOMEM when the workspace cannot hold the result, in which case the
+ *   heap is unchanged.
+ *
+ **************************************************************************
+ */
+int32_t
+adts_heap_build( adts_heap_t      *p_adts_heap,
+                 adts_heap_node_t *p_nodes,
+                 const int64_t    *p_keys,
+                 void * const     *pp_data,
+                 size_t            bytes,
+                 size_t            elems );
+
+int32_t
+adts_heap_build_ext( adts_heap_t             *p_adts_heap,
+                     const adts_heap_build_t *p_op );
+
 void
 adts_heap_destroy( adts_heap_t *p_adts_heap );
 
 adts_heap_t *
 adts_heap_create( adts_heap_type_t type );
 
+adts_heap_t *
+adts_heap_create_ext( const adts_heap_create_t *p_op );
+
 void
 utest_adts_heap( void );
 
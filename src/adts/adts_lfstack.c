@@ -0,0 +1,715 @@
+#include <sched.h>
+#include <errno.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <inttypes.h>
+
+/* Toolbox */
+#include <adts_time.h>
+#include <adts_stack.h>
+#include <adts_memory.h>
+#include <adts_lfstack.h>
+#include <adts_private.h>
+#include <adts_display.h>
+
+
+/******************************************************************************
+ #####  ####### ######  #     #  #####  ####### #     # ######  #######  #####
+#     #    #    #     # #     # #     #    #    #     # #     # #       #     #
+#          #    #     # #     # #          #    #     # #     # #       #
+ #####     #    ######  #     # #          #    #     # ######  #####    #####
+      #    #    #   #   #     # #          #    #     # #   #   #             #
+#     #    #    #    #  #     # #     #    #    #     # #    #  #       #     #
+ #####     #    #     #  #####   #####     #     #####  #     # #######  #####
+******************************************************************************/
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+typedef struct lfstack_node_s {
+    /**< public data  - consumer visible */
+    adts_lfstack_node_public_t  pub;
+
+    /**< private data */
+    struct lfstack_node_s      *p_next;
+} lfstack_node_t;
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Top of stack.  The tag counts successful updates, it wraps only
+ *   after 2^64 operations.  word overlays the pair for the double width
+ *   compare and swap, thus the pair is 16 byte aligned.
+ *
+ ****************************************************************************
+ */
+typedef union {
+    struct {
+        lfstack_node_t *p_top;
+        uint64_t        tag;
+    };
+    unsigned __int128 word;
+} __attribute__((aligned(16))) lfstack_head_t;
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+typedef struct {
+    lfstack_head_t head ADTS_CACHELINE_ALIGN;
+    adts_mem_t     mem  ADTS_CACHELINE_ALIGN;
+} lfstack_t;
+
+
+/******************************************************************************
+ * ####### #     # #     #  #####  #######   ###   ####### #     #  #####
+ * #       #     # ##    # #     #    #       #    #     # ##    # #     #
+ * #       #     # # #   # #          #       #    #     # # #   # #
+ * #####   #     # #  #  # #          #       #    #     # #  #  #  #####
+ * #       #     # #   # # #          #       #    #     # #   # #       #
+ * #       #     # #    ## #     #    #       #    #     # #    ## #     #
+ * #        #####  #     #  #####     #      ###   ####### #     #  #####
+******************************************************************************/
+
+/*
+ ****************************************************************************
+ * \details
+ *   Snapshot of the top of stack.  The halves are read separately, a
+ *   torn pair simply fails the following compare and swap.
+ *
+ ****************************************************************************
+ */
+static inline lfstack_head_t
+lfstack_head_load( lfstack_head_t *p_head )
+{
+    lfstack_head_t head;
+
+    head.tag   = __atomic_load_n(&(p_head->tag), __ATOMIC_ACQUIRE);
+    head.p_top = __atomic_load_n(&(p_head->p_top), __ATOMIC_ACQUIRE);
+
+    return head;
+} /* lfstack_head_load() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Double width compare and swap, full barrier.  On failure p_expect is
+ *   refreshed with the current top of stack.
+ *
+ *   cmpxchg16b is issued inline on x86_64, thus neither -mcx16 nor
+ *   libatomic is required there.  Elsewhere the compiler builtin is used.
+ *
+ ****************************************************************************
+ */
+static inline bool
+lfstack_head_cas( lfstack_head_t *p_head,
+                  lfstack_head_t *p_expect,
+                  lfstack_head_t  desired )
+{
+#if defined(__x86_64__)
+    bool swapped = false;
+
+    __asm__ __volatile__("lock cmpxchg16b %1\n\t"
+                         "setz %0"
+                         : "=q" (swapped),
+                           "+m" (p_head->word),
+                           "+a" (p_expect->p_top),
+                           "+d" (p_expect->tag)
+                         : "b" (desired.p_top),
+                           "c" (desired.tag)
+                         : "memory", "cc");
+
+    return swapped;
+#else
+    return __atomic_compare_exchange_n(&(p_head->word),
+                                       &(p_expect->word),
+                                       desired.word,
+                                       false,
+                                       __ATOMIC_ACQ_REL,
+                                       __ATOMIC_ACQUIRE);
+#endif
+} /* lfstack_head_cas() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_lfstack_push( adts_lfstack_t      *p_adts_lfstack,
+                   adts_lfstack_node_t *p_adts_node,
+                   void                *p_data,
+                   size_t               bytes )
+{
+    lfstack_t      *p_lfstack = (lfstack_t *) p_adts_lfstack;
+    lfstack_node_t *p_node    = (lfstack_node_t *) p_adts_node;
+    lfstack_head_t  head      = lfstack_head_load(&(p_lfstack->head));
+    lfstack_head_t  next;
+
+    p_node->pub.p_data = p_data;
+    p_node->pub.bytes  = bytes;
+
+    do {
+        p_node->p_next = head.p_top;
+        next.p_top     = p_node;
+        next.tag       = head.tag + 1;
+    } while (!lfstack_head_cas(&(p_lfstack->head), &(head), next));
+
+    return;
+} /* adts_lfstack_push() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   The link of the snapshot top is read before the swap.  Should that
+ *   node be popped and reused meanwhile the link may be stale, however
+ *   the tag has then moved on and the swap fails.
+ *
+ ****************************************************************************
+ */
+adts_lfstack_node_t *
+adts_lfstack_pop( adts_lfstack_t *p_adts_lfstack )
+{
+    lfstack_t      *p_lfstack = (lfstack_t *) p_adts_lfstack;
+    lfstack_head_t  head      = lfstack_head_load(&(p_lfstack->head));
+    lfstack_head_t  next;
+
+    while (head.p_top) {
+        next.p_top = __atomic_load_n(&(head.p_top->p_next), __ATOMIC_RELAXED);
+        next.tag   = head.tag + 1;
+
+        if (lfstack_head_cas(&(p_lfstack->head), &(head), next)) {
+            break;
+        }
+    }
+
+    return (adts_lfstack_node_t *) head.p_top;
+} /* adts_lfstack_pop() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   The detached chain is private to the caller, thus it is counted
+ *   after the swap.
+ *
+ ****************************************************************************
+ */
+adts_lfstack_node_t *
+adts_lfstack_pop_all( adts_lfstack_t *p_adts_lfstack,
+                      size_t         *p_count )
+{
+    size_t          count     = 0;
+    lfstack_t      *p_lfstack = (lfstack_t *) p_adts_lfstack;
+    lfstack_head_t  head      = lfstack_head_load(&(p_lfstack->head));
+    lfstack_head_t  next;
+
+    while (head.p_top) {
+        next.p_top = NULL;
+        next.tag   = head.tag + 1;
+
+        if (lfstack_head_cas(&(p_lfstack->head), &(head), next)) {
+            break;
+        }
+    }
+
+    if (p_count) {
+        for (lfstack_node_t *p_node = head.p_top; p_node; p_node = p_node->p_next) {
+            count++;
+        }
+        *p_count = count;
+    }
+
+    return (adts_lfstack_node_t *) head.p_top;
+} /* adts_lfstack_pop_all() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+adts_lfstack_node_t *
+adts_lfstack_next( adts_lfstack_node_t *p_adts_node )
+{
+    lfstack_node_t *p_node = (lfstack_node_t *) p_adts_node;
+
+    return (adts_lfstack_node_t *) p_node->p_next;
+} /* adts_lfstack_next() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   A snapshot, a concurrent push / pop may change it immediately.
+ *
+ ****************************************************************************
+ */
+bool
+adts_lfstack_is_empty( adts_lfstack_t *p_adts_lfstack )
+{
+    lfstack_t *p_lfstack = (lfstack_t *) p_adts_lfstack;
+
+    return (NULL == __atomic_load_n(&(p_lfstack->head.p_top),
+                                    __ATOMIC_ACQUIRE));
+} /* adts_lfstack_is_empty() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_lfstack_mem_usage( adts_lfstack_t   *p_adts_lfstack,
+                        adts_mem_stats_t *p_out )
+{
+    lfstack_t *p_lfstack = (lfstack_t *) p_adts_lfstack;
+
+    adts_mem_usage(&(p_lfstack->mem), p_out);
+
+    return;
+} /* adts_lfstack_mem_usage() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   All threads must have quiesced.  Nodes still stacked belong to the
+ *   consumer and are left untouched.
+ *
+ ****************************************************************************
+ */
+void
+adts_lfstack_destroy( adts_lfstack_t *p_adts_lfstack )
+{
+    lfstack_t  *p_lfstack = (lfstack_t *) p_adts_lfstack;
+    adts_mem_t  mem       = p_lfstack->mem;
+
+    adts_mem_put(&(mem), p_adts_lfstack, sizeof(*p_adts_lfstack));
+
+    return;
+} /* adts_lfstack_destroy() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+adts_lfstack_t *
+adts_lfstack_create( void )
+{
+    return adts_lfstack_create_ext(NULL);
+} /* adts_lfstack_create() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   The double width swap faults on a misaligned pair, thus a consumer
+ *   allocator must return at least 16 byte aligned memory.
+ *
+ ****************************************************************************
+ */
+adts_lfstack_t *
+adts_lfstack_create_ext( const adts_allocator_t *p_allocator )
+{
+    adts_mem_t      mem            = {0};
+    adts_lfstack_t *p_adts_lfstack = NULL;
+    lfstack_t      *p_lfstack      = NULL;
+
+    adts_mem_init_ext(&(mem), ADTS_MEM_TYPE_LFSTACK, p_allocator);
+
+    p_adts_lfstack = adts_mem_get(&(mem), sizeof(*p_adts_lfstack));
+    if (NULL == p_adts_lfstack) {
+        goto exception;
+    }
+
+    if ((uintptr_t) p_adts_lfstack & (sizeof(lfstack_head_t) - 1)) {
+        adts_mem_put(&(mem), p_adts_lfstack, sizeof(*p_adts_lfstack));
+        p_adts_lfstack = NULL;
+        goto exception;
+    }
+
+    p_lfstack      = (lfstack_t *) p_adts_lfstack;
+    p_lfstack->mem = mem;
+
+exception:
+    return p_adts_lfstack;
+} /* adts_lfstack_create_ext() */
+
+
+
+/******************************************************************************
+ * #     # #     #   ###   ####### ####### #######  #####  #######  #####
+ * #     # ##    #    #       #       #    #       #     #    #    #     #
+ * #     # # #   #    #       #       #    #       #          #    #
+ * #     # #  #  #    #       #       #    #####    #####     #     #####
+ * #     # #   # #    #       #       #    #             #    #          #
+ * #     # #    ##    #       #       #    #       #     #    #    #     #
+ *  #####  #     #   ###      #       #    #######  #####     #     #####
+******************************************************************************/
+
+/**
+ **************************************************************************
+ * \brief
+ *   Compile time structure sanity
+ *
+ * \details
+ *   Sanitize the abstract data type interface.  Enforced in header file so
+ *   as to catch improper usage/include by unauthorized callers.
+ *
+ **************************************************************************
+ */
+static void
+utest_lfstack_bytes( void )
+{
+    CDISPLAY("[%u]", sizeof(lfstack_t));
+    CDISPLAY("[%u]", sizeof(adts_lfstack_t));
+    CDISPLAY("[%u]", sizeof(lfstack_node_t));
+    CDISPLAY("[%u]", sizeof(adts_lfstack_node_t));
+
+    _Static_assert(sizeof(lfstack_t) <= sizeof(adts_lfstack_t),
+        "Mismatch structs detected");
+    _Static_assert(sizeof(lfstack_node_t) <= sizeof(adts_lfstack_node_t),
+        "Mismatch structs detected");
+    _Static_assert(16 == sizeof(lfstack_head_t),
+        "Mismatch structs detected");
+
+    return;
+} /* utest_lfstack_bytes() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Shared free list benchmark.  Every thread repeatedly takes a buffer
+ *   and returns it, which is the access pattern of a buffer pool.  The
+ *   baseline is adts_stack behind a mutex.
+ *
+ ****************************************************************************
+ */
+#ifndef UTEST_LFSTACK_OPS
+#define UTEST_LFSTACK_OPS (1 << 21)
+#endif
+
+#ifndef UTEST_LFSTACK_THREADS_MAX
+#define UTEST_LFSTACK_THREADS_MAX (8)
+#endif
+
+#ifndef UTEST_LFSTACK_BUFFERS
+#define UTEST_LFSTACK_BUFFERS (256)
+#endif
+
+typedef struct {
+    size_t              owner;
+    size_t              uses;
+    adts_lfstack_node_t node;
+} utest_lfstack_buf_t;
+
+typedef struct {
+    adts_lfstack_t  *p_lfstack;
+    adts_stack_t    *p_stack;
+    pthread_mutex_t *p_lock;
+    size_t           ops;
+    size_t           id;
+    size_t           empty;
+} utest_lfstack_ctx_t;
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   owner is claimed on pop and released before the push, a buffer held
+ *   by two threads at once trips the assert.
+ *
+ ****************************************************************************
+ */
+static void *
+utest_lfstack_worker( void *p_arg )
+{
+    utest_lfstack_ctx_t *p_ctx  = p_arg;
+    utest_lfstack_buf_t *p_buf  = NULL;
+    adts_lfstack_node_t *p_node = NULL;
+
+    for (size_t idx = 0; idx < p_ctx->ops; idx++) {
+        p_node = adts_lfstack_pop(p_ctx->p_lfstack);
+        if (NULL == p_node) {
+            p_ctx->empty++;
+            sched_yield();
+            continue;
+        }
+
+        p_buf = p_node->pub.p_data;
+        assert(0 == p_buf->owner);
+        p_buf->owner = p_ctx->id;
+        p_buf->uses++;
+        p_buf->owner = 0;
+
+        adts_lfstack_push(p_ctx->p_lfstack, p_node, p_buf, sizeof(*p_buf));
+    }
+
+    return NULL;
+} /* utest_lfstack_worker() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+static void *
+utest_lfstack_mutex_worker( void *p_arg )
+{
+    utest_lfstack_ctx_t *p_ctx = p_arg;
+    utest_lfstack_buf_t *p_buf = NULL;
+
+    for (size_t idx = 0; idx < p_ctx->ops; idx++) {
+        pthread_mutex_lock(p_ctx->p_lock);
+        p_buf = adts_stack_pop(p_ctx->p_stack);
+        pthread_mutex_unlock(p_ctx->p_lock);
+
+        if (NULL == p_buf) {
+            p_ctx->empty++;
+            sched_yield();
+            continue;
+        }
+
+        assert(0 == p_buf->owner);
+        p_buf->owner = p_ctx->id;
+        p_buf->uses++;
+        p_buf->owner = 0;
+
+        pthread_mutex_lock(p_ctx->p_lock);
+        (void) adts_stack_push(p_ctx->p_stack, p_buf, sizeof(*p_buf));
+        pthread_mutex_unlock(p_ctx->p_lock);
+    }
+
+    return NULL;
+} /* utest_lfstack_mutex_worker() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Run one configuration and return ns per take / return pair.  Every
+ *   buffer must be back on the stack, exactly once, afterwards.
+ *
+ ****************************************************************************
+ */
+static double
+utest_lfstack_rate( size_t threads,
+                    bool   lockfree )
+{
+    int32_t              rc        = 0;
+    size_t               per       = UTEST_LFSTACK_OPS / threads;
+    size_t               uses      = 0;
+    size_t               count     = 0;
+    uint64_t             start     = 0;
+    uint64_t             delta     = 0;
+    adts_lfstack_t      *p_lfstack = NULL;
+    adts_stack_t        *p_stack   = NULL;
+    adts_lfstack_node_t *p_node    = NULL;
+    utest_lfstack_buf_t *p_bufs    = NULL;
+    pthread_mutex_t      lock      = PTHREAD_MUTEX_INITIALIZER;
+    pthread_t            tids[ UTEST_LFSTACK_THREADS_MAX ];
+    utest_lfstack_ctx_t  ctx[ UTEST_LFSTACK_THREADS_MAX ];
+
+    p_lfstack = adts_lfstack_create();
+    p_stack   = adts_stack_create();
+    p_bufs    = calloc(UTEST_LFSTACK_BUFFERS, sizeof(*p_bufs));
+    assert(p_lfstack && p_stack && p_bufs);
+
+    for (size_t idx = 0; idx < UTEST_LFSTACK_BUFFERS; idx++) {
+        utest_lfstack_buf_t *p_buf = &(p_bufs[idx]);
+
+        if (lockfree) {
+            adts_lfstack_push(p_lfstack, &(p_buf->node), p_buf, sizeof(*p_buf));
+        }else {
+            rc = adts_stack_push(p_stack, p_buf, sizeof(*p_buf));
+            assert(0 == rc);
+        }
+    }
+
+    start = adts_tstamp();
+    for (size_t idx = 0; idx < threads; idx++) {
+        memset(&(ctx[idx]), 0, sizeof(ctx[idx]));
+        ctx[idx].p_lfstack = p_lfstack;
+        ctx[idx].p_stack   = p_stack;
+        ctx[idx].p_lock    = &(lock);
+        ctx[idx].ops       = per;
+        ctx[idx].id        = idx + 1;
+
+        rc = pthread_create(&(tids[idx]), NULL,
+                            lockfree ? utest_lfstack_worker : utest_lfstack_mutex_worker,
+                            &(ctx[idx]));
+        assert(0 == rc);
+    }
+    for (size_t idx = 0; idx < threads; idx++) {
+        (void) pthread_join(tids[idx], NULL);
+        uses += per - ctx[idx].empty;
+    }
+    delta = adts_tstamp() - start;
+
+    for (size_t idx = 0; idx < UTEST_LFSTACK_BUFFERS; idx++) {
+        uses -= p_bufs[idx].uses;
+        p_bufs[idx].uses = 0;
+    }
+    assert(0 == uses);
+
+    if (lockfree) {
+        p_node = adts_lfstack_pop_all(p_lfstack, &(count));
+        for (; p_node; p_node = adts_lfstack_next(p_node)) {
+            utest_lfstack_buf_t *p_buf = p_node->pub.p_data;
+
+            assert(0 == p_buf->uses);
+            p_buf->uses = 1;
+        }
+        assert(adts_lfstack_is_empty(p_lfstack));
+    }else {
+        count = adts_stack_entries(p_stack);
+    }
+    assert(UTEST_LFSTACK_BUFFERS == count);
+
+    free(p_bufs);
+    adts_stack_destroy(p_stack);
+    adts_lfstack_destroy(p_lfstack);
+
+    return (double) delta / (double) (per * threads);
+} /* utest_lfstack_rate() */
+
+
+/*
+ ****************************************************************************
+ * test control
+ *
+ ****************************************************************************
+ */
+static void
+utest_control( void )
+{
+    utest_lfstack_bytes();
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: single thread push / pop / pop_all");
+
+        size_t               count     = 0;
+        adts_lfstack_t      *p_lfstack = NULL;
+        adts_lfstack_node_t *p_node    = NULL;
+        adts_lfstack_node_t  nodes[ 8 ];
+
+        p_lfstack = adts_lfstack_create();
+        assert(p_lfstack);
+        assert(adts_lfstack_is_empty(p_lfstack));
+        assert(NULL == adts_lfstack_pop(p_lfstack));
+        assert(NULL == adts_lfstack_pop_all(p_lfstack, &(count)));
+        assert(0 == count);
+
+        for (size_t idx = 0; idx < 8; idx++) {
+            adts_lfstack_push(p_lfstack, &(nodes[idx]), (void *) (idx + 1), idx);
+        }
+        for (size_t idx = 8; idx > 5; idx--) {
+            p_node = adts_lfstack_pop(p_lfstack);
+            assert(&(nodes[idx - 1]) == p_node);
+            assert((void *) idx == p_node->pub.p_data);
+            assert((idx - 1) == p_node->pub.bytes);
+        }
+
+        /* newest first */
+        p_node = adts_lfstack_pop_all(p_lfstack, &(count));
+        assert(5 == count);
+        for (size_t idx = 5; idx > 0; idx--) {
+            assert(&(nodes[idx - 1]) == p_node);
+            p_node = adts_lfstack_next(p_node);
+        }
+        assert(NULL == p_node);
+        assert(adts_lfstack_is_empty(p_lfstack));
+        assert(NULL == adts_lfstack_pop(p_lfstack));
+
+        adts_lfstack_destroy(p_lfstack);
+    }
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: ABA, stale top of stack is rejected");
+
+        lfstack_t            *p_lfstack = NULL;
+        adts_lfstack_t       *p_adts    = NULL;
+        lfstack_head_t        stale;
+        lfstack_head_t        next;
+        adts_lfstack_node_t   nodes[ 3 ];
+
+        p_adts    = adts_lfstack_create();
+        p_lfstack = (lfstack_t *) p_adts;
+        assert(p_adts);
+
+        for (size_t idx = 0; idx < 3; idx++) {
+            adts_lfstack_push(p_adts, &(nodes[idx]), NULL, 0);
+        }
+
+        /*
+         * A preempted pop snapshots { C, tag } and the link C -> B.  Others
+         * then pop C and B and push C back.  C is the top again, but the
+         * stale pop would install the taken B as the top.
+         */
+        stale      = lfstack_head_load(&(p_lfstack->head));
+        next.p_top = ((lfstack_node_t *) stale.p_top)->p_next;
+        next.tag   = stale.tag + 1;
+        assert(&(nodes[2]) == (adts_lfstack_node_t *) stale.p_top);
+
+        assert(&(nodes[2]) == adts_lfstack_pop(p_adts));
+        assert(&(nodes[1]) == adts_lfstack_pop(p_adts));
+        adts_lfstack_push(p_adts, &(nodes[2]), NULL, 0);
+
+        assert(false == lfstack_head_cas(&(p_lfstack->head), &(stale), next));
+        assert(&(nodes[2]) == (adts_lfstack_node_t *) stale.p_top);
+        assert(&(nodes[2]) == adts_lfstack_pop(p_adts));
+        assert(&(nodes[0]) == adts_lfstack_pop(p_adts));
+        assert(NULL == adts_lfstack_pop(p_adts));
+
+        adts_lfstack_destroy(p_adts);
+    }
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: shared free list, lock-free vs mutex adts_stack");
+
+        for (size_t threads = 1; threads <= UTEST_LFSTACK_THREADS_MAX; threads <<= 1) {
+            double lockfree = utest_lfstack_rate(threads, true);
+            double mutex    = utest_lfstack_rate(threads, false);
+
+            CDISPLAY("threads: %2zu  ns/op lfstack: %7.2f  mutex: %7.2f  speedup: %5.2fx",
+                     threads, lockfree, mutex, mutex / (lockfree ? lockfree : 1));
+        }
+    }
+
+    return;
+} /* utest_control() */
+
+
+/*
+ ****************************************************************************
+ * test entrypoint
+ *
+ ****************************************************************************
+ */
+void
+utest_adts_lfstack( void )
+{
+    utest_control();
+
+    return;
+} /* utest_adts_lfstack() */
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <adts_memory.h>
+
+
+/******************************************************************************
+ #####  ####### ######  #     #  #####  ####### #     # ######  #######  #####
+#     #    #    #     # #     # #     #    #    #     # #     # #       #     #
+#          #    #     # #     # #          #    #     # #     # #       #
+ #####     #    ######  #     # #          #    #     # ######  #####    #####
+      #    #    #   #   #     # #          #    #     # #   #   #             #
+#     #    #    #    #  #     # #     #    #    #     # #    #  #       #     #
+ #####     #    #     #  #####   #####     #     #####  #     # #######  #####
+******************************************************************************/
+
+/**
+ **************************************************************************
+ * \details
+ *   Unbounded intrusive lock-free LIFO (Treiber stack).  The consumer
+ *   embeds an adts_lfstack_node_t in its own structure, thus a push never
+ *   allocates.  Any number of threads may push and pop concurrently
+ *   without consumer provided locking, e.g. a free list of buffers shared
+ *   between threads.
+ *
+ *   The top of stack is a { pointer, tag } pair swapped with a single
+ *   128 bit compare and swap.  Every successful push / pop advances the
+ *   tag, thus a node popped and pushed back while another thread was
+ *   preempted mid pop is not mistaken for the unchanged top (ABA).
+ *
+ *   A pop reads the link of a node which another thread may have popped
+ *   concurrently, thus node memory must remain readable for the lifetime
+ *   of the stack.  Nodes may be reused at will, but not unmapped.
+ *
+ **************************************************************************
+ */
+#define ADTS_LFSTACK_BYTES      (128)
+#define ADTS_LFSTACK_NODE_BYTES (32)
+
+typedef struct {
+    const char reserved[ ADTS_LFSTACK_BYTES ];
+} adts_lfstack_t;
+
+typedef struct {
+    void   *p_data;
+    size_t  bytes;
+} adts_lfstack_node_public_t;
+
+typedef union {
+    const char                       reserved[ ADTS_LFSTACK_NODE_BYTES ];
+    const adts_lfstack_node_public_t pub; /**< read only */
+} adts_lfstack_node_t;
+
+
+
+/******************************************************************************
+ #####   #####    ####    #####   ####    #####   #   #  #####   ######   ####
+ #    #  #    #  #    #     #    #    #     #      # #   #    #  #       #
+ #    #  #    #  #    #     #    #    #     #       #    #    #  #####    ####
+ #####   #####   #    #     #    #    #     #       #    #####   #            #
+ #       #   #   #    #     #    #    #     #       #    #       #       #    #
+ #       #    #   ####      #     ####      #       #    #       ######   ####
+*******************************************************************************/
+
+/**
+ **************************************************************************
+ * \brief
+ *   Stack services, safe from any thread
+ *
+ * \details
+ *   - adts_lfstack_push()    the node is owned by the stack until popped
+ *   - adts_lfstack_pop()     newest node, NULL when empty
+ *   - adts_lfstack_pop_all() detach every node as one NULL terminated
+ *                            chain, newest first, walk with
+ *                            adts_lfstack_next()
+ *
+ **************************************************************************
+ */
+void
+adts_lfstack_push( adts_lfstack_t      *p_adts_lfstack,
+                   adts_lfstack_node_t *p_adts_node,
+                   void                *p_data,
+                   size_t               bytes );
+
+adts_lfstack_node_t *
+adts_lfstack_pop( adts_lfstack_t *p_adts_lfstack );
+
+adts_lfstack_node_t *
+adts_lfstack_pop_all( adts_lfstack_t *p_adts_lfstack,
+                      size_t         *p_count );
+
+adts_lfstack_node_t *
+adts_lfstack_next( adts_lfstack_node_t *p_adts_node );
+
+bool
+adts_lfstack_is_empty( adts_lfstack_t *p_adts_lfstack );
+
+void
+adts_lfstack_mem_usage( adts_lfstack_t   *p_adts_lfstack,
+                        adts_mem_stats_t *p_out );
+
+void
+adts_lfstack_destroy( adts_lfstack_t *p_adts_lfstack );
+
+adts_lfstack_t *
+adts_lfstack_create( void );
+
+adts_lfstack_t *
+adts_lfstack_create_ext( const adts_allocator_t *p_allocator );
+
+
+/**
+ **************************************************************************
+ * \details
+ *   Unit Test prototypes
+ *
+ **************************************************************************
+ */
+void
+utest_adts_lfstack( void );
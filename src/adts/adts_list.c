@@ -2,6 +2,7 @@
 
 #include <errno.h>
 #include <assert.h>
+#include <stdlib.h>
 #include <string.h>
 #include <limits.h>
 #include <stdbool.h>
@@ -9,6 +10,7 @@
 
 /* Toolbox */
 #include <adts_list.h>
+#include <adts_memory.h>
 #include <adts_sanity.h>
 #include <adts_private.h>
 #include <adts_display.h>
@@ -51,6 +53,7 @@ typedef struct list_s {
     list_node_t  *p_head;
     list_node_t  *p_tail;
     adts_sanity_t sanity;
+    adts_mem_t    mem;
 } list_t;
 
 typedef enum {
@@ -285,7 +288,7 @@ adts_list_is_invalid( adts_list_t *p_adts_list )
     adts_sanity_entry(p_sanity);
 
     elems  = p_list->elems_curr;
-    a_comp = calloc(elems, sizeof(int64_t));
+    a_comp = adts_mem_alloc(&(p_list->mem), elems * sizeof(int64_t));
     if (NULL == a_comp) {
         goto exception;
     }
@@ -310,9 +313,7 @@ adts_list_is_invalid( adts_list_t *p_adts_list )
     }
 
 exception:
-    if (a_comp) {
-        free(a_comp);
-    }
+    adts_mem_put(&(p_list->mem), a_comp, elems * sizeof(int64_t));
     adts_sanity_exit(p_sanity);
     return rc;
 } /* adts_list_is_invalid() */
@@ -358,6 +359,23 @@ adts_list_entries_max( adts_list_t *p_adts_list )
 } /* adts_list_entries_max() */
 
 
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_list_mem_usage( adts_list_t      *p_adts_list,
+                     adts_mem_stats_t *p_out )
+{
+    list_t *p_list = (list_t *) p_adts_list;
+
+    adts_mem_usage(&(p_list->mem), p_out);
+
+    return;
+} /* adts_list_mem_usage() */
+
+
 /*
  ****************************************************************************
  *
@@ -523,9 +541,10 @@ adts_list_remove_tail( adts_list_t *p_adts_list )
 void
 adts_list_destroy( adts_list_t *p_adts_list )
 {
-    list_t  *p_list = (list_t *) p_adts_list;
+    list_t     *p_list = (list_t *) p_adts_list;
+    adts_mem_t  mem    = p_list->mem;
 
-    free(p_list);
+    adts_mem_put(&(mem), p_list, sizeof(*p_adts_list));
 
     return;
 } /* adts_list_destroy() */
@@ -540,10 +559,38 @@ adts_list_destroy( adts_list_t *p_adts_list )
 adts_list_t *
 adts_list_create( void )
 {
-    return adts_mem_zalloc(sizeof(adts_list_t));
+    return adts_list_create_ext(NULL);
 } /* adts_list_create() */
 
 
+/*
+ ****************************************************************************
+ *
+ *
+ ****************************************************************************
+ */
+adts_list_t *
+adts_list_create_ext( const adts_allocator_t *p_allocator )
+{
+    list_t      *p_list      = NULL;
+    adts_mem_t   mem         = {0};
+    adts_list_t *p_adts_list = NULL;
+
+    adts_mem_init_ext(&(mem), ADTS_MEM_TYPE_LIST, p_allocator);
+
+    p_adts_list = adts_mem_get(&(mem), sizeof(*p_adts_list));
+    if (NULL == p_adts_list) {
+        goto exception;
+    }
+
+    p_list      = (list_t *) p_adts_list;
+    p_list->mem = mem;
+
+exception:
+    return p_adts_list;
+} /* adts_list_create_ext() */
+
+
 /******************************************************************************
  * #     # #     #   ###   ####### ####### #######  #####  #######  #####
  * #     # ##    #    #       #       #    #       #     #    #    #     #
@@ -630,6 +677,9 @@ utest_list_create( list_t *p_list )
     list_node_t *prev   = NULL;
     list_node_t *p_node = NULL;
 
+    /* Stack resident list, thus the memory context is set in place */
+    adts_mem_init(&(p_list->mem), ADTS_MEM_TYPE_LIST);
+
     /* Assign head */
     p_list->p_head = utest_list_create_nodes(elems, base);
 
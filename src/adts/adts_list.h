@@ -3,6 +3,7 @@
 #include <string.h>
 #include <stdbool.h>
 #include <inttypes.h>
+#include <adts_memory.h>
 
 /**
  **************************************************************************
@@ -10,7 +11,7 @@
  *
  **************************************************************************
  */
-#define ADTS_LIST_BYTES      (64)
+#define ADTS_LIST_BYTES      (128)
 #define ADTS_LIST_ELEM_BYTES (64)
 
 typedef struct {
@@ -41,6 +42,19 @@ adts_list_is_empty( adts_list_t *p_adts_list );
 bool
 adts_list_is_not_empty( adts_list_t *p_adts_list );
 
+void
+adts_list_mem_usage( adts_list_t      *p_adts_list,
+                     adts_mem_stats_t *p_out );
+
+void
+adts_list_destroy( adts_list_t *p_adts_list );
+
+adts_list_t *
+adts_list_create( void );
+
+adts_list_t *
+adts_list_create_ext( const adts_allocator_t *p_allocator );
+
 
 /**
  **************************************************************************
@@ -0,0 +1,724 @@
+#include <sched.h>
+#include <errno.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <inttypes.h>
+
+/* Toolbox */
+#include <adts_math.h>
+#include <adts_spsc.h>
+#include <adts_time.h>
+#include <adts_mcast.h>
+#include <adts_memory.h>
+#include <adts_private.h>
+#include <adts_display.h>
+
+
+/******************************************************************************
+ #####  ####### ######  #     #  #####  ####### #     # ######  #######  #####
+#     #    #    #     # #     # #     #    #    #     # #     # #       #     #
+#          #    #     # #     # #          #    #     # #     # #       #
+ #####     #    ######  #     # #          #    #     # ######  #####    #####
+      #    #    #   #   #     # #          #    #     # #   #   #             #
+#     #    #    #    #  #     # #     #    #    #     # #    #  #       #     #
+ #####     #    #     #  #####   #####     #     #####  #     # #######  #####
+******************************************************************************/
+
+/*
+ ****************************************************************************
+ * \details
+ *   Consumer cursor, one cache line per consumer.  head is the next
+ *   entry to release, tail_cache the last observed producer tail.
+ *
+ ****************************************************************************
+ */
+typedef struct {
+    size_t head;
+    size_t tail_cache;
+} ADTS_CACHELINE_ALIGN mcast_cursor_t;
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   The producer publishes with a release store of tail.  Consumers
+ *   release with a release store of their head, and the producer gates
+ *   on the minimum head, i.e. the largest lag, cached in gate until a
+ *   publish would overrun it.
+ *
+ ****************************************************************************
+ */
+typedef struct {
+    struct {
+        void           **p_slots;
+        size_t           slots;
+        size_t           mask;
+        mcast_cursor_t  *p_cursors;
+        size_t           consumers;
+        adts_mem_t       mem;
+    } ADTS_CACHELINE_ALIGN ring;
+
+    struct {
+        size_t             tail;
+        size_t             gate;
+        adts_mcast_stats_t stats;
+    } ADTS_CACHELINE_ALIGN prod;
+} mcast_t;
+
+
+/******************************************************************************
+ * ####### #     # #     #  #####  #######   ###   ####### #     #  #####
+ * #       #     # ##    # #     #    #       #    #     # ##    # #     #
+ * #       #     # # #   # #          #       #    #     # # #   # #
+ * #####   #     # #  #  # #          #       #    #     # #  #  #  #####
+ * #       #     # #   # # #          #       #    #     # #   # #       #
+ * #       #     # #    ## #     #    #       #    #     # #    ## #     #
+ * #        #####  #     #  #####     #      ###   ####### #     #  #####
+******************************************************************************/
+
+/*
+ ****************************************************************************
+ * \details
+ *   Slowest consumer position relative to tail.
+ *
+ ****************************************************************************
+ */
+static inline size_t
+mcast_gate( mcast_t *p_mcast,
+            size_t   tail )
+{
+    size_t lag = 0;
+
+    for (size_t idx = 0; idx < p_mcast->ring.consumers; idx++) {
+        size_t head = __atomic_load_n(&(p_mcast->ring.p_cursors[idx].head),
+                                      __ATOMIC_ACQUIRE);
+
+        lag = MAX(lag, tail - head);
+    }
+    p_mcast->prod.stats.gate_scans++;
+
+    return (tail - lag);
+} /* mcast_gate() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+size_t
+adts_mcast_publish_n( adts_mcast_t *p_adts_mcast,
+                      void *const  *pp_data,
+                      size_t        n )
+{
+    mcast_t *p_mcast = (mcast_t *) p_adts_mcast;
+    size_t   tail    = p_mcast->prod.tail;
+    size_t   avail   = p_mcast->ring.slots - (tail - p_mcast->prod.gate);
+
+    if (avail < n) {
+        p_mcast->prod.gate = mcast_gate(p_mcast, tail);
+        avail = p_mcast->ring.slots - (tail - p_mcast->prod.gate);
+        n     = MIN(n, avail);
+        if (0 == n) {
+            p_mcast->prod.stats.full++;
+            goto exception;
+        }
+    }
+
+    for (size_t idx = 0; idx < n; idx++) {
+        p_mcast->ring.p_slots[(tail + idx) & p_mcast->ring.mask] = pp_data[idx];
+    }
+
+    __atomic_store_n(&(p_mcast->prod.tail), tail + n, __ATOMIC_RELEASE);
+    p_mcast->prod.stats.published += n;
+
+exception:
+    return n;
+} /* adts_mcast_publish_n() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+int32_t
+adts_mcast_publish( adts_mcast_t *p_adts_mcast,
+                    void         *p_data )
+{
+    int32_t rc = 0;
+
+    if (unlikely(0 == adts_mcast_publish_n(p_adts_mcast, &(p_data), 1))) {
+        rc = EAGAIN;
+    }
+
+    return rc;
+} /* adts_mcast_publish() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+size_t
+adts_mcast_claim( adts_mcast_t  *p_adts_mcast,
+                  size_t         id,
+                  size_t         max,
+                  void *const  **ppp_data )
+{
+    mcast_t        *p_mcast  = (mcast_t *) p_adts_mcast;
+    mcast_cursor_t *p_cursor = NULL;
+    size_t          head     = 0;
+    size_t          idx      = 0;
+    size_t          n        = 0;
+
+    assert(id < p_mcast->ring.consumers);
+    p_cursor = &(p_mcast->ring.p_cursors[id]);
+    head     = p_cursor->head;
+
+    n = p_cursor->tail_cache - head;
+    if (n < max) {
+        p_cursor->tail_cache = __atomic_load_n(&(p_mcast->prod.tail),
+                                               __ATOMIC_ACQUIRE);
+        n = p_cursor->tail_cache - head;
+    }
+
+    /* contiguous run only */
+    idx = head & p_mcast->ring.mask;
+    n   = MIN(n, max);
+    n   = MIN(n, p_mcast->ring.slots - idx);
+
+    *ppp_data = &(p_mcast->ring.p_slots[idx]);
+
+    return n;
+} /* adts_mcast_claim() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_mcast_release( adts_mcast_t *p_adts_mcast,
+                    size_t        id,
+                    size_t        n )
+{
+    mcast_t        *p_mcast  = (mcast_t *) p_adts_mcast;
+    mcast_cursor_t *p_cursor = NULL;
+
+    assert(id < p_mcast->ring.consumers);
+    p_cursor = &(p_mcast->ring.p_cursors[id]);
+    assert(n <= (p_cursor->tail_cache - p_cursor->head));
+
+    __atomic_store_n(&(p_cursor->head), p_cursor->head + n, __ATOMIC_RELEASE);
+
+    return;
+} /* adts_mcast_release() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+int32_t
+adts_mcast_consume( adts_mcast_t  *p_adts_mcast,
+                    size_t         id,
+                    void         **pp_data )
+{
+    int32_t      rc       = 0;
+    void *const *pp_slots = NULL;
+
+    if (unlikely(0 == adts_mcast_claim(p_adts_mcast, id, 1, &(pp_slots)))) {
+        rc = EAGAIN;
+        goto exception;
+    }
+
+    *pp_data = pp_slots[0];
+    adts_mcast_release(p_adts_mcast, id, 1);
+
+exception:
+    return rc;
+} /* adts_mcast_consume() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+size_t
+adts_mcast_lag( adts_mcast_t *p_adts_mcast,
+                size_t        id )
+{
+    mcast_t *p_mcast = (mcast_t *) p_adts_mcast;
+    size_t   head    = 0;
+    size_t   tail    = 0;
+
+    assert(id < p_mcast->ring.consumers);
+    head = __atomic_load_n(&(p_mcast->ring.p_cursors[id].head),
+                           __ATOMIC_ACQUIRE);
+    tail = __atomic_load_n(&(p_mcast->prod.tail), __ATOMIC_ACQUIRE);
+
+    return (tail - head);
+} /* adts_mcast_lag() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+size_t
+adts_mcast_capacity( adts_mcast_t *p_adts_mcast )
+{
+    mcast_t *p_mcast = (mcast_t *) p_adts_mcast;
+
+    return p_mcast->ring.slots;
+} /* adts_mcast_capacity() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Producer counters, exact once the producer has quiesced.
+ *
+ ****************************************************************************
+ */
+void
+adts_mcast_stats( adts_mcast_t       *p_adts_mcast,
+                  adts_mcast_stats_t *p_out )
+{
+    mcast_t *p_mcast = (mcast_t *) p_adts_mcast;
+
+    *p_out = p_mcast->prod.stats;
+
+    return;
+} /* adts_mcast_stats() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_mcast_mem_usage( adts_mcast_t     *p_adts_mcast,
+                      adts_mem_stats_t *p_out )
+{
+    mcast_t *p_mcast = (mcast_t *) p_adts_mcast;
+
+    adts_mem_usage(&(p_mcast->ring.mem), p_out);
+
+    return;
+} /* adts_mcast_mem_usage() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   All threads must have quiesced.  Consumer data is not owned by the
+ *   ring.
+ *
+ ****************************************************************************
+ */
+void
+adts_mcast_destroy( adts_mcast_t *p_adts_mcast )
+{
+    mcast_t    *p_mcast = (mcast_t *) p_adts_mcast;
+    adts_mem_t  mem     = p_mcast->ring.mem;
+
+    adts_mem_put_aligned(&(mem), p_mcast->ring.p_cursors,
+                         p_mcast->ring.consumers * sizeof(mcast_cursor_t));
+    adts_mem_put(&(mem), p_mcast->ring.p_slots,
+                 p_mcast->ring.slots * sizeof(void *));
+    adts_mem_put_aligned(&(mem), p_adts_mcast, sizeof(*p_adts_mcast));
+
+    return;
+} /* adts_mcast_destroy() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+adts_mcast_t *
+adts_mcast_create( const adts_mcast_create_t *p_op )
+{
+    int32_t       rc           = 0;
+    size_t        slots        = 0;
+    mcast_t      *p_mcast      = NULL;
+    adts_mem_t    mem          = {0};
+    adts_mcast_t *p_adts_mcast = NULL;
+
+    assert(p_op);
+    if ((0 == p_op->elems) || (p_op->elems > (UINT32_MAX >> 1)) ||
+        (0 == p_op->consumers) ||
+        (ADTS_MCAST_CONSUMERS_MAX < p_op->consumers)) {
+        rc = EINVAL;
+        goto exception;
+    }
+    slots = adts_pow2_round_up(p_op->elems);
+
+    adts_mem_init_ext(&(mem), ADTS_MEM_TYPE_MCAST, p_op->p_allocator);
+
+    p_adts_mcast = adts_mem_get_aligned(&(mem), sizeof(*p_adts_mcast));
+    if (NULL == p_adts_mcast) {
+        rc = ENOMEM;
+        goto exception;
+    }
+
+    p_mcast                 = (mcast_t *) p_adts_mcast;
+    p_mcast->ring.slots     = slots;
+    p_mcast->ring.mask      = slots - 1;
+    p_mcast->ring.consumers = p_op->consumers;
+
+    p_mcast->ring.p_slots = adts_mem_get(&(mem), slots * sizeof(void *));
+    if (NULL == p_mcast->ring.p_slots) {
+        rc = ENOMEM;
+        goto exception;
+    }
+
+    p_mcast->ring.p_cursors = adts_mem_get_aligned(&(mem), p_op->consumers *
+                                                           sizeof(mcast_cursor_t));
+    if (NULL == p_mcast->ring.p_cursors) {
+        rc = ENOMEM;
+        goto exception;
+    }
+
+    p_mcast->ring.mem = mem;
+
+exception:
+    if (rc && p_adts_mcast) {
+        adts_mem_put(&(mem), p_mcast->ring.p_slots, slots * sizeof(void *));
+        adts_mem_put_aligned(&(mem), p_adts_mcast, sizeof(*p_adts_mcast));
+        p_adts_mcast = NULL;
+    }
+
+    return p_adts_mcast;
+} /* adts_mcast_create() */
+
+
+
+/******************************************************************************
+ * #     # #     #   ###   ####### ####### #######  #####  #######  #####
+ * #     # ##    #    #       #       #    #       #     #    #    #     #
+ * #     # # #   #    #       #       #    #       #          #    #
+ * #     # #  #  #    #       #       #    #####    #####     #     #####
+ * #     # #   # #    #       #       #    #             #    #          #
+ * #     # #    ##    #       #       #    #       #     #    #    #     #
+ *  #####  #     #   ###      #       #    #######  #####     #     #####
+******************************************************************************/
+
+/**
+ **************************************************************************
+ * \brief
+ *   Compile time structure sanity
+ *
+ * \details
+ *   Sanitize the abstract data type interface.  Enforced in header file so
+ *   as to catch improper usage/include by unauthorized callers.
+ *
+ **************************************************************************
+ */
+static void
+utest_mcast_bytes( void )
+{
+    CDISPLAY("[%u]", sizeof(mcast_t));
+    CDISPLAY("[%u]", sizeof(adts_mcast_t));
+
+    _Static_assert(sizeof(mcast_t) <= sizeof(adts_mcast_t),
+        "Mismatch structs detected");
+
+    return;
+} /* utest_mcast_bytes() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Benchmark parameters.  Events fanned out, ring capacity and the
+ *   consumer batch size.
+ *
+ ****************************************************************************
+ */
+#ifndef UTEST_MCAST_ITEMS
+#define UTEST_MCAST_ITEMS (1 << 21)
+#endif
+
+#ifndef UTEST_MCAST_ELEMS
+#define UTEST_MCAST_ELEMS (1 << 12)
+#endif
+
+#define UTEST_MCAST_BATCH (32)
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Consumer context, the fan out is either the broadcast ring or one
+ *   spsc ring per consumer carrying a copy of every event.
+ *
+ ****************************************************************************
+ */
+typedef struct {
+    adts_mcast_t *p_mcast;
+    adts_spsc_t  *p_spsc;
+    size_t        id;
+    size_t        items;
+    size_t        sum;
+} utest_mcast_ctx_t;
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+static void *
+utest_mcast_consumer( void *p_arg )
+{
+    utest_mcast_ctx_t *p_ctx    = p_arg;
+    size_t             recv     = 0;
+    size_t             cnt      = 0;
+    void *const       *pp_run   = NULL;
+    void              *data[ UTEST_MCAST_BATCH ];
+
+    while (recv < p_ctx->items) {
+        if (p_ctx->p_mcast) {
+            cnt = adts_mcast_claim(p_ctx->p_mcast, p_ctx->id,
+                                   UTEST_MCAST_BATCH, &(pp_run));
+        }else {
+            cnt    = adts_spsc_dequeue_n(p_ctx->p_spsc, data, UTEST_MCAST_BATCH);
+            pp_run = data;
+        }
+
+        if (0 == cnt) {
+            sched_yield();
+            continue;
+        }
+
+        for (size_t idx = 0; idx < cnt; idx++) {
+            assert((void *) (recv + idx + 1) == pp_run[idx]);
+            p_ctx->sum += (size_t) pp_run[idx];
+        }
+        recv += cnt;
+
+        if (p_ctx->p_mcast) {
+            adts_mcast_release(p_ctx->p_mcast, p_ctx->id, cnt);
+        }
+    }
+
+    return NULL;
+} /* utest_mcast_consumer() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Fan out to n consumers, published once into the broadcast ring, or
+ *   copied into n spsc rings.
+ *
+ ****************************************************************************
+ */
+static void
+utest_mcast_fanout( size_t consumers,
+                    bool   broadcast )
+{
+    int32_t              rc      = 0;
+    size_t               items   = UTEST_MCAST_ITEMS;
+    uint64_t             start   = 0;
+    uint64_t             delta   = 0;
+    adts_mcast_t        *p_mcast = NULL;
+    adts_mcast_create_t  op      = {0};
+    adts_spsc_create_t   sop     = {0};
+    adts_mcast_stats_t   stats   = {0};
+    pthread_t            tids[ ADTS_MCAST_CONSUMERS_MAX ];
+    utest_mcast_ctx_t    ctx[ ADTS_MCAST_CONSUMERS_MAX ];
+
+    memset(ctx, 0, sizeof(ctx));
+
+    op.elems     = UTEST_MCAST_ELEMS;
+    op.consumers = consumers;
+    sop.elems    = UTEST_MCAST_ELEMS;
+
+    if (broadcast) {
+        p_mcast = adts_mcast_create(&(op));
+        assert(p_mcast);
+    }
+
+    for (size_t idx = 0; idx < consumers; idx++) {
+        ctx[idx].p_mcast = p_mcast;
+        ctx[idx].id      = idx;
+        ctx[idx].items   = items;
+        if (!broadcast) {
+            ctx[idx].p_spsc = adts_spsc_create(&(sop));
+            assert(ctx[idx].p_spsc);
+        }
+    }
+
+    start = adts_tstamp();
+    for (size_t idx = 0; idx < consumers; idx++) {
+        rc = pthread_create(&(tids[idx]), NULL, utest_mcast_consumer, &(ctx[idx]));
+        assert(0 == rc);
+    }
+
+    for (size_t seq = 1; seq <= items; seq++) {
+        if (broadcast) {
+            while (adts_mcast_publish(p_mcast, (void *) seq)) {
+                sched_yield();
+            }
+            continue;
+        }
+
+        for (size_t idx = 0; idx < consumers; idx++) {
+            while (adts_spsc_enqueue(ctx[idx].p_spsc, (void *) seq)) {
+                sched_yield();
+            }
+        }
+    }
+
+    for (size_t idx = 0; idx < consumers; idx++) {
+        (void) pthread_join(tids[idx], NULL);
+        assert(ctx[idx].sum == (items * (items + 1)) / 2);
+    }
+    delta = adts_tstamp() - start;
+
+    if (broadcast) {
+        adts_mcast_stats(p_mcast, &(stats));
+        assert(items == stats.published);
+        adts_mcast_destroy(p_mcast);
+    }else {
+        for (size_t idx = 0; idx < consumers; idx++) {
+            adts_spsc_destroy(ctx[idx].p_spsc);
+        }
+    }
+
+    CDISPLAY("consumers: %zu  %s  events/s: %12.0f  ns/event: %6.2f  full: %zu  gate scans: %zu",
+             consumers,
+             broadcast ? "mcast     " : "spsc copy ",
+             (double) items * 1e9 / (double) (delta ? delta : 1),
+             (double) delta / (double) items,
+             stats.full,
+             stats.gate_scans);
+
+    return;
+} /* utest_mcast_fanout() */
+
+
+/*
+ ****************************************************************************
+ * test control
+ *
+ ****************************************************************************
+ */
+static void
+utest_control( void )
+{
+    utest_mcast_bytes();
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: invalid create");
+
+        adts_mcast_create_t op = {0};
+
+        op.elems = 8;
+        assert(NULL == adts_mcast_create(&(op)));
+        op.consumers = ADTS_MCAST_CONSUMERS_MAX + 1;
+        assert(NULL == adts_mcast_create(&(op)));
+        op.elems     = 0;
+        op.consumers = 1;
+        assert(NULL == adts_mcast_create(&(op)));
+    }
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: slowest consumer gating, batch claim at the wrap");
+
+        void                *p_data   = NULL;
+        void *const         *pp_run   = NULL;
+        adts_mcast_t        *p_mcast  = NULL;
+        adts_mcast_create_t  op       = {0};
+        adts_mem_stats_t     before   = {0};
+        adts_mem_stats_t     after    = {0};
+        void                *in[ 8 ];
+
+        (void) adts_mem_stats(ADTS_MEM_TYPE_MCAST, &(before));
+
+        op.elems     = 7;
+        op.consumers = 2;
+        p_mcast      = adts_mcast_create(&(op));
+        assert(p_mcast);
+        assert(8 == adts_mcast_capacity(p_mcast));
+
+        for (size_t idx = 0; idx < 8; idx++) {
+            in[idx] = (void *) (idx + 1);
+        }
+        assert(8 == adts_mcast_publish_n(p_mcast, in, 8));
+        assert(EAGAIN == adts_mcast_publish(p_mcast, in[0]));
+
+        /* consumer 0 drains, consumer 1 lags and still gates */
+        for (size_t idx = 0; idx < 8; idx++) {
+            assert(0 == adts_mcast_consume(p_mcast, 0, &(p_data)));
+            assert(in[idx] == p_data);
+        }
+        assert(EAGAIN == adts_mcast_consume(p_mcast, 0, &(p_data)));
+        assert(EAGAIN == adts_mcast_publish(p_mcast, in[0]));
+        assert(8 == adts_mcast_lag(p_mcast, 1));
+
+        /* consumer 1 releases 6, the producer wraps */
+        assert(6 == adts_mcast_claim(p_mcast, 1, 6, &(pp_run)));
+        assert((in[0] == pp_run[0]) && (in[5] == pp_run[5]));
+        adts_mcast_release(p_mcast, 1, 6);
+        assert(6 == adts_mcast_publish_n(p_mcast, in, 8));
+
+        /* a claim spanning the wrap is cut at the ring end */
+        assert(2 == adts_mcast_claim(p_mcast, 1, 8, &(pp_run)));
+        assert((in[6] == pp_run[0]) && (in[7] == pp_run[1]));
+        adts_mcast_release(p_mcast, 1, 2);
+        assert(6 == adts_mcast_claim(p_mcast, 1, 8, &(pp_run)));
+        assert(in[0] == pp_run[0]);
+        adts_mcast_release(p_mcast, 1, 6);
+        assert(0 == adts_mcast_lag(p_mcast, 1));
+        assert(6 == adts_mcast_lag(p_mcast, 0));
+
+        adts_mcast_destroy(p_mcast);
+
+        (void) adts_mem_stats(ADTS_MEM_TYPE_MCAST, &(after));
+        assert(before.bytes_curr == after.bytes_curr);
+    }
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: fan out, broadcast ring vs per consumer copy");
+
+        for (size_t consumers = 4; consumers <= 8; consumers <<= 1) {
+            utest_mcast_fanout(consumers, false);
+            utest_mcast_fanout(consumers, true);
+        }
+    }
+
+    return;
+} /* utest_control() */
+
+
+/*
+ ****************************************************************************
+ * test entrypoint
+ *
+ ****************************************************************************
+ */
+void
+utest_adts_mcast( void )
+{
+    utest_control();
+
+    return;
+} /* utest_adts_mcast() */
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <adts_memory.h>
+
+
+/******************************************************************************
+ #####  ####### ######  #     #  #####  ####### #     # ######  #######  #####
+#     #    #    #     # #     # #     #    #    #     # #     # #       #     #
+#          #    #     # #     # #          #    #     # #     # #       #
+ #####     #    ######  #     # #          #    #     # ######  #####    #####
+      #    #    #   #   #     # #          #    #     # #   #   #             #
+#     #    #    #    #  #     # #     #    #    #     # #    #  #       #     #
+ #####     #    #     #  #####   #####     #     #####  #     # #######  #####
+******************************************************************************/
+
+/**
+ **************************************************************************
+ * \details
+ *   Bounded single producer / multi consumer broadcast ring.  Every
+ *   consumer observes every published entry, in order.  An entry is
+ *   published once and read in place by all consumers, each of which
+ *   tracks its own sequence cursor.  The producer may only overwrite a
+ *   slot once the slowest consumer has released it.
+ *
+ *   The producer and each consumer may run concurrently without consumer
+ *   provided locking, provided each consumer id is used by one thread.
+ *
+ **************************************************************************
+ */
+#define ADTS_MCAST_BYTES         (192)
+#define ADTS_MCAST_CONSUMERS_MAX (64)
+
+typedef struct {
+    const char reserved[ ADTS_MCAST_BYTES ];
+} adts_mcast_t;
+
+
+/**
+ **************************************************************************
+ * \details
+ *   elems is rounded up to a power of two.  Consumer ids are
+ *   0 .. consumers - 1, each starts at the first published entry.
+ *
+ **************************************************************************
+ */
+typedef struct {
+    size_t                  elems;       /**< ring capacity */
+    size_t                  consumers;   /**< 1 .. ADTS_MCAST_CONSUMERS_MAX */
+    const adts_allocator_t *p_allocator; /**< NULL selects the default */
+} adts_mcast_create_t;
+
+
+/**
+ **************************************************************************
+ * \details
+ *   Producer counters, lifetime of the instance.
+ *
+ **************************************************************************
+ */
+typedef struct {
+    size_t published;  /**< entries published */
+    size_t full;       /**< publish blocked by the slowest consumer */
+    size_t gate_scans; /**< consumer cursor scans by the producer */
+} adts_mcast_stats_t;
+
+
+
+/******************************************************************************
+ #####   #####    ####    #####   ####    #####   #   #  #####   ######   ####
+ #    #  #    #  #    #     #    #    #     #      # #   #    #  #       #
+ #    #  #    #  #    #     #    #    #     #       #    #    #  #####    ####
+ #####   #####   #    #     #    #    #     #       #    #####   #            #
+ #       #   #   #    #     #    #    #     #       #    #       #       #    #
+ #       #    #   ####      #     ####      #       #    #       ######   ####
+*******************************************************************************/
+
+/**
+ **************************************************************************
+ * \brief
+ *   Producer services, call from the producer thread only
+ *
+ * \details
+ *   - adts_mcast_publish()   EAGAIN when the slowest consumer is a full
+ *                            ring behind
+ *   - adts_mcast_publish_n() publish up to n, returns the number published
+ *
+ **************************************************************************
+ */
+int32_t
+adts_mcast_publish( adts_mcast_t *p_adts_mcast,
+                    void         *p_data );
+
+size_t
+adts_mcast_publish_n( adts_mcast_t *p_adts_mcast,
+                      void *const  *pp_data,
+                      size_t        n );
+
+
+/**
+ **************************************************************************
+ * \brief
+ *   Consumer services, call from the thread owning consumer id only
+ *
+ * \details
+ *   - adts_mcast_claim()   up to max entries, read in place through
+ *                          *ppp_data, returns the count.  The run is
+ *                          contiguous, thus may be cut short at the ring
+ *                          wrap.  Entries stay valid until released.
+ *   - adts_mcast_release() release n claimed entries, oldest first
+ *   - adts_mcast_consume() claim and release a single entry, EAGAIN when
+ *                          none is available
+ *
+ **************************************************************************
+ */
+size_t
+adts_mcast_claim( adts_mcast_t  *p_adts_mcast,
+                  size_t         id,
+                  size_t         max,
+                  void *const  **ppp_data );
+
+void
+adts_mcast_release( adts_mcast_t *p_adts_mcast,
+                    size_t        id,
+                    size_t        n );
+
+int32_t
+adts_mcast_consume( adts_mcast_t  *p_adts_mcast,
+                    size_t         id,
+                    void         **pp_data );
+
+
+/**
+ **************************************************************************
+ * \details
+ *   adts_mcast_lag() is the number of entries published but not yet
+ *   released by consumer id, a snapshot when called concurrently.
+ *
+ **************************************************************************
+ */
+size_t
+adts_mcast_lag( adts_mcast_t *p_adts_mcast,
+                size_t        id );
+
+size_t
+adts_mcast_capacity( adts_mcast_t *p_adts_mcast );
+
+void
+adts_mcast_stats( adts_mcast_t       *p_adts_mcast,
+                  adts_mcast_stats_t *p_out );
+
+void
+adts_mcast_mem_usage( adts_mcast_t     *p_adts_mcast,
+                      adts_mem_stats_t *p_out );
+
+void
+adts_mcast_destroy( adts_mcast_t *p_adts_mcast );
+
+adts_mcast_t *
+adts_mcast_create( const adts_mcast_create_t *p_op );
+
+
+/**
+ **************************************************************************
+ * \details
+ *   Unit Test prototypes
+ *
+ **************************************************************************
+ */
+void
+utest_adts_mcast( void );
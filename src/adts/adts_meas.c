@@ -2,6 +2,7 @@
 
 #include <errno.h>
 #include <assert.h>
+#include <stdlib.h>
 #include <string.h>
 #include <limits.h>
 #include <stdbool.h>
@@ -9,6 +10,7 @@
 
 /* Toolbox */
 #include <adts_meas.h>
+#include <adts_memory.h>
 #include <adts_sanity.h>
 #include <adts_private.h>
 #include <adts_display.h>
@@ -50,6 +52,7 @@ typedef struct {
     uint64_t      total;     // lifetime number of measurements
     uint64_t      min;       // lifetime min value
     uint64_t      max;       // lifetime max value
+    adts_mem_t    mem;       // accounted memory, unused when embedded
     meas_entry_t *entry;
 } meas_t;
 
@@ -230,8 +233,10 @@ int32_t
 adts_meas_destroy( void *p_handle )
 {
     int32_t        rc       = 0;
+    size_t         bytes    = 0;
     meas_t        *p_meas   = (meas_t *) p_handle;
     adts_sanity_t *p_sanity = NULL;
+    adts_mem_t     mem      = {0};
 
     rc = meas_input_sanity(p_meas);
     if (rc) {
@@ -243,7 +248,11 @@ adts_meas_destroy( void *p_handle )
 
     p_meas->state = MEAS_FREE;
 
-    free(p_meas);
+    bytes  = sizeof(meas_t);
+    bytes += ((size_t) p_meas->entries * sizeof(meas_entry_t));
+    mem    = p_meas->mem;
+
+    adts_mem_put(&(mem), p_meas, bytes);
 
 exception:
     /* No adts_sanity_exit() since we've freed the memory */
@@ -256,22 +265,36 @@ exception:
 void *
 adts_meas_create( uint32_t elems )
 {
-    uint32_t  bytes    = 0;
-    meas_t   *p_meas   = NULL;
-    void     *p_handle = NULL;
+    return adts_meas_create_ext(elems, NULL);
+} /* adts_meas_create() */
+
+
+
+
+void *
+adts_meas_create_ext( uint32_t                elems,
+                      const adts_allocator_t *p_allocator )
+{
+    size_t      bytes    = 0;
+    meas_t     *p_meas   = NULL;
+    void       *p_handle = NULL;
+    adts_mem_t  mem      = {0};
 
     if (elems < ADTS_MEAS_MIN_ENTRIES) {
         goto exception;
     }
 
+    /* Large histories qualify for a huge page backed region */
     bytes  = sizeof(meas_t);
-    bytes += (elems * sizeof(meas_entry_t));
+    bytes += ((size_t) elems * sizeof(meas_entry_t));
 
-    p_meas = adts_mem_zalloc(bytes);
+    adts_mem_init_ext(&(mem), ADTS_MEM_TYPE_MEAS, p_allocator);
+    p_meas = adts_mem_get(&(mem), bytes);
     if (NULL == p_meas) {
         goto exception;
     }
 
+    p_meas->mem      = mem;
     p_meas->state    = MEAS_ALLOC;
     p_meas->entries  = elems;
     p_meas->min      = -1;
@@ -281,7 +304,7 @@ adts_meas_create( uint32_t elems )
 
 exception:
     return p_handle;
-} /* adts_meas_create() */
+} /* adts_meas_create_ext() */
 
 
 
@@ -462,7 +485,7 @@ utest_control( void )
     CDISPLAY("=========================================================");
     {
         //TEST: good visual dump amd iterate - compare to above
-        char         arr[176]    = {0};
+        char         arr[176 + sizeof(adts_mem_t)] = {0};
         int32_t      err         = 0;
         uint32_t     bytes       = sizeof(arr);
         void        *p_adts_meas = NULL;
@@ -493,6 +516,30 @@ utest_control( void )
         adts_hexdump(p_adts_meas, bytes, "MEAS Embedded");
         meas_display(p_adts_meas);
     }
+
+    CDISPLAY("=========================================================");
+    {
+        //TEST: large history is accounted and huge page eligible
+        uint32_t              elems       = 1 << 18;
+        void                 *p_adts_meas = NULL;
+        adts_mem_stats_t      family      = {0};
+        adts_mem_map_stats_t  before      = {0};
+        adts_mem_map_stats_t  after       = {0};
+
+        adts_mem_map_stats(&(before));
+        p_adts_meas = adts_meas_create(elems);
+        assert(p_adts_meas);
+
+        (void) adts_mem_stats(ADTS_MEM_TYPE_MEAS, &(family));
+        assert(family.bytes_curr >= (elems * sizeof(meas_entry_t)));
+
+        adts_meas_destroy(p_adts_meas);
+        adts_mem_map_stats(&(after));
+        CDISPLAY("maps: %zu  thp_advised: %zu",
+                 after.maps - before.maps,
+                 after.thp_advised - before.thp_advised);
+        assert(1 == (after.unmaps - before.unmaps));
+    }
 #if 0
     CDISPLAY("=========================================================");
     {
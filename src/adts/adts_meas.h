@@ -3,6 +3,7 @@
 #include <string.h>
 #include <stdbool.h>
 #include <inttypes.h>
+#include <adts_memory.h>
 
 
 typedef struct {
@@ -16,6 +17,17 @@ typedef struct {
 #define ADTS_MEAS_MIN_ENTRIES (8)
 
 
+int32_t
+adts_meas_destroy( void *p_handle );
+
+void *
+adts_meas_create( uint32_t elems );
+
+void *
+adts_meas_create_ext( uint32_t                elems,
+                      const adts_allocator_t *p_allocator );
+
+
 /**
  **************************************************************************
  * \details
@@ -0,0 +1,776 @@
+#define _GNU_SOURCE /* fallocate() */
+#include <fcntl.h>
+#include <errno.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* Toolbox */
+#include <adts_sort.h>
+#include <adts_heap.h>
+#include <adts_stack.h>
+#include <adts_sanity.h>
+#include <adts_mem_file.h>
+#include <adts_private.h>
+#include <adts_display.h>
+
+
+/******************************************************************************
+ #####  ####### ######  #     #  #####  ####### #     # ######  #######  #####
+#     #    #    #     # #     # #     #    #    #     # #     # #       #     #
+#          #    #     # #     # #          #    #     # #     # #       #
+ #####     #    ######  #     # #          #    #     # ######  #####    #####
+      #    #    #   #   #     # #          #    #     # #   #   #             #
+#     #    #    #    #  #     # #     #    #    #     # #    #  #       #     #
+ #####     #    #     #  #####   #####     #     #####  #     # #######  #####
+******************************************************************************/
+
+/*
+ ****************************************************************************
+ * \details
+ *   The embedded allocator refers back to this instance via p_ctx, thus
+ *   the instance must outlive every ADT created with it.
+ *
+ *   hwm is the highest carve offset ever reached.  File contents above
+ *   hwm have never been written and read as zero.
+ *
+ ****************************************************************************
+ */
+typedef struct {
+    adts_allocator_t       allocator;
+    adts_sanity_t          sanity;
+    int32_t                fd;
+    uint8_t               *p_base;
+    size_t                 page;
+    size_t                 hwm;
+    adts_mem_file_stats_t  stats;
+} mem_file_t;
+
+
+
+/******************************************************************************
+ * ####### #     # #     #  #####  #######   ###   ####### #     #  #####
+ * #       #     # ##    # #     #    #       #    #     # ##    # #     #
+ * #       #     # # #   # #          #       #    #     # # #   # #
+ * #####   #     # #  #  # #          #       #    #     # #  #  #  #####
+ * #       #     # #   # # #          #       #    #     # #   # #       #
+ * #       #     # #    ## #     #    #       #    #     # #    ## #     #
+ * #        #####  #     #  #####     #      ###   ####### #     #  #####
+******************************************************************************/
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+static inline size_t
+mem_file_carve( size_t bytes )
+{
+    return (bytes + ADTS_MEM_FILE_ALIGN - 1) & ~(ADTS_MEM_FILE_ALIGN - 1);
+} /* mem_file_carve() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Only the most recent allocation ends at the carve top.
+ *
+ ****************************************************************************
+ */
+static inline bool
+mem_file_is_top( mem_file_t *p_file,
+                 void       *p_buf,
+                 size_t      bytes )
+{
+    uint8_t *p_end = (uint8_t *) p_buf + mem_file_carve(bytes);
+
+    return (p_end == (p_file->p_base + p_file->stats.bytes_top));
+} /* mem_file_is_top() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Release the file blocks of whole pages within [off, off + bytes).
+ *   Failure is benign, e.g. a file system without hole punch support,
+ *   the blocks simply remain allocated.
+ *
+ ****************************************************************************
+ */
+static void
+mem_file_release( mem_file_t *p_file,
+                  size_t      off,
+                  size_t      bytes )
+{
+    size_t page = p_file->page;
+    size_t lo   = (off + page - 1) & ~(page - 1);
+    size_t hi   = (off + bytes) & ~(page - 1);
+
+    if (hi > lo) {
+        (void) fallocate(p_file->fd,
+                         FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                         lo, hi - lo);
+    }
+
+    return;
+} /* mem_file_release() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Advance the carve top, NULL when capacity is exhausted.
+ *
+ ****************************************************************************
+ */
+static void *
+mem_file_carve_top( mem_file_t *p_file,
+                    size_t      off,
+                    size_t      bytes )
+{
+    void   *p_buf = NULL;
+    size_t  top   = off + mem_file_carve(bytes);
+
+    if (top > p_file->stats.capacity) {
+        goto exception;
+    }
+
+    p_file->stats.bytes_top = top;
+    p_file->hwm             = MAX(p_file->hwm, top);
+    p_buf                   = p_file->p_base + off;
+
+exception:
+    return p_buf;
+} /* mem_file_carve_top() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+static void *
+mem_file_alloc( void   *p_ctx,
+                size_t  bytes )
+{
+    mem_file_t *p_file = p_ctx;
+    void       *p_buf  = NULL;
+
+    p_buf = mem_file_carve_top(p_file, p_file->stats.bytes_top, bytes);
+    if (NULL == p_buf) {
+        goto exception;
+    }
+
+    p_file->stats.bytes_live += mem_file_carve(bytes);
+    p_file->stats.allocs++;
+
+exception:
+    return p_buf;
+} /* mem_file_alloc() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Only the portion below the prior high watermark may hold stale
+ *   contents, the remainder is untouched file and reads as zero.
+ *
+ ****************************************************************************
+ */
+static void *
+mem_file_zalloc( void   *p_ctx,
+                 size_t  bytes )
+{
+    mem_file_t *p_file = p_ctx;
+    uint8_t    *p_buf  = NULL;
+    size_t      off    = p_file->stats.bytes_top;
+    size_t      hwm    = p_file->hwm;
+
+    p_buf = mem_file_alloc(p_ctx, bytes);
+    if (NULL == p_buf) {
+        goto exception;
+    }
+
+    if (hwm > off) {
+        memset(p_buf, 0, MIN(bytes, hwm - off));
+    }
+
+exception:
+    return p_buf;
+} /* mem_file_zalloc() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+static void
+mem_file_free( void   *p_ctx,
+               void   *p_buf,
+               size_t  bytes )
+{
+    mem_file_t *p_file = p_ctx;
+    size_t      off    = (uint8_t *) p_buf - p_file->p_base;
+    size_t      carve  = mem_file_carve(bytes);
+
+    if (mem_file_is_top(p_file, p_buf, bytes)) {
+        /* reclaim the carve top */
+        p_file->stats.bytes_top = off;
+    }
+    mem_file_release(p_file, off, carve);
+
+    p_file->stats.bytes_live -= carve;
+    p_file->stats.frees++;
+
+    return;
+} /* mem_file_free() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Array workspaces are typically the most recent allocation of their
+ *   ADT, thus grow and shrink in place without a copy.
+ *
+ ****************************************************************************
+ */
+static void *
+mem_file_realloc( void   *p_ctx,
+                  void   *p_old,
+                  size_t  bytes_old,
+                  size_t  bytes_new )
+{
+    mem_file_t *p_file = p_ctx;
+    void       *p_buf  = NULL;
+    size_t      off    = (uint8_t *) p_old - p_file->p_base;
+
+    if (mem_file_is_top(p_file, p_old, bytes_old)) {
+        p_buf = mem_file_carve_top(p_file, off, bytes_new);
+        if (NULL == p_buf) {
+            goto exception;
+        }
+
+        p_file->stats.bytes_live -= mem_file_carve(bytes_old);
+        p_file->stats.bytes_live += mem_file_carve(bytes_new);
+        p_file->stats.inplace++;
+
+        if (bytes_new < bytes_old) {
+            mem_file_release(p_file, off + mem_file_carve(bytes_new),
+                             mem_file_carve(bytes_old) -
+                             mem_file_carve(bytes_new));
+        }
+        goto exception;
+    }
+
+    p_buf = mem_file_alloc(p_ctx, bytes_new);
+    if (NULL == p_buf) {
+        goto exception;
+    }
+
+    memcpy(p_buf, p_old, MIN(bytes_old, bytes_new));
+    mem_file_free(p_ctx, p_old, bytes_old);
+
+exception:
+    return p_buf;
+} /* mem_file_realloc() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+const adts_allocator_t *
+adts_mem_file_allocator( adts_mem_file_t *p_adts_file )
+{
+    mem_file_t *p_file = (mem_file_t *) p_adts_file;
+
+    return &(p_file->allocator);
+} /* adts_mem_file_allocator() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   The range is widened to page boundaries and clipped to the mapping.
+ *
+ ****************************************************************************
+ */
+int32_t
+adts_mem_file_advise( adts_mem_file_t        *p_adts_file,
+                      void                   *p_buf,
+                      size_t                  bytes,
+                      adts_mem_file_advice_t  advice )
+{
+    int32_t        rc       = 0;
+    int32_t        hint     = 0;
+    size_t         lo       = 0;
+    size_t         hi       = 0;
+    mem_file_t    *p_file   = (mem_file_t *) p_adts_file;
+    adts_sanity_t *p_sanity = &(p_file->sanity);
+
+    adts_sanity_entry(p_sanity);
+
+    switch (advice) {
+        case ADTS_MEM_FILE_NORMAL:
+            hint = MADV_NORMAL;
+            break;
+        case ADTS_MEM_FILE_SEQUENTIAL:
+            hint = MADV_SEQUENTIAL;
+            break;
+        case ADTS_MEM_FILE_RANDOM:
+            hint = MADV_RANDOM;
+            break;
+        case ADTS_MEM_FILE_WILLNEED:
+            hint = MADV_WILLNEED;
+            break;
+        case ADTS_MEM_FILE_DONTNEED:
+            hint = MADV_DONTNEED;
+            break;
+        default:
+            rc = EINVAL;
+            goto exception;
+    }
+
+    if (NULL == p_buf) {
+        lo = 0;
+        hi = p_file->stats.capacity;
+    }else {
+        lo = (uint8_t *) p_buf - p_file->p_base;
+        hi = lo + bytes;
+        if ((p_buf < (void *) p_file->p_base) ||
+            (hi > p_file->stats.capacity)) {
+            rc = EINVAL;
+            goto exception;
+        }
+        lo = lo & ~(p_file->page - 1);
+        hi = (hi + p_file->page - 1) & ~(p_file->page - 1);
+    }
+
+    rc = madvise(p_file->p_base + lo, hi - lo, hint);
+    if (rc) {
+        rc = errno;
+    }
+
+exception:
+    adts_sanity_exit(p_sanity);
+    return rc;
+} /* adts_mem_file_advise() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Pages above the high watermark have never been dirtied.
+ *
+ ****************************************************************************
+ */
+int32_t
+adts_mem_file_checkpoint( adts_mem_file_t *p_adts_file )
+{
+    int32_t        rc       = 0;
+    size_t         bytes    = 0;
+    mem_file_t    *p_file   = (mem_file_t *) p_adts_file;
+    adts_sanity_t *p_sanity = &(p_file->sanity);
+
+    adts_sanity_entry(p_sanity);
+
+    bytes = (p_file->hwm + p_file->page - 1) & ~(p_file->page - 1);
+    if (0 == bytes) {
+        goto exception;
+    }
+
+    rc = msync(p_file->p_base, bytes, MS_SYNC);
+    if (rc) {
+        rc = errno;
+        goto exception;
+    }
+    p_file->stats.checkpoints++;
+
+exception:
+    adts_sanity_exit(p_sanity);
+    return rc;
+} /* adts_mem_file_checkpoint() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_mem_file_usage( const adts_mem_file_t *p_adts_file,
+                     adts_mem_file_stats_t *p_out )
+{
+    const mem_file_t *p_file = (const mem_file_t *) p_adts_file;
+
+    memcpy(p_out, &(p_file->stats), sizeof(*p_out));
+
+    return;
+} /* adts_mem_file_usage() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Contents are not synchronized, see adts_mem_file_checkpoint().
+ *
+ ****************************************************************************
+ */
+void
+adts_mem_file_destroy( adts_mem_file_t *p_adts_file )
+{
+    mem_file_t    *p_file   = (mem_file_t *) p_adts_file;
+    adts_sanity_t *p_sanity = &(p_file->sanity);
+
+    adts_sanity_entry(p_sanity);
+
+    (void) munmap(p_file->p_base, p_file->stats.capacity);
+    (void) close(p_file->fd);
+
+    /* Ensure proper cleanup to avoid false positives on accidental reuse */
+    memset(p_file, 0, sizeof(*p_file));
+    free(p_file);
+
+    /* No adts_sanity_exit() since we've freed the memory */
+
+    return;
+} /* adts_mem_file_destroy() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+adts_mem_file_t *
+adts_mem_file_create( const adts_mem_file_create_t *p_op )
+{
+    int32_t          rc          = 0;
+    int32_t          fd          = -1;
+    bool             created     = false;
+    size_t           page        = getpagesize();
+    size_t           capacity    = 0;
+    uint8_t         *p_base      = MAP_FAILED;
+    mem_file_t      *p_file      = NULL;
+    adts_mem_file_t *p_adts_file = NULL;
+
+    assert(p_op);
+    if ((NULL == p_op->p_path) || (0 == p_op->capacity)) {
+        rc = EINVAL;
+        goto exception;
+    }
+    capacity = (p_op->capacity + page - 1) & ~(page - 1);
+
+    p_adts_file = adts_mem_zalloc(sizeof(*p_adts_file));
+    if (NULL == p_adts_file) {
+        rc = ENOMEM;
+        goto exception;
+    }
+
+    /* Only a file this call created may be removed on failure */
+    fd = open(p_op->p_path, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (0 <= fd) {
+        created = true;
+    }else if (EEXIST == errno) {
+        fd = open(p_op->p_path, O_RDWR | O_TRUNC);
+    }
+    if (0 > fd) {
+        rc = errno;
+        goto exception;
+    }
+
+    /* Sparse, no blocks are allocated until pages are written back */
+    rc = ftruncate(fd, (off_t) capacity);
+    if (rc) {
+        rc = errno;
+        goto exception;
+    }
+
+    p_base = mmap(NULL, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (MAP_FAILED == p_base) {
+        rc = errno;
+        goto exception;
+    }
+
+    if (p_op->unlink) {
+        (void) unlink(p_op->p_path);
+    }
+
+    p_file                      = (mem_file_t *) p_adts_file;
+    p_file->fd                  = fd;
+    p_file->p_base              = p_base;
+    p_file->page                = page;
+    p_file->stats.capacity      = capacity;
+    p_file->allocator.p_alloc   = mem_file_alloc;
+    p_file->allocator.p_zalloc  = mem_file_zalloc;
+    p_file->allocator.p_realloc = mem_file_realloc;
+    p_file->allocator.p_free    = mem_file_free;
+    p_file->allocator.p_ctx     = p_file;
+
+exception:
+    if (rc) {
+        if (0 <= fd) {
+            (void) close(fd);
+        }
+
+        if (created) {
+            (void) unlink(p_op->p_path);
+        }
+
+        free(p_adts_file);
+        p_adts_file = NULL;
+    }
+
+    return p_adts_file;
+} /* adts_mem_file_create() */
+
+
+
+/******************************************************************************
+ * #     # #     #   ###   ####### ####### #######  #####  #######  #####
+ * #     # ##    #    #       #       #    #       #     #    #    #     #
+ * #     # # #   #    #       #       #    #       #          #    #
+ * #     # #  #  #    #       #       #    #####    #####     #     #####
+ * #     # #   # #    #       #       #    #             #    #          #
+ * #     # #    ##    #       #       #    #       #     #    #    #     #
+ *  #####  #     #   ###      #       #    #######  #####     #     #####
+******************************************************************************/
+
+/**
+ **************************************************************************
+ * \brief
+ *   Compile time structure sanity
+ *
+ * \details
+ *   Sanitize the abstract data type interface.  Enforced in header file so
+ *   as to catch improper usage/include by unauthorized callers.
+ *
+ **************************************************************************
+ */
+static void
+utest_mem_file_bytes( void )
+{
+    CDISPLAY("[%u]", sizeof(mem_file_t));
+    CDISPLAY("[%u]", sizeof(adts_mem_file_t));
+
+    _Static_assert(sizeof(mem_file_t) <= sizeof(adts_mem_file_t),
+        "Mismatch structs detected");
+
+    return;
+} /* utest_mem_file_bytes() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Backing file location, tmpfs or a real file system both qualify.
+ *
+ ****************************************************************************
+ */
+#ifndef UTEST_MEM_FILE_PATH
+#define UTEST_MEM_FILE_PATH "/tmp/adts_mem_file.utest"
+#endif
+
+#define UTEST_MEM_FILE_CAPACITY (256ul << 20)
+
+
+/*
+ ****************************************************************************
+ * test control
+ *
+ ****************************************************************************
+ */
+static void
+utest_control( void )
+{
+    adts_mem_file_create_t op = {
+        .p_path   = UTEST_MEM_FILE_PATH,
+        .capacity = UTEST_MEM_FILE_CAPACITY,
+        .unlink   = true,
+    };
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: size verification");
+
+        utest_mem_file_bytes();
+    }
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: invalid create");
+
+        int32_t                fd  = -1;
+        adts_mem_file_create_t bad = {0};
+
+        assert(NULL == adts_mem_file_create(&(bad)));
+
+        /* a failed create removes a file it created, never a prior one */
+        bad.p_path   = UTEST_MEM_FILE_PATH;
+        bad.capacity = (size_t) 1 << 62;
+        (void) unlink(bad.p_path);
+        assert(NULL == adts_mem_file_create(&(bad)));
+        assert((0 != access(bad.p_path, F_OK)) && (ENOENT == errno));
+
+        fd = open(bad.p_path, O_RDWR | O_CREAT | O_EXCL, 0600);
+        assert(0 <= fd);
+        (void) close(fd);
+        assert(NULL == adts_mem_file_create(&(bad)));
+        assert(0 == access(bad.p_path, F_OK));
+        (void) unlink(bad.p_path);
+    }
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: sparse carve, top reuse and in place resize");
+
+        uint8_t                *p_a    = NULL;
+        uint8_t                *p_b    = NULL;
+        struct stat             st     = {0};
+        mem_file_t             *p_file = NULL;
+        adts_mem_file_t        *p_mf   = NULL;
+        adts_mem_file_stats_t   stats  = {0};
+        const adts_allocator_t *p_al   = NULL;
+
+        p_mf = adts_mem_file_create(&(op));
+        assert(p_mf);
+        p_file = (mem_file_t *) p_mf;
+        p_al   = adts_mem_file_allocator(p_mf);
+
+        p_a = p_al->p_zalloc(p_al->p_ctx, 100);
+        p_b = p_al->p_zalloc(p_al->p_ctx, 1 << 20);
+        assert(p_a && p_b);
+        assert(0 == ((uintptr_t) p_b % ADTS_MEM_FILE_ALIGN));
+        memset(p_b, 0xa5, 1 << 20);
+
+        /* top allocation grows and shrinks without moving */
+        assert(p_b == p_al->p_realloc(p_al->p_ctx, p_b, 1 << 20, 8 << 20));
+        assert(0xa5 == p_b[(1 << 20) - 1]);
+        assert(p_b == p_al->p_realloc(p_al->p_ctx, p_b, 8 << 20, 2 << 20));
+
+        /* freed top is reclaimed and re-zeroed on the next zalloc */
+        p_al->p_free(p_al->p_ctx, p_b, 2 << 20);
+        assert(p_b == p_al->p_zalloc(p_al->p_ctx, 4096));
+        assert(0 == p_b[0]);
+        p_al->p_free(p_al->p_ctx, p_b, 4096);
+        p_al->p_free(p_al->p_ctx, p_a, 100);
+
+        adts_mem_file_usage(p_mf, &(stats));
+        assert(0 == stats.bytes_live);
+        assert(2 == stats.inplace);
+
+        assert(0 == adts_mem_file_checkpoint(p_mf));
+        assert(0 == fstat(p_file->fd, &(st)));
+        CDISPLAY("capacity: %zu  size: %zu  disk: %zu",
+                 stats.capacity, (size_t) st.st_size,
+                 (size_t) st.st_blocks * 512);
+        assert(stats.capacity == (size_t) st.st_size);
+        assert(stats.capacity > ((size_t) st.st_blocks * 512));
+
+        adts_mem_file_destroy(p_mf);
+    }
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: stack and heap workspaces on the file allocator");
+
+        size_t                  elems   = 1 << 18;
+        adts_mem_file_t        *p_mf    = NULL;
+        adts_stack_t           *p_stack = NULL;
+        adts_heap_t            *p_heap  = NULL;
+        adts_heap_node_t       *p_node  = NULL;
+        adts_stack_create_t     sop     = {0};
+        adts_heap_create_t      hop     = {0};
+        adts_mem_file_stats_t   stats   = {0};
+
+        p_mf = adts_mem_file_create(&(op));
+        assert(p_mf);
+
+        sop.p_allocator = adts_mem_file_allocator(p_mf);
+        p_stack = adts_stack_create_ext(&(sop));
+        assert(p_stack);
+        for (size_t idx = 1; idx <= elems; idx++) {
+            assert(0 == adts_stack_push(p_stack, (void *) idx, sizeof(idx)));
+        }
+        for (size_t idx = elems; idx >= 1; idx--) {
+            assert((void *) idx == adts_stack_pop(p_stack));
+        }
+        adts_stack_destroy(p_stack);
+
+        p_node = calloc(elems, sizeof(*p_node));
+        assert(p_node);
+
+        hop.type        = ADTS_HEAP_MIN;
+        hop.p_allocator = adts_mem_file_allocator(p_mf);
+        p_heap = adts_heap_create_ext(&(hop));
+        assert(p_heap);
+        for (size_t idx = 0; idx < elems; idx++) {
+            assert(0 == adts_heap_push(p_heap, &(p_node[idx]), p_node, 1, idx));
+        }
+        assert(elems == adts_heap_entries(p_heap));
+        adts_heap_destroy(p_heap);
+        free(p_node);
+
+        adts_mem_file_usage(p_mf, &(stats));
+        CDISPLAY("allocs: %zu  frees: %zu  inplace: %zu  live: %zu",
+                 stats.allocs, stats.frees, stats.inplace, stats.bytes_live);
+        assert(0 == stats.bytes_live);
+        assert(stats.inplace);
+
+        adts_mem_file_destroy(p_mf);
+    }
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: merge sort buffer on the file allocator");
+
+        size_t            elems = 1 << 20;
+        int32_t          *arr   = NULL;
+        adts_mem_file_t  *p_mf  = NULL;
+
+        p_mf = adts_mem_file_create(&(op));
+        assert(p_mf);
+
+        arr = malloc(elems * sizeof(arr[0]));
+        assert(arr);
+        for (size_t idx = 0; idx < elems; idx++) {
+            arr[idx] = elems - idx;
+        }
+
+        /* merge passes sweep the buffer front to back */
+        assert(0 == adts_mem_file_advise(p_mf, NULL, 0,
+                                         ADTS_MEM_FILE_SEQUENTIAL));
+        assert(0 == adts_sort_merge_ext(arr, elems,
+                                        adts_mem_file_allocator(p_mf)));
+        assert(adts_arr_is_sorted(arr, elems));
+        assert(0 == adts_mem_file_checkpoint(p_mf));
+        assert(EINVAL == adts_mem_file_advise(p_mf, arr, 1,
+                                              ADTS_MEM_FILE_RANDOM));
+
+        free(arr);
+        adts_mem_file_destroy(p_mf);
+    }
+
+    return;
+} /* utest_control() */
+
+
+/*
+ ****************************************************************************
+ * test entrypoint
+ *
+ ****************************************************************************
+ */
+void
+utest_adts_mem_file( void )
+{
+    utest_control();
+
+    return;
+} /* utest_adts_mem_file() */
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <adts_memory.h>
+
+
+/******************************************************************************
+ #####  ####### ######  #     #  #####  ####### #     # ######  #######  #####
+#     #    #    #     # #     # #     #    #    #     # #     # #       #     #
+#          #    #     # #     # #          #    #     # #     # #       #
+ #####     #    ######  #     # #          #    #     # ######  #####    #####
+      #    #    #   #   #     # #          #    #     # #   #   #             #
+#     #    #    #    #  #     # #     #    #    #     # #    #  #       #     #
+ #####     #    #     #  #####   #####     #     #####  #     # #######  #####
+******************************************************************************/
+
+/**
+ **************************************************************************
+ * \details
+ *   File backed allocator.  Allocations are carved from a sparse file
+ *   mapped MAP_SHARED, thus cold pages are written back to the file and
+ *   dropped from the page cache rather than consuming swap.  Intended for
+ *   array workspaces which exceed physical memory.
+ *
+ *   Carving is a bump allocator on ADTS_MEM_FILE_ALIGN boundaries.  The
+ *   most recent allocation may grow or shrink in place and is reclaimed
+ *   on free.  Space of any other freed allocation is released to the
+ *   file system, but the address range is not reused.
+ *
+ **************************************************************************
+ */
+#define ADTS_MEM_FILE_BYTES (256)
+#define ADTS_MEM_FILE_ALIGN (64)
+
+typedef struct {
+    const char reserved[ ADTS_MEM_FILE_BYTES ];
+} adts_mem_file_t;
+
+
+/**
+ **************************************************************************
+ * \details
+ *   p_path names the backing file, created or truncated.  capacity is
+ *   the file size and upper bound of all live allocations, no disk blocks
+ *   are consumed until written.  unlink removes the path on create such
+ *   that the file is released on destroy.
+ *
+ **************************************************************************
+ */
+typedef struct {
+    const char *p_path;
+    size_t      capacity;
+    bool        unlink;
+} adts_mem_file_create_t;
+
+
+/**
+ **************************************************************************
+ * \details
+ *   Access pattern hints, see madvise(2).
+ *
+ **************************************************************************
+ */
+typedef enum {
+    ADTS_MEM_FILE_NORMAL = 0,
+    ADTS_MEM_FILE_SEQUENTIAL,
+    ADTS_MEM_FILE_RANDOM,
+    ADTS_MEM_FILE_WILLNEED,
+    ADTS_MEM_FILE_DONTNEED,
+} adts_mem_file_advice_t;
+
+
+/**
+ **************************************************************************
+ * \details
+ *   Byte counts are carve sizes, thus include alignment padding.
+ *
+ **************************************************************************
+ */
+typedef struct {
+    size_t capacity;     /**< file size */
+    size_t bytes_top;    /**< carve offset, next allocation starts here */
+    size_t bytes_live;   /**< bytes in live allocations */
+    size_t allocs;       /**< lifetime allocations */
+    size_t frees;        /**< lifetime frees */
+    size_t inplace;      /**< resizes serviced at the carve top */
+    size_t checkpoints;  /**< successful msync operations */
+} adts_mem_file_stats_t;
+
+
+
+/******************************************************************************
+ #####   #####    ####    #####   ####    #####   #   #  #####   ######   ####
+ #    #  #    #  #    #     #    #    #     #      # #   #    #  #       #
+ #    #  #    #  #    #     #    #    #     #       #    #    #  #####    ####
+ #####   #####   #    #     #    #    #     #       #    #####   #            #
+ #       #   #   #    #     #    #    #     #       #    #       #       #    #
+ #       #    #   ####      #     ####      #       #    #       ######   ####
+*******************************************************************************/
+
+
+/**
+ **************************************************************************
+ * \brief
+ *   File backed allocator services
+ *
+ * \details
+ *   - adts_mem_file_allocator()  allocator for any adts_*_create_ext()
+ *   - adts_mem_file_advise()     access hint for a range, NULL for all
+ *   - adts_mem_file_checkpoint() synchronous write back of dirty pages
+ *
+ *   Consumer is responsible for serialization, as with all ADT state.
+ *
+ **************************************************************************
+ */
+const adts_allocator_t *
+adts_mem_file_allocator( adts_mem_file_t *p_adts_file );
+
+int32_t
+adts_mem_file_advise( adts_mem_file_t        *p_adts_file,
+                      void                   *p_buf,
+                      size_t                  bytes,
+                      adts_mem_file_advice_t  advice );
+
+int32_t
+adts_mem_file_checkpoint( adts_mem_file_t *p_adts_file );
+
+void
+adts_mem_file_usage( const adts_mem_file_t *p_adts_file,
+                     adts_mem_file_stats_t *p_out );
+
+void
+adts_mem_file_destroy( adts_mem_file_t *p_adts_file );
+
+adts_mem_file_t *
+adts_mem_file_create( const adts_mem_file_create_t *p_op );
+
+
+/**
+ **************************************************************************
+ * \details
+ *   Unit Test prototypes
+ *
+ **************************************************************************
+ */
+void
+utest_adts_mem_file( void );
@@ -1,7 +1,65 @@
+#define _GNU_SOURCE /* mremap() */
+#include <errno.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
 
+/* Toolbox */
 #include <adts_memory.h>
+#include <adts_private.h>
+#include <adts_display.h>
+
+
+/******************************************************************************
+ #####  ####### ######  #     #  #####  ####### #     # ######  #######  #####
+#     #    #    #     # #     # #     #    #    #     # #     # #       #     #
+#          #    #     # #     # #          #    #     # #     # #       #
+ #####     #    ######  #     # #          #    #     # ######  #####    #####
+      #    #    #   #   #     # #          #    #     # #   #   #             #
+#     #    #    #    #  #     # #     #    #    #     # #    #  #       #     #
+ #####     #    #     #  #####   #####     #     #####  #     # #######  #####
+******************************************************************************/
+
+/*
+ ****************************************************************************
+ * \details
+ *   Process wide counters per ADT family.  Instances of the same family
+ *   may be owned by different threads, thus all updates are atomic.
+ *
+ ****************************************************************************
+ */
+static adts_mem_stats_t mem_family[ ADTS_MEM_TYPE_MAX ];
 
 
+/*
+ ****************************************************************************
+ * \details
+ *   Large allocation policy and lifetime mapped region counters.
+ *
+ ****************************************************************************
+ */
+static adts_mem_config_t mem_config = {
+    .map_bytes = ADTS_MEM_MAP_BYTES_DEFAULT,
+    .thp       = true,
+    .remap     = true,
+};
+
+static adts_mem_map_stats_t mem_regions;
+
+
+
+/******************************************************************************
+ * ####### #     # #     #  #####  #######   ###   ####### #     #  #####
+ * #       #     # ##    # #     #    #       #    #     # ##    # #     #
+ * #       #     # # #   # #          #       #    #     # # #   # #
+ * #####   #     # #  #  # #          #       #    #     # #  #  #  #####
+ * #       #     # #   # # #          #       #    #     # #   # #       #
+ * #       #     # #    ## #     #    #       #    #     # #    ## #     #
+ * #        #####  #     #  #####     #      ###   ####### #     #  #####
+******************************************************************************/
+
 /*
  ****************************************************************************
  *
@@ -25,3 +83,1053 @@ adts_mem_zalloc( size_t bytes )
 exception:
     return p_mem;
 } /* adts_mem_zalloc() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Mapped regions are released by length, thus the length is derived
+ *   from the requested bytes alone.
+ *
+ ****************************************************************************
+ */
+static inline size_t
+mem_map_len( size_t bytes )
+{
+    size_t page = getpagesize();
+
+    return (bytes + page - 1) & ~(page - 1);
+} /* mem_map_len() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+static inline bool
+mem_is_mapped( size_t bytes )
+{
+    size_t map_bytes = __atomic_load_n(&(mem_config.map_bytes),
+                                       __ATOMIC_RELAXED);
+
+    return ((ADTS_MEM_MAP_DISABLE != map_bytes) && (bytes >= map_bytes));
+} /* mem_is_mapped() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Over map by one huge page, then trim the head and tail such that the
+ *   region starts on a huge page boundary.  A huge page can only back a
+ *   naturally aligned 2MB range.
+ *
+ ****************************************************************************
+ */
+static void *
+mem_map( size_t bytes )
+{
+    int32_t  rc     = 0;
+    size_t   len    = mem_map_len(bytes);
+    size_t   align  = ADTS_MEM_HUGEPAGE_BYTES;
+    size_t   head   = 0;
+    size_t   tail   = 0;
+    uint8_t *p_raw  = NULL;
+    uint8_t *p_buf  = NULL;
+
+    p_raw = mmap(NULL, len + align,
+                 PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS,
+                 -1, 0);
+    if (MAP_FAILED == p_raw) {
+        p_buf = NULL;
+        goto exception;
+    }
+
+    p_buf = (uint8_t *) (((uintptr_t) p_raw + align - 1) & ~(align - 1));
+    head  = p_buf - p_raw;
+    tail  = align - head;
+    if (head) {
+        (void) munmap(p_raw, head);
+    }
+    if (tail) {
+        (void) munmap(p_buf + len, tail);
+    }
+
+    __atomic_add_fetch(&(mem_regions.maps), 1, __ATOMIC_RELAXED);
+
+    if (__atomic_load_n(&(mem_config.thp), __ATOMIC_RELAXED)) {
+        /* EINVAL when the kernel lacks THP, keep the base page mapping */
+        rc = madvise(p_buf, len, MADV_HUGEPAGE);
+        if (rc) {
+            __atomic_add_fetch(&(mem_regions.thp_fallback), 1, __ATOMIC_RELAXED);
+        }else {
+            __atomic_add_fetch(&(mem_regions.thp_advised), 1, __ATOMIC_RELAXED);
+        }
+    }
+
+exception:
+    return p_buf;
+} /* mem_map() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+static void
+mem_unmap( void   *p_buf,
+           size_t  bytes )
+{
+    (void) munmap(p_buf, mem_map_len(bytes));
+    __atomic_add_fetch(&(mem_regions.unmaps), 1, __ATOMIC_RELAXED);
+
+    return;
+} /* mem_unmap() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Anonymous mappings are zero filled by the kernel, only the C heap
+ *   path requires a memset.
+ *
+ ****************************************************************************
+ */
+static void *
+mem_backend_alloc( size_t bytes,
+                   bool   zero )
+{
+    void    *p_buf = NULL;
+    int32_t  rc    = 0;
+
+    if (mem_is_mapped(bytes)) {
+        p_buf = mem_map(bytes);
+        goto exception;
+    }
+
+    rc = posix_memalign(&(p_buf), getpagesize(), bytes);
+    if (rc) {
+        p_buf = NULL;
+        goto exception;
+    }
+
+    if (zero) {
+        memset(p_buf, 0, bytes);
+    }
+
+exception:
+    return p_buf;
+} /* mem_backend_alloc() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+static void
+mem_backend_free( void   *p_buf,
+                  size_t  bytes )
+{
+    if (mem_is_mapped(bytes)) {
+        mem_unmap(p_buf, bytes);
+    }else {
+        free(p_buf);
+    }
+
+    return;
+} /* mem_backend_free() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   The VMA keeps its MADV_HUGEPAGE advice across mremap(), including any
+ *   extension.  A moved region may lose its 2MB alignment, in which case
+ *   only the aligned interior is eligible for huge pages.
+ *
+ ****************************************************************************
+ */
+static void *
+mem_remap( void   *p_old,
+           size_t  bytes_old,
+           size_t  bytes_new )
+{
+    void *p_buf = NULL;
+
+    p_buf = mremap(p_old, mem_map_len(bytes_old), mem_map_len(bytes_new),
+                   MREMAP_MAYMOVE);
+    if (MAP_FAILED == p_buf) {
+        p_buf = NULL;
+        goto exception;
+    }
+
+    __atomic_add_fetch(&(mem_regions.remaps), 1, __ATOMIC_RELAXED);
+
+exception:
+    return p_buf;
+} /* mem_remap() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   C heap to C heap is left to realloc(), mapped to mapped is left to
+ *   mremap() when enabled.  Any other transition is a copy into a new
+ *   allocation.
+ *
+ ****************************************************************************
+ */
+static void *
+mem_backend_realloc( void   *p_old,
+                     size_t  bytes_old,
+                     size_t  bytes_new )
+{
+    void *p_buf = NULL;
+    bool  remap = __atomic_load_n(&(mem_config.remap), __ATOMIC_RELAXED);
+
+    if (!mem_is_mapped(bytes_old) && !mem_is_mapped(bytes_new)) {
+        p_buf = realloc(p_old, bytes_new);
+        goto exception;
+    }
+
+    if (remap && mem_is_mapped(bytes_old) && mem_is_mapped(bytes_new)) {
+        p_buf = mem_remap(p_old, bytes_old, bytes_new);
+        goto exception;
+    }
+
+    p_buf = mem_backend_alloc(bytes_new, false);
+    if (NULL == p_buf) {
+        goto exception;
+    }
+
+    memcpy(p_buf, p_old, MIN(bytes_old, bytes_new));
+    mem_backend_free(p_old, bytes_old);
+
+exception:
+    return p_buf;
+} /* mem_backend_realloc() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Default allocator entrypoints, the context is unused.
+ *
+ ****************************************************************************
+ */
+static void *
+mem_default_alloc( void   *p_ctx,
+                   size_t  bytes )
+{
+    (void) p_ctx;
+
+    return mem_backend_alloc(bytes, false);
+} /* mem_default_alloc() */
+
+
+static void *
+mem_default_zalloc( void   *p_ctx,
+                    size_t  bytes )
+{
+    (void) p_ctx;
+
+    return mem_backend_alloc(bytes, true);
+} /* mem_default_zalloc() */
+
+
+static void *
+mem_default_realloc( void   *p_ctx,
+                     void   *p_old,
+                     size_t  bytes_old,
+                     size_t  bytes_new )
+{
+    (void) p_ctx;
+
+    return mem_backend_realloc(p_old, bytes_old, bytes_new);
+} /* mem_default_realloc() */
+
+
+static void
+mem_default_free( void   *p_ctx,
+                  void   *p_buf,
+                  size_t  bytes )
+{
+    (void) p_ctx;
+
+    mem_backend_free(p_buf, bytes);
+
+    return;
+} /* mem_default_free() */
+
+
+const adts_allocator_t adts_allocator_default = {
+    .p_alloc   = mem_default_alloc,
+    .p_zalloc  = mem_default_zalloc,
+    .p_realloc = mem_default_realloc,
+    .p_free    = mem_default_free,
+    .p_ctx     = NULL,
+};
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Family counters are shared, thus the high watermark is maintained
+ *   with a compare and swap loop.
+ *
+ ****************************************************************************
+ */
+static inline void
+mem_family_add( adts_mem_type_t type,
+                size_t          bytes )
+{
+    size_t            curr    = 0;
+    size_t            peak    = 0;
+    adts_mem_stats_t *p_stats = &(mem_family[type]);
+
+    curr = __atomic_add_fetch(&(p_stats->bytes_curr), bytes, __ATOMIC_RELAXED);
+    peak = __atomic_load_n(&(p_stats->bytes_peak), __ATOMIC_RELAXED);
+    while (curr > peak) {
+        if (__atomic_compare_exchange_n(&(p_stats->bytes_peak), &(peak), curr,
+                                        true,
+                                        __ATOMIC_RELAXED,
+                                        __ATOMIC_RELAXED)) {
+            break;
+        }
+    }
+
+    return;
+} /* mem_family_add() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+static inline void
+mem_family_sub( adts_mem_type_t type,
+                size_t          bytes )
+{
+    adts_mem_stats_t *p_stats = &(mem_family[type]);
+
+    (void) __atomic_sub_fetch(&(p_stats->bytes_curr), bytes, __ATOMIC_RELAXED);
+
+    return;
+} /* mem_family_sub() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+static inline void
+mem_account_add( adts_mem_t *p_mem,
+                 size_t      bytes )
+{
+    adts_mem_stats_t *p_stats = &(p_mem->stats);
+
+    p_stats->bytes_curr += bytes;
+    p_stats->bytes_peak  = MAX(p_stats->bytes_peak, p_stats->bytes_curr);
+
+    mem_family_add(p_mem->type, bytes);
+
+    return;
+} /* mem_account_add() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+static inline void
+mem_account_sub( adts_mem_t *p_mem,
+                 size_t      bytes )
+{
+    adts_mem_stats_t *p_stats = &(p_mem->stats);
+
+    /* Mismatched get / put byte counts */
+    assert(p_stats->bytes_curr >= bytes);
+
+    p_stats->bytes_curr -= bytes;
+
+    mem_family_sub(p_mem->type, bytes);
+
+    return;
+} /* mem_account_sub() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_mem_init( adts_mem_t      *p_mem,
+               adts_mem_type_t  type )
+{
+    adts_mem_init_ext(p_mem, type, NULL);
+
+    return;
+} /* adts_mem_init() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_mem_init_ext( adts_mem_t             *p_mem,
+                   adts_mem_type_t         type,
+                   const adts_allocator_t *p_allocator )
+{
+    assert(ADTS_MEM_TYPE_MAX > type);
+
+    if (NULL == p_allocator) {
+        p_allocator = &(adts_allocator_default);
+    }
+    assert(p_allocator->p_alloc);
+    assert(p_allocator->p_zalloc);
+    assert(p_allocator->p_realloc);
+    assert(p_allocator->p_free);
+
+    memset(p_mem, 0, sizeof(*p_mem));
+    p_mem->type        = type;
+    p_mem->p_allocator = p_allocator;
+
+    return;
+} /* adts_mem_init_ext() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void *
+adts_mem_get( adts_mem_t *p_mem,
+              size_t      bytes )
+{
+    void                   *p_buf   = NULL;
+    const adts_allocator_t *p_alloc = p_mem->p_allocator;
+
+    p_buf = p_alloc->p_zalloc(p_alloc->p_ctx, bytes);
+    if (NULL == p_buf) {
+        goto exception;
+    }
+
+    mem_account_add(p_mem, bytes);
+
+exception:
+    return p_buf;
+} /* adts_mem_get() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void *
+adts_mem_alloc( adts_mem_t *p_mem,
+                size_t      bytes )
+{
+    void                   *p_buf   = NULL;
+    const adts_allocator_t *p_alloc = p_mem->p_allocator;
+
+    p_buf = p_alloc->p_alloc(p_alloc->p_ctx, bytes);
+    if (NULL == p_buf) {
+        goto exception;
+    }
+
+    mem_account_add(p_mem, bytes);
+
+exception:
+    return p_buf;
+} /* adts_mem_alloc() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   On failure the original buffer and accounting are left untouched.
+ *
+ ****************************************************************************
+ */
+void *
+adts_mem_resize( adts_mem_t *p_mem,
+                 void       *p_old,
+                 size_t      bytes_old,
+                 size_t      bytes_new )
+{
+    void                   *p_buf   = NULL;
+    const adts_allocator_t *p_alloc = p_mem->p_allocator;
+
+    p_buf = p_alloc->p_realloc(p_alloc->p_ctx, p_old, bytes_old, bytes_new);
+    if (NULL == p_buf) {
+        goto exception;
+    }
+
+    mem_account_sub(p_mem, bytes_old);
+    mem_account_add(p_mem, bytes_new);
+
+exception:
+    return p_buf;
+} /* adts_mem_resize() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_mem_put( adts_mem_t *p_mem,
+              void       *p_buf,
+              size_t      bytes )
+{
+    const adts_allocator_t *p_alloc = p_mem->p_allocator;
+
+    if (NULL == p_buf) {
+        goto exception;
+    }
+
+    p_alloc->p_free(p_alloc->p_ctx, p_buf, bytes);
+    mem_account_sub(p_mem, bytes);
+
+exception:
+    return;
+} /* adts_mem_put() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   The allocator guarantees pointer alignment only, thus a cacheline of
+ *   slack is requested.  The raw block address is kept in the word below
+ *   the aligned block, the pad is never less than one word.
+ *
+ ****************************************************************************
+ */
+void *
+adts_mem_get_aligned( adts_mem_t *p_mem,
+                      size_t      bytes )
+{
+    uintptr_t   first = 0;
+    void      **p_buf = NULL;
+    void       *p_raw = NULL;
+
+    p_raw = adts_mem_get(p_mem, bytes + ADTS_CACHELINE_BYTES);
+    if (NULL == p_raw) {
+        goto exception;
+    }
+
+    first = ((uintptr_t) p_raw + sizeof(void *) + ADTS_CACHELINE_BYTES - 1) &
+            ~((uintptr_t) ADTS_CACHELINE_BYTES - 1);
+    p_buf = (void **) first;
+    p_buf[-1] = p_raw;
+
+exception:
+    return p_buf;
+} /* adts_mem_get_aligned() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_mem_put_aligned( adts_mem_t *p_mem,
+                      void       *p_buf,
+                      size_t      bytes )
+{
+    if (NULL == p_buf) {
+        goto exception;
+    }
+
+    adts_mem_put(p_mem, ((void **) p_buf)[-1], bytes + ADTS_CACHELINE_BYTES);
+
+exception:
+    return;
+} /* adts_mem_put_aligned() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_mem_usage( const adts_mem_t *p_mem,
+                adts_mem_stats_t *p_out )
+{
+    memcpy(p_out, &(p_mem->stats), sizeof(*p_out));
+
+    return;
+} /* adts_mem_usage() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+int32_t
+adts_mem_stats( adts_mem_type_t   type,
+                adts_mem_stats_t *p_out )
+{
+    int32_t           rc      = 0;
+    adts_mem_stats_t *p_stats = NULL;
+
+    if (ADTS_MEM_TYPE_MAX <= type) {
+        rc = EINVAL;
+        goto exception;
+    }
+
+    p_stats = &(mem_family[type]);
+    p_out->bytes_curr = __atomic_load_n(&(p_stats->bytes_curr), __ATOMIC_RELAXED);
+    p_out->bytes_peak = __atomic_load_n(&(p_stats->bytes_peak), __ATOMIC_RELAXED);
+
+exception:
+    return rc;
+} /* adts_mem_stats() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+int32_t
+adts_mem_config_set( const adts_mem_config_t *p_config )
+{
+    int32_t          rc    = 0;
+    adts_mem_stats_t stats = {0};
+
+    if (p_config->map_bytes != mem_config.map_bytes) {
+        /* Live allocations would be released via the wrong backend */
+        for (int32_t type = 0; type < ADTS_MEM_TYPE_MAX; type++) {
+            (void) adts_mem_stats(type, &(stats));
+            if (stats.bytes_curr) {
+                rc = EBUSY;
+                goto exception;
+            }
+        }
+    }
+
+    __atomic_store_n(&(mem_config.map_bytes), p_config->map_bytes,
+                     __ATOMIC_RELAXED);
+    __atomic_store_n(&(mem_config.thp), p_config->thp, __ATOMIC_RELAXED);
+    __atomic_store_n(&(mem_config.remap), p_config->remap, __ATOMIC_RELAXED);
+
+exception:
+    return rc;
+} /* adts_mem_config_set() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_mem_config_get( adts_mem_config_t *p_config )
+{
+    p_config->map_bytes = __atomic_load_n(&(mem_config.map_bytes),
+                                          __ATOMIC_RELAXED);
+    p_config->thp       = __atomic_load_n(&(mem_config.thp),
+                                          __ATOMIC_RELAXED);
+    p_config->remap     = __atomic_load_n(&(mem_config.remap),
+                                          __ATOMIC_RELAXED);
+
+    return;
+} /* adts_mem_config_get() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_mem_map_stats( adts_mem_map_stats_t *p_out )
+{
+    p_out->maps         = __atomic_load_n(&(mem_regions.maps), __ATOMIC_RELAXED);
+    p_out->unmaps       = __atomic_load_n(&(mem_regions.unmaps), __ATOMIC_RELAXED);
+    p_out->thp_advised  = __atomic_load_n(&(mem_regions.thp_advised),
+                                          __ATOMIC_RELAXED);
+    p_out->thp_fallback = __atomic_load_n(&(mem_regions.thp_fallback),
+                                          __ATOMIC_RELAXED);
+    p_out->remaps       = __atomic_load_n(&(mem_regions.remaps),
+                                          __ATOMIC_RELAXED);
+
+    return;
+} /* adts_mem_map_stats() */
+
+
+
+/******************************************************************************
+ * #     # #     #   ###   ####### ####### #######  #####  #######  #####
+ * #     # ##    #    #       #       #    #       #     #    #    #     #
+ * #     # # #   #    #       #       #    #       #          #    #
+ * #     # #  #  #    #       #       #    #####    #####     #     #####
+ * #     # #   # #    #       #       #    #             #    #          #
+ * #     # #    ##    #       #       #    #       #     #    #    #     #
+ *  #####  #     #   ###      #       #    #######  #####     #     #####
+******************************************************************************/
+
+/*
+ ****************************************************************************
+ * \details
+ *   Counting C heap allocator, the context holds the counters.
+ *
+ ****************************************************************************
+ */
+typedef struct {
+    size_t allocs;
+    size_t reallocs;
+    size_t frees;
+    size_t bytes;
+    size_t skew;  /**< offset of returned blocks from the malloc() block */
+} utest_alloc_t;
+
+static void *
+utest_alloc( void   *p_ctx,
+             size_t  bytes )
+{
+    utest_alloc_t *p_cnt = p_ctx;
+
+    uint8_t       *p_buf = NULL;
+
+    p_cnt->allocs++;
+    p_cnt->bytes += bytes;
+
+    p_buf = malloc(bytes + p_cnt->skew);
+
+    return p_buf ? (p_buf + p_cnt->skew) : NULL;
+} /* utest_alloc() */
+
+
+static void *
+utest_zalloc( void   *p_ctx,
+              size_t  bytes )
+{
+    utest_alloc_t *p_cnt = p_ctx;
+
+    uint8_t       *p_buf = NULL;
+
+    p_cnt->allocs++;
+    p_cnt->bytes += bytes;
+
+    p_buf = calloc(1, bytes + p_cnt->skew);
+
+    return p_buf ? (p_buf + p_cnt->skew) : NULL;
+} /* utest_zalloc() */
+
+
+static void *
+utest_realloc( void   *p_ctx,
+               void   *p_old,
+               size_t  bytes_old,
+               size_t  bytes_new )
+{
+    utest_alloc_t *p_cnt = p_ctx;
+    uint8_t       *p_buf = NULL;
+
+    p_buf = realloc((uint8_t *) p_old - p_cnt->skew, bytes_new + p_cnt->skew);
+    if (p_buf) {
+        p_cnt->reallocs++;
+        p_cnt->bytes -= bytes_old;
+        p_cnt->bytes += bytes_new;
+        p_buf        += p_cnt->skew;
+    }
+
+    return p_buf;
+} /* utest_realloc() */
+
+
+static void
+utest_free( void   *p_ctx,
+            void   *p_buf,
+            size_t  bytes )
+{
+    utest_alloc_t *p_cnt = p_ctx;
+
+    p_cnt->frees++;
+    p_cnt->bytes -= bytes;
+    free((uint8_t *) p_buf - p_cnt->skew);
+
+    return;
+} /* utest_free() */
+
+
+/*
+ ****************************************************************************
+ * test control
+ *
+ ****************************************************************************
+ */
+static void
+utest_control( void )
+{
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: get -> resize -> put accounting");
+
+        void             *p_buf  = NULL;
+        adts_mem_t        mem    = {0};
+        adts_mem_stats_t  before = {0};
+        adts_mem_stats_t  after  = {0};
+        adts_mem_stats_t  inst   = {0};
+
+        (void) adts_mem_stats(ADTS_MEM_TYPE_LIST, &(before));
+        adts_mem_init(&(mem), ADTS_MEM_TYPE_LIST);
+
+        p_buf = adts_mem_get(&(mem), 128);
+        assert(p_buf);
+        p_buf = adts_mem_resize(&(mem), p_buf, 128, 4096);
+        assert(p_buf);
+        p_buf = adts_mem_resize(&(mem), p_buf, 4096, 64);
+        assert(p_buf);
+
+        adts_mem_usage(&(mem), &(inst));
+        CDISPLAY("curr: %zu  peak: %zu", inst.bytes_curr, inst.bytes_peak);
+        assert(64   == inst.bytes_curr);
+        assert(4096 == inst.bytes_peak);
+
+        adts_mem_put(&(mem), p_buf, 64);
+        adts_mem_usage(&(mem), &(inst));
+        assert(0 == inst.bytes_curr);
+
+        (void) adts_mem_stats(ADTS_MEM_TYPE_LIST, &(after));
+        assert(before.bytes_curr == after.bytes_curr);
+        assert(after.bytes_peak  >= 4096);
+    }
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: mapped region get -> grow -> put");
+
+        uint8_t              *p_buf  = NULL;
+        size_t                bytes  = ADTS_MEM_MAP_BYTES_DEFAULT;
+        adts_mem_t            mem    = {0};
+        adts_mem_config_t     config = {0};
+        adts_mem_map_stats_t  before = {0};
+        adts_mem_map_stats_t  after  = {0};
+
+        adts_mem_config_get(&(config));
+        adts_mem_map_stats(&(before));
+        adts_mem_init(&(mem), ADTS_MEM_TYPE_LIST);
+
+        p_buf = adts_mem_get(&(mem), bytes);
+        assert(p_buf);
+        assert(0 == ((uintptr_t) p_buf % ADTS_MEM_HUGEPAGE_BYTES));
+        assert(0 == p_buf[bytes - 1]);
+        memset(p_buf, 0xa5, bytes);
+
+        /* small -> mapped -> small transitions preserve contents */
+        p_buf = adts_mem_resize(&(mem), p_buf, bytes, 2 * bytes);
+        assert(p_buf);
+        assert(0xa5 == p_buf[bytes - 1]);
+        p_buf = adts_mem_resize(&(mem), p_buf, 2 * bytes, 64);
+        assert(p_buf);
+        assert(0xa5 == p_buf[63]);
+        adts_mem_put(&(mem), p_buf, 64);
+
+        adts_mem_map_stats(&(after));
+        CDISPLAY("maps: %zu  unmaps: %zu  remaps: %zu  thp_advised: %zu  thp_fallback: %zu",
+                 after.maps, after.unmaps, after.remaps,
+                 after.thp_advised, after.thp_fallback);
+        assert(2 == ((after.maps   - before.maps) +
+                     (after.remaps - before.remaps)));
+        assert((after.maps - before.maps) == (after.unmaps - before.unmaps));
+        if (config.thp) {
+            assert((after.maps - before.maps) ==
+                     ((after.thp_advised  - before.thp_advised) +
+                      (after.thp_fallback - before.thp_fallback)));
+        }
+    }
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: mapped region remap vs copy");
+
+        uint8_t              *p_buf  = NULL;
+        size_t                bytes  = ADTS_MEM_MAP_BYTES_DEFAULT;
+        adts_mem_t            mem    = {0};
+        adts_mem_config_t     config = {0};
+        adts_mem_config_t     change = {0};
+        adts_mem_map_stats_t  before = {0};
+        adts_mem_map_stats_t  after  = {0};
+
+        adts_mem_config_get(&(config));
+        adts_mem_init(&(mem), ADTS_MEM_TYPE_LIST);
+
+        p_buf = adts_mem_get(&(mem), bytes);
+        assert(p_buf);
+        memset(p_buf, 0x5a, bytes);
+
+        for (int32_t remap = 1; remap >= 0; remap--) {
+            change       = config;
+            change.remap = remap;
+            assert(0 == adts_mem_config_set(&(change)));
+
+            adts_mem_map_stats(&(before));
+            p_buf = adts_mem_resize(&(mem), p_buf, bytes, 2 * bytes);
+            assert(p_buf);
+            assert(0x5a == p_buf[bytes - 1]);
+            assert(0 == p_buf[bytes]);
+            p_buf = adts_mem_resize(&(mem), p_buf, 2 * bytes, bytes);
+            assert(p_buf);
+            assert(0x5a == p_buf[bytes - 1]);
+            adts_mem_map_stats(&(after));
+
+            CDISPLAY("remap: %d  remaps: %zu  maps: %zu", remap,
+                     after.remaps - before.remaps,
+                     after.maps   - before.maps);
+            assert((remap ? 2 : 0) == (after.remaps - before.remaps));
+            assert((remap ? 0 : 2) == (after.maps   - before.maps));
+        }
+
+        adts_mem_put(&(mem), p_buf, bytes);
+        assert(0 == adts_mem_config_set(&(config)));
+    }
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: map threshold latched while memory is live");
+
+        void              *p_buf  = NULL;
+        adts_mem_t         mem    = {0};
+        adts_mem_config_t  config = {0};
+        adts_mem_config_t  change = {0};
+
+        adts_mem_config_get(&(config));
+        adts_mem_init(&(mem), ADTS_MEM_TYPE_LIST);
+
+        p_buf = adts_mem_get(&(mem), 64);
+        assert(p_buf);
+
+        change           = config;
+        change.map_bytes = ADTS_MEM_MAP_DISABLE;
+        assert(EBUSY == adts_mem_config_set(&(change)));
+
+        /* thp alone may change at any time */
+        change     = config;
+        change.thp = !config.thp;
+        assert(0 == adts_mem_config_set(&(change)));
+        assert(0 == adts_mem_config_set(&(config)));
+
+        adts_mem_put(&(mem), p_buf, 64);
+    }
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: consumer allocator");
+
+        uint8_t          *p_buf = NULL;
+        utest_alloc_t     cnt   = {0};
+        adts_mem_t        mem   = {0};
+        adts_mem_stats_t  inst  = {0};
+        adts_allocator_t  alloc = {
+            .p_alloc   = utest_alloc,
+            .p_zalloc  = utest_zalloc,
+            .p_realloc = utest_realloc,
+            .p_free    = utest_free,
+            .p_ctx     = &(cnt),
+        };
+
+        adts_mem_init_ext(&(mem), ADTS_MEM_TYPE_LIST, &(alloc));
+
+        p_buf = adts_mem_get(&(mem), 128);
+        assert(p_buf);
+        assert(0 == p_buf[127]);
+        p_buf = adts_mem_resize(&(mem), p_buf, 128, 256);
+        assert(p_buf);
+        adts_mem_put(&(mem), p_buf, 256);
+
+        p_buf = adts_mem_alloc(&(mem), 64);
+        assert(p_buf);
+        adts_mem_usage(&(mem), &(inst));
+        assert(64 == inst.bytes_curr);
+        adts_mem_put(&(mem), p_buf, 64);
+
+        CDISPLAY("allocs: %zu  reallocs: %zu  frees: %zu  bytes: %zu",
+                 cnt.allocs, cnt.reallocs, cnt.frees, cnt.bytes);
+        assert(2 == cnt.allocs);
+        assert(1 == cnt.reallocs);
+        assert(2 == cnt.frees);
+        assert(0 == cnt.bytes);
+    }
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: cacheline aligned get -> put, skewed allocator");
+
+        uint8_t          *p_buf = NULL;
+        utest_alloc_t     cnt   = {0};
+        adts_mem_t        mem   = {0};
+        adts_mem_stats_t  inst  = {0};
+        adts_allocator_t  alloc = {
+            .p_alloc   = utest_alloc,
+            .p_zalloc  = utest_zalloc,
+            .p_realloc = utest_realloc,
+            .p_free    = utest_free,
+            .p_ctx     = &(cnt),
+        };
+
+        adts_mem_init_ext(&(mem), ADTS_MEM_TYPE_LIST, &(alloc));
+
+        /* every word offset within a cacheline */
+        for (cnt.skew = 0; cnt.skew < ADTS_CACHELINE_BYTES; cnt.skew += sizeof(void *)) {
+            p_buf = adts_mem_get_aligned(&(mem), 200);
+            assert(p_buf);
+            assert(0 == ((uintptr_t) p_buf & (ADTS_CACHELINE_BYTES - 1)));
+            assert((0 == p_buf[0]) && (0 == p_buf[199]));
+            memset(p_buf, 0xa5, 200);
+
+            adts_mem_usage(&(mem), &(inst));
+            assert((200 + ADTS_CACHELINE_BYTES) == inst.bytes_curr);
+            adts_mem_put_aligned(&(mem), p_buf, 200);
+        }
+        cnt.skew = 0;
+
+        adts_mem_usage(&(mem), &(inst));
+        assert(0 == inst.bytes_curr);
+        assert(cnt.allocs == cnt.frees);
+        assert(0 == cnt.bytes);
+    }
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: invalid family");
+
+        adts_mem_stats_t stats = {0};
+
+        assert(EINVAL == adts_mem_stats(ADTS_MEM_TYPE_MAX, &(stats)));
+    }
+
+    return;
+} /* utest_control() */
+
+
+/*
+ ****************************************************************************
+ * test entrypoint
+ *
+ ****************************************************************************
+ */
+void
+utest_adts_memory( void )
+{
+    utest_control();
+
+    return;
+} /* utest_adts_memory() */
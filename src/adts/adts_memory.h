@@ -15,6 +15,169 @@
  #####     #    #     #  #####   #####     #     #####  #     # #######  #####
 ******************************************************************************/
 
+/**
+ **************************************************************************
+ * \details
+ *   ADT families for which memory is accounted.  Each instance reports
+ *   into exactly one family.
+ *
+ **************************************************************************
+ */
+typedef enum {
+    ADTS_MEM_TYPE_HASH = 0,
+    ADTS_MEM_TYPE_HEAP,
+    ADTS_MEM_TYPE_LIST,
+    ADTS_MEM_TYPE_MEAS,
+    ADTS_MEM_TYPE_TREE,
+    ADTS_MEM_TYPE_TRIE,
+    ADTS_MEM_TYPE_RBT,
+    ADTS_MEM_TYPE_GRAPH,
+    ADTS_MEM_TYPE_STACK,
+    ADTS_MEM_TYPE_QUEUE,
+    ADTS_MEM_TYPE_SORT,
+    ADTS_MEM_TYPE_SPSC,
+    ADTS_MEM_TYPE_MPMC,
+    ADTS_MEM_TYPE_MPSC,
+    ADTS_MEM_TYPE_MCAST,
+    ADTS_MEM_TYPE_LFSTACK,
+    ADTS_MEM_TYPE_WSDEQUE,
+    ADTS_MEM_TYPE_TIMERWHEEL,
+    ADTS_MEM_TYPE_MULTIQUEUE,
+    ADTS_MEM_TYPE_RADIXHEAP,
+    ADTS_MEM_TYPE_TOPK,
+    ADTS_MEM_TYPE_THEAP,
+    ADTS_MEM_TYPE_MINMAXHEAP,
+    ADTS_MEM_TYPE_MAX,
+} adts_mem_type_t;
+
+
+/**
+ **************************************************************************
+ * \details
+ *   Accounted allocations at or above map_bytes are backed by a private
+ *   2MB aligned mmap region rather than the C heap.  When thp is set the
+ *   region is advised with MADV_HUGEPAGE such that large workspaces are
+ *   covered by transparent huge pages, reducing TLB misses.  Kernels
+ *   without THP support simply keep the default page size.
+ *
+ *   When remap is set a mapped region is grown or shrunk in place via
+ *   mremap(MREMAP_MAYMOVE), moving page table entries rather than copying
+ *   the contents.  Otherwise a resize is a copy into a new region.
+ *
+ *   map_bytes selects how the region is released, thus it may only be
+ *   changed while no accounted memory is live.  thp and remap may change
+ *   at will.
+ *
+ **************************************************************************
+ */
+#define ADTS_MEM_HUGEPAGE_BYTES    (2 << 20)
+#define ADTS_MEM_MAP_BYTES_DEFAULT (4 << 20)
+#define ADTS_MEM_MAP_DISABLE       (0)
+
+typedef struct {
+    size_t map_bytes; /**< mmap threshold, ADTS_MEM_MAP_DISABLE for none */
+    bool   thp;       /**< advise transparent huge pages on mapped regions */
+    bool   remap;     /**< resize mapped regions without a copy */
+} adts_mem_config_t;
+
+
+/**
+ **************************************************************************
+ * \details
+ *   Lifetime mapped region counters.
+ *
+ **************************************************************************
+ */
+typedef struct {
+    size_t maps;         /**< mapped regions created */
+    size_t unmaps;       /**< mapped regions released */
+    size_t thp_advised;  /**< regions accepted for huge pages */
+    size_t thp_fallback; /**< regions left at base page size */
+    size_t remaps;       /**< resizes serviced without a copy */
+} adts_mem_map_stats_t;
+
+
+/**
+ **************************************************************************
+ * \details
+ *   Live and high watermark byte counters.  Bytes are the amount
+ *   requested from the allocator, thus workspace slack after a grow
+ *   operation is included.
+ *
+ **************************************************************************
+ */
+typedef struct {
+    size_t bytes_curr; /**< bytes currently held */
+    size_t bytes_peak; /**< lifetime maximum of bytes_curr */
+} adts_mem_stats_t;
+
+
+/**
+ **************************************************************************
+ * \details
+ *   Consumer provided allocator, e.g. a pool, an arena or a NUMA local
+ *   node.  Every member is required.  bytes is always the value given to
+ *   the allocating call, thus sized free and realloc are available to
+ *   the implementation.
+ *
+ *   Instances keep the allocator pointer and call through it up to and
+ *   including destroy.  The allocator, and its p_ctx, must therefore
+ *   outlive every instance created with it.
+ *
+ *   Returned memory must be suitably aligned for any fundamental type, as
+ *   with malloc().  Instances whose control block is ADTS_CACHELINE_BYTES
+ *   (64) aligned obtain it through adts_mem_get_aligned(), thus a larger
+ *   alignment is not required of the allocator.
+ *
+ *   - p_alloc()   uninitialized contents
+ *   - p_zalloc()  zeroed contents
+ *   - p_realloc() preserve contents up to the lesser byte count, NULL on
+ *                 failure with p_old left intact
+ *   - p_free()    release
+ *
+ **************************************************************************
+ */
+typedef struct {
+    void *(*p_alloc)   (void   *p_ctx,
+                        size_t  bytes);
+    void *(*p_zalloc)  (void   *p_ctx,
+                        size_t  bytes);
+    void *(*p_realloc) (void   *p_ctx,
+                        void   *p_old,
+                        size_t  bytes_old,
+                        size_t  bytes_new);
+    void  (*p_free)    (void   *p_ctx,
+                        void   *p_buf,
+                        size_t  bytes);
+    void   *p_ctx;     /**< consumer context, passed to each call */
+} adts_allocator_t;
+
+
+/**
+ **************************************************************************
+ * \details
+ *   Default allocator.  C heap below the map threshold, otherwise a
+ *   mapped region per adts_mem_config_t.
+ *
+ **************************************************************************
+ */
+extern const adts_allocator_t adts_allocator_default;
+
+
+/**
+ **************************************************************************
+ * \details
+ *   Per instance memory context.  Embedded in each ADT control structure
+ *   and passed to every alloc / resize / free of that instance.
+ *
+ **************************************************************************
+ */
+typedef struct {
+    adts_mem_type_t         type;        /**< accounting family */
+    adts_mem_stats_t        stats;       /**< instance counters */
+    const adts_allocator_t *p_allocator; /**< backing allocator */
+} adts_mem_t;
+
 
 
 /******************************************************************************
@@ -37,3 +200,99 @@
  */
 void *
 adts_mem_zalloc( size_t bytes );
+
+
+/**
+ **************************************************************************
+ * \brief
+ *   Accounted allocation services
+ *
+ * \details
+ *   - adts_mem_init()        default allocator
+ *   - adts_mem_init_ext()    consumer allocator, NULL selects the default
+ *   - adts_mem_get()         zeroed allocation
+ *   - adts_mem_alloc()       uninitialized allocation
+ *   - adts_mem_resize()      preserve contents up to the lesser byte count
+ *   - adts_mem_put()         release, bytes must match the get / resize
+ *                            value
+ *   - adts_mem_get_aligned() zeroed, ADTS_CACHELINE_BYTES aligned, a
+ *                            cacheline of slack is accounted with bytes
+ *   - adts_mem_put_aligned() release, bytes must match the get value
+ *
+ *   Instance counters are not serialized, the ADT consumer is responsible
+ *   as with all other instance state.  Family counters are atomic.
+ *
+ **************************************************************************
+ */
+void
+adts_mem_init( adts_mem_t      *p_mem,
+               adts_mem_type_t  type );
+void
+adts_mem_init_ext( adts_mem_t             *p_mem,
+                   adts_mem_type_t         type,
+                   const adts_allocator_t *p_allocator );
+void *
+adts_mem_get( adts_mem_t *p_mem,
+              size_t      bytes );
+void *
+adts_mem_alloc( adts_mem_t *p_mem,
+                size_t      bytes );
+void *
+adts_mem_resize( adts_mem_t *p_mem,
+                 void       *p_old,
+                 size_t      bytes_old,
+                 size_t      bytes_new );
+void
+adts_mem_put( adts_mem_t *p_mem,
+              void       *p_buf,
+              size_t      bytes );
+void *
+adts_mem_get_aligned( adts_mem_t *p_mem,
+                      size_t      bytes );
+void
+adts_mem_put_aligned( adts_mem_t *p_mem,
+                      void       *p_buf,
+                      size_t      bytes );
+
+
+/**
+ **************************************************************************
+ * \brief
+ *   Footprint reporting
+ *
+ * \details
+ *   - adts_mem_usage() per instance counters
+ *   - adts_mem_stats() per ADT family counters
+ *
+ **************************************************************************
+ */
+void
+adts_mem_usage( const adts_mem_t *p_mem,
+                adts_mem_stats_t *p_out );
+int32_t
+adts_mem_stats( adts_mem_type_t   type,
+                adts_mem_stats_t *p_out );
+
+
+/**
+ **************************************************************************
+ * \brief
+ *   Large allocation policy
+ *
+ * \details
+ *   adts_mem_config_set() returns EBUSY on a map_bytes change while any
+ *   accounted memory is live.
+ *
+ **************************************************************************
+ */
+int32_t
+adts_mem_config_set( const adts_mem_config_t *p_config );
+
+void
+adts_mem_config_get( adts_mem_config_t *p_config );
+
+void
+adts_mem_map_stats( adts_mem_map_stats_t *p_out );
+
+void
+utest_adts_memory( void );
@@ -0,0 +1,1132 @@
+#include <errno.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <adts_heap.h>
+#include <adts_time.h>
+#include <adts_memory.h>
+#include <adts_sanity.h>
+#include <adts_private.h>
+#include <adts_display.h>
+#include <adts_minmaxheap.h>
+
+
+/******************************************************************************
+ #####  ####### ######  #     #  #####  ####### #     # ######  #######  #####
+#     #    #    #     # #     # #     #    #    #     # #     # #       #     #
+#          #    #     # #     # #          #    #     # #     # #       #
+ #####     #    ######  #     # #          #    #     # ######  #####    #####
+      #    #    #   #   #     # #          #    #     # #   #   #             #
+#     #    #    #    #  #     # #     #    #    #     # #    #  #       #     #
+ #####     #    #     #  #####   #####     #     #####  #     # #######  #####
+******************************************************************************/
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+typedef enum {
+    MINMAXHEAP_GROW   = 0x22222222,
+    MINMAXHEAP_SHRINK = 0x55555555,
+} minmaxheap_resize_op_t;
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Reserve one 4k page worth of entries.
+ *
+ ****************************************************************************
+ */
+#define MINMAXHEAP_DEFAULT_ELEMS (4096 / sizeof(minmaxheap_entry_t))
+#define MINMAXHEAP_IDX_NONE      (SIZE_MAX)
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+typedef struct {
+    void    *p_data; /**< consumer datapointer */
+    size_t   bytes;  /**< data bytes for p_data */
+    int64_t  key;
+    size_t   idx;    /**< workspace index, MINMAXHEAP_IDX_NONE when not a member */
+} minmaxheap_node_t;
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Workspace entry, the key inline next to the node pointer.  Min and
+ *   max levels order in opposite directions, thus unlike adts_heap the
+ *   key is kept in its signed form.
+ *
+ ****************************************************************************
+ */
+typedef struct {
+    int64_t            key;
+    minmaxheap_node_t *p_node;
+} minmaxheap_entry_t;
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+typedef struct {
+    size_t              elems_curr;
+    size_t              elems_limit;
+    minmaxheap_entry_t *workspace;
+    adts_sanity_t       sanity;
+    adts_mem_t          mem;
+} minmaxheap_t;
+
+
+
+/******************************************************************************
+ * ####### #     # #     #  #####  #######   ###   ####### #     #  #####
+ * #       #     # ##    # #     #    #       #    #     # ##    # #     #
+ * #       #     # # #   # #          #       #    #     # # #   # #
+ * #####   #     # #  #  # #          #       #    #     # #  #  #  #####
+ * #       #     # #   # # #          #       #    #     # #   # #       #
+ * #       #     # #    ## #     #    #       #    #     # #    ## #     #
+ * #        #####  #     #  #####     #      ###   ####### #     #  #####
+******************************************************************************/
+
+/*
+ ****************************************************************************
+ * \details
+ *   Level of idx is log2(idx + 1), odd levels are max ordered.
+ *
+ ****************************************************************************
+ */
+static inline bool
+minmaxheap_is_max_level( size_t idx )
+{
+    return (bool) ((63 - __builtin_clzll((uint64_t) idx + 1)) & 1);
+} /* minmaxheap_is_max_level() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   True when key a belongs above key b on a level of the given order.
+ *   max is a constant at every call site, thus the select folds away.
+ *
+ ****************************************************************************
+ */
+static inline bool
+minmaxheap_before( bool    max,
+                   int64_t a,
+                   int64_t b )
+{
+    return max ? (a > b) : (a < b);
+} /* minmaxheap_before() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+static inline void
+minmaxheap_set( minmaxheap_entry_t *ws,
+                size_t              idx,
+                minmaxheap_entry_t  entry )
+{
+    ws[idx]           = entry;
+    entry.p_node->idx = idx;
+
+    return;
+} /* minmaxheap_set() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Resize the workspace, which must hold the current population.  The
+ *   workspace is unchanged on failure.
+ *
+ ****************************************************************************
+ */
+static int32_t
+minmaxheap_resize( minmaxheap_t           *p_mmh,
+                   minmaxheap_resize_op_t  op )
+{
+    size_t              limit_new = p_mmh->elems_limit;
+    int32_t             rc        = 0;
+    minmaxheap_entry_t *p_tmp     = NULL;
+
+    switch (op) {
+        case MINMAXHEAP_GROW:
+            limit_new *= 2;
+            break;
+        case MINMAXHEAP_SHRINK:
+            limit_new /= 2;
+            break;
+        default:
+            /* invalid op */
+            assert(0);
+    }
+
+    assert(limit_new >= p_mmh->elems_curr);
+
+    p_tmp = adts_mem_resize(&(p_mmh->mem), p_mmh->workspace,
+                            p_mmh->elems_limit * sizeof(*p_tmp),
+                            limit_new * sizeof(*p_tmp));
+    if (NULL == p_tmp) {
+        rc = ENOMEM;
+        goto exception;
+    }
+
+    p_mmh->workspace   = p_tmp;
+    p_mmh->elems_limit = limit_new;
+
+exception:
+    return rc;
+} /* minmaxheap_resize() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   As adts_heap, shrink once utilization falls to 25% beyond the default.
+ *
+ ****************************************************************************
+ */
+static inline bool
+minmaxheap_resize_shrink_candidate( minmaxheap_t *p_mmh )
+{
+    return ((MINMAXHEAP_DEFAULT_ELEMS < p_mmh->elems_limit) &&
+            (p_mmh->elems_curr < (p_mmh->elems_limit / 4)));
+} /* minmaxheap_resize_shrink_candidate() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Place entry at idx, or above along the chain of grandparents, which
+ *   are on levels of the same order.
+ *
+ ****************************************************************************
+ */
+static inline void
+minmaxheap_adjust_up( minmaxheap_t       *p_mmh,
+                      size_t              idx,
+                      minmaxheap_entry_t  entry,
+                      const bool          max )
+{
+    minmaxheap_entry_t *ws = p_mmh->workspace;
+
+    while (idx > 2) {
+        size_t gp = (idx - 3) >> 2;
+
+        if (false == minmaxheap_before(max, entry.key, ws[gp].key)) {
+            break;
+        }
+
+        minmaxheap_set(ws, idx, ws[gp]);
+        idx = gp;
+    }
+
+    minmaxheap_set(ws, idx, entry);
+
+    return;
+} /* minmaxheap_adjust_up() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Place entry at idx, or below.  The best of the up to two children and
+ *   four grandchildren moves up into the hole while it belongs above
+ *   entry.  A grandchild leaves entry between it and the intervening
+ *   child, which is of the opposite order, so entry trades places with
+ *   that child when it is out of order against it.
+ *
+ ****************************************************************************
+ */
+static inline void
+minmaxheap_adjust_down( minmaxheap_t       *p_mmh,
+                        size_t              idx,
+                        minmaxheap_entry_t  entry,
+                        const bool          max )
+{
+    minmaxheap_entry_t *ws    = p_mmh->workspace;
+    const size_t        elems = p_mmh->elems_curr;
+
+    for (;;) {
+        size_t child = (idx << 1) + 1;
+        size_t gc    = (child << 1) + 1;
+        size_t last  = 0;
+        size_t best  = child;
+
+        if (unlikely(child >= elems)) {
+            /* leaf */
+            break;
+        }
+
+        if (((child + 1) < elems) &&
+            minmaxheap_before(max, ws[child + 1].key, ws[child].key)) {
+            best = child + 1;
+        }
+
+        last = MIN(gc + 4, elems);
+        for (size_t c = gc; c < last; c++) {
+            /* select rather than branch, the outcome is unpredictable */
+            bool b = minmaxheap_before(max, ws[c].key, ws[best].key);
+
+            best = b ? c : best;
+        }
+
+        if (false == minmaxheap_before(max, ws[best].key, entry.key)) {
+            break;
+        }
+
+        minmaxheap_set(ws, idx, ws[best]);
+        idx = best;
+
+        if (best < gc) {
+            /* a child, which has no descendant beyond entry's bound */
+            break;
+        }
+
+        child = (best - 1) >> 1;
+        if (minmaxheap_before(max, ws[child].key, entry.key)) {
+            minmaxheap_entry_t tmp = ws[child];
+
+            minmaxheap_set(ws, child, entry);
+            entry = tmp;
+        }
+    }
+
+    minmaxheap_set(ws, idx, entry);
+
+    return;
+} /* minmaxheap_adjust_down() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Place entry at idx, a leaf for push, else the slot vacated by a pop,
+ *   removal or re-key, whose subtrees are valid.  With idx on a min level:
+ *     - entry greater than the parent, a max level, belongs on the max
+ *       chain above.  The parent drops into idx and is sifted down, it
+ *       is no less than anything below.
+ *     - entry less than the grandparent rises along the min chain, each
+ *       grandparent dropping is no greater than the subtree it enters.
+ *     - otherwise entry sifts down.
+ *   and conversely on a max level.
+ *
+ ****************************************************************************
+ */
+static inline void
+minmaxheap_place( minmaxheap_t       *p_mmh,
+                  size_t              idx,
+                  minmaxheap_entry_t  entry )
+{
+    minmaxheap_entry_t *ws  = p_mmh->workspace;
+    const bool          max = minmaxheap_is_max_level(idx);
+
+    if (likely(idx)) {
+        size_t parent = (idx - 1) >> 1;
+
+        if (minmaxheap_before(!max, entry.key, ws[parent].key)) {
+            minmaxheap_entry_t drop = ws[parent];
+
+            if (max) {
+                minmaxheap_adjust_up(p_mmh, parent, entry, false);
+                minmaxheap_adjust_down(p_mmh, idx, drop, true);
+            }else {
+                minmaxheap_adjust_up(p_mmh, parent, entry, true);
+                minmaxheap_adjust_down(p_mmh, idx, drop, false);
+            }
+            return;
+        }
+
+        if ((idx > 2) &&
+            minmaxheap_before(max, entry.key, ws[(idx - 3) >> 2].key)) {
+            if (max) {
+                minmaxheap_adjust_up(p_mmh, idx, entry, true);
+            }else {
+                minmaxheap_adjust_up(p_mmh, idx, entry, false);
+            }
+            return;
+        }
+    }
+
+    if (max) {
+        minmaxheap_adjust_down(p_mmh, idx, entry, true);
+    }else {
+        minmaxheap_adjust_down(p_mmh, idx, entry, false);
+    }
+
+    return;
+} /* minmaxheap_place() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Remove the entry at idx, the last entry fills the vacated slot.
+ *
+ ****************************************************************************
+ */
+static inline minmaxheap_node_t *
+minmaxheap_remove_idx( minmaxheap_t *p_mmh,
+                       size_t        idx )
+{
+    size_t             last   = 0;
+    minmaxheap_node_t *p_node = NULL;
+
+    if (minmaxheap_resize_shrink_candidate(p_mmh)) {
+        /* Do not error out.  Try again on next removal */
+        (void) minmaxheap_resize(p_mmh, MINMAXHEAP_SHRINK);
+    }
+
+    p_node      = p_mmh->workspace[idx].p_node;
+    p_node->idx = MINMAXHEAP_IDX_NONE;
+    last        = --p_mmh->elems_curr;
+
+    if (idx != last) {
+        minmaxheap_place(p_mmh, idx, p_mmh->workspace[last]);
+    }
+
+    return p_node;
+} /* minmaxheap_remove_idx() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Index of the greatest key, the root or one of its children.
+ *
+ ****************************************************************************
+ */
+static inline size_t
+minmaxheap_max_idx( minmaxheap_t *p_mmh )
+{
+    const minmaxheap_entry_t *ws = p_mmh->workspace;
+
+    switch (p_mmh->elems_curr) {
+        case 1:
+            return 0;
+        case 2:
+            return 1;
+        default:
+            return (ws[2].key > ws[1].key) ? 2 : 1;
+    }
+} /* minmaxheap_max_idx() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   A node is a member when its recorded index refers back to it.
+ *
+ ****************************************************************************
+ */
+static inline bool
+minmaxheap_node_is_member( minmaxheap_t      *p_mmh,
+                           minmaxheap_node_t *p_node )
+{
+    size_t idx = p_node->idx;
+
+    return ((idx < p_mmh->elems_curr) &&
+            (p_mmh->workspace[idx].p_node == p_node));
+} /* minmaxheap_node_is_member() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+int32_t
+adts_minmaxheap_push( adts_minmaxheap_t      *p_adts_minmaxheap,
+                      adts_minmaxheap_node_t *p_adts_node,
+                      void                   *p_data,
+                      size_t                  bytes,
+                      int64_t                 key )
+{
+    int32_t             rc     = 0;
+    minmaxheap_t       *p_mmh  = (minmaxheap_t *) p_adts_minmaxheap;
+    minmaxheap_node_t  *p_node = (minmaxheap_node_t *) p_adts_node;
+    minmaxheap_entry_t  entry  = {0};
+
+    adts_sanity_entry(&(p_mmh->sanity));
+
+    /* Key not validated. Duplicates and 0 value allowed */
+    assert(p_node);
+    assert(p_data);
+    assert(bytes);
+
+    if (unlikely(p_mmh->elems_curr == p_mmh->elems_limit)) {
+        rc = minmaxheap_resize(p_mmh, MINMAXHEAP_GROW);
+        if (rc) {
+            goto exception;
+        }
+    }
+
+    p_node->p_data = p_data;
+    p_node->bytes  = bytes;
+    p_node->key    = key;
+
+    entry.key    = key;
+    entry.p_node = p_node;
+    minmaxheap_place(p_mmh, p_mmh->elems_curr++, entry);
+
+exception:
+    adts_sanity_exit(&(p_mmh->sanity));
+    return rc;
+} /* adts_minmaxheap_push() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+int32_t
+adts_minmaxheap_update_key( adts_minmaxheap_t      *p_adts_minmaxheap,
+                            adts_minmaxheap_node_t *p_adts_node,
+                            int64_t                 key )
+{
+    int32_t             rc     = 0;
+    minmaxheap_t       *p_mmh  = (minmaxheap_t *) p_adts_minmaxheap;
+    minmaxheap_node_t  *p_node = (minmaxheap_node_t *) p_adts_node;
+    minmaxheap_entry_t  entry  = {0};
+
+    adts_sanity_entry(&(p_mmh->sanity));
+
+    assert(p_node);
+
+    if (unlikely(false == minmaxheap_node_is_member(p_mmh, p_node))) {
+        rc = EINVAL;
+        goto exception;
+    }
+
+    p_node->key  = key;
+    entry.key    = key;
+    entry.p_node = p_node;
+    minmaxheap_place(p_mmh, p_node->idx, entry);
+
+exception:
+    adts_sanity_exit(&(p_mmh->sanity));
+    return rc;
+} /* adts_minmaxheap_update_key() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+int32_t
+adts_minmaxheap_remove( adts_minmaxheap_t      *p_adts_minmaxheap,
+                        adts_minmaxheap_node_t *p_adts_node )
+{
+    int32_t            rc     = 0;
+    minmaxheap_t      *p_mmh  = (minmaxheap_t *) p_adts_minmaxheap;
+    minmaxheap_node_t *p_node = (minmaxheap_node_t *) p_adts_node;
+
+    adts_sanity_entry(&(p_mmh->sanity));
+
+    assert(p_node);
+
+    if (unlikely(false == minmaxheap_node_is_member(p_mmh, p_node))) {
+        rc = EINVAL;
+        goto exception;
+    }
+
+    (void) minmaxheap_remove_idx(p_mmh, p_node->idx);
+
+exception:
+    adts_sanity_exit(&(p_mmh->sanity));
+    return rc;
+} /* adts_minmaxheap_remove() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+adts_minmaxheap_node_t *
+adts_minmaxheap_peek_min( adts_minmaxheap_t *p_adts_minmaxheap )
+{
+    minmaxheap_t      *p_mmh  = (minmaxheap_t *) p_adts_minmaxheap;
+    minmaxheap_node_t *p_node = NULL;
+
+    if (likely(p_mmh->elems_curr)) {
+        p_node = p_mmh->workspace[0].p_node;
+    }
+
+    return (adts_minmaxheap_node_t *) p_node;
+} /* adts_minmaxheap_peek_min() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+adts_minmaxheap_node_t *
+adts_minmaxheap_peek_max( adts_minmaxheap_t *p_adts_minmaxheap )
+{
+    minmaxheap_t      *p_mmh  = (minmaxheap_t *) p_adts_minmaxheap;
+    minmaxheap_node_t *p_node = NULL;
+
+    if (likely(p_mmh->elems_curr)) {
+        p_node = p_mmh->workspace[minmaxheap_max_idx(p_mmh)].p_node;
+    }
+
+    return (adts_minmaxheap_node_t *) p_node;
+} /* adts_minmaxheap_peek_max() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+adts_minmaxheap_node_t *
+adts_minmaxheap_pop_min( adts_minmaxheap_t *p_adts_minmaxheap )
+{
+    minmaxheap_t      *p_mmh  = (minmaxheap_t *) p_adts_minmaxheap;
+    minmaxheap_node_t *p_node = NULL;
+
+    adts_sanity_entry(&(p_mmh->sanity));
+
+    if (likely(p_mmh->elems_curr)) {
+        p_node = minmaxheap_remove_idx(p_mmh, 0);
+    }
+
+    adts_sanity_exit(&(p_mmh->sanity));
+
+    return (adts_minmaxheap_node_t *) p_node;
+} /* adts_minmaxheap_pop_min() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+adts_minmaxheap_node_t *
+adts_minmaxheap_pop_max( adts_minmaxheap_t *p_adts_minmaxheap )
+{
+    minmaxheap_t      *p_mmh  = (minmaxheap_t *) p_adts_minmaxheap;
+    minmaxheap_node_t *p_node = NULL;
+
+    adts_sanity_entry(&(p_mmh->sanity));
+
+    if (likely(p_mmh->elems_curr)) {
+        p_node = minmaxheap_remove_idx(p_mmh, minmaxheap_max_idx(p_mmh));
+    }
+
+    adts_sanity_exit(&(p_mmh->sanity));
+
+    return (adts_minmaxheap_node_t *) p_node;
+} /* adts_minmaxheap_pop_max() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+bool
+adts_minmaxheap_is_empty( adts_minmaxheap_t *p_adts_minmaxheap )
+{
+    minmaxheap_t *p_mmh = (minmaxheap_t *) p_adts_minmaxheap;
+
+    return (0 == p_mmh->elems_curr);
+} /* adts_minmaxheap_is_empty() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+size_t
+adts_minmaxheap_entries( adts_minmaxheap_t *p_adts_minmaxheap )
+{
+    minmaxheap_t *p_mmh = (minmaxheap_t *) p_adts_minmaxheap;
+
+    return p_mmh->elems_curr;
+} /* adts_minmaxheap_entries() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_minmaxheap_mem_usage( adts_minmaxheap_t *p_adts_minmaxheap,
+                           adts_mem_stats_t  *p_out )
+{
+    minmaxheap_t *p_mmh = (minmaxheap_t *) p_adts_minmaxheap;
+
+    adts_mem_usage(&(p_mmh->mem), p_out);
+
+    return;
+} /* adts_minmaxheap_mem_usage() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Remaining nodes belong to the consumer and are abandoned.
+ *
+ ****************************************************************************
+ */
+void
+adts_minmaxheap_destroy( adts_minmaxheap_t *p_adts_minmaxheap )
+{
+    minmaxheap_t *p_mmh = (minmaxheap_t *) p_adts_minmaxheap;
+    adts_mem_t    mem   = p_mmh->mem;
+
+    adts_sanity_entry(&(p_mmh->sanity));
+
+    adts_mem_put(&(mem), p_mmh->workspace,
+                 p_mmh->elems_limit * sizeof(minmaxheap_entry_t));
+    adts_mem_put(&(mem), p_adts_minmaxheap, sizeof(*p_adts_minmaxheap));
+
+    /* No adts_sanity_exit() since we've freed the memory */
+
+    return;
+} /* adts_minmaxheap_destroy() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+adts_minmaxheap_t *
+adts_minmaxheap_create( void )
+{
+    adts_minmaxheap_create_t op = {0};
+
+    return adts_minmaxheap_create_ext(&(op));
+} /* adts_minmaxheap_create() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+adts_minmaxheap_t *
+adts_minmaxheap_create_ext( const adts_minmaxheap_create_t *p_op )
+{
+    size_t              elems             = MINMAXHEAP_DEFAULT_ELEMS;
+    minmaxheap_t       *p_mmh             = NULL;
+    adts_mem_t          mem               = {0};
+    minmaxheap_entry_t *p_ws              = NULL;
+    adts_minmaxheap_t  *p_adts_minmaxheap = NULL;
+
+    assert(p_op);
+
+    adts_mem_init_ext(&(mem), ADTS_MEM_TYPE_MINMAXHEAP, p_op->p_allocator);
+
+    p_adts_minmaxheap = adts_mem_get(&(mem), sizeof(*p_adts_minmaxheap));
+    if (NULL == p_adts_minmaxheap) {
+        goto exception;
+    }
+
+    p_ws = adts_mem_get(&(mem), elems * sizeof(*p_ws));
+    if (NULL == p_ws) {
+        adts_mem_put(&(mem), p_adts_minmaxheap, sizeof(*p_adts_minmaxheap));
+        p_adts_minmaxheap = NULL;
+        goto exception;
+    }
+
+    p_mmh              = (minmaxheap_t *) p_adts_minmaxheap;
+    p_mmh->workspace   = p_ws;
+    p_mmh->elems_limit = elems;
+    p_mmh->mem         = mem;
+
+exception:
+    return p_adts_minmaxheap;
+} /* adts_minmaxheap_create_ext() */
+
+
+/******************************************************************************
+ * #     # #     #   ###   ####### ####### #######  #####  #######  #####
+ * #     # ##    #    #       #       #    #       #     #    #    #     #
+ * #     # # #   #    #       #       #    #       #          #    #
+ * #     # #  #  #    #       #       #    #####    #####     #     #####
+ * #     # #   # #    #       #       #    #             #    #          #
+ * #     # #    ##    #       #       #    #       #     #    #    #     #
+ *  #####  #     #   ###      #       #    #######  #####     #     #####
+******************************************************************************/
+
+/**
+ **************************************************************************
+ * \brief
+ *   Compile time structure sanity
+ *
+ * \details
+ *   Sanitize the abstract data type interface.  Enforced in header file so
+ *   as to catch improper usage/include by unauthorized callers.
+ *
+ **************************************************************************
+ */
+static void
+utest_minmaxheap_bytes( void )
+{
+    CDISPLAY("[%u]", sizeof(minmaxheap_t));
+    CDISPLAY("[%u]", sizeof(adts_minmaxheap_t));
+    CDISPLAY("[%u]", sizeof(minmaxheap_node_t));
+    CDISPLAY("[%u]", sizeof(adts_minmaxheap_node_t));
+
+    _Static_assert(sizeof(minmaxheap_t) <= sizeof(adts_minmaxheap_t),
+        "Mismatch structs detected");
+    _Static_assert(sizeof(minmaxheap_node_t) <= sizeof(adts_minmaxheap_node_t),
+        "Mismatch structs detected");
+    _Static_assert(offsetof(minmaxheap_node_t, key) ==
+                   offsetof(adts_minmaxheap_node_public_t, key),
+        "Mismatch structs detected");
+
+    return;
+} /* utest_minmaxheap_bytes() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Small PRNG for key generation, xorshift64.
+ *
+ ****************************************************************************
+ */
+static inline uint64_t
+utest_minmaxheap_rand( uint64_t *p_state )
+{
+    uint64_t x = *p_state;
+
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *p_state = x;
+
+    return x;
+} /* utest_minmaxheap_rand() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Every entry against its parent and grandparent, which by transitivity
+ *   covers every ancestor, and every node's recorded index.
+ *
+ ****************************************************************************
+ */
+static void
+utest_minmaxheap_verify( adts_minmaxheap_t *p_adts_minmaxheap )
+{
+    minmaxheap_t       *p_mmh = (minmaxheap_t *) p_adts_minmaxheap;
+    minmaxheap_entry_t *ws    = p_mmh->workspace;
+
+    for (size_t idx = 0; idx < p_mmh->elems_curr; idx++) {
+        bool max = minmaxheap_is_max_level(idx);
+
+        assert(ws[idx].p_node->idx == idx);
+        assert(ws[idx].p_node->key == ws[idx].key);
+
+        if (idx) {
+            assert(false == minmaxheap_before(!max, ws[idx].key,
+                                              ws[(idx - 1) >> 1].key));
+        }
+        if (idx > 2) {
+            assert(false == minmaxheap_before(max, ws[idx].key,
+                                              ws[(idx - 3) >> 2].key));
+        }
+    }
+
+    return;
+} /* utest_minmaxheap_verify() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Random push, pop min, pop max, re-key and removal against a key count
+ *   table, both ends compared after every operation, duplicates frequent.
+ *
+ ****************************************************************************
+ */
+#define UTEST_MINMAXHEAP_NODES (4096)
+#define UTEST_MINMAXHEAP_KEYS  (1024)
+
+static void
+utest_minmaxheap_trace( void )
+{
+    uint64_t                 seed    = 0x9e3779b97f4a7c15ULL;
+    size_t                   live    = 0;
+    size_t                  *p_count = NULL;
+    adts_minmaxheap_t       *p_mmh   = NULL;
+    adts_minmaxheap_node_t  *p_node  = NULL;
+    adts_minmaxheap_node_t  *p_out   = NULL;
+    bool                    *p_in    = NULL;
+
+    p_count = calloc(UTEST_MINMAXHEAP_KEYS, sizeof(*p_count));
+    p_node  = calloc(UTEST_MINMAXHEAP_NODES, sizeof(*p_node));
+    p_in    = calloc(UTEST_MINMAXHEAP_NODES, sizeof(*p_in));
+    p_mmh   = adts_minmaxheap_create();
+    assert(p_count && p_node && p_in && p_mmh);
+
+    assert(NULL == adts_minmaxheap_pop_min(p_mmh));
+    assert(NULL == adts_minmaxheap_peek_max(p_mmh));
+
+    for (size_t op = 0; op < (64 * UTEST_MINMAXHEAP_NODES); op++) {
+        uint64_t r   = utest_minmaxheap_rand(&(seed));
+        size_t   idx = (size_t) (utest_minmaxheap_rand(&(seed)) % UTEST_MINMAXHEAP_NODES);
+        int64_t  key = (int64_t) (utest_minmaxheap_rand(&(seed)) % UTEST_MINMAXHEAP_KEYS);
+        int64_t  lo  = 0;
+        int64_t  hi  = UTEST_MINMAXHEAP_KEYS - 1;
+
+        /* population drifts between empty and full over the run */
+        switch ((r >> 8) % (((op >> 14) & 1) ? 6 : 8)) {
+            case 0:
+            case 1:
+            case 6:
+            case 7:
+                if (p_in[idx]) {
+                    p_count[p_node[idx].pub.key]--;
+                    assert(0 == adts_minmaxheap_update_key(p_mmh, &(p_node[idx]), key));
+                }else {
+                    assert(0 == adts_minmaxheap_push(p_mmh, &(p_node[idx]), &(p_node[idx]), 1, key));
+                    p_in[idx] = true;
+                    live++;
+                }
+                assert(p_node[idx].pub.key == key);
+                p_count[key]++;
+                break;
+            case 2:
+            case 3:
+                p_out = (r & 1) ? adts_minmaxheap_pop_max(p_mmh) :
+                                  adts_minmaxheap_pop_min(p_mmh);
+                if (0 == live) {
+                    assert(NULL == p_out);
+                    break;
+                }
+                while (0 == p_count[lo]) {
+                    lo++;
+                }
+                while (0 == p_count[hi]) {
+                    hi--;
+                }
+                assert(p_out->pub.key == ((r & 1) ? hi : lo));
+                p_count[p_out->pub.key]--;
+                p_in[(adts_minmaxheap_node_t *) p_out->pub.p_data - p_node] = false;
+                live--;
+                break;
+            default:
+                if (p_in[idx]) {
+                    assert(0 == adts_minmaxheap_remove(p_mmh, &(p_node[idx])));
+                    p_count[p_node[idx].pub.key]--;
+                    p_in[idx] = false;
+                    live--;
+                }
+                assert(EINVAL == adts_minmaxheap_remove(p_mmh, &(p_node[idx])));
+                assert(EINVAL == adts_minmaxheap_update_key(p_mmh, &(p_node[idx]), key));
+                break;
+        }
+
+        assert(live == adts_minmaxheap_entries(p_mmh));
+        if (0 == (op & 0x3ff)) {
+            utest_minmaxheap_verify(p_mmh);
+        }
+    }
+
+    utest_minmaxheap_verify(p_mmh);
+
+    /* drain from both ends */
+    {
+        int64_t lo = INT64_MIN;
+        int64_t hi = INT64_MAX;
+
+        while (false == adts_minmaxheap_is_empty(p_mmh)) {
+            int64_t min = adts_minmaxheap_peek_min(p_mmh)->pub.key;
+            int64_t max = adts_minmaxheap_peek_max(p_mmh)->pub.key;
+
+            assert((lo <= min) && (min <= max) && (max <= hi));
+            assert(min == adts_minmaxheap_pop_min(p_mmh)->pub.key);
+            if (adts_minmaxheap_is_empty(p_mmh)) {
+                break;
+            }
+            assert(max == adts_minmaxheap_pop_max(p_mmh)->pub.key);
+            lo = min;
+            hi = max;
+        }
+    }
+
+    adts_minmaxheap_destroy(p_mmh);
+    free(p_in);
+    free(p_node);
+    free(p_count);
+
+    return;
+} /* utest_minmaxheap_trace() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Sliding window scheduler item, as kept by the two heap alternative:
+ *   a min heap and a max heap node per item, the twin removed by handle
+ *   whenever either end is popped.
+ *
+ ****************************************************************************
+ */
+typedef struct {
+    adts_heap_node_t       lo;
+    adts_heap_node_t       hi;
+    adts_minmaxheap_node_t mm;
+} utest_minmaxheap_item_t;
+
+#ifndef UTEST_MINMAXHEAP_RATE_ELEMS_MIN
+#define UTEST_MINMAXHEAP_RATE_ELEMS_MIN (1000)
+#endif
+
+#ifndef UTEST_MINMAXHEAP_RATE_ELEMS_MAX
+#define UTEST_MINMAXHEAP_RATE_ELEMS_MAX (1000000)
+#endif
+
+#ifndef UTEST_MINMAXHEAP_RATE_OPS
+#define UTEST_MINMAXHEAP_RATE_OPS (1 << 21)
+#endif
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Steady population of n, each operation pops the min or the max end,
+ *   alternately, and pushes the popped item back with a fresh key.  Both
+ *   approaches see the same key sequence and must agree on every pop.
+ *   Reports ns per operation and workspace bytes at the end.
+ *
+ ****************************************************************************
+ */
+static void
+utest_minmaxheap_rate( void )
+{
+    utest_minmaxheap_item_t *p_item = NULL;
+
+    p_item = calloc(UTEST_MINMAXHEAP_RATE_ELEMS_MAX, sizeof(*p_item));
+    assert(p_item);
+
+    for (size_t elems = UTEST_MINMAXHEAP_RATE_ELEMS_MIN;
+         elems <= UTEST_MINMAXHEAP_RATE_ELEMS_MAX;
+         elems *= 10) {
+        uint64_t           ns[ 2 ]    = {0};
+        uint64_t           sum[ 2 ]   = {0};
+        adts_mem_stats_t   stats[ 3 ] = {{0}};
+        adts_heap_t       *p_lo       = adts_heap_create(ADTS_HEAP_MIN);
+        adts_heap_t       *p_hi       = adts_heap_create(ADTS_HEAP_MAX);
+        adts_minmaxheap_t *p_mmh      = adts_minmaxheap_create();
+
+        assert(p_lo && p_hi && p_mmh);
+
+        for (uint32_t mm = 0; mm < 2; mm++) {
+            uint64_t seed  = 0x2545f4914f6cdd1dULL;
+            uint64_t start = 0;
+
+            for (size_t idx = 0; idx < elems; idx++) {
+                utest_minmaxheap_item_t *p   = &(p_item[idx]);
+                int64_t                  key = (int64_t) (utest_minmaxheap_rand(&(seed)) >> 2);
+
+                if (mm) {
+                    (void) adts_minmaxheap_push(p_mmh, &(p->mm), p, 1, key);
+                }else {
+                    (void) adts_heap_push(p_lo, &(p->lo), p, 1, key);
+                    (void) adts_heap_push(p_hi, &(p->hi), p, 1, key);
+                }
+            }
+
+            start = adts_tstamp();
+            for (size_t op = 0; op < UTEST_MINMAXHEAP_RATE_OPS; op++) {
+                utest_minmaxheap_item_t *p   = NULL;
+                int64_t                  key = (int64_t) (utest_minmaxheap_rand(&(seed)) >> 2);
+
+                if (mm) {
+                    adts_minmaxheap_node_t *p_node = (op & 1) ?
+                                                     adts_minmaxheap_pop_max(p_mmh) :
+                                                     adts_minmaxheap_pop_min(p_mmh);
+
+                    p = p_node->pub.p_data;
+                    sum[mm] += (uint64_t) p_node->pub.key;
+                    (void) adts_minmaxheap_push(p_mmh, &(p->mm), p, 1, key);
+                }else {
+                    adts_heap_node_t *p_node = NULL;
+
+                    if (op & 1) {
+                        p_node = adts_heap_pop(p_hi);
+                        p      = p_node->pub.p_data;
+                        (void) adts_heap_remove(p_lo, &(p->lo));
+                    }else {
+                        p_node = adts_heap_pop(p_lo);
+                        p      = p_node->pub.p_data;
+                        (void) adts_heap_remove(p_hi, &(p->hi));
+                    }
+                    sum[mm] += (uint64_t) p_node->pub.key;
+                    (void) adts_heap_push(p_lo, &(p->lo), p, 1, key);
+                    (void) adts_heap_push(p_hi, &(p->hi), p, 1, key);
+                }
+            }
+            ns[mm] = adts_tstamp() - start;
+        }
+
+        assert(sum[0] == sum[1]);
+        utest_minmaxheap_verify(p_mmh);
+
+        adts_heap_mem_usage(p_lo, &(stats[0]));
+        adts_heap_mem_usage(p_hi, &(stats[1]));
+        adts_minmaxheap_mem_usage(p_mmh, &(stats[2]));
+
+        CDISPLAY("elems: %8zu  ns/op: %7.2f / %7.2f  workspace: %10zu / %10zu bytes  node: %zu / %zu bytes  (two heaps / minmaxheap)",
+                 elems,
+                 (double) ns[0] / (double) UTEST_MINMAXHEAP_RATE_OPS,
+                 (double) ns[1] / (double) UTEST_MINMAXHEAP_RATE_OPS,
+                 stats[0].bytes_curr + stats[1].bytes_curr,
+                 stats[2].bytes_curr,
+                 2 * sizeof(adts_heap_node_t),
+                 sizeof(adts_minmaxheap_node_t));
+
+        adts_minmaxheap_destroy(p_mmh);
+        adts_heap_destroy(p_hi);
+        adts_heap_destroy(p_lo);
+    }
+
+    free(p_item);
+
+    return;
+} /* utest_minmaxheap_rate() */
+
+
+/*
+ ****************************************************************************
+ * test entrypoint
+ *
+ ****************************************************************************
+ */
+void
+utest_adts_minmaxheap( void )
+{
+    utest_minmaxheap_bytes();
+    utest_minmaxheap_trace();
+    utest_minmaxheap_rate();
+
+    return;
+} /* utest_adts_minmaxheap() */
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <adts_memory.h>
+
+
+/******************************************************************************
+ #####  ####### ######  #     #  #####  ####### #     # ######  #######  #####
+#     #    #    #     # #     # #     #    #    #     # #     # #       #     #
+#          #    #     # #     # #          #    #     # #     # #       #
+ #####     #    ######  #     # #          #    #     # ######  #####    #####
+      #    #    #   #   #     # #          #    #     # #   #   #             #
+#     #    #    #    #  #     # #     #    #    #     # #    #  #       #     #
+ #####     #    #     #  #####   #####     #     #####  #     # #######  #####
+******************************************************************************/
+
+/**
+ **************************************************************************
+ * \details
+ *   Double ended priority queue of consumer owned nodes (min-max heap).
+ *   A single binary heap array whose even levels, the root included, are
+ *   min ordered and whose odd levels are max ordered.  The least key is
+ *   the root and the greatest is one of its two children, thus both ends
+ *   are peeked in O(1) and popped, pushed, re-keyed or removed in
+ *   O(log n).
+ *
+ *   Keys are held inline in the workspace alongside the node pointer, as
+ *   for adts_heap, thus sifting does not touch consumer nodes.
+ *
+ *   ADTS consumer is responsible for serialization.
+ *
+ **************************************************************************
+ */
+#define ADTS_MINMAXHEAP_BYTES      (128)
+#define ADTS_MINMAXHEAP_NODE_BYTES (32)
+
+typedef struct {
+    const char reserved[ ADTS_MINMAXHEAP_BYTES ];
+} adts_minmaxheap_t;
+
+typedef struct {
+    void    *p_data;
+    size_t   bytes;
+    int64_t  key;
+} adts_minmaxheap_node_public_t;
+
+typedef union {
+    const char                          reserved[ ADTS_MINMAXHEAP_NODE_BYTES ];
+    const adts_minmaxheap_node_public_t pub; /**< read only */
+} adts_minmaxheap_node_t;
+
+
+/**
+ **************************************************************************
+ * \details
+ *   minmaxheap create options
+ *
+ **************************************************************************
+ */
+typedef struct {
+    const adts_allocator_t *p_allocator; /**< NULL selects the default */
+} adts_minmaxheap_create_t;
+
+
+
+/******************************************************************************
+ #####   #####    ####    #####   ####    #####   #   #  #####   ######   ####
+ #    #  #    #  #    #     #    #    #     #      # #   #    #  #       #
+ #    #  #    #  #    #     #    #    #     #       #    #    #  #####    ####
+ #####   #####   #    #     #    #    #     #       #    #####   #            #
+ #       #   #   #    #     #    #    #     #       #    #       #       #    #
+ #       #    #   ####      #     ####      #       #    #       ######   ####
+*******************************************************************************/
+
+/**
+ **************************************************************************
+ * \brief
+ *   Queue services
+ *
+ * \details
+ *   - adts_minmaxheap_push()          ENOMEM when the workspace fails to
+ *                                     grow, the heap is then unchanged
+ *   - adts_minmaxheap_update_key()    EINVAL when not a member, the key may
+ *                                     move either way
+ *   - adts_minmaxheap_remove()        EINVAL when not a member
+ *   - adts_minmaxheap_peek_min()/max() least/greatest key, NULL when empty.
+ *                                     Equal keys are returned in no
+ *                                     particular order.
+ *   - adts_minmaxheap_pop_min()/max() as peek, the node is removed
+ *
+ **************************************************************************
+ */
+int32_t
+adts_minmaxheap_push( adts_minmaxheap_t      *p_adts_minmaxheap,
+                      adts_minmaxheap_node_t *p_adts_node,
+                      void                   *p_data,
+                      size_t                  bytes,
+                      int64_t                 key );
+
+int32_t
+adts_minmaxheap_update_key( adts_minmaxheap_t      *p_adts_minmaxheap,
+                            adts_minmaxheap_node_t *p_adts_node,
+                            int64_t                 key );
+
+int32_t
+adts_minmaxheap_remove( adts_minmaxheap_t      *p_adts_minmaxheap,
+                        adts_minmaxheap_node_t *p_adts_node );
+
+adts_minmaxheap_node_t *
+adts_minmaxheap_peek_min( adts_minmaxheap_t *p_adts_minmaxheap );
+
+adts_minmaxheap_node_t *
+adts_minmaxheap_peek_max( adts_minmaxheap_t *p_adts_minmaxheap );
+
+adts_minmaxheap_node_t *
+adts_minmaxheap_pop_min( adts_minmaxheap_t *p_adts_minmaxheap );
+
+adts_minmaxheap_node_t *
+adts_minmaxheap_pop_max( adts_minmaxheap_t *p_adts_minmaxheap );
+
+bool
+adts_minmaxheap_is_empty( adts_minmaxheap_t *p_adts_minmaxheap );
+
+size_t
+adts_minmaxheap_entries( adts_minmaxheap_t *p_adts_minmaxheap );
+
+void
+adts_minmaxheap_mem_usage( adts_minmaxheap_t *p_adts_minmaxheap,
+                           adts_mem_stats_t  *p_out );
+
+void
+adts_minmaxheap_destroy( adts_minmaxheap_t *p_adts_minmaxheap );
+
+adts_minmaxheap_t *
+adts_minmaxheap_create( void );
+
+adts_minmaxheap_t *
+adts_minmaxheap_create_ext( const adts_minmaxheap_create_t *p_op );
+
+
+/**
+ **************************************************************************
+ * \details
+ *   Unit Test prototypes
+ *
+ **************************************************************************
+ */
+void
+utest_adts_minmaxheap( void );
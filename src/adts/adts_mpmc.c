@@ -0,0 +1,853 @@
+#include <sched.h>
+#include <errno.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <inttypes.h>
+
+/* Toolbox */
+#include <adts_math.h>
+#include <adts_mpmc.h>
+#include <adts_time.h>
+#include <adts_wait.h>
+#include <adts_memory.h>
+#include <adts_private.h>
+#include <adts_display.h>
+
+
+/******************************************************************************
+ #####  ####### ######  #     #  #####  ####### #     # ######  #######  #####
+#     #    #    #     # #     # #     #    #    #     # #     # #       #     #
+#          #    #     # #     # #          #    #     # #     # #       #
+ #####     #    ######  #     # #          #    #     # ######  #####    #####
+      #    #    #   #   #     # #          #    #     # #   #   #             #
+#     #    #    #    #  #     # #     #    #    #     # #    #  #       #     #
+ #####     #    #     #  #####   #####     #     #####  #     # #######  #####
+******************************************************************************/
+
+/*
+ ****************************************************************************
+ * \details
+ *   Slot sequence protocol for position pos, i.e. the slot at pos & mask:
+ *   - seq == pos            free, a producer may claim pos
+ *   - seq == pos + 1        full, a consumer may claim pos
+ *   - seq == pos + slots    free for the producer of the next lap
+ *
+ ****************************************************************************
+ */
+typedef struct {
+    size_t  seq;
+    void   *p_data;
+} mpmc_slot_t;
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Spin rounds of adts_mpmc_enqueue_wait() before each yield of the cpu.
+ *
+ ****************************************************************************
+ */
+#define MPMC_SPIN_BUDGET (128)
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Contention counters, one cacheline stripe per thread slot.  A thread
+ *   takes a slot on first use, threads beyond MPMC_STAT_STRIPES share.
+ *   Updates are plain relaxed load / store, never a locked instruction,
+ *   thus an increment racing a thread sharing the stripe may be lost.
+ *
+ ****************************************************************************
+ */
+#define MPMC_STAT_STRIPES (16)
+
+typedef struct {
+    size_t enqueue_retries;
+    size_t dequeue_retries;
+    size_t full;
+    size_t empty;
+    size_t waits;
+} ADTS_CACHELINE_ALIGN mpmc_stat_t;
+
+static uint32_t          mpmc_stat_next;
+static __thread uint32_t mpmc_stat_slot;
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Four cache lines:
+ *   - ring:  written at create / destroy only
+ *   - prod:  producer claim index
+ *   - cons:  consumer claim index
+ *   - wait:  consumer park / producer wake, written only while parking
+ *
+ *   The counters are kept apart, see mpmc_stat_t, such that the CAS'd
+ *   index lines carry no other read-modify-write traffic.
+ *
+ ****************************************************************************
+ */
+typedef struct {
+    struct {
+        mpmc_slot_t *p_slots;
+        size_t       slots;
+        size_t       mask;
+        void        *p_stat_raw; /**< stripes, plus alignment slack */
+        adts_mem_t   mem;
+    } ADTS_CACHELINE_ALIGN ring;
+
+    struct {
+        size_t       tail;
+    } ADTS_CACHELINE_ALIGN prod;
+
+    struct {
+        size_t       head;
+    } ADTS_CACHELINE_ALIGN cons;
+
+    adts_wait_t      ADTS_CACHELINE_ALIGN wait;
+} mpmc_t;
+
+
+/******************************************************************************
+ * ####### #     # #     #  #####  #######   ###   ####### #     #  #####
+ * #       #     # ##    # #     #    #       #    #     # ##    # #     #
+ * #       #     # # #   # #          #       #    #     # # #   # #
+ * #####   #     # #  #  # #          #       #    #     # #  #  #  #####
+ * #       #     # #   # # #          #       #    #     # #   # #       #
+ * #       #     # #    ## #     #    #       #    #     # #    ## #     #
+ * #        #####  #     #  #####     #      ###   ####### #     #  #####
+******************************************************************************/
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+static inline size_t
+mpmc_stat_bytes( void )
+{
+    return (MPMC_STAT_STRIPES * sizeof(mpmc_stat_t)) + ADTS_CACHELINE_BYTES;
+} /* mpmc_stat_bytes() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   First stripe, cacheline aligned within the allocation.
+ *
+ ****************************************************************************
+ */
+static inline mpmc_stat_t *
+mpmc_stat_stripes( const mpmc_t *p_mpmc )
+{
+    uintptr_t raw = (uintptr_t) p_mpmc->ring.p_stat_raw;
+
+    return (mpmc_stat_t *) ((raw + ADTS_CACHELINE_BYTES - 1) &
+                            ~((uintptr_t) ADTS_CACHELINE_BYTES - 1));
+} /* mpmc_stat_stripes() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   The calling thread's stripe, slots are numbered from 1 so that 0
+ *   marks a thread yet to take one.
+ *
+ ****************************************************************************
+ */
+static inline mpmc_stat_t *
+mpmc_stat( const mpmc_t *p_mpmc )
+{
+    if (unlikely(0 == mpmc_stat_slot)) {
+        mpmc_stat_slot = __atomic_add_fetch(&(mpmc_stat_next), 1,
+                                            __ATOMIC_RELAXED);
+    }
+
+    return &(mpmc_stat_stripes(p_mpmc)[(mpmc_stat_slot - 1) &
+                                       (MPMC_STAT_STRIPES - 1)]);
+} /* mpmc_stat() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+static inline void
+mpmc_count( size_t *p_counter )
+{
+    __atomic_store_n(p_counter,
+                     __atomic_load_n(p_counter, __ATOMIC_RELAXED) + 1,
+                     __ATOMIC_RELAXED);
+
+    return;
+} /* mpmc_count() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Backoff between attempts of the _wait variants.
+ *
+ ****************************************************************************
+ */
+static inline void
+mpmc_backoff( mpmc_t *p_mpmc )
+{
+    for (int32_t idx = 0; idx < MPMC_SPIN_BUDGET; idx++) {
+        adts_cpu_pause();
+    }
+
+    mpmc_count(&(mpmc_stat(p_mpmc)->waits));
+    sched_yield();
+
+    return;
+} /* mpmc_backoff() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+int32_t
+adts_mpmc_enqueue( adts_mpmc_t *p_adts_mpmc,
+                   void        *p_data )
+{
+    int32_t      rc     = 0;
+    mpmc_t      *p_mpmc = (mpmc_t *) p_adts_mpmc;
+    mpmc_slot_t *p_slot = NULL;
+    size_t       pos    = 0;
+    size_t       seq    = 0;
+    intptr_t     diff   = 0;
+
+    pos = __atomic_load_n(&(p_mpmc->prod.tail), __ATOMIC_RELAXED);
+    for (;;) {
+        p_slot = &(p_mpmc->ring.p_slots[pos & p_mpmc->ring.mask]);
+        seq    = __atomic_load_n(&(p_slot->seq), __ATOMIC_ACQUIRE);
+        diff   = (intptr_t) seq - (intptr_t) pos;
+
+        if (0 == diff) {
+            /* free for this lap, claim it */
+            if (__atomic_compare_exchange_n(&(p_mpmc->prod.tail), &(pos),
+                                            pos + 1, true,
+                                            __ATOMIC_RELAXED,
+                                            __ATOMIC_RELAXED)) {
+                break;
+            }
+            mpmc_count(&(mpmc_stat(p_mpmc)->enqueue_retries));
+        }else if (0 > diff) {
+            /* previous lap not yet consumed */
+            mpmc_count(&(mpmc_stat(p_mpmc)->full));
+            rc = EAGAIN;
+            goto exception;
+        }else {
+            /* another producer claimed pos */
+            mpmc_count(&(mpmc_stat(p_mpmc)->enqueue_retries));
+            pos = __atomic_load_n(&(p_mpmc->prod.tail), __ATOMIC_RELAXED);
+        }
+    }
+
+    p_slot->p_data = p_data;
+    __atomic_store_n(&(p_slot->seq), pos + 1, __ATOMIC_RELEASE);
+    adts_wait_notify(&(p_mpmc->wait));
+
+exception:
+    return rc;
+} /* adts_mpmc_enqueue() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+int32_t
+adts_mpmc_dequeue( adts_mpmc_t  *p_adts_mpmc,
+                   void        **pp_data )
+{
+    int32_t      rc     = 0;
+    mpmc_t      *p_mpmc = (mpmc_t *) p_adts_mpmc;
+    mpmc_slot_t *p_slot = NULL;
+    size_t       pos    = 0;
+    size_t       seq    = 0;
+    intptr_t     diff   = 0;
+
+    pos = __atomic_load_n(&(p_mpmc->cons.head), __ATOMIC_RELAXED);
+    for (;;) {
+        p_slot = &(p_mpmc->ring.p_slots[pos & p_mpmc->ring.mask]);
+        seq    = __atomic_load_n(&(p_slot->seq), __ATOMIC_ACQUIRE);
+        diff   = (intptr_t) seq - (intptr_t) (pos + 1);
+
+        if (0 == diff) {
+            /* full for this lap, claim it */
+            if (__atomic_compare_exchange_n(&(p_mpmc->cons.head), &(pos),
+                                            pos + 1, true,
+                                            __ATOMIC_RELAXED,
+                                            __ATOMIC_RELAXED)) {
+                break;
+            }
+            mpmc_count(&(mpmc_stat(p_mpmc)->dequeue_retries));
+        }else if (0 > diff) {
+            /* not yet produced */
+            mpmc_count(&(mpmc_stat(p_mpmc)->empty));
+            rc = EAGAIN;
+            goto exception;
+        }else {
+            /* another consumer claimed pos */
+            mpmc_count(&(mpmc_stat(p_mpmc)->dequeue_retries));
+            pos = __atomic_load_n(&(p_mpmc->cons.head), __ATOMIC_RELAXED);
+        }
+    }
+
+    *pp_data = p_slot->p_data;
+    __atomic_store_n(&(p_slot->seq), pos + p_mpmc->ring.slots,
+                     __ATOMIC_RELEASE);
+
+exception:
+    return rc;
+} /* adts_mpmc_dequeue() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Spin then yield while full.
+ *
+ ****************************************************************************
+ */
+void
+adts_mpmc_enqueue_wait( adts_mpmc_t *p_adts_mpmc,
+                        void        *p_data )
+{
+    mpmc_t *p_mpmc = (mpmc_t *) p_adts_mpmc;
+
+    while (adts_mpmc_enqueue(p_adts_mpmc, p_data)) {
+        mpmc_backoff(p_mpmc);
+    }
+
+    return;
+} /* adts_mpmc_enqueue_wait() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   adts_wait_until() condition.
+ *
+ ****************************************************************************
+ */
+typedef struct {
+    adts_mpmc_t *p_mpmc;
+    void        *p_data;
+} mpmc_wait_ctx_t;
+
+static bool
+mpmc_wait_try( void *p_arg )
+{
+    mpmc_wait_ctx_t *p_ctx = p_arg;
+
+    return (0 == adts_mpmc_dequeue(p_ctx->p_mpmc, &(p_ctx->p_data)));
+} /* mpmc_wait_try() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Spin then park while empty.
+ *
+ ****************************************************************************
+ */
+void *
+adts_mpmc_dequeue_wait( adts_mpmc_t *p_adts_mpmc )
+{
+    mpmc_t          *p_mpmc = (mpmc_t *) p_adts_mpmc;
+    mpmc_wait_ctx_t  ctx    = { .p_mpmc = p_adts_mpmc };
+
+    if (adts_mpmc_dequeue(p_adts_mpmc, &(ctx.p_data))) {
+        adts_wait_until(&(p_mpmc->wait), mpmc_wait_try, &(ctx));
+    }
+
+    return ctx.p_data;
+} /* adts_mpmc_dequeue_wait() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+size_t
+adts_mpmc_entries( adts_mpmc_t *p_adts_mpmc )
+{
+    mpmc_t *p_mpmc = (mpmc_t *) p_adts_mpmc;
+    size_t  head   = __atomic_load_n(&(p_mpmc->cons.head), __ATOMIC_ACQUIRE);
+    size_t  tail   = __atomic_load_n(&(p_mpmc->prod.tail), __ATOMIC_ACQUIRE);
+
+    /* claimed positions may race ahead of one another in a snapshot */
+    return ((intptr_t) (tail - head) > 0) ? (tail - head) : 0;
+} /* adts_mpmc_entries() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+size_t
+adts_mpmc_capacity( adts_mpmc_t *p_adts_mpmc )
+{
+    mpmc_t *p_mpmc = (mpmc_t *) p_adts_mpmc;
+
+    return p_mpmc->ring.slots;
+} /* adts_mpmc_capacity() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_mpmc_stats( adts_mpmc_t       *p_adts_mpmc,
+                 adts_mpmc_stats_t *p_out )
+{
+    mpmc_t      *p_mpmc   = (mpmc_t *) p_adts_mpmc;
+    mpmc_stat_t *p_stripe = mpmc_stat_stripes(p_mpmc);
+
+    memset(p_out, 0, sizeof(*p_out));
+    for (uint32_t idx = 0; idx < MPMC_STAT_STRIPES; idx++) {
+        p_out->enqueue_retries += __atomic_load_n(&(p_stripe[idx].enqueue_retries),
+                                                  __ATOMIC_RELAXED);
+        p_out->dequeue_retries += __atomic_load_n(&(p_stripe[idx].dequeue_retries),
+                                                  __ATOMIC_RELAXED);
+        p_out->full            += __atomic_load_n(&(p_stripe[idx].full),
+                                                  __ATOMIC_RELAXED);
+        p_out->empty           += __atomic_load_n(&(p_stripe[idx].empty),
+                                                  __ATOMIC_RELAXED);
+        p_out->waits           += __atomic_load_n(&(p_stripe[idx].waits),
+                                                  __ATOMIC_RELAXED);
+    }
+
+    return;
+} /* adts_mpmc_stats() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_mpmc_wait_stats( adts_mpmc_t       *p_adts_mpmc,
+                      adts_wait_stats_t *p_out )
+{
+    mpmc_t *p_mpmc = (mpmc_t *) p_adts_mpmc;
+
+    adts_wait_stats(&(p_mpmc->wait), p_out);
+
+    return;
+} /* adts_mpmc_wait_stats() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_mpmc_mem_usage( adts_mpmc_t      *p_adts_mpmc,
+                     adts_mem_stats_t *p_out )
+{
+    mpmc_t *p_mpmc = (mpmc_t *) p_adts_mpmc;
+
+    adts_mem_usage(&(p_mpmc->ring.mem), p_out);
+
+    return;
+} /* adts_mpmc_mem_usage() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   All threads must have quiesced.  Undrained entries are dropped, the
+ *   consumer data is not owned by the queue.
+ *
+ ****************************************************************************
+ */
+void
+adts_mpmc_destroy( adts_mpmc_t *p_adts_mpmc )
+{
+    mpmc_t     *p_mpmc = (mpmc_t *) p_adts_mpmc;
+    adts_mem_t  mem    = p_mpmc->ring.mem;
+
+    adts_mem_put(&(mem), p_mpmc->ring.p_stat_raw, mpmc_stat_bytes());
+    adts_mem_put(&(mem), p_mpmc->ring.p_slots,
+                 p_mpmc->ring.slots * sizeof(*(p_mpmc->ring.p_slots)));
+    adts_mem_put_aligned(&(mem), p_adts_mpmc, sizeof(*p_adts_mpmc));
+
+    return;
+} /* adts_mpmc_destroy() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+adts_mpmc_t *
+adts_mpmc_create( const adts_mpmc_create_t *p_op )
+{
+    size_t       slots       = 0;
+    mpmc_t      *p_mpmc      = NULL;
+    adts_mem_t   mem         = {0};
+    adts_mpmc_t *p_adts_mpmc = NULL;
+
+    assert(p_op);
+    if ((0 == p_op->elems) || (p_op->elems > (UINT32_MAX >> 1))) {
+        goto exception;
+    }
+    slots = MAX(2, adts_pow2_round_up(p_op->elems));
+
+    adts_mem_init_ext(&(mem), ADTS_MEM_TYPE_MPMC, p_op->p_allocator);
+
+    p_adts_mpmc = adts_mem_get_aligned(&(mem), sizeof(*p_adts_mpmc));
+    if (NULL == p_adts_mpmc) {
+        goto exception;
+    }
+
+    p_mpmc               = (mpmc_t *) p_adts_mpmc;
+    p_mpmc->ring.p_slots = adts_mem_alloc(&(mem), slots * sizeof(mpmc_slot_t));
+    if (NULL == p_mpmc->ring.p_slots) {
+        adts_mem_put_aligned(&(mem), p_adts_mpmc, sizeof(*p_adts_mpmc));
+        p_adts_mpmc = NULL;
+        goto exception;
+    }
+
+    p_mpmc->ring.p_stat_raw = adts_mem_get(&(mem), mpmc_stat_bytes());
+    if (NULL == p_mpmc->ring.p_stat_raw) {
+        adts_mem_put(&(mem), p_mpmc->ring.p_slots, slots * sizeof(mpmc_slot_t));
+        adts_mem_put_aligned(&(mem), p_adts_mpmc, sizeof(*p_adts_mpmc));
+        p_adts_mpmc = NULL;
+        goto exception;
+    }
+
+    for (size_t idx = 0; idx < slots; idx++) {
+        p_mpmc->ring.p_slots[idx].seq    = idx;
+        p_mpmc->ring.p_slots[idx].p_data = NULL;
+    }
+    p_mpmc->ring.slots = slots;
+    p_mpmc->ring.mask  = slots - 1;
+    p_mpmc->ring.mem   = mem;
+    adts_wait_init(&(p_mpmc->wait), p_op->spins);
+
+exception:
+    return p_adts_mpmc;
+} /* adts_mpmc_create() */
+
+
+
+/******************************************************************************
+ * #     # #     #   ###   ####### ####### #######  #####  #######  #####
+ * #     # ##    #    #       #       #    #       #     #    #    #     #
+ * #     # # #   #    #       #       #    #       #          #    #
+ * #     # #  #  #    #       #       #    #####    #####     #     #####
+ * #     # #   # #    #       #       #    #             #    #          #
+ * #     # #    ##    #       #       #    #       #     #    #    #     #
+ *  #####  #     #   ###      #       #    #######  #####     #     #####
+******************************************************************************/
+
+/**
+ **************************************************************************
+ * \brief
+ *   Compile time structure sanity
+ *
+ * \details
+ *   Sanitize the abstract data type interface.  Enforced in header file so
+ *   as to catch improper usage/include by unauthorized callers.
+ *
+ **************************************************************************
+ */
+static void
+utest_mpmc_bytes( void )
+{
+    CDISPLAY("[%u]", sizeof(mpmc_t));
+    CDISPLAY("[%u]", sizeof(adts_mpmc_t));
+
+    _Static_assert(sizeof(mpmc_t) <= sizeof(adts_mpmc_t),
+        "Mismatch structs detected");
+
+    return;
+} /* utest_mpmc_bytes() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Benchmark parameters.  Items moved per thread count and the ring
+ *   capacity.  Thread counts double from 1 to UTEST_MPMC_THREADS_MAX,
+ *   with that many producers and as many consumers.
+ *
+ ****************************************************************************
+ */
+#ifndef UTEST_MPMC_ITEMS
+#define UTEST_MPMC_ITEMS (1 << 21)
+#endif
+
+#ifndef UTEST_MPMC_ELEMS
+#define UTEST_MPMC_ELEMS (1 << 10)
+#endif
+
+#ifndef UTEST_MPMC_THREADS_MAX
+#define UTEST_MPMC_THREADS_MAX (64)
+#endif
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Per thread benchmark context.  Producer payloads encode the producer
+ *   in the upper bits and the sequence in the lower bits, thus consumers
+ *   verify per producer FIFO order.
+ *
+ ****************************************************************************
+ */
+#define UTEST_MPMC_ID_SHIFT (40)
+
+typedef struct {
+    adts_mpmc_t *p_mpmc;
+    size_t       id;
+    size_t       items;
+    size_t       producers;
+    size_t       sum;
+    size_t      *p_last;
+} utest_mpmc_ctx_t;
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+static void *
+utest_mpmc_producer( void *p_arg )
+{
+    utest_mpmc_ctx_t *p_ctx = p_arg;
+
+    for (size_t idx = 1; idx <= p_ctx->items; idx++) {
+        size_t val = (p_ctx->id << UTEST_MPMC_ID_SHIFT) | idx;
+
+        adts_mpmc_enqueue_wait(p_ctx->p_mpmc, (void *) val);
+    }
+
+    return NULL;
+} /* utest_mpmc_producer() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+static void *
+utest_mpmc_consumer( void *p_arg )
+{
+    utest_mpmc_ctx_t *p_ctx = p_arg;
+    size_t            mask  = ((size_t) 1 << UTEST_MPMC_ID_SHIFT) - 1;
+
+    for (size_t idx = 0; idx < p_ctx->items; idx++) {
+        size_t val = (size_t) adts_mpmc_dequeue_wait(p_ctx->p_mpmc);
+        size_t id  = val >> UTEST_MPMC_ID_SHIFT;
+
+        assert(id < p_ctx->producers);
+        assert((val & mask) > p_ctx->p_last[id]);
+        p_ctx->p_last[id]  = val & mask;
+        p_ctx->sum        += val & mask;
+    }
+
+    return NULL;
+} /* utest_mpmc_consumer() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Scalability, n producers and n consumers on a shared queue.  The
+ *   item total is fixed, thus each producer / consumer moves items / n.
+ *
+ ****************************************************************************
+ */
+static void
+utest_mpmc_scale( size_t threads )
+{
+    int32_t             rc       = 0;
+    size_t              per      = UTEST_MPMC_ITEMS / threads;
+    size_t              items    = per * threads;
+    size_t              sum      = 0;
+    uint64_t            start    = 0;
+    uint64_t            delta    = 0;
+    pthread_t          *p_tids   = NULL;
+    utest_mpmc_ctx_t   *p_ctx    = NULL;
+    size_t             *p_last   = NULL;
+    adts_mpmc_t        *p_mpmc   = NULL;
+    adts_mpmc_create_t  op       = {0};
+    adts_mpmc_stats_t   stats    = {0};
+    adts_wait_stats_t   wait     = {0};
+
+    op.elems = UTEST_MPMC_ELEMS;
+    p_mpmc   = adts_mpmc_create(&(op));
+    assert(p_mpmc);
+
+    p_tids = calloc(2 * threads, sizeof(*p_tids));
+    p_ctx  = calloc(2 * threads, sizeof(*p_ctx));
+    p_last = calloc(threads * threads, sizeof(*p_last));
+    assert(p_tids && p_ctx && p_last);
+
+    start = adts_tstamp();
+    for (size_t idx = 0; idx < (2 * threads); idx++) {
+        p_ctx[idx].p_mpmc    = p_mpmc;
+        p_ctx[idx].id        = idx % threads;
+        p_ctx[idx].items     = per;
+        p_ctx[idx].producers = threads;
+        p_ctx[idx].p_last    = &(p_last[(idx % threads) * threads]);
+
+        rc = pthread_create(&(p_tids[idx]), NULL,
+                            (idx < threads) ? utest_mpmc_producer :
+                                              utest_mpmc_consumer,
+                            &(p_ctx[idx]));
+        assert(0 == rc);
+    }
+
+    for (size_t idx = 0; idx < (2 * threads); idx++) {
+        (void) pthread_join(p_tids[idx], NULL);
+        sum += (idx < threads) ? 0 : p_ctx[idx].sum;
+    }
+    delta = adts_tstamp() - start;
+
+    /* every producer sequence 1..per observed exactly once */
+    assert(sum == threads * ((per * (per + 1)) / 2));
+    assert(0 == adts_mpmc_entries(p_mpmc));
+
+    adts_mpmc_stats(p_mpmc, &(stats));
+    adts_mpmc_wait_stats(p_mpmc, &(wait));
+    CDISPLAY("threads: %2zu+%-2zu  items/s: %12.0f  retries/item: %6.3f  full: %8zu  empty: %8zu  waits: %8zu  parks: %8zu  wakes: %8zu",
+             threads,
+             threads,
+             (double) items * 1e9 / (double) (delta ? delta : 1),
+             (double) (stats.enqueue_retries + stats.dequeue_retries) /
+                 (double) items,
+             stats.full,
+             stats.empty,
+             stats.waits,
+             wait.parks,
+             wait.wakes);
+
+    free(p_last);
+    free(p_ctx);
+    free(p_tids);
+    adts_mpmc_destroy(p_mpmc);
+
+    return;
+} /* utest_mpmc_scale() */
+
+
+/*
+ ****************************************************************************
+ * test control
+ *
+ ****************************************************************************
+ */
+static void
+utest_control( void )
+{
+    utest_mpmc_bytes();
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: invalid create");
+
+        adts_mpmc_create_t op = {0};
+
+        assert(NULL == adts_mpmc_create(&(op)));
+    }
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: single thread FIFO, full / empty and laps");
+
+        void               *p_data = NULL;
+        adts_mpmc_t        *p_mpmc = NULL;
+        adts_mpmc_create_t  op     = {0};
+        adts_mpmc_stats_t   stats  = {0};
+        adts_mem_stats_t    before = {0};
+        adts_mem_stats_t    after  = {0};
+
+        (void) adts_mem_stats(ADTS_MEM_TYPE_MPMC, &(before));
+
+        op.elems = 1;
+        p_mpmc   = adts_mpmc_create(&(op));
+        assert(p_mpmc);
+        assert(2 == adts_mpmc_capacity(p_mpmc));
+        adts_mpmc_destroy(p_mpmc);
+
+        op.elems = 3;
+        p_mpmc   = adts_mpmc_create(&(op));
+        assert(p_mpmc);
+        assert(4 == adts_mpmc_capacity(p_mpmc));
+        assert(EAGAIN == adts_mpmc_dequeue(p_mpmc, &(p_data)));
+
+        /* several laps of the ring */
+        for (size_t lap = 0; lap < 4; lap++) {
+            for (size_t idx = 1; idx <= 4; idx++) {
+                assert(0 == adts_mpmc_enqueue(p_mpmc, (void *) idx));
+            }
+            assert(EAGAIN == adts_mpmc_enqueue(p_mpmc, (void *) 5));
+            assert(4 == adts_mpmc_entries(p_mpmc));
+
+            for (size_t idx = 1; idx <= 4; idx++) {
+                assert(0 == adts_mpmc_dequeue(p_mpmc, &(p_data)));
+                assert((void *) idx == p_data);
+            }
+            assert(EAGAIN == adts_mpmc_dequeue(p_mpmc, &(p_data)));
+        }
+
+        adts_mpmc_stats(p_mpmc, &(stats));
+        assert((4 == stats.full) && (5 == stats.empty));
+        assert(0 == stats.enqueue_retries + stats.dequeue_retries);
+
+        adts_mpmc_destroy(p_mpmc);
+
+        (void) adts_mem_stats(ADTS_MEM_TYPE_MPMC, &(after));
+        assert(before.bytes_curr == after.bytes_curr);
+    }
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: producer / consumer scalability");
+
+        for (size_t threads = 1; threads <= UTEST_MPMC_THREADS_MAX; threads <<= 1) {
+            utest_mpmc_scale(threads);
+        }
+    }
+
+    return;
+} /* utest_control() */
+
+
+/*
+ ****************************************************************************
+ * test entrypoint
+ *
+ ****************************************************************************
+ */
+void
+utest_adts_mpmc( void )
+{
+    utest_control();
+
+    return;
+} /* utest_adts_mpmc() */
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <adts_wait.h>
+#include <adts_memory.h>
+
+
+/******************************************************************************
+ #####  ####### ######  #     #  #####  ####### #     # ######  #######  #####
+#     #    #    #     # #     # #     #    #    #     # #     # #       #     #
+#          #    #     # #     # #          #    #     # #     # #       #
+ #####     #    ######  #     # #          #    #     # ######  #####    #####
+      #    #    #   #   #     # #          #    #     # #   #   #             #
+#     #    #    #    #  #     # #     #    #    #     # #    #  #       #     #
+ #####     #    #     #  #####   #####     #     #####  #     # #######  #####
+******************************************************************************/
+
+/**
+ **************************************************************************
+ * \details
+ *   Bounded multi producer / multi consumer queue of pointers.  Any
+ *   number of threads may enqueue and dequeue concurrently without
+ *   consumer provided locking.
+ *
+ *   Each slot carries a sequence number which tells a producer the slot
+ *   is free, and a consumer the slot is full, for the current lap of the
+ *   ring.  Producers and consumers claim a slot with a CAS on the tail /
+ *   head index respectively.
+ *
+ **************************************************************************
+ */
+#define ADTS_MPMC_BYTES (256)
+
+typedef struct {
+    const char reserved[ ADTS_MPMC_BYTES ];
+} adts_mpmc_t;
+
+
+/**
+ **************************************************************************
+ * \details
+ *   elems is rounded up to a power of two, minimum of 2.  spins is the
+ *   spin budget of adts_mpmc_dequeue_wait() before parking, 0 selects
+ *   the default.
+ *
+ **************************************************************************
+ */
+typedef struct {
+    size_t                  elems;       /**< ring capacity */
+    uint32_t                spins;       /**< dequeue_wait spin budget */
+    const adts_allocator_t *p_allocator; /**< NULL selects the default */
+} adts_mpmc_create_t;
+
+
+/**
+ **************************************************************************
+ * \details
+ *   Contention counters, lifetime of the instance.  Kept per thread off
+ *   the queue's hot lines, thus a count may be lost when more than 16
+ *   threads share an instance.
+ *
+ **************************************************************************
+ */
+typedef struct {
+    size_t enqueue_retries; /**< producer CAS lost or stale tail */
+    size_t dequeue_retries; /**< consumer CAS lost or stale head */
+    size_t full;            /**< enqueue found the ring full */
+    size_t empty;           /**< dequeue found the ring empty */
+    size_t waits;           /**< enqueue_wait backoff rounds */
+} adts_mpmc_stats_t;
+
+
+
+/******************************************************************************
+ #####   #####    ####    #####   ####    #####   #   #  #####   ######   ####
+ #    #  #    #  #    #     #    #    #     #      # #   #    #  #       #
+ #    #  #    #  #    #     #    #    #     #       #    #    #  #####    ####
+ #####   #####   #    #     #    #    #     #       #    #####   #            #
+ #       #   #   #    #     #    #    #     #       #    #       #       #    #
+ #       #    #   ####      #     ####      #       #    #       ######   ####
+*******************************************************************************/
+
+/**
+ **************************************************************************
+ * \brief
+ *   Queue services, safe from any thread
+ *
+ * \details
+ *   - adts_mpmc_enqueue()      EAGAIN when full
+ *   - adts_mpmc_dequeue()      EAGAIN when empty
+ *   - adts_mpmc_enqueue_wait() spin, then yield while full
+ *   - adts_mpmc_dequeue_wait() spin, then park while empty
+ *
+ **************************************************************************
+ */
+int32_t
+adts_mpmc_enqueue( adts_mpmc_t *p_adts_mpmc,
+                   void        *p_data );
+
+int32_t
+adts_mpmc_dequeue( adts_mpmc_t  *p_adts_mpmc,
+                   void        **pp_data );
+
+void
+adts_mpmc_enqueue_wait( adts_mpmc_t *p_adts_mpmc,
+                        void        *p_data );
+
+void *
+adts_mpmc_dequeue_wait( adts_mpmc_t *p_adts_mpmc );
+
+
+/**
+ **************************************************************************
+ * \details
+ *   adts_mpmc_entries() is a snapshot when called concurrently.
+ *
+ **************************************************************************
+ */
+size_t
+adts_mpmc_entries( adts_mpmc_t *p_adts_mpmc );
+
+size_t
+adts_mpmc_capacity( adts_mpmc_t *p_adts_mpmc );
+
+void
+adts_mpmc_stats( adts_mpmc_t       *p_adts_mpmc,
+                 adts_mpmc_stats_t *p_out );
+
+void
+adts_mpmc_wait_stats( adts_mpmc_t       *p_adts_mpmc,
+                      adts_wait_stats_t *p_out );
+
+void
+adts_mpmc_mem_usage( adts_mpmc_t      *p_adts_mpmc,
+                     adts_mem_stats_t *p_out );
+
+void
+adts_mpmc_destroy( adts_mpmc_t *p_adts_mpmc );
+
+adts_mpmc_t *
+adts_mpmc_create( const adts_mpmc_create_t *p_op );
+
+
+/**
+ **************************************************************************
+ * \details
+ *   Unit Test prototypes
+ *
+ **************************************************************************
+ */
+void
+utest_adts_mpmc( void );
@@ -0,0 +1,737 @@
+#include <sched.h>
+#include <errno.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <inttypes.h>
+
+/* Toolbox */
+#include <adts_mpsc.h>
+#include <adts_time.h>
+#include <adts_memory.h>
+#include <adts_private.h>
+#include <adts_display.h>
+
+
+/******************************************************************************
+ #####  ####### ######  #     #  #####  ####### #     # ######  #######  #####
+#     #    #    #     # #     # #     #    #    #     # #     # #       #     #
+#          #    #     # #     # #          #    #     # #     # #       #
+ #####     #    ######  #     # #          #    #     # ######  #####    #####
+      #    #    #   #   #     # #          #    #     # #   #   #             #
+#     #    #    #    #  #     # #     #    #    #     # #    #  #       #     #
+ #####     #    #     #  #####   #####     #     #####  #     # #######  #####
+******************************************************************************/
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+typedef struct mpsc_node_s {
+    /**< public data  - consumer visible */
+    adts_mpsc_node_public_t  pub;
+
+    /**< private data */
+    struct mpsc_node_s      *p_next;
+} mpsc_node_t;
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Nodes are linked oldest to newest.  Producers swing p_head to their
+ *   node, then link the previous head to it.  Between those two steps the
+ *   chain is transiently broken, which only the consumer observes.
+ *
+ *   The stub node keeps the chain non-empty such that p_tail is always
+ *   valid.  It is re-pushed when the consumer is about to take the last
+ *   node.
+ *
+ ****************************************************************************
+ */
+typedef struct {
+    struct {
+        mpsc_node_t *p_head;
+    } ADTS_CACHELINE_ALIGN prod;
+
+    struct {
+        mpsc_node_t *p_tail;
+        mpsc_node_t  stub;
+        adts_mem_t   mem;
+    } ADTS_CACHELINE_ALIGN cons;
+} mpsc_t;
+
+
+/******************************************************************************
+ * ####### #     # #     #  #####  #######   ###   ####### #     #  #####
+ * #       #     # ##    # #     #    #       #    #     # ##    # #     #
+ * #       #     # # #   # #          #       #    #     # # #   # #
+ * #####   #     # #  #  # #          #       #    #     # #  #  #  #####
+ * #       #     # #   # # #          #       #    #     # #   # #       #
+ * #       #     # #    ## #     #    #       #    #     # #    ## #     #
+ * #        #####  #     #  #####     #      ###   ####### #     #  #####
+******************************************************************************/
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+static inline void
+mpsc_push( mpsc_t      *p_mpsc,
+           mpsc_node_t *p_node )
+{
+    mpsc_node_t *p_prev = NULL;
+
+    __atomic_store_n(&(p_node->p_next), NULL, __ATOMIC_RELAXED);
+    p_prev = __atomic_exchange_n(&(p_mpsc->prod.p_head), p_node,
+                                 __ATOMIC_ACQ_REL);
+    __atomic_store_n(&(p_prev->p_next), p_node, __ATOMIC_RELEASE);
+
+    return;
+} /* mpsc_push() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Successor of a node known not to be the newest, waits out a push
+ *   which has swung p_head but not yet linked.
+ *
+ ****************************************************************************
+ */
+static inline mpsc_node_t *
+mpsc_next_linked( mpsc_node_t *p_node )
+{
+    mpsc_node_t *p_next = NULL;
+
+    while (NULL == (p_next = __atomic_load_n(&(p_node->p_next),
+                                             __ATOMIC_ACQUIRE))) {
+        adts_cpu_pause();
+    }
+
+    return p_next;
+} /* mpsc_next_linked() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_mpsc_push( adts_mpsc_t      *p_adts_mpsc,
+                adts_mpsc_node_t *p_adts_node,
+                void             *p_data,
+                size_t            bytes )
+{
+    mpsc_t      *p_mpsc = (mpsc_t *) p_adts_mpsc;
+    mpsc_node_t *p_node = (mpsc_node_t *) p_adts_node;
+
+    p_node->pub.p_data = p_data;
+    p_node->pub.bytes  = bytes;
+    mpsc_push(p_mpsc, p_node);
+
+    return;
+} /* adts_mpsc_push() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+adts_mpsc_node_t *
+adts_mpsc_pop( adts_mpsc_t *p_adts_mpsc )
+{
+    mpsc_t      *p_mpsc = (mpsc_t *) p_adts_mpsc;
+    mpsc_node_t *p_stub = &(p_mpsc->cons.stub);
+    mpsc_node_t *p_tail = p_mpsc->cons.p_tail;
+    mpsc_node_t *p_next = __atomic_load_n(&(p_tail->p_next), __ATOMIC_ACQUIRE);
+    mpsc_node_t *p_node = NULL;
+
+    if (p_tail == p_stub) {
+        if (NULL == p_next) {
+            /* empty, or the first push is still linking */
+            goto exception;
+        }
+
+        /* step over the stub */
+        p_mpsc->cons.p_tail = p_next;
+        p_tail              = p_next;
+        p_next = __atomic_load_n(&(p_next->p_next), __ATOMIC_ACQUIRE);
+    }
+
+    if (likely(p_next)) {
+        p_mpsc->cons.p_tail = p_next;
+        p_node              = p_tail;
+        goto exception;
+    }
+
+    if (p_tail != __atomic_load_n(&(p_mpsc->prod.p_head), __ATOMIC_ACQUIRE)) {
+        /* a push is linking behind p_tail */
+        goto exception;
+    }
+
+    /* p_tail is the newest node, re-insert the stub behind it */
+    mpsc_push(p_mpsc, p_stub);
+
+    p_next = __atomic_load_n(&(p_tail->p_next), __ATOMIC_ACQUIRE);
+    if (p_next) {
+        p_mpsc->cons.p_tail = p_next;
+        p_node              = p_tail;
+    }
+
+exception:
+    return (adts_mpsc_node_t *) p_node;
+} /* adts_mpsc_pop() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   The chain is walked from p_tail to a snapshot of p_head, waiting on
+ *   any link still in flight.  A pop which re-inserted the stub while a
+ *   push was linking leaves the stub mid chain, it is unlinked on the way.
+ *   When the stub is the snapshot head the chain is cut ahead of it, the
+ *   stub remaining as p_tail.  Otherwise the stub is swung in as the new
+ *   head, which cuts the chain at the previous head, and the walk
+ *   continues to the cut such that the returned chain is whole.
+ *
+ ****************************************************************************
+ */
+adts_mpsc_node_t *
+adts_mpsc_drain( adts_mpsc_t *p_adts_mpsc,
+                 size_t      *p_count )
+{
+    size_t       count   = 0;
+    mpsc_t      *p_mpsc  = (mpsc_t *) p_adts_mpsc;
+    mpsc_node_t *p_stub  = &(p_mpsc->cons.stub);
+    mpsc_node_t *p_first = p_mpsc->cons.p_tail;
+    mpsc_node_t *p_head  = __atomic_load_n(&(p_mpsc->prod.p_head),
+                                           __ATOMIC_ACQUIRE);
+    mpsc_node_t *p_node  = NULL;
+
+    if (p_first == p_stub) {
+        if (p_stub == p_head) {
+            /* empty */
+            p_first = NULL;
+            goto exception;
+        }
+
+        /* the stub is not the newest, thus has or will have a successor */
+        p_first = mpsc_next_linked(p_stub);
+    }
+
+    /* walk to the snapshot head, unlinking the stub should it be mid chain */
+    p_node = p_first;
+    while (p_node != p_head) {
+        mpsc_node_t *p_next = mpsc_next_linked(p_node);
+
+        if ((p_next == p_stub) && (p_stub != p_head)) {
+            p_next = mpsc_next_linked(p_stub);
+            __atomic_store_n(&(p_node->p_next), p_next, __ATOMIC_RELAXED);
+        }
+
+        if (p_next == p_stub) {
+            /* the stub is the newest, cut ahead of it */
+            __atomic_store_n(&(p_node->p_next), NULL, __ATOMIC_RELAXED);
+            p_mpsc->cons.p_tail = p_stub;
+            count++;
+            goto exception;
+        }
+
+        p_node = p_next;
+        count++;
+    }
+
+    /* the stub is no longer in the chain, cut at the current head */
+    __atomic_store_n(&(p_stub->p_next), NULL, __ATOMIC_RELAXED);
+    p_node = __atomic_exchange_n(&(p_mpsc->prod.p_head), p_stub,
+                                 __ATOMIC_ACQ_REL);
+    p_mpsc->cons.p_tail = p_stub;
+
+    for (count++; p_head != p_node; count++) {
+        p_head = mpsc_next_linked(p_head);
+    }
+    __atomic_store_n(&(p_node->p_next), NULL, __ATOMIC_RELAXED);
+
+exception:
+    if (p_count) {
+        *p_count = count;
+    }
+
+    return (adts_mpsc_node_t *) p_first;
+} /* adts_mpsc_drain() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+adts_mpsc_node_t *
+adts_mpsc_next( adts_mpsc_node_t *p_adts_node )
+{
+    mpsc_node_t *p_node = (mpsc_node_t *) p_adts_node;
+
+    return (adts_mpsc_node_t *) p_node->p_next;
+} /* adts_mpsc_next() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   A snapshot, a push in flight may not yet be visible.
+ *
+ ****************************************************************************
+ */
+bool
+adts_mpsc_is_empty( adts_mpsc_t *p_adts_mpsc )
+{
+    mpsc_t      *p_mpsc = (mpsc_t *) p_adts_mpsc;
+    mpsc_node_t *p_stub = &(p_mpsc->cons.stub);
+
+    return ((p_mpsc->cons.p_tail == p_stub) &&
+            (p_stub == __atomic_load_n(&(p_mpsc->prod.p_head),
+                                       __ATOMIC_ACQUIRE)));
+} /* adts_mpsc_is_empty() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_mpsc_mem_usage( adts_mpsc_t      *p_adts_mpsc,
+                     adts_mem_stats_t *p_out )
+{
+    mpsc_t *p_mpsc = (mpsc_t *) p_adts_mpsc;
+
+    adts_mem_usage(&(p_mpsc->cons.mem), p_out);
+
+    return;
+} /* adts_mpsc_mem_usage() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   All threads must have quiesced.  Undrained nodes belong to the
+ *   consumer and are left untouched.
+ *
+ ****************************************************************************
+ */
+void
+adts_mpsc_destroy( adts_mpsc_t *p_adts_mpsc )
+{
+    mpsc_t     *p_mpsc = (mpsc_t *) p_adts_mpsc;
+    adts_mem_t  mem    = p_mpsc->cons.mem;
+
+    adts_mem_put_aligned(&(mem), p_adts_mpsc, sizeof(*p_adts_mpsc));
+
+    return;
+} /* adts_mpsc_destroy() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+adts_mpsc_t *
+adts_mpsc_create( void )
+{
+    return adts_mpsc_create_ext(NULL);
+} /* adts_mpsc_create() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+adts_mpsc_t *
+adts_mpsc_create_ext( const adts_allocator_t *p_allocator )
+{
+    mpsc_t      *p_mpsc      = NULL;
+    adts_mem_t   mem         = {0};
+    adts_mpsc_t *p_adts_mpsc = NULL;
+
+    adts_mem_init_ext(&(mem), ADTS_MEM_TYPE_MPSC, p_allocator);
+
+    p_adts_mpsc = adts_mem_get_aligned(&(mem), sizeof(*p_adts_mpsc));
+    if (NULL == p_adts_mpsc) {
+        goto exception;
+    }
+
+    p_mpsc              = (mpsc_t *) p_adts_mpsc;
+    p_mpsc->prod.p_head = &(p_mpsc->cons.stub);
+    p_mpsc->cons.p_tail = &(p_mpsc->cons.stub);
+    p_mpsc->cons.mem    = mem;
+
+exception:
+    return p_adts_mpsc;
+} /* adts_mpsc_create_ext() */
+
+
+
+/******************************************************************************
+ * #     # #     #   ###   ####### ####### #######  #####  #######  #####
+ * #     # ##    #    #       #       #    #       #     #    #    #     #
+ * #     # # #   #    #       #       #    #       #          #    #
+ * #     # #  #  #    #       #       #    #####    #####     #     #####
+ * #     # #   # #    #       #       #    #             #    #          #
+ * #     # #    ##    #       #       #    #       #     #    #    #     #
+ *  #####  #     #   ###      #       #    #######  #####     #     #####
+******************************************************************************/
+
+/**
+ **************************************************************************
+ * \brief
+ *   Compile time structure sanity
+ *
+ * \details
+ *   Sanitize the abstract data type interface.  Enforced in header file so
+ *   as to catch improper usage/include by unauthorized callers.
+ *
+ **************************************************************************
+ */
+static void
+utest_mpsc_bytes( void )
+{
+    CDISPLAY("[%u]", sizeof(mpsc_t));
+    CDISPLAY("[%u]", sizeof(adts_mpsc_t));
+    CDISPLAY("[%u]", sizeof(mpsc_node_t));
+    CDISPLAY("[%u]", sizeof(adts_mpsc_node_t));
+
+    _Static_assert(sizeof(mpsc_t) <= sizeof(adts_mpsc_t),
+        "Mismatch structs detected");
+    _Static_assert(sizeof(mpsc_node_t) <= sizeof(adts_mpsc_node_t),
+        "Mismatch structs detected");
+
+    return;
+} /* utest_mpsc_bytes() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Consumer structure with an embedded node, as used by a completion
+ *   path.  seq encodes the producer and its sequence.
+ *
+ ****************************************************************************
+ */
+#ifndef UTEST_MPSC_ITEMS
+#define UTEST_MPSC_ITEMS (1 << 21)
+#endif
+
+#ifndef UTEST_MPSC_PRODUCERS_MAX
+#define UTEST_MPSC_PRODUCERS_MAX (8)
+#endif
+
+typedef struct {
+    size_t           id;
+    size_t           seq;
+    adts_mpsc_node_t node;
+} utest_mpsc_item_t;
+
+typedef struct {
+    adts_mpsc_t       *p_mpsc;
+    utest_mpsc_item_t *p_items;
+    size_t             items;
+} utest_mpsc_ctx_t;
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+static void *
+utest_mpsc_producer( void *p_arg )
+{
+    utest_mpsc_ctx_t *p_ctx = p_arg;
+
+    for (size_t idx = 0; idx < p_ctx->items; idx++) {
+        utest_mpsc_item_t *p_item = &(p_ctx->p_items[idx]);
+
+        adts_mpsc_push(p_ctx->p_mpsc, &(p_item->node), p_item, sizeof(*p_item));
+    }
+
+    return NULL;
+} /* utest_mpsc_producer() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Consumer modes, mixed alternates pop and drain.
+ *
+ ****************************************************************************
+ */
+typedef enum {
+    UTEST_MPSC_POP   = 0x11111111,
+    UTEST_MPSC_DRAIN = 0x22222222,
+    UTEST_MPSC_MIXED = 0x33333333,
+} utest_mpsc_mode_t;
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   n producers feed the single calling consumer, which takes nodes one
+ *   at a time, drains whole chains, or alternates the two.  Per producer
+ *   order is verified.
+ *
+ ****************************************************************************
+ */
+static void
+utest_mpsc_rate( size_t            producers,
+                 utest_mpsc_mode_t mode )
+{
+    int32_t             rc        = 0;
+    size_t              per       = UTEST_MPSC_ITEMS / producers;
+    size_t              items     = per * producers;
+    size_t              recv      = 0;
+    size_t              chains    = 0;
+    size_t              laps      = 0;
+    bool                drain     = false;
+    uint64_t            start     = 0;
+    uint64_t            delta     = 0;
+    adts_mpsc_t        *p_mpsc    = NULL;
+    adts_mpsc_node_t   *p_node    = NULL;
+    utest_mpsc_item_t  *p_items   = NULL;
+    pthread_t           tids[ UTEST_MPSC_PRODUCERS_MAX ];
+    utest_mpsc_ctx_t    ctx[ UTEST_MPSC_PRODUCERS_MAX ];
+    size_t              next[ UTEST_MPSC_PRODUCERS_MAX ] = {0};
+    adts_mem_stats_t    before    = {0};
+    adts_mem_stats_t    after     = {0};
+
+    p_mpsc  = adts_mpsc_create();
+    p_items = calloc(items, sizeof(*p_items));
+    assert(p_mpsc && p_items);
+
+    for (size_t idx = 0; idx < items; idx++) {
+        p_items[idx].id  = idx / per;
+        p_items[idx].seq = idx % per;
+    }
+
+    (void) adts_mem_stats(ADTS_MEM_TYPE_MPSC, &(before));
+
+    start = adts_tstamp();
+    for (size_t idx = 0; idx < producers; idx++) {
+        ctx[idx].p_mpsc  = p_mpsc;
+        ctx[idx].p_items = &(p_items[idx * per]);
+        ctx[idx].items   = per;
+
+        rc = pthread_create(&(tids[idx]), NULL, utest_mpsc_producer, &(ctx[idx]));
+        assert(0 == rc);
+    }
+
+    while (recv < items) {
+        drain = (UTEST_MPSC_DRAIN == mode) ||
+                ((UTEST_MPSC_MIXED == mode) && (laps++ & 1));
+        if (drain) {
+            size_t count = 0;
+
+            p_node = adts_mpsc_drain(p_mpsc, &(count));
+            chains += (0 < count);
+        }else {
+            p_node = adts_mpsc_pop(p_mpsc);
+        }
+
+        if (NULL == p_node) {
+            sched_yield();
+            continue;
+        }
+
+        for (; p_node; p_node = drain ? adts_mpsc_next(p_node) : NULL) {
+            utest_mpsc_item_t *p_item = p_node->pub.p_data;
+
+            assert(&(p_item->node) == p_node);
+            assert(next[p_item->id] == p_item->seq);
+            next[p_item->id]++;
+            recv++;
+        }
+    }
+    delta = adts_tstamp() - start;
+
+    for (size_t idx = 0; idx < producers; idx++) {
+        (void) pthread_join(tids[idx], NULL);
+    }
+    assert(adts_mpsc_is_empty(p_mpsc));
+    assert(NULL == adts_mpsc_pop(p_mpsc));
+
+    /* no allocation per message */
+    (void) adts_mem_stats(ADTS_MEM_TYPE_MPSC, &(after));
+    assert(before.bytes_curr == after.bytes_curr);
+
+    CDISPLAY("producers: %zu  %s  items/s: %12.0f  ns/item: %6.2f  chains: %zu",
+             producers,
+             (UTEST_MPSC_POP == mode) ? "pop  " :
+             (UTEST_MPSC_DRAIN == mode) ? "drain" : "mixed",
+             (double) items * 1e9 / (double) (delta ? delta : 1),
+             (double) delta / (double) items,
+             chains);
+
+    free(p_items);
+    adts_mpsc_destroy(p_mpsc);
+
+    return;
+} /* utest_mpsc_rate() */
+
+
+/*
+ ****************************************************************************
+ * test control
+ *
+ ****************************************************************************
+ */
+static void
+utest_control( void )
+{
+    utest_mpsc_bytes();
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: single thread pop / drain");
+
+        size_t             count    = 0;
+        adts_mpsc_t       *p_mpsc   = NULL;
+        adts_mpsc_node_t  *p_node   = NULL;
+        adts_mpsc_node_t   nodes[ 8 ];
+
+        p_mpsc = adts_mpsc_create();
+        assert(p_mpsc);
+        assert(adts_mpsc_is_empty(p_mpsc));
+        assert(NULL == adts_mpsc_pop(p_mpsc));
+        assert(NULL == adts_mpsc_drain(p_mpsc, &(count)));
+        assert(0 == count);
+
+        /* pop through the stub re-insertion several times */
+        for (size_t lap = 0; lap < 3; lap++) {
+            for (size_t idx = 0; idx < 3; idx++) {
+                adts_mpsc_push(p_mpsc, &(nodes[idx]), (void *) (idx + 1), idx);
+            }
+            for (size_t idx = 0; idx < 3; idx++) {
+                p_node = adts_mpsc_pop(p_mpsc);
+                assert(&(nodes[idx]) == p_node);
+                assert((void *) (idx + 1) == p_node->pub.p_data);
+                assert(idx == p_node->pub.bytes);
+            }
+            assert(NULL == adts_mpsc_pop(p_mpsc));
+            assert(adts_mpsc_is_empty(p_mpsc));
+        }
+
+        /* drain after a partial pop, then reuse the queue */
+        for (size_t idx = 0; idx < 8; idx++) {
+            adts_mpsc_push(p_mpsc, &(nodes[idx]), (void *) (idx + 1), 0);
+        }
+        assert(&(nodes[0]) == adts_mpsc_pop(p_mpsc));
+
+        p_node = adts_mpsc_drain(p_mpsc, &(count));
+        assert(7 == count);
+        for (size_t idx = 1; idx < 8; idx++) {
+            assert(&(nodes[idx]) == p_node);
+            p_node = adts_mpsc_next(p_node);
+        }
+        assert(NULL == p_node);
+        assert(adts_mpsc_is_empty(p_mpsc));
+
+        adts_mpsc_push(p_mpsc, &(nodes[0]), NULL, 0);
+        p_node = adts_mpsc_drain(p_mpsc, &(count));
+        assert((&(nodes[0]) == p_node) && (1 == count));
+        assert(NULL == adts_mpsc_next(p_node));
+        assert(NULL == adts_mpsc_pop(p_mpsc));
+
+        adts_mpsc_destroy(p_mpsc);
+    }
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: drain after a pop re-inserted the stub mid chain");
+
+        size_t             count  = 0;
+        adts_mpsc_t       *p_mpsc = NULL;
+        mpsc_t            *p_priv = NULL;
+        mpsc_node_t       *p_prev = NULL;
+        adts_mpsc_node_t  *p_node = NULL;
+        adts_mpsc_node_t   nodes[ 5 ];
+
+        for (size_t newest = 0; newest < 2; newest++) {
+            p_mpsc = adts_mpsc_create();
+            assert(p_mpsc);
+            p_priv = (mpsc_t *) p_mpsc;
+
+            /* A and X pushed, A popped, p_tail is X */
+            adts_mpsc_push(p_mpsc, &(nodes[0]), &(nodes[0]), 1);
+            adts_mpsc_push(p_mpsc, &(nodes[1]), &(nodes[1]), 1);
+            assert(&(nodes[0]) == adts_mpsc_pop(p_mpsc));
+
+            /* replay: pop finds X the newest, a push of Y swings p_head but
+             * has yet to link X, pop re-inserts the stub behind Y */
+            ((mpsc_node_t *) &(nodes[2]))->pub.p_data = &(nodes[2]);
+            ((mpsc_node_t *) &(nodes[2]))->p_next     = NULL;
+            p_prev = __atomic_exchange_n(&(p_priv->prod.p_head),
+                                         (mpsc_node_t *) &(nodes[2]),
+                                         __ATOMIC_ACQ_REL);
+            mpsc_push(p_priv, &(p_priv->cons.stub));
+            assert(NULL == p_prev->p_next);
+            p_prev->p_next = (mpsc_node_t *) &(nodes[2]);
+
+            /* X -> Y -> stub, and Z beyond unless the stub is newest */
+            if (0 == newest) {
+                adts_mpsc_push(p_mpsc, &(nodes[3]), &(nodes[3]), 1);
+            }
+
+            p_node = adts_mpsc_drain(p_mpsc, &(count));
+            assert(count == (size_t) (newest ? 2 : 3));
+            for (size_t idx = 1; idx < (newest ? 3 : 4); idx++) {
+                assert(&(nodes[idx]) == p_node);
+                p_node = adts_mpsc_next(p_node);
+            }
+            assert(NULL == p_node);
+            assert(adts_mpsc_is_empty(p_mpsc));
+            assert(NULL == adts_mpsc_pop(p_mpsc));
+
+            adts_mpsc_push(p_mpsc, &(nodes[4]), &(nodes[4]), 1);
+            assert(&(nodes[4]) == adts_mpsc_pop(p_mpsc));
+            assert(NULL == adts_mpsc_drain(p_mpsc, &(count)));
+
+            adts_mpsc_destroy(p_mpsc);
+        }
+    }
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: producer scalability, pop, drain and mixed");
+
+        for (size_t producers = 1; producers <= UTEST_MPSC_PRODUCERS_MAX; producers <<= 1) {
+            utest_mpsc_rate(producers, UTEST_MPSC_POP);
+            utest_mpsc_rate(producers, UTEST_MPSC_DRAIN);
+            utest_mpsc_rate(producers, UTEST_MPSC_MIXED);
+        }
+    }
+
+    return;
+} /* utest_control() */
+
+
+/*
+ ****************************************************************************
+ * test entrypoint
+ *
+ ****************************************************************************
+ */
+void
+utest_adts_mpsc( void )
+{
+    utest_control();
+
+    return;
+} /* utest_adts_mpsc() */
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <adts_memory.h>
+
+
+/******************************************************************************
+ #####  ####### ######  #     #  #####  ####### #     # ######  #######  #####
+#     #    #    #     # #     # #     #    #    #     # #     # #       #     #
+#          #    #     # #     # #          #    #     # #     # #       #
+ #####     #    ######  #     # #          #    #     # ######  #####    #####
+      #    #    #   #   #     # #          #    #     # #   #   #             #
+#     #    #    #    #  #     # #     #    #    #     # #    #  #       #     #
+ #####     #    #     #  #####   #####     #     #####  #     # #######  #####
+******************************************************************************/
+
+/**
+ **************************************************************************
+ * \details
+ *   Unbounded intrusive multi producer / single consumer queue.  The
+ *   consumer embeds an adts_mpsc_node_t in its own structure, thus a push
+ *   never allocates.  Any number of threads may push concurrently with
+ *   the single consumer without consumer provided locking.
+ *
+ *   A push is a single atomic exchange.  A pop reads the links with
+ *   acquire loads only, an atomic is issued solely when the queue is
+ *   about to become empty.
+ *
+ **************************************************************************
+ */
+#define ADTS_MPSC_BYTES      (128)
+#define ADTS_MPSC_NODE_BYTES (32)
+
+typedef struct {
+    const char reserved[ ADTS_MPSC_BYTES ];
+} adts_mpsc_t;
+
+typedef struct {
+    void   *p_data;
+    size_t  bytes;
+} adts_mpsc_node_public_t;
+
+typedef union {
+    const char                    reserved[ ADTS_MPSC_NODE_BYTES ];
+    const adts_mpsc_node_public_t pub; /**< read only */
+} adts_mpsc_node_t;
+
+
+
+/******************************************************************************
+ #####   #####    ####    #####   ####    #####   #   #  #####   ######   ####
+ #    #  #    #  #    #     #    #    #     #      # #   #    #  #       #
+ #    #  #    #  #    #     #    #    #     #       #    #    #  #####    ####
+ #####   #####   #    #     #    #    #     #       #    #####   #            #
+ #       #   #   #    #     #    #    #     #       #    #       #       #    #
+ #       #    #   ####      #     ####      #       #    #       ######   ####
+*******************************************************************************/
+
+/**
+ **************************************************************************
+ * \brief
+ *   Producer services, safe from any thread
+ *
+ * \details
+ *   The node is owned by the queue until returned by a pop / drain.
+ *
+ **************************************************************************
+ */
+void
+adts_mpsc_push( adts_mpsc_t      *p_adts_mpsc,
+                adts_mpsc_node_t *p_adts_node,
+                void             *p_data,
+                size_t            bytes );
+
+
+/**
+ **************************************************************************
+ * \brief
+ *   Consumer services, call from the consumer thread only
+ *
+ * \details
+ *   - adts_mpsc_pop()   oldest node, NULL when empty.  NULL is also
+ *                       returned, transiently, while the only remaining
+ *                       push is still linking its node.
+ *   - adts_mpsc_drain() detach every pushed node as one NULL terminated
+ *                       chain, oldest first, walk with adts_mpsc_next()
+ *
+ **************************************************************************
+ */
+adts_mpsc_node_t *
+adts_mpsc_pop( adts_mpsc_t *p_adts_mpsc );
+
+adts_mpsc_node_t *
+adts_mpsc_drain( adts_mpsc_t *p_adts_mpsc,
+                 size_t      *p_count );
+
+adts_mpsc_node_t *
+adts_mpsc_next( adts_mpsc_node_t *p_adts_node );
+
+bool
+adts_mpsc_is_empty( adts_mpsc_t *p_adts_mpsc );
+
+void
+adts_mpsc_mem_usage( adts_mpsc_t      *p_adts_mpsc,
+                     adts_mem_stats_t *p_out );
+
+void
+adts_mpsc_destroy( adts_mpsc_t *p_adts_mpsc );
+
+adts_mpsc_t *
+adts_mpsc_create( void );
+
+adts_mpsc_t *
+adts_mpsc_create_ext( const adts_allocator_t *p_allocator );
+
+
+/**
+ **************************************************************************
+ * \details
+ *   Unit Test prototypes
+ *
+ **************************************************************************
+ */
+void
+utest_adts_mpsc( void );
@@ -0,0 +1,999 @@
+#include <sched.h>
+#include <errno.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <adts_heap.h>
+#include <adts_time.h>
+#include <adts_memory.h>
+#include <adts_private.h>
+#include <adts_display.h>
+#include <adts_multiqueue.h>
+
+
+/******************************************************************************
+ #####  ####### ######  #     #  #####  ####### #     # ######  #######  #####
+#     #    #    #     # #     # #     #    #    #     # #     # #       #     #
+#          #    #     # #     # #          #    #     # #     # #       #
+ #####     #    ######  #     # #          #    #     # ######  #####    #####
+      #    #    #   #   #     # #          #    #     # #   #   #             #
+#     #    #    #    #  #     # #     #    #    #     # #    #  #       #     #
+ #####     #    #     #  #####   #####     #     #####  #     # #######  #####
+******************************************************************************/
+
+/*
+ ****************************************************************************
+ * \details
+ *   The root of each heap is cached as an unsigned, min ordered key, as
+ *   adts_heap does internally, thus a pop compares two candidates with
+ *   one unsigned compare for either ordering.  An empty heap caches
+ *   the worst possible key.
+ *
+ ****************************************************************************
+ */
+#define MQ_SIGN_BIT   (1ULL << 63)
+#define MQ_TOP_EMPTY  (UINT64_MAX)
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Pops which found both candidates empty before the heaps are scanned
+ *   for any entry at all.
+ *
+ ****************************************************************************
+ */
+#define MQ_EMPTY_TRIES (4)
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   One heap and its try lock, one cacheline each.  top and elems are
+ *   written under the lock and read without it.
+ *
+ ****************************************************************************
+ */
+typedef struct {
+    uint32_t     lock;
+    uint64_t     top;
+    size_t       elems;
+    size_t       pushes;
+    size_t       pops;
+    size_t       contended;
+    adts_heap_t *p_heap;
+} ADTS_CACHELINE_ALIGN mq_queue_t;
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+typedef struct {
+    uint32_t          queues;
+    uint64_t          key_mask;   /**< key to ordering key, per type */
+    mq_queue_t       *p_queues;   /**< cacheline aligned, within p_raw */
+    void             *p_raw;
+    size_t            raw_bytes;
+    adts_heap_type_t  type;
+    adts_mem_t        mem;
+} mq_t;
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Per thread generator state for queue selection, lazily seeded.
+ *
+ ****************************************************************************
+ */
+static __thread uint64_t mq_seed;
+
+
+
+/******************************************************************************
+ * ####### #     # #     #  #####  #######   ###   ####### #     #  #####
+ * #       #     # ##    # #     #    #       #    #     # ##    # #     #
+ * #       #     # # #   # #          #       #    #     # # #   # #
+ * #####   #     # #  #  # #          #       #    #     # #  #  #  #####
+ * #       #     # #   # # #          #       #    #     # #   # #       #
+ * #       #     # #    ## #     #    #       #    #     # #    ## #     #
+ * #        #####  #     #  #####     #      ###   ####### #     #  #####
+******************************************************************************/
+
+/*
+ ****************************************************************************
+ * \details
+ *   Uniform queue index, xorshift64 scaled without a division.  The seed
+ *   mixes the address of the thread local state, distinct per thread.
+ *
+ ****************************************************************************
+ */
+static inline uint32_t
+mq_pick( const mq_t *p_mq )
+{
+    uint64_t x = mq_seed;
+
+    if (unlikely(0 == x)) {
+        x = ((uint64_t) (uintptr_t) &(mq_seed) * 0x9e3779b97f4a7c15ULL) | 1;
+    }
+
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    mq_seed = x;
+
+    return (uint32_t) (((x >> 32) * p_mq->queues) >> 32);
+} /* mq_pick() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+static inline bool
+mq_trylock( mq_queue_t *p_queue )
+{
+    bool locked = false;
+
+    if (0 == __atomic_load_n(&(p_queue->lock), __ATOMIC_RELAXED)) {
+        locked = (0 == __atomic_exchange_n(&(p_queue->lock), 1, __ATOMIC_ACQUIRE));
+    }
+
+    if (false == locked) {
+        __atomic_fetch_add(&(p_queue->contended), 1, __ATOMIC_RELAXED);
+    }
+
+    return locked;
+} /* mq_trylock() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Publish the root and population before the release.
+ *
+ ****************************************************************************
+ */
+static inline void
+mq_unlock( const mq_t *p_mq,
+           mq_queue_t *p_queue )
+{
+    adts_heap_node_t *p_top = adts_heap_peek(p_queue->p_heap);
+    uint64_t          top   = MQ_TOP_EMPTY;
+
+    if (p_top) {
+        top = ((uint64_t) p_top->pub.key) ^ p_mq->key_mask;
+    }
+
+    __atomic_store_n(&(p_queue->top), top, __ATOMIC_RELAXED);
+    __atomic_store_n(&(p_queue->elems),
+                     adts_heap_entries(p_queue->p_heap), __ATOMIC_RELAXED);
+    __atomic_store_n(&(p_queue->lock), 0, __ATOMIC_RELEASE);
+
+    return;
+} /* mq_unlock() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Retry with a fresh random heap until one is uncontended, pausing
+ *   after each failed attempt.
+ *
+ ****************************************************************************
+ */
+int32_t
+adts_multiqueue_push( adts_multiqueue_t *p_adts_multiqueue,
+                      adts_heap_node_t  *p_adts_node,
+                      void              *p_data,
+                      size_t             bytes,
+                      int64_t            key )
+{
+    int32_t     rc      = 0;
+    mq_t       *p_mq    = (mq_t *) p_adts_multiqueue;
+    mq_queue_t *p_queue = NULL;
+
+    for (;;) {
+        p_queue = &(p_mq->p_queues[mq_pick(p_mq)]);
+        if (mq_trylock(p_queue)) {
+            break;
+        }
+        adts_cpu_pause();
+    }
+
+    rc = adts_heap_push(p_queue->p_heap, p_adts_node, p_data, bytes, key);
+    if (0 == rc) {
+        p_queue->pushes++;
+    }
+
+    mq_unlock(p_mq, p_queue);
+
+    return rc;
+} /* adts_multiqueue_push() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Two choice pop.  The cached roots of two random heaps are compared
+ *   without locking, the better heap is locked and popped.  A contended
+ *   or meanwhile emptied heap restarts the choice.  After repeated empty
+ *   choices every heap is checked, NULL only when all are empty.
+ *
+ ****************************************************************************
+ */
+adts_heap_node_t *
+adts_multiqueue_pop( adts_multiqueue_t *p_adts_multiqueue )
+{
+    mq_t             *p_mq   = (mq_t *) p_adts_multiqueue;
+    adts_heap_node_t *p_node = NULL;
+    uint32_t          empty  = 0;
+
+    for (;;) {
+        mq_queue_t *p_a   = &(p_mq->p_queues[mq_pick(p_mq)]);
+        mq_queue_t *p_b   = &(p_mq->p_queues[mq_pick(p_mq)]);
+        uint64_t    top_a = __atomic_load_n(&(p_a->top), __ATOMIC_RELAXED);
+        uint64_t    top_b = __atomic_load_n(&(p_b->top), __ATOMIC_RELAXED);
+
+        if (top_b < top_a) {
+            p_a   = p_b;
+            top_a = top_b;
+        }
+
+        if (unlikely(0 == __atomic_load_n(&(p_a->elems), __ATOMIC_RELAXED))) {
+            if (++empty < MQ_EMPTY_TRIES) {
+                continue;
+            }
+
+            /* Both choices keep coming up empty, find any entry */
+            p_a = NULL;
+            for (uint32_t idx = 0; idx < p_mq->queues; idx++) {
+                if (__atomic_load_n(&(p_mq->p_queues[idx].elems), __ATOMIC_RELAXED)) {
+                    p_a = &(p_mq->p_queues[idx]);
+                    break;
+                }
+            }
+            if (NULL == p_a) {
+                break;
+            }
+            empty = 0;
+        }
+
+        if (false == mq_trylock(p_a)) {
+            adts_cpu_pause();
+            continue;
+        }
+
+        p_node = adts_heap_pop(p_a->p_heap);
+        if (p_node) {
+            p_a->pops++;
+        }
+        mq_unlock(p_mq, p_a);
+
+        if (p_node) {
+            break;
+        }
+    }
+
+    return p_node;
+} /* adts_multiqueue_pop() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+size_t
+adts_multiqueue_entries( adts_multiqueue_t *p_adts_multiqueue )
+{
+    mq_t   *p_mq  = (mq_t *) p_adts_multiqueue;
+    size_t  elems = 0;
+
+    for (uint32_t idx = 0; idx < p_mq->queues; idx++) {
+        elems += __atomic_load_n(&(p_mq->p_queues[idx].elems), __ATOMIC_RELAXED);
+    }
+
+    return elems;
+} /* adts_multiqueue_entries() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+uint32_t
+adts_multiqueue_queues( adts_multiqueue_t *p_adts_multiqueue )
+{
+    mq_t *p_mq = (mq_t *) p_adts_multiqueue;
+
+    return p_mq->queues;
+} /* adts_multiqueue_queues() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_multiqueue_stats( adts_multiqueue_t       *p_adts_multiqueue,
+                       adts_multiqueue_stats_t *p_out )
+{
+    mq_t *p_mq = (mq_t *) p_adts_multiqueue;
+
+    memset(p_out, 0, sizeof(*p_out));
+    for (uint32_t idx = 0; idx < p_mq->queues; idx++) {
+        mq_queue_t *p_queue = &(p_mq->p_queues[idx]);
+
+        p_out->pushes    += __atomic_load_n(&(p_queue->pushes), __ATOMIC_RELAXED);
+        p_out->pops      += __atomic_load_n(&(p_queue->pops), __ATOMIC_RELAXED);
+        p_out->contended += __atomic_load_n(&(p_queue->contended), __ATOMIC_RELAXED);
+    }
+
+    return;
+} /* adts_multiqueue_stats() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Instance memory plus that of every heap.  The peak is the sum of the
+ *   individual peaks, an upper bound.
+ *
+ ****************************************************************************
+ */
+void
+adts_multiqueue_mem_usage( adts_multiqueue_t *p_adts_multiqueue,
+                           adts_mem_stats_t  *p_out )
+{
+    mq_t *p_mq = (mq_t *) p_adts_multiqueue;
+
+    adts_mem_usage(&(p_mq->mem), p_out);
+    for (uint32_t idx = 0; idx < p_mq->queues; idx++) {
+        adts_mem_stats_t heap = {0};
+
+        adts_heap_mem_usage(p_mq->p_queues[idx].p_heap, &(heap));
+        p_out->bytes_curr += heap.bytes_curr;
+        p_out->bytes_peak += heap.bytes_peak;
+    }
+
+    return;
+} /* adts_multiqueue_mem_usage() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   All threads must have quiesced.  Remaining nodes belong to the
+ *   consumer.
+ *
+ ****************************************************************************
+ */
+void
+adts_multiqueue_destroy( adts_multiqueue_t *p_adts_multiqueue )
+{
+    mq_t       *p_mq = (mq_t *) p_adts_multiqueue;
+    adts_mem_t  mem  = p_mq->mem;
+
+    for (uint32_t idx = 0; idx < p_mq->queues; idx++) {
+        if (p_mq->p_queues[idx].p_heap) {
+            adts_heap_destroy(p_mq->p_queues[idx].p_heap);
+        }
+    }
+
+    adts_mem_put(&(mem), p_mq->p_raw, p_mq->raw_bytes);
+    adts_mem_put(&(mem), p_adts_multiqueue, sizeof(*p_adts_multiqueue));
+
+    return;
+} /* adts_multiqueue_destroy() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+adts_multiqueue_t *
+adts_multiqueue_create( const adts_multiqueue_create_t *p_op )
+{
+    int32_t             rc                = 0;
+    uint32_t            queues            = 0;
+    long                ncpus             = 0;
+    mq_t               *p_mq              = NULL;
+    adts_mem_t          mem               = {0};
+    adts_heap_create_t  hop               = {0};
+    adts_multiqueue_t  *p_adts_multiqueue = NULL;
+
+    assert(p_op);
+
+    if ((ADTS_HEAP_MIN != p_op->type) && (ADTS_HEAP_MAX != p_op->type)) {
+        rc = EINVAL;
+        goto exception;
+    }
+
+    queues = p_op->queues;
+    if (0 == queues) {
+        ncpus  = sysconf(_SC_NPROCESSORS_ONLN);
+        queues = 2 * (uint32_t) MAX(1, ncpus);
+    }
+
+    adts_mem_init_ext(&(mem), ADTS_MEM_TYPE_MULTIQUEUE, p_op->p_allocator);
+
+    p_adts_multiqueue = adts_mem_get(&(mem), sizeof(*p_adts_multiqueue));
+    if (NULL == p_adts_multiqueue) {
+        rc = ENOMEM;
+        goto exception;
+    }
+    p_mq = (mq_t *) p_adts_multiqueue;
+
+    /* Queue array plus cacheline alignment slack */
+    p_mq->raw_bytes = (queues * sizeof(mq_queue_t)) + ADTS_CACHELINE_BYTES;
+    p_mq->p_raw     = adts_mem_get(&(mem), p_mq->raw_bytes);
+    if (NULL == p_mq->p_raw) {
+        rc = ENOMEM;
+        goto exception;
+    }
+    p_mq->p_queues = (mq_queue_t *) (((uintptr_t) p_mq->p_raw + ADTS_CACHELINE_BYTES - 1) &
+                                     ~((uintptr_t) ADTS_CACHELINE_BYTES - 1));
+    p_mq->queues   = queues;
+
+    hop.type        = p_op->type;
+    hop.p_allocator = p_op->p_allocator;
+    for (uint32_t idx = 0; idx < queues; idx++) {
+        p_mq->p_queues[idx].top    = MQ_TOP_EMPTY;
+        p_mq->p_queues[idx].p_heap = adts_heap_create_ext(&(hop));
+        if (NULL == p_mq->p_queues[idx].p_heap) {
+            rc = ENOMEM;
+            goto exception;
+        }
+    }
+
+    p_mq->type     = p_op->type;
+    p_mq->key_mask = (ADTS_HEAP_MIN == p_op->type) ? MQ_SIGN_BIT : ~MQ_SIGN_BIT;
+    p_mq->mem      = mem;
+
+exception:
+    if (rc && p_mq) {
+        if (p_mq->p_raw) {
+            for (uint32_t idx = 0; idx < queues; idx++) {
+                if (p_mq->p_queues[idx].p_heap) {
+                    adts_heap_destroy(p_mq->p_queues[idx].p_heap);
+                }
+            }
+            adts_mem_put(&(mem), p_mq->p_raw, p_mq->raw_bytes);
+        }
+
+        adts_mem_put(&(mem), p_adts_multiqueue, sizeof(*p_adts_multiqueue));
+        p_adts_multiqueue = NULL;
+    }
+
+    return p_adts_multiqueue;
+} /* adts_multiqueue_create() */
+
+
+
+/******************************************************************************
+ * #     # #     #   ###   ####### ####### #######  #####  #######  #####
+ * #     # ##    #    #       #       #    #       #     #    #    #     #
+ * #     # # #   #    #       #       #    #       #          #    #
+ * #     # #  #  #    #       #       #    #####    #####     #     #####
+ * #     # #   # #    #       #       #    #             #    #          #
+ * #     # #    ##    #       #       #    #       #     #    #    #     #
+ *  #####  #     #   ###      #       #    #######  #####     #     #####
+******************************************************************************/
+
+/**
+ **************************************************************************
+ * \brief
+ *   Compile time structure sanity
+ *
+ * \details
+ *   Sanitize the abstract data type interface.  Enforced in header file so
+ *   as to catch improper usage/include by unauthorized callers.
+ *
+ **************************************************************************
+ */
+static void
+utest_multiqueue_bytes( void )
+{
+    CDISPLAY("[%u]", sizeof(mq_t));
+    CDISPLAY("[%u]", sizeof(adts_multiqueue_t));
+    CDISPLAY("[%u]", sizeof(mq_queue_t));
+
+    _Static_assert(sizeof(mq_t) <= sizeof(adts_multiqueue_t),
+        "Mismatch structs detected");
+    _Static_assert(sizeof(mq_queue_t) == ADTS_CACHELINE_BYTES,
+        "Mismatch structs detected");
+
+    return;
+} /* utest_multiqueue_bytes() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Rank error measurement.  Keys are drawn from [0, UTEST_MQ_KEYS), a
+ *   Fenwick tree counts the keys present, thus the rank of a popped key
+ *   is the count of present keys strictly better than it, 0 for an exact
+ *   priority queue.
+ *
+ ****************************************************************************
+ */
+#define UTEST_MQ_KEYS      (1 << 20)
+#define UTEST_MQ_RANK_LOG2 (20)
+
+typedef struct {
+    size_t   pops;
+    uint64_t sum;
+    size_t   max;
+    size_t   log2[ UTEST_MQ_RANK_LOG2 + 2 ]; /**< rank histogram, 0, 1, 2-3, ... */
+    int32_t *p_tree;                          /**< Fenwick, 1 based */
+} utest_mq_rank_t;
+
+
+static void
+utest_mq_fenwick_add( utest_mq_rank_t *p_rank,
+                      size_t           key,
+                      int32_t          delta )
+{
+    for (size_t idx = key + 1; idx <= UTEST_MQ_KEYS; idx += idx & (~idx + 1)) {
+        p_rank->p_tree[idx] += delta;
+    }
+
+    return;
+} /* utest_mq_fenwick_add() */
+
+
+/* count of present keys < key */
+static size_t
+utest_mq_fenwick_below( const utest_mq_rank_t *p_rank,
+                        size_t                 key )
+{
+    int64_t count = 0;
+
+    for (size_t idx = key; idx > 0; idx -= idx & (~idx + 1)) {
+        count += p_rank->p_tree[idx];
+    }
+
+    return (size_t) count;
+} /* utest_mq_fenwick_below() */
+
+
+static void
+utest_mq_rank_pop( utest_mq_rank_t *p_rank,
+                   size_t           key )
+{
+    size_t rank   = utest_mq_fenwick_below(p_rank, key);
+    size_t bucket = 0;
+
+    utest_mq_fenwick_add(p_rank, key, -1);
+
+    if (rank) {
+        bucket = MIN(UTEST_MQ_RANK_LOG2 + 1, 1 + (63 - __builtin_clzll(rank)));
+    }
+    p_rank->log2[bucket]++;
+    p_rank->sum += rank;
+    p_rank->max  = MAX(p_rank->max, rank);
+    p_rank->pops++;
+
+    return;
+} /* utest_mq_rank_pop() */
+
+
+/* rank at or below which the given fraction of pops fall, bucket bound */
+static size_t
+utest_mq_rank_quantile( const utest_mq_rank_t *p_rank,
+                        double                 fraction )
+{
+    size_t need = (size_t) ((double) p_rank->pops * fraction);
+    size_t seen = 0;
+
+    for (size_t b = 0; b < (UTEST_MQ_RANK_LOG2 + 2); b++) {
+        seen += p_rank->log2[b];
+        if (seen >= need) {
+            return b ? (((size_t) 1 << b) - 1) : 0;
+        }
+    }
+
+    return p_rank->max;
+} /* utest_mq_rank_quantile() */
+
+
+static void
+utest_mq_rank_display( const char            *p_label,
+                       uint32_t               value,
+                       const utest_mq_rank_t *p_rank )
+{
+    CDISPLAY("%-8s %3u  pops: %9zu  rank error mean: %8.2f  p50 <= %6zu  p99 <= %6zu  max: %6zu",
+             p_label, value, p_rank->pops,
+             (double) p_rank->sum / (double) MAX(1, p_rank->pops),
+             utest_mq_rank_quantile(p_rank, 0.50),
+             utest_mq_rank_quantile(p_rank, 0.99),
+             p_rank->max);
+
+    return;
+} /* utest_mq_rank_display() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Small PRNG for key generation, xorshift64.
+ *
+ ****************************************************************************
+ */
+static inline uint64_t
+utest_mq_rand( uint64_t *p_state )
+{
+    uint64_t x = *p_state;
+
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *p_state = x;
+
+    return x;
+} /* utest_mq_rand() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Single thread: every entry is returned exactly once for either
+ *   ordering, pop on empty is NULL, and a single heap is exact.
+ *
+ ****************************************************************************
+ */
+static void
+utest_multiqueue_basic( void )
+{
+    size_t                    elems   = 1 << 14;
+    uint64_t                  seed    = 0x9e3779b97f4a7c15ULL;
+    adts_heap_node_t         *p_node  = NULL;
+    uint8_t                  *p_seen  = NULL;
+    adts_heap_type_t          types[] = {ADTS_HEAP_MIN, ADTS_HEAP_MAX};
+    adts_multiqueue_create_t  op      = {0};
+    adts_multiqueue_stats_t   stats   = {0};
+
+    p_node = calloc(elems, sizeof(*p_node));
+    p_seen = calloc(elems, sizeof(*p_seen));
+    assert(p_node && p_seen);
+
+    op.type = 0;
+    assert(NULL == adts_multiqueue_create(&(op)));
+
+    for (size_t t = 0; t < sizeof(types) / sizeof(types[0]); t++) {
+        for (uint32_t queues = 1; queues <= 8; queues *= 2) {
+            adts_multiqueue_t *p_mq = NULL;
+            int64_t            prev = 0;
+
+            op.type   = types[t];
+            op.queues = queues;
+            p_mq      = adts_multiqueue_create(&(op));
+            assert(p_mq);
+            assert(queues == adts_multiqueue_queues(p_mq));
+            assert(NULL == adts_multiqueue_pop(p_mq));
+
+            memset(p_seen, 0, elems);
+            for (size_t idx = 0; idx < elems; idx++) {
+                int64_t key = (int64_t) (utest_mq_rand(&(seed)) % 1000) - 500;
+
+                assert(0 == adts_multiqueue_push(p_mq, &(p_node[idx]),
+                                                 &(p_node[idx]), 1, key));
+            }
+            assert(elems == adts_multiqueue_entries(p_mq));
+
+            for (size_t idx = 0; idx < elems; idx++) {
+                adts_heap_node_t *p_pop = adts_multiqueue_pop(p_mq);
+
+                assert(p_pop);
+                assert(p_pop->pub.p_data == p_pop);
+                assert(0 == p_seen[p_pop - p_node]);
+                p_seen[p_pop - p_node] = 1;
+
+                /* a single heap is an exact priority queue */
+                if ((1 == queues) && idx) {
+                    assert((ADTS_HEAP_MIN == types[t]) ? (prev <= p_pop->pub.key) :
+                                                         (prev >= p_pop->pub.key));
+                }
+                prev = p_pop->pub.key;
+            }
+
+            assert(0 == adts_multiqueue_entries(p_mq));
+            assert(NULL == adts_multiqueue_pop(p_mq));
+
+            adts_multiqueue_stats(p_mq, &(stats));
+            assert((elems == stats.pushes) && (elems == stats.pops));
+            adts_multiqueue_destroy(p_mq);
+        }
+    }
+
+    free(p_seen);
+    free(p_node);
+
+    return;
+} /* utest_multiqueue_basic() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Sequential rank error versus the number of heaps.  The queue is
+ *   prefilled then held at a steady population, each pop followed by a
+ *   push of a fresh random key.
+ *
+ ****************************************************************************
+ */
+#ifndef UTEST_MQ_PREFILL
+#define UTEST_MQ_PREFILL (1 << 16)
+#endif
+
+#ifndef UTEST_MQ_OPS
+#define UTEST_MQ_OPS (1 << 20)
+#endif
+
+static void
+utest_multiqueue_rank( void )
+{
+    adts_heap_node_t *p_node = NULL;
+
+    p_node = calloc(UTEST_MQ_PREFILL, sizeof(*p_node));
+    assert(p_node);
+
+    for (uint32_t queues = 1; queues <= 64; queues *= 2) {
+        uint64_t                  seed = 0x853c49e6748fea9bULL;
+        adts_multiqueue_t        *p_mq = NULL;
+        adts_multiqueue_create_t  op   = {0};
+        utest_mq_rank_t           rank = {0};
+
+        rank.p_tree = calloc(UTEST_MQ_KEYS + 1, sizeof(*rank.p_tree));
+        assert(rank.p_tree);
+
+        op.type   = ADTS_HEAP_MIN;
+        op.queues = queues;
+        p_mq      = adts_multiqueue_create(&(op));
+        assert(p_mq);
+
+        for (size_t idx = 0; idx < UTEST_MQ_PREFILL; idx++) {
+            size_t key = utest_mq_rand(&(seed)) % UTEST_MQ_KEYS;
+
+            (void) adts_multiqueue_push(p_mq, &(p_node[idx]), p_node, 1, (int64_t) key);
+            utest_mq_fenwick_add(&(rank), key, 1);
+        }
+
+        for (size_t idx = 0; idx < UTEST_MQ_OPS; idx++) {
+            adts_heap_node_t *p_pop = adts_multiqueue_pop(p_mq);
+            size_t            key   = utest_mq_rand(&(seed)) % UTEST_MQ_KEYS;
+
+            utest_mq_rank_pop(&(rank), (size_t) p_pop->pub.key);
+            (void) adts_multiqueue_push(p_mq, p_pop, p_node, 1, (int64_t) key);
+            utest_mq_fenwick_add(&(rank), key, 1);
+        }
+
+        if (1 == queues) {
+            assert(0 == rank.max);
+        }
+        utest_mq_rank_display("queues:", queues, &(rank));
+
+        adts_multiqueue_destroy(p_mq);
+        free(rank.p_tree);
+    }
+
+    free(p_node);
+
+    return;
+} /* utest_multiqueue_rank() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Concurrent throughput and rank error.  Every thread repeats pop then
+ *   push of a fresh key, logging each operation with a timestamp, taken
+ *   before a push and after a pop, thus a key is always replayed present
+ *   when popped.  The merged log, ordered by timestamp, is replayed
+ *   through the Fenwick tree, an in flight push counts against the pop,
+ *   a slight overestimate.  The baseline is a single adts_heap behind
+ *   a mutex, queues 1 in the output.
+ *
+ ****************************************************************************
+ */
+#ifndef UTEST_MQ_THREADS_MAX
+#define UTEST_MQ_THREADS_MAX (8)
+#endif
+
+typedef struct {
+    uint64_t tstamp;
+    uint32_t key;
+    uint32_t push;
+} utest_mq_log_t;
+
+typedef struct {
+    adts_multiqueue_t *p_mq;
+    adts_heap_t       *p_heap;   /**< baseline when not NULL */
+    pthread_mutex_t   *p_mutex;
+    size_t             ops;
+    uint64_t           seed;
+    utest_mq_log_t    *p_log;    /**< 2 x ops entries */
+} utest_mq_ctx_t;
+
+
+static void *
+utest_mq_worker( void *p_arg )
+{
+    utest_mq_ctx_t *p_ctx = p_arg;
+    utest_mq_log_t *p_log = p_ctx->p_log;
+
+    for (size_t idx = 0; idx < p_ctx->ops; idx++) {
+        adts_heap_node_t *p_pop = NULL;
+        uint32_t          key   = (uint32_t) (utest_mq_rand(&(p_ctx->seed)) % UTEST_MQ_KEYS);
+
+        if (p_ctx->p_heap) {
+            pthread_mutex_lock(p_ctx->p_mutex);
+            p_pop = adts_heap_pop(p_ctx->p_heap);
+            pthread_mutex_unlock(p_ctx->p_mutex);
+        }else {
+            p_pop = adts_multiqueue_pop(p_ctx->p_mq);
+        }
+        assert(p_pop);
+        p_log->tstamp = adts_tstamp();
+        p_log->key    = (uint32_t) p_pop->pub.key;
+        p_log->push   = 0;
+        p_log++;
+
+        p_log->tstamp = adts_tstamp();
+        p_log->key    = key;
+        p_log->push   = 1;
+        p_log++;
+        if (p_ctx->p_heap) {
+            pthread_mutex_lock(p_ctx->p_mutex);
+            (void) adts_heap_push(p_ctx->p_heap, p_pop, p_pop->pub.p_data, 1, key);
+            pthread_mutex_unlock(p_ctx->p_mutex);
+        }else {
+            (void) adts_multiqueue_push(p_ctx->p_mq, p_pop, p_pop->pub.p_data, 1, key);
+        }
+    }
+
+    return NULL;
+} /* utest_mq_worker() */
+
+
+static int
+utest_mq_log_cmp( const void *p_a,
+                  const void *p_b )
+{
+    const utest_mq_log_t *p_x = p_a;
+    const utest_mq_log_t *p_y = p_b;
+
+    return (p_x->tstamp > p_y->tstamp) - (p_x->tstamp < p_y->tstamp);
+} /* utest_mq_log_cmp() */
+
+
+static void
+utest_multiqueue_scale( size_t threads,
+                        bool   baseline )
+{
+    int32_t                   rc      = 0;
+    size_t                    per     = UTEST_MQ_OPS / threads;
+    size_t                    logged  = 2 * per * threads;
+    uint64_t                  seed    = 0x94d049bb133111ebULL;
+    uint64_t                  start   = 0;
+    uint64_t                  delta   = 0;
+    pthread_t                 tids[ UTEST_MQ_THREADS_MAX ];
+    utest_mq_ctx_t            ctx[ UTEST_MQ_THREADS_MAX ];
+    pthread_mutex_t           mutex   = PTHREAD_MUTEX_INITIALIZER;
+    adts_heap_node_t         *p_node  = NULL;
+    utest_mq_log_t           *p_log   = NULL;
+    adts_multiqueue_t        *p_mq    = NULL;
+    adts_heap_t              *p_heap  = NULL;
+    adts_multiqueue_create_t  op      = {0};
+    adts_multiqueue_stats_t   stats   = {0};
+    utest_mq_rank_t           rank    = {0};
+
+    p_node      = calloc(UTEST_MQ_PREFILL, sizeof(*p_node));
+    p_log       = calloc(logged, sizeof(*p_log));
+    rank.p_tree = calloc(UTEST_MQ_KEYS + 1, sizeof(*rank.p_tree));
+    assert(p_node && p_log && rank.p_tree);
+
+    if (baseline) {
+        p_heap = adts_heap_create(ADTS_HEAP_MIN);
+        assert(p_heap);
+    }else {
+        op.type   = ADTS_HEAP_MIN;
+        op.queues = (uint32_t) (2 * threads);
+        p_mq      = adts_multiqueue_create(&(op));
+        assert(p_mq);
+    }
+
+    for (size_t idx = 0; idx < UTEST_MQ_PREFILL; idx++) {
+        size_t key = utest_mq_rand(&(seed)) % UTEST_MQ_KEYS;
+
+        if (baseline) {
+            (void) adts_heap_push(p_heap, &(p_node[idx]), p_node, 1, (int64_t) key);
+        }else {
+            (void) adts_multiqueue_push(p_mq, &(p_node[idx]), p_node, 1, (int64_t) key);
+        }
+        utest_mq_fenwick_add(&(rank), key, 1);
+    }
+
+    start = adts_tstamp();
+    for (size_t idx = 0; idx < threads; idx++) {
+        ctx[idx].p_mq    = p_mq;
+        ctx[idx].p_heap  = p_heap;
+        ctx[idx].p_mutex = &(mutex);
+        ctx[idx].ops     = per;
+        ctx[idx].seed    = seed + (idx * 0x9e3779b97f4a7c15ULL);
+        ctx[idx].p_log   = &(p_log[2 * per * idx]);
+
+        rc = pthread_create(&(tids[idx]), NULL, utest_mq_worker, &(ctx[idx]));
+        assert(0 == rc);
+    }
+
+    for (size_t idx = 0; idx < threads; idx++) {
+        (void) pthread_join(tids[idx], NULL);
+    }
+    delta = adts_tstamp() - start;
+
+    /* replay in timestamp order */
+    qsort(p_log, logged, sizeof(*p_log), utest_mq_log_cmp);
+    for (size_t idx = 0; idx < logged; idx++) {
+        if (p_log[idx].push) {
+            utest_mq_fenwick_add(&(rank), p_log[idx].key, 1);
+        }else {
+            utest_mq_rank_pop(&(rank), p_log[idx].key);
+        }
+    }
+
+    if (baseline) {
+        CDISPLAY("mutex+heap threads: %2zu  ops/s: %12.0f", threads,
+                 (double) logged * 1e9 / (double) (delta ? delta : 1));
+        utest_mq_rank_display("queues:", 1, &(rank));
+        assert(UTEST_MQ_PREFILL == adts_heap_entries(p_heap));
+        adts_heap_destroy(p_heap);
+    }else {
+        adts_multiqueue_stats(p_mq, &(stats));
+        CDISPLAY("multiqueue threads: %2zu  ops/s: %12.0f  contended/op: %6.3f", threads,
+                 (double) logged * 1e9 / (double) (delta ? delta : 1),
+                 (double) stats.contended / (double) logged);
+        utest_mq_rank_display("queues:", adts_multiqueue_queues(p_mq), &(rank));
+        assert(UTEST_MQ_PREFILL == adts_multiqueue_entries(p_mq));
+        adts_multiqueue_destroy(p_mq);
+    }
+
+    free(rank.p_tree);
+    free(p_log);
+    free(p_node);
+
+    return;
+} /* utest_multiqueue_scale() */
+
+
+/*
+ ****************************************************************************
+ * test entrypoint
+ *
+ ****************************************************************************
+ */
+void
+utest_adts_multiqueue( void )
+{
+    utest_multiqueue_bytes();
+    utest_multiqueue_basic();
+    utest_multiqueue_rank();
+
+    for (size_t threads = 1; threads <= UTEST_MQ_THREADS_MAX; threads *= 2) {
+        utest_multiqueue_scale(threads, true);
+        utest_multiqueue_scale(threads, false);
+    }
+
+    return;
+} /* utest_adts_multiqueue() */
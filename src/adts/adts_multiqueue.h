@@ -0,0 +1,131 @@
+#pragma once
+
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <adts_heap.h>
+#include <adts_memory.h>
+
+
+/******************************************************************************
+ #####  ####### ######  #     #  #####  ####### #     # ######  #######  #####
+#     #    #    #     # #     # #     #    #    #     # #     # #       #     #
+#          #    #     # #     # #          #    #     # #     # #       #
+ #####     #    ######  #     # #          #    #     # ######  #####    #####
+      #    #    #   #   #     # #          #    #     # #   #   #             #
+#     #    #    #    #  #     # #     #    #    #     # #    #  #       #     #
+ #####     #    #     #  #####   #####     #     #####  #     # #######  #####
+******************************************************************************/
+
+/**
+ **************************************************************************
+ * \details
+ *   Relaxed concurrent priority queue (MultiQueue).  c x T adts_heap
+ *   instances, each behind its own try lock.  A push goes to a random
+ *   heap.  A pop compares the cached roots of two random heaps and pops
+ *   the better one, thus the entry taken is near, but not necessarily,
+ *   the best entry overall.  The expected rank error grows with the
+ *   number of heaps and is independent of the population.
+ *
+ *   Safe from any thread, no consumer locking is required.  Nodes are
+ *   adts_heap_node_t, the popped node's pub carries data and key.
+ *
+ **************************************************************************
+ */
+#define ADTS_MULTIQUEUE_BYTES (128)
+
+typedef struct {
+    const char reserved[ ADTS_MULTIQUEUE_BYTES ];
+} adts_multiqueue_t;
+
+
+/**
+ **************************************************************************
+ * \details
+ *   queues is the number of heaps, 0 selects 2 x online CPUs.
+ *
+ **************************************************************************
+ */
+typedef struct {
+    adts_heap_type_t        type;        /**< min or max ordering */
+    uint32_t                queues;      /**< heaps, c x T */
+    const adts_allocator_t *p_allocator; /**< NULL selects the default */
+} adts_multiqueue_create_t;
+
+
+/**
+ **************************************************************************
+ * \details
+ *   Counters summed over the heaps, a snapshot when read concurrently.
+ *
+ **************************************************************************
+ */
+typedef struct {
+    size_t pushes;    /**< entries accepted */
+    size_t pops;      /**< entries taken */
+    size_t contended; /**< try lock failures, the op retried elsewhere */
+} adts_multiqueue_stats_t;
+
+
+
+/******************************************************************************
+ #####   #####    ####    #####   ####    #####   #   #  #####   ######   ####
+ #    #  #    #  #    #     #    #    #     #      # #   #    #  #       #
+ #    #  #    #  #    #     #    #    #     #       #    #    #  #####    ####
+ #####   #####   #    #     #    #    #     #       #    #####   #            #
+ #       #   #   #    #     #    #    #     #       #    #       #       #    #
+ #       #    #   ####      #     ####      #       #    #       ######   ####
+*******************************************************************************/
+
+/**
+ **************************************************************************
+ * \brief
+ *   Queue services, safe from any thread
+ *
+ * \details
+ *   - adts_multiqueue_push()  ENOMEM when the chosen heap fails to grow
+ *   - adts_multiqueue_pop()   a near best entry, NULL when every heap is
+ *                             empty
+ *
+ **************************************************************************
+ */
+int32_t
+adts_multiqueue_push( adts_multiqueue_t *p_adts_multiqueue,
+                      adts_heap_node_t  *p_adts_node,
+                      void              *p_data,
+                      size_t             bytes,
+                      int64_t            key );
+
+adts_heap_node_t *
+adts_multiqueue_pop( adts_multiqueue_t *p_adts_multiqueue );
+
+size_t
+adts_multiqueue_entries( adts_multiqueue_t *p_adts_multiqueue );
+
+uint32_t
+adts_multiqueue_queues( adts_multiqueue_t *p_adts_multiqueue );
+
+void
+adts_multiqueue_stats( adts_multiqueue_t       *p_adts_multiqueue,
+                       adts_multiqueue_stats_t *p_out );
+
+void
+adts_multiqueue_mem_usage( adts_multiqueue_t *p_adts_multiqueue,
+                           adts_mem_stats_t  *p_out );
+
+void
+adts_multiqueue_destroy( adts_multiqueue_t *p_adts_multiqueue );
+
+adts_multiqueue_t *
+adts_multiqueue_create( const adts_multiqueue_create_t *p_op );
+
+
+/**
+ **************************************************************************
+ * \details
+ *   Unit Test prototypes
+ *
+ **************************************************************************
+ */
+void
+utest_adts_multiqueue( void );
@@ -36,6 +36,39 @@
 #endif
 
 
+/**
+ **************************************************************************
+ * \brief
+ *   Cache line size, used to separate state written by different threads
+ *
+ **************************************************************************
+ */
+#define ADTS_CACHELINE_BYTES (64)
+#define ADTS_CACHELINE_ALIGN __attribute__((aligned(ADTS_CACHELINE_BYTES)))
+
+
+/**
+ **************************************************************************
+ * \brief
+ *   Spin wait hint, yields pipeline resources to a sibling hyperthread
+ *
+ **************************************************************************
+ */
+static inline void
+adts_cpu_pause( void )
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield" ::: "memory");
+#else
+    __asm__ __volatile__("" ::: "memory");
+#endif
+
+    return;
+} /* adts_cpu_pause() */
+
+
 
 
 
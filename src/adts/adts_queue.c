@@ -1,13 +1,16 @@
 
 #include <errno.h>
 #include <assert.h>
+#include <stdlib.h>
 #include <string.h>
 #include <limits.h>
 #include <stdbool.h>
 #include <inttypes.h>
 
 /* Toolbox */
+#include <adts_time.h>
 #include <adts_queue.h>
+#include <adts_memory.h>
 #include <adts_sanity.h>
 #include <adts_private.h>
 #include <adts_display.h>
@@ -28,24 +31,68 @@
  *
  ****************************************************************************
  */
-typedef struct queue_node_s {
-    void                *p_data;
-    size_t               bytes;
-    struct queue_node_s *p_prev;
-    struct queue_node_s *p_next;
-} queue_node_t;
+typedef struct {
+    void   *p_data;
+    size_t  bytes;
+} queue_slot_t;
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Power of two slot array.  head and tail are free running, thus the
+ *   depth is (tail - head), a slot index is the count masked, and the
+ *   counts double as lifetime dequeues / enqueues.  A full ring doubles
+ *   in place of failing the enqueue.
+ *
+ ****************************************************************************
+ */
+#define QUEUE_RING_SLOTS_MIN (16)
+
+typedef struct {
+    queue_slot_t *p_slots;
+    size_t        slots;
+    size_t        mask;
+    size_t        head;  /**< next dequeue */
+    size_t        tail;  /**< next enqueue */
+} queue_ring_t;
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   A lane is a ring plus its scheduling weight, depth limit and the
+ *   counters which are not derived from the ring.
+ *
+ ****************************************************************************
+ */
+typedef struct {
+    queue_ring_t  ring;
+    uint32_t      quantum;
+    size_t        limit;
+    size_t        depth_peak;
+    size_t        waits;
+    size_t        drops;
+} queue_lane_t;
 
 
 /*
  ****************************************************************************
+ * \details
+ *   Bit n of occupied is set while lane n is non-empty.  drr_lane and
+ *   drr_credit are the lane in service and its remaining quantum.
  *
  ****************************************************************************
  */
 typedef struct {
-    size_t        elems_curr;
-    queue_node_t *p_head;
-    queue_node_t *p_tail;
-    adts_sanity_t sanity;
+    queue_lane_t        *p_lanes;
+    size_t               lanes;
+    uint64_t             occupied;
+    adts_queue_policy_t  policy;
+    size_t               drr_lane;
+    uint32_t             drr_credit;
+    adts_sanity_t        sanity;
+    adts_mem_t           mem;
 } queue_t;
 
 
@@ -59,6 +106,100 @@ typedef struct {
  * #        #####  #     #  #####     #      ###   ####### #     #  #####
 ******************************************************************************/
 
+/*
+ ****************************************************************************
+ * \details
+ *   Double the slot array.  Live entries keep their free running count,
+ *   thus are copied to the slot that count masks to in the new ring.
+ *
+ ****************************************************************************
+ */
+static int32_t
+queue_ring_grow( queue_t      *p_queue,
+                 queue_ring_t *p_ring )
+{
+    int32_t       rc      = 0;
+    queue_slot_t *p_slots = NULL;
+    size_t        slots   = p_ring->slots << 1;
+
+    p_slots = adts_mem_alloc(&(p_queue->mem), slots * sizeof(*p_slots));
+    if (unlikely(NULL == p_slots)) {
+        rc = ENOMEM;
+        goto exception;
+    }
+
+    for (size_t pos = p_ring->head; pos != p_ring->tail; pos++) {
+        p_slots[pos & (slots - 1)] = p_ring->p_slots[pos & p_ring->mask];
+    }
+
+    adts_mem_put(&(p_queue->mem), p_ring->p_slots,
+                 p_ring->slots * sizeof(*p_slots));
+
+    p_ring->p_slots = p_slots;
+    p_ring->slots   = slots;
+    p_ring->mask    = slots - 1;
+
+exception:
+    return rc;
+} /* queue_ring_grow() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Deficit round robin lane selection, occupied must be non-zero.  The
+ *   lane in service keeps the turn until it has dequeued its quantum or
+ *   drained, then the turn passes to the next non-empty lane in circular
+ *   order.
+ *
+ ****************************************************************************
+ */
+static inline size_t
+queue_lane_select_drr( queue_t *p_queue )
+{
+    size_t   lane = 0;
+    uint64_t next = 0;
+
+    if (p_queue->drr_credit) {
+        lane = p_queue->drr_lane;
+        goto exception;
+    }
+
+    /* new turn, first non-empty lane at or after drr_lane */
+    next = p_queue->occupied & (~0ull << p_queue->drr_lane);
+    lane = __builtin_ctzll(next ? next : p_queue->occupied);
+
+    p_queue->drr_lane   = lane;
+    p_queue->drr_credit = p_queue->p_lanes[lane].quantum;
+
+exception:
+    return lane;
+} /* queue_lane_select_drr() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   A wait is charged to every other non-empty lane passed over by a
+ *   dequeue.
+ *
+ ****************************************************************************
+ */
+static inline void
+queue_lane_waits( queue_t *p_queue,
+                  size_t   lane )
+{
+    uint64_t others = p_queue->occupied & ~(1ull << lane);
+
+    while (others) {
+        p_queue->p_lanes[__builtin_ctzll(others)].waits++;
+        others &= (others - 1);
+    }
+
+    return;
+} /* queue_lane_waits() */
+
+
 /*
  ****************************************************************************
  *
@@ -70,7 +211,7 @@ adts_queue_is_empty( adts_queue_t *p_adts_queue )
 {
     queue_t *p_queue = (queue_t *) p_adts_queue;
 
-    return ((NULL == p_queue->p_head) && (NULL == p_queue->p_tail));
+    return (0 == p_queue->occupied);
 } /* adts_queue_is_empty() */
 
 
@@ -95,12 +236,82 @@ adts_queue_is_not_empty( adts_queue_t *p_adts_queue )
 size_t
 adts_queue_entries( adts_queue_t *p_adts_queue )
 {
-    queue_t *p_queue = (queue_t *) p_adts_queue;
+    size_t        elems   = 0;
+    queue_t      *p_queue = (queue_t *) p_adts_queue;
+    queue_ring_t *p_ring  = NULL;
+
+    for (size_t lane = 0; lane < p_queue->lanes; lane++) {
+        p_ring  = &(p_queue->p_lanes[lane].ring);
+        elems  += p_ring->tail - p_ring->head;
+    }
 
-    return p_queue->elems_curr;
+    return elems;
 } /* adts_queue_entries() */
 
 
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+size_t
+adts_queue_lanes( adts_queue_t *p_adts_queue )
+{
+    queue_t *p_queue = (queue_t *) p_adts_queue;
+
+    return p_queue->lanes;
+} /* adts_queue_lanes() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+int32_t
+adts_queue_lane_stats( adts_queue_t            *p_adts_queue,
+                       size_t                   lane,
+                       adts_queue_lane_stats_t *p_out )
+{
+    int32_t       rc      = 0;
+    queue_t      *p_queue = (queue_t *) p_adts_queue;
+    queue_lane_t *p_lane  = NULL;
+
+    if (unlikely(lane >= p_queue->lanes)) {
+        rc = EINVAL;
+        goto exception;
+    }
+    p_lane = &(p_queue->p_lanes[lane]);
+
+    p_out->depth      = p_lane->ring.tail - p_lane->ring.head;
+    p_out->depth_peak = p_lane->depth_peak;
+    p_out->enqueues   = p_lane->ring.tail;
+    p_out->dequeues   = p_lane->ring.head;
+    p_out->waits      = p_lane->waits;
+    p_out->drops      = p_lane->drops;
+
+exception:
+    return rc;
+} /* adts_queue_lane_stats() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_queue_mem_usage( adts_queue_t     *p_adts_queue,
+                      adts_mem_stats_t *p_out )
+{
+    queue_t *p_queue = (queue_t *) p_adts_queue;
+
+    adts_mem_usage(&(p_queue->mem), p_out);
+
+    return;
+} /* adts_queue_mem_usage() */
+
+
 /*
  ****************************************************************************
  *
@@ -109,29 +320,29 @@ adts_queue_entries( adts_queue_t *p_adts_queue )
 void
 adts_queue_display( adts_queue_t *p_adts_queue )
 {
-    size_t         idx      = 0;
-    size_t         elems    = 0;
     size_t         digits   = 0;
     queue_t       *p_queue  = (queue_t *) p_adts_queue;
-    queue_node_t  *p_tmp    = NULL;
+    queue_ring_t  *p_ring   = NULL;
+    queue_slot_t  *p_slot   = NULL;
     adts_sanity_t *p_sanity = &(p_queue->sanity);
 
     adts_sanity_entry(p_sanity);
 
-    /* display the entire queue with dynamic width formatting */
-    elems  = adts_queue_entries(p_adts_queue);
-    digits = adts_digits_decimal(elems);
-    p_tmp  = p_queue->p_head;
-    while (p_tmp) {
-        printf("[%*d]  node: %p  vaddr: %p  bytes: %d \n",
-                digits,
-                idx,
-                p_tmp,
-                p_tmp->p_data,
-                p_tmp->bytes);
+    /* display each lane, oldest first, with dynamic width formatting */
+    digits = adts_digits_decimal(adts_queue_entries(p_adts_queue));
+    for (size_t lane = 0; lane < p_queue->lanes; lane++) {
+        p_ring = &(p_queue->p_lanes[lane].ring);
 
-        idx++;
-        p_tmp = p_tmp->p_next;
+        for (size_t idx = 0; idx < (p_ring->tail - p_ring->head); idx++) {
+            p_slot = &(p_ring->p_slots[(p_ring->head + idx) & p_ring->mask]);
+            printf("lane: %2zu [%*zu]  slot: %p  vaddr: %p  bytes: %zu \n",
+                    lane,
+                    (int) digits,
+                    idx,
+                    p_slot,
+                    p_slot->p_data,
+                    p_slot->bytes);
+        }
     }
 
     adts_sanity_exit(p_sanity);
@@ -150,32 +361,44 @@ void *
 adts_queue_dequeue( adts_queue_t *p_adts_queue )
 {
     void          *p_data   = NULL;
+    size_t         lane     = 0;
     queue_t       *p_queue  = (queue_t *) p_adts_queue;
-    queue_node_t  *p_node   = NULL;
+    queue_lane_t  *p_lane   = NULL;
+    queue_ring_t  *p_ring   = NULL;
     adts_sanity_t *p_sanity = &(p_queue->sanity);
 
     adts_sanity_entry(p_sanity);
 
-    /* Ensure we don't dereference a null tail pointer */
-    if (likely(p_queue->p_tail)) {
-        p_data = p_queue->p_tail->p_data;
-    }else {
+    if (unlikely(0 == p_queue->occupied)) {
         goto exception;
     }
 
-    if (p_queue->p_head == p_queue->p_tail) {
-        /* This is the last element */
-        p_queue->p_head = NULL;
-        p_queue->p_tail = NULL;
+    if (likely(ADTS_QUEUE_POLICY_STRICT == p_queue->policy)) {
+        lane = __builtin_ctzll(p_queue->occupied);
     }else {
-        /* Remove from tail only */
-        p_queue->p_tail         = p_queue->p_tail->p_prev;
-        p_queue->p_tail->p_next = NULL;
+        lane = queue_lane_select_drr(p_queue);
     }
+    p_lane = &(p_queue->p_lanes[lane]);
+    p_ring = &(p_lane->ring);
 
-    /* Remove the node memory */
-    free(p_node);
-    p_queue->elems_curr--;
+    if (unlikely(p_queue->occupied & (p_queue->occupied - 1))) {
+        queue_lane_waits(p_queue, lane);
+    }
+
+    p_data = p_ring->p_slots[p_ring->head & p_ring->mask].p_data;
+    p_ring->head++;
+
+    if (p_ring->head == p_ring->tail) {
+        p_queue->occupied  &= ~(1ull << lane);
+        p_queue->drr_credit = 1;
+    }
+
+    if (ADTS_QUEUE_POLICY_DRR == p_queue->policy) {
+        if (0 == --(p_queue->drr_credit)) {
+            /* pass the turn, the selection wraps via the occupied mask */
+            p_queue->drr_lane = ((lane + 1) < p_queue->lanes) ? (lane + 1) : 0;
+        }
+    }
 
 exception:
     adts_sanity_exit(p_sanity);
@@ -183,6 +406,55 @@ exception:
 } /* adts_queue_dequeue() */
 
 
+/*
+ ****************************************************************************
+ * \details
+ *   Append to a validated lane.  Shared by the default and the lane
+ *   enqueue such that the single lane path costs no extra call.
+ *
+ ****************************************************************************
+ */
+static inline int32_t
+queue_enqueue_lane( queue_t *p_queue,
+                    size_t   lane,
+                    void    *p_data,
+                    size_t   bytes )
+{
+    int32_t       rc     = 0;
+    queue_lane_t *p_lane = &(p_queue->p_lanes[lane]);
+    queue_ring_t *p_ring = &(p_lane->ring);
+    queue_slot_t *p_slot = NULL;
+    size_t        depth  = p_ring->tail - p_ring->head;
+
+    if (unlikely(p_lane->limit && (depth >= p_lane->limit))) {
+        p_lane->drops++;
+        rc = ENOSPC;
+        goto exception;
+    }
+
+    if (unlikely(depth == p_ring->slots)) {
+        rc = queue_ring_grow(p_queue, p_ring);
+        if (unlikely(rc)) {
+            p_lane->drops++;
+            goto exception;
+        }
+    }
+
+    p_slot         = &(p_ring->p_slots[p_ring->tail & p_ring->mask]);
+    p_slot->p_data = p_data;
+    p_slot->bytes  = bytes;
+    p_ring->tail++;
+
+    p_queue->occupied |= (1ull << lane);
+    if (unlikely(depth >= p_lane->depth_peak)) {
+        p_lane->depth_peak = depth + 1;
+    }
+
+exception:
+    return rc;
+} /* queue_enqueue_lane() */
+
+
 /*
  ****************************************************************************
  *
@@ -190,40 +462,49 @@ exception:
  ****************************************************************************
  */
 int32_t
-adts_queue_enqueue( adts_queue_t *p_adts_queue,
-                    void         *p_data,
-                    size_t        bytes )
+adts_queue_enqueue_lane( adts_queue_t *p_adts_queue,
+                         size_t        lane,
+                         void         *p_data,
+                         size_t        bytes )
 {
     int32_t        rc       = 0;
     queue_t       *p_queue  = (queue_t *) p_adts_queue;
-    queue_node_t  *p_node   = NULL;
     adts_sanity_t *p_sanity = &(p_queue->sanity);
 
     adts_sanity_entry(p_sanity);
 
-    p_node = adts_mem_zalloc(sizeof(*p_node));
-    if (unlikely(NULL == p_node)) {
-        rc = ENOMEM;
+    if (unlikely(lane >= p_queue->lanes)) {
+        rc = EINVAL;
         goto exception;
     }
-    p_node->p_data = p_data;
-    p_node->bytes  = bytes;
-
-    if ((NULL == p_queue->p_head) &&
-        (NULL == p_queue->p_tail)) {
-        /* first addition to list */
-        p_queue->p_head = p_node;
-        p_queue->p_tail = p_node;
-    }else {
-        /* Add new nodes to head of list */
-        p_node->p_next          = p_queue->p_head;
-        p_queue->p_head->p_prev = p_node;
-        p_queue->p_head         = p_node;
-    }
 
-    p_queue->elems_curr++;
+    rc = queue_enqueue_lane(p_queue, lane, p_data, bytes);
 
 exception:
+    adts_sanity_exit(p_sanity);
+    return rc;
+} /* adts_queue_enqueue_lane() */
+
+
+/*
+ ****************************************************************************
+ *
+ *
+ ****************************************************************************
+ */
+int32_t
+adts_queue_enqueue( adts_queue_t *p_adts_queue,
+                    void         *p_data,
+                    size_t        bytes )
+{
+    int32_t        rc       = 0;
+    queue_t       *p_queue  = (queue_t *) p_adts_queue;
+    adts_sanity_t *p_sanity = &(p_queue->sanity);
+
+    adts_sanity_entry(p_sanity);
+
+    rc = queue_enqueue_lane(p_queue, 0, p_data, bytes);
+
     adts_sanity_exit(p_sanity);
     return rc;
 } /* adts_queue_enqueue() */
@@ -240,11 +521,24 @@ void
 adts_queue_destroy( adts_queue_t *p_adts_queue )
 {
     queue_t       *p_queue  = (queue_t *) p_adts_queue;
+    queue_ring_t  *p_ring   = NULL;
+    adts_mem_t     mem      = {0};
     adts_sanity_t *p_sanity = &(p_queue->sanity);
 
     adts_sanity_entry(p_sanity);
 
-    free(p_queue);
+    /* Entries the consumer did not dequeue are dropped with the rings.
+     * Consumer data is not owned by the queue and is left untouched. */
+    for (size_t lane = 0; lane < p_queue->lanes; lane++) {
+        p_ring = &(p_queue->p_lanes[lane].ring);
+        adts_mem_put(&(p_queue->mem), p_ring->p_slots,
+                     p_ring->slots * sizeof(*(p_ring->p_slots)));
+    }
+    adts_mem_put(&(p_queue->mem), p_queue->p_lanes,
+                 p_queue->lanes * sizeof(*(p_queue->p_lanes)));
+
+    mem = p_queue->mem;
+    adts_mem_put(&(mem), p_queue, sizeof(*p_adts_queue));
 
     /* No adts_sanity_exit() since we've freed the memory */
 
@@ -261,12 +555,89 @@ adts_queue_destroy( adts_queue_t *p_adts_queue )
 adts_queue_t *
 adts_queue_create( void )
 {
-    adts_queue_t *p_adts_queue = adts_mem_zalloc(sizeof(*p_adts_queue));
+    adts_queue_create_t op = {0};
 
-    return p_adts_queue;
+    return adts_queue_create_ext(&(op));
 } /* adts_queue_create() */
 
 
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+adts_queue_t *
+adts_queue_create_ext( const adts_queue_create_t *p_op )
+{
+    int32_t       rc           = 0;
+    size_t        lanes        = 0;
+    queue_t      *p_queue      = NULL;
+    queue_lane_t *p_lane       = NULL;
+    adts_mem_t    mem          = {0};
+    adts_queue_t *p_adts_queue = NULL;
+
+    assert(p_op);
+    lanes = p_op->lanes ? p_op->lanes : 1;
+    if ((ADTS_QUEUE_LANES_MAX < lanes) ||
+        (ADTS_QUEUE_POLICY_MAX <= p_op->policy)) {
+        goto exception;
+    }
+
+    adts_mem_init_ext(&(mem), ADTS_MEM_TYPE_QUEUE, p_op->p_allocator);
+
+    p_adts_queue = adts_mem_get(&(mem), sizeof(*p_adts_queue));
+    if (NULL == p_adts_queue) {
+        goto exception;
+    }
+
+    p_queue          = (queue_t *) p_adts_queue;
+    p_queue->mem     = mem;
+    p_queue->policy  = p_op->policy;
+    p_queue->p_lanes = adts_mem_get(&(p_queue->mem), lanes * sizeof(*p_lane));
+    if (NULL == p_queue->p_lanes) {
+        rc = ENOMEM;
+        goto exception;
+    }
+
+    for (p_queue->lanes = 0; p_queue->lanes < lanes; p_queue->lanes++) {
+        p_lane          = &(p_queue->p_lanes[p_queue->lanes]);
+        p_lane->quantum = 1;
+        p_lane->limit   = p_op->lane_limit;
+        if (p_op->p_weights && p_op->p_weights[p_queue->lanes]) {
+            p_lane->quantum = p_op->p_weights[p_queue->lanes];
+        }
+
+        p_lane->ring.slots   = QUEUE_RING_SLOTS_MIN;
+        p_lane->ring.mask    = QUEUE_RING_SLOTS_MIN - 1;
+        p_lane->ring.p_slots =
+            adts_mem_alloc(&(p_queue->mem),
+                           QUEUE_RING_SLOTS_MIN * sizeof(queue_slot_t));
+        if (NULL == p_lane->ring.p_slots) {
+            rc = ENOMEM;
+            goto exception;
+        }
+    }
+
+exception:
+    if (rc) {
+        /* release the lanes built so far, unbuilt slots are NULL */
+        for (size_t idx = 0; p_queue->p_lanes && (idx < lanes); idx++) {
+            p_lane = &(p_queue->p_lanes[idx]);
+            adts_mem_put(&(p_queue->mem), p_lane->ring.p_slots,
+                         QUEUE_RING_SLOTS_MIN * sizeof(queue_slot_t));
+        }
+        adts_mem_put(&(p_queue->mem), p_queue->p_lanes,
+                     lanes * sizeof(*p_lane));
+
+        mem = p_queue->mem;
+        adts_mem_put(&(mem), p_adts_queue, sizeof(*p_adts_queue));
+        p_adts_queue = NULL;
+    }
+
+    return p_adts_queue;
+} /* adts_queue_create_ext() */
+
+
 
 
 /******************************************************************************
@@ -304,6 +675,318 @@ utest_queue_bytes( void )
 } /* utest_queue_bytes() */
 
 
+/*
+ ****************************************************************************
+ * \details
+ *   Report the instance footprint as the queue depth increases, then
+ *   destroy a non-empty queue to verify all nodes are released.
+ *
+ ****************************************************************************
+ */
+static void
+utest_queue_footprint( void )
+{
+    size_t            elems   = 1 << 12;
+    int32_t           rc      = 0;
+    adts_queue_t     *p_queue = NULL;
+    adts_mem_stats_t  inst    = {0};
+    adts_mem_stats_t  before  = {0};
+    adts_mem_stats_t  family  = {0};
+
+    (void) adts_mem_stats(ADTS_MEM_TYPE_QUEUE, &(before));
+
+    p_queue = adts_queue_create();
+    assert(p_queue);
+
+    for (size_t idx = 1; idx <= elems; idx++) {
+        rc = adts_queue_enqueue(p_queue, (void *) idx, sizeof(idx));
+        assert(0 == rc);
+        if (0 == (idx & (idx - 1))) {
+            adts_queue_mem_usage(p_queue, &(inst));
+            CDISPLAY("elems: %8zu  bytes: %10zu  peak: %10zu  bytes/elem: %8.2f",
+                     idx,
+                     inst.bytes_curr,
+                     inst.bytes_peak,
+                     (double) inst.bytes_curr / (double) idx);
+        }
+    }
+
+    /* Destroy while populated */
+    adts_queue_destroy(p_queue);
+
+    (void) adts_mem_stats(ADTS_MEM_TYPE_QUEUE, &(family));
+    CDISPLAY("family   bytes: %10zu  peak: %10zu",
+             family.bytes_curr, family.bytes_peak);
+    assert(before.bytes_curr == family.bytes_curr);
+
+    return;
+} /* utest_queue_footprint() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Enqueue / dequeue in steady state with the ring wrapped, then grow
+ *   while wrapped and verify FIFO order survives the unwrapping copy.
+ *
+ ****************************************************************************
+ */
+static void
+utest_queue_wrap( void )
+{
+    size_t        next_in  = 1;
+    size_t        next_out = 1;
+    int32_t       rc       = 0;
+    adts_queue_t *p_queue  = NULL;
+
+    p_queue = adts_queue_create();
+    assert(p_queue);
+
+    /* rotate a partially full ring past its boundary several times */
+    for (size_t idx = 0; idx < (QUEUE_RING_SLOTS_MIN / 2); idx++) {
+        rc = adts_queue_enqueue(p_queue, (void *) next_in++, sizeof(idx));
+        assert(0 == rc);
+    }
+    for (size_t idx = 0; idx < (QUEUE_RING_SLOTS_MIN * 4); idx++) {
+        rc = adts_queue_enqueue(p_queue, (void *) next_in++, sizeof(idx));
+        assert(0 == rc);
+        assert((void *) next_out++ == adts_queue_dequeue(p_queue));
+    }
+
+    /* grow twice from a wrapped state */
+    for (size_t idx = 0; idx < (QUEUE_RING_SLOTS_MIN * 3); idx++) {
+        rc = adts_queue_enqueue(p_queue, (void *) next_in++, sizeof(idx));
+        assert(0 == rc);
+    }
+    assert((next_in - next_out) == adts_queue_entries(p_queue));
+
+    while (adts_queue_is_not_empty(p_queue)) {
+        assert((void *) next_out++ == adts_queue_dequeue(p_queue));
+    }
+    assert(next_in == next_out);
+
+    adts_queue_destroy(p_queue);
+
+    return;
+} /* utest_queue_wrap() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Items moved by the throughput benchmark and the steady state depth
+ *   held while moving them.
+ *
+ ****************************************************************************
+ */
+#ifndef UTEST_QUEUE_RATE_ITEMS
+#define UTEST_QUEUE_RATE_ITEMS (1 << 23)
+#endif
+
+#ifndef UTEST_QUEUE_RATE_DEPTH
+#define UTEST_QUEUE_RATE_DEPTH (1 << 10)
+#endif
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Single threaded enqueue + dequeue rate at a fixed depth, i.e. a
+ *   pipeline stage which keeps a backlog.
+ *
+ ****************************************************************************
+ */
+static void
+utest_queue_rate( void )
+{
+    size_t        items   = UTEST_QUEUE_RATE_ITEMS;
+    size_t        depth   = UTEST_QUEUE_RATE_DEPTH;
+    size_t        sum     = 0;
+    uint64_t      start   = 0;
+    uint64_t      delta   = 0;
+    adts_queue_t *p_queue = NULL;
+
+    p_queue = adts_queue_create();
+    assert(p_queue);
+
+    for (size_t idx = 0; idx < depth; idx++) {
+        (void) adts_queue_enqueue(p_queue, (void *) idx, sizeof(idx));
+    }
+
+    start = adts_tstamp();
+    for (size_t idx = 0; idx < items; idx++) {
+        (void) adts_queue_enqueue(p_queue, (void *) idx, sizeof(idx));
+        sum += (size_t) adts_queue_dequeue(p_queue);
+    }
+    delta = adts_tstamp() - start;
+
+    adts_queue_destroy(p_queue);
+
+    CDISPLAY("items: %zu  depth: %zu  ns/item: %6.2f  items/s: %12.0f  [%zu]",
+             items,
+             depth,
+             (double) delta / (double) items,
+             (double) items * 1e9 / (double) (delta ? delta : 1),
+             sum);
+
+    return;
+} /* utest_queue_rate() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Strict priority, stats and drops at the lane limit.
+ *
+ ****************************************************************************
+ */
+static void
+utest_queue_lanes_strict( void )
+{
+    adts_queue_t            *p_queue = NULL;
+    adts_queue_create_t      op      = {0};
+    adts_queue_lane_stats_t  stats   = {0};
+
+    op.lanes = ADTS_QUEUE_LANES_MAX + 1;
+    assert(NULL == adts_queue_create_ext(&(op)));
+
+    op.lanes      = 3;
+    op.policy     = ADTS_QUEUE_POLICY_STRICT;
+    op.lane_limit = 4;
+    p_queue       = adts_queue_create_ext(&(op));
+    assert(p_queue);
+    assert(3 == adts_queue_lanes(p_queue));
+    assert(EINVAL == adts_queue_enqueue_lane(p_queue, 3, NULL, 0));
+
+    /* bulk first, then control, control dequeues first */
+    for (size_t idx = 1; idx <= 5; idx++) {
+        int32_t rc = adts_queue_enqueue_lane(p_queue, 2, (void *) (20 + idx), 0);
+
+        assert((idx <= 4) ? (0 == rc) : (ENOSPC == rc));
+    }
+    assert(0 == adts_queue_enqueue_lane(p_queue, 0, (void *) 1, 0));
+    assert(0 == adts_queue_enqueue_lane(p_queue, 0, (void *) 2, 0));
+    assert(6 == adts_queue_entries(p_queue));
+
+    assert((void *) 1 == adts_queue_dequeue(p_queue));
+    assert((void *) 2 == adts_queue_dequeue(p_queue));
+    assert(0 == adts_queue_enqueue_lane(p_queue, 1, (void *) 11, 0));
+    assert((void *) 11 == adts_queue_dequeue(p_queue));
+    for (size_t idx = 1; idx <= 4; idx++) {
+        assert((void *) (20 + idx) == adts_queue_dequeue(p_queue));
+    }
+    assert(adts_queue_is_empty(p_queue));
+
+    assert(0 == adts_queue_lane_stats(p_queue, 2, &(stats)));
+    assert((0 == stats.depth) && (4 == stats.depth_peak));
+    assert((4 == stats.enqueues) && (4 == stats.dequeues));
+    assert((1 == stats.drops) && (3 == stats.waits));
+    assert(EINVAL == adts_queue_lane_stats(p_queue, 3, &(stats)));
+
+    adts_queue_destroy(p_queue);
+
+    return;
+} /* utest_queue_lanes_strict() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Deficit round robin with weights 3 / 1, both lanes backlogged, then
+ *   a lane draining mid turn passes the turn on.
+ *
+ ****************************************************************************
+ */
+static void
+utest_queue_lanes_drr( void )
+{
+    size_t               served[ 2 ] = {0};
+    uint32_t             weights[ 2 ] = {3, 1};
+    adts_queue_t        *p_queue     = NULL;
+    adts_queue_create_t  op          = {0};
+
+    op.lanes     = 2;
+    op.policy    = ADTS_QUEUE_POLICY_DRR;
+    op.p_weights = weights;
+    p_queue      = adts_queue_create_ext(&(op));
+    assert(p_queue);
+
+    for (size_t idx = 0; idx < 400; idx++) {
+        assert(0 == adts_queue_enqueue_lane(p_queue, 0, (void *) 1, 0));
+        assert(0 == adts_queue_enqueue_lane(p_queue, 1, (void *) 2, 0));
+    }
+
+    /* exact 3:1 service while both lanes are backlogged */
+    for (size_t idx = 0; idx < 400; idx++) {
+        size_t lane = (size_t) adts_queue_dequeue(p_queue) - 1;
+
+        assert(lane == (((idx % 4) < 3) ? 0 : 1));
+        served[lane]++;
+    }
+    assert((300 == served[0]) && (100 == served[1]));
+
+    /* lane 0 drains, lane 1 is then served continuously */
+    while (adts_queue_is_not_empty(p_queue)) {
+        served[(size_t) adts_queue_dequeue(p_queue) - 1]++;
+    }
+    assert((400 == served[0]) && (400 == served[1]));
+
+    adts_queue_destroy(p_queue);
+
+    return;
+} /* utest_queue_lanes_drr() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Mixed control / bulk traffic through two strict lanes versus the
+ *   single lane FIFO at the same depth.
+ *
+ ****************************************************************************
+ */
+static void
+utest_queue_lanes_rate( void )
+{
+    size_t               items   = UTEST_QUEUE_RATE_ITEMS;
+    size_t               depth   = UTEST_QUEUE_RATE_DEPTH;
+    size_t               sum     = 0;
+    uint64_t             start   = 0;
+    uint64_t             delta   = 0;
+    adts_queue_t        *p_queue = NULL;
+    adts_queue_create_t  op      = {0};
+
+    op.lanes  = 2;
+    op.policy = ADTS_QUEUE_POLICY_STRICT;
+    p_queue   = adts_queue_create_ext(&(op));
+    assert(p_queue);
+
+    for (size_t idx = 0; idx < depth; idx++) {
+        (void) adts_queue_enqueue_lane(p_queue, 1, (void *) idx, sizeof(idx));
+    }
+
+    /* one control entry in eight */
+    start = adts_tstamp();
+    for (size_t idx = 0; idx < items; idx++) {
+        (void) adts_queue_enqueue_lane(p_queue, (0 == (idx & 7)) ? 0 : 1,
+                                       (void *) idx, sizeof(idx));
+        sum += (size_t) adts_queue_dequeue(p_queue);
+    }
+    delta = adts_tstamp() - start;
+
+    adts_queue_destroy(p_queue);
+
+    CDISPLAY("lanes: 2  items: %zu  depth: %zu  ns/item: %6.2f  items/s: %12.0f  [%zu]",
+             items,
+             depth,
+             (double) delta / (double) items,
+             (double) items * 1e9 / (double) (delta ? delta : 1),
+             sum);
+
+    return;
+} /* utest_queue_lanes_rate() */
+
+
 /*
  ****************************************************************************
  * test control
@@ -313,6 +996,8 @@ utest_queue_bytes( void )
 static void
 utest_control( void )
 {
+    utest_queue_bytes();
+
     CDISPLAY("=========================================================");
     {
         adts_queue_t *p_queue = NULL;
@@ -324,6 +1009,72 @@ utest_control( void )
         adts_queue_destroy(p_queue);
     }
 
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: enqueue -> dequeue FIFO order");
+
+        int32_t       rc      = 0;
+        adts_queue_t *p_queue = NULL;
+
+        p_queue = adts_queue_create();
+        assert(p_queue);
+
+        for (size_t idx = 1; idx <= 8; idx++) {
+            rc = adts_queue_enqueue(p_queue, (void *) idx, sizeof(idx));
+            assert(0 == rc);
+        }
+
+        for (size_t idx = 1; idx <= 8; idx++) {
+            assert((void *) idx == adts_queue_dequeue(p_queue));
+        }
+        assert(adts_queue_is_empty(p_queue));
+        assert(NULL == adts_queue_dequeue(p_queue));
+
+        adts_queue_destroy(p_queue);
+    }
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: queue footprint");
+
+        utest_queue_footprint();
+    }
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: wrapped ring grow");
+
+        utest_queue_wrap();
+    }
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: enqueue / dequeue rate");
+
+        utest_queue_rate();
+    }
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: lanes, strict priority and limits");
+
+        utest_queue_lanes_strict();
+    }
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: lanes, deficit round robin");
+
+        utest_queue_lanes_drr();
+    }
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: lanes, enqueue / dequeue rate");
+
+        utest_queue_lanes_rate();
+    }
+
     return;
 } /* utest_control() */
 
@@ -3,6 +3,7 @@
 #include <string.h>
 #include <stdbool.h>
 #include <inttypes.h>
+#include <adts_memory.h>
 
 
 /**
@@ -11,7 +12,7 @@
  *
  **************************************************************************
  */
-#define ADTS_QUEUE_BYTES (64)
+#define ADTS_QUEUE_BYTES (96)
 
 
 /**
@@ -25,6 +26,65 @@ typedef struct {
 } adts_queue_t;
 
 
+/**
+ **************************************************************************
+ * \details
+ *   Lane dequeue policy.
+ *
+ *   - STRICT  lane 0 is served first, lane n only while lanes 0 .. n-1
+ *             are empty
+ *   - DRR     deficit round robin, each non-empty lane in turn dequeues
+ *             up to its weight in entries before the turn passes on
+ *
+ **************************************************************************
+ */
+#define ADTS_QUEUE_LANES_MAX (64)
+
+typedef enum {
+    ADTS_QUEUE_POLICY_STRICT = 0,
+    ADTS_QUEUE_POLICY_DRR,
+    ADTS_QUEUE_POLICY_MAX,
+} adts_queue_policy_t;
+
+
+/**
+ **************************************************************************
+ * \details
+ *   queue create options
+ *
+ *   lanes of 0 or 1 is a single FIFO.  p_weights, when given, holds one
+ *   DRR weight per lane, 0 selects a weight of 1.  lane_limit bounds the
+ *   depth of each lane, an enqueue beyond it is dropped, 0 is unbounded.
+ *
+ **************************************************************************
+ */
+typedef struct {
+    const adts_allocator_t *p_allocator; /**< NULL selects the default */
+    size_t                  lanes;       /**< 1 .. ADTS_QUEUE_LANES_MAX */
+    adts_queue_policy_t     policy;      /**< multi lane dequeue order */
+    const uint32_t         *p_weights;   /**< DRR weights, NULL for 1 */
+    size_t                  lane_limit;  /**< per lane depth limit */
+} adts_queue_create_t;
+
+
+/**
+ **************************************************************************
+ * \details
+ *   Per lane counters.  A wait is a dequeue served from another lane
+ *   while this lane was non-empty.
+ *
+ **************************************************************************
+ */
+typedef struct {
+    size_t depth;      /**< current entries */
+    size_t depth_peak; /**< lifetime maximum of depth */
+    size_t enqueues;   /**< accepted entries */
+    size_t dequeues;   /**< removed entries */
+    size_t waits;      /**< dequeues which passed this lane over */
+    size_t drops;      /**< rejected entries, limit or no memory */
+} adts_queue_lane_stats_t;
+
+
 
 
 /**
@@ -42,6 +102,10 @@ adts_queue_is_not_empty( adts_queue_t *p_adts_queue );
 size_t
 adts_queue_entries( adts_queue_t *p_adts_queue );
 
+void
+adts_queue_mem_usage( adts_queue_t     *p_adts_queue,
+                      adts_mem_stats_t *p_out );
+
 void
 adts_queue_display( adts_queue_t *p_adts_queue );
 
@@ -53,12 +117,38 @@ adts_queue_enqueue( adts_queue_t *p_adts_queue,
                     void         *p_data,
                     size_t        bytes );
 
+
+/**
+ **************************************************************************
+ * \details
+ *   adts_queue_enqueue() is lane 0.  adts_queue_enqueue_lane() returns
+ *   EINVAL for an unknown lane and ENOSPC when the lane is at its limit.
+ *
+ **************************************************************************
+ */
+int32_t
+adts_queue_enqueue_lane( adts_queue_t *p_adts_queue,
+                         size_t        lane,
+                         void         *p_data,
+                         size_t        bytes );
+
+size_t
+adts_queue_lanes( adts_queue_t *p_adts_queue );
+
+int32_t
+adts_queue_lane_stats( adts_queue_t            *p_adts_queue,
+                       size_t                   lane,
+                       adts_queue_lane_stats_t *p_out );
+
 void
 adts_queue_destroy( adts_queue_t *p_adts_queue );
 
 adts_queue_t *
 adts_queue_create( void );
 
+adts_queue_t *
+adts_queue_create_ext( const adts_queue_create_t *p_op );
+
 void
 utest_adts_queue( void );
 
@@ -0,0 +1,965 @@
+#include <errno.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <adts_heap.h>
+#include <adts_time.h>
+#include <adts_memory.h>
+#include <adts_sanity.h>
+#include <adts_private.h>
+#include <adts_display.h>
+#include <adts_radixheap.h>
+
+
+/******************************************************************************
+ #####  ####### ######  #     #  #####  ####### #     # ######  #######  #####
+#     #    #    #     # #     # #     #    #    #     # #     # #       #     #
+#          #    #     # #     # #          #    #     # #     # #       #
+ #####     #    ######  #     # #          #    #     # ######  #####    #####
+      #    #    #   #   #     # #          #    #     # #   #   #             #
+#     #    #    #    #  #     # #     #    #    #     # #    #  #       #     #
+ #####     #    #     #  #####   #####     #     #####  #     # #######  #####
+******************************************************************************/
+
+/*
+ ****************************************************************************
+ * \details
+ *   Bucket 0 holds keys equal to last, bucket b > 0 keys whose highest bit
+ *   differing from last is b - 1.
+ *
+ ****************************************************************************
+ */
+#define RADIXHEAP_BUCKETS      (65)
+#define RADIXHEAP_BUCKET_ELEMS (16) /**< initial bucket capacity */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   The node records its bucket and index, thus update and remove locate
+ *   it directly.
+ *
+ ****************************************************************************
+ */
+typedef struct {
+    void     *p_data;
+    size_t    bytes;
+    uint64_t  key;
+    uint32_t  bucket;
+    uint32_t  idx;
+} radixheap_node_t;
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Buckets are arrays of key and node, as in adts_heap, thus a
+ *   redistribution streams through keys without touching the nodes
+ *   beyond recording their new position.
+ *
+ ****************************************************************************
+ */
+typedef struct {
+    uint64_t          key;
+    radixheap_node_t *p_node;
+} radixheap_entry_t;
+
+typedef struct {
+    radixheap_entry_t *p_entries;
+    uint32_t           elems;
+    uint32_t           limit;
+} radixheap_bucket_t;
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   occupied bit b - 1 is set when bucket b > 0 is not empty.
+ *
+ ****************************************************************************
+ */
+typedef struct {
+    uint64_t           last;
+    uint64_t           occupied;
+    size_t             elems;
+    radixheap_bucket_t bucket[ RADIXHEAP_BUCKETS ];
+    adts_sanity_t      sanity;
+    adts_mem_t         mem;
+} radixheap_t;
+
+
+
+/******************************************************************************
+ * ####### #     # #     #  #####  #######   ###   ####### #     #  #####
+ * #       #     # ##    # #     #    #       #    #     # ##    # #     #
+ * #       #     # # #   # #          #       #    #     # # #   # #
+ * #####   #     # #  #  # #          #       #    #     # #  #  #  #####
+ * #       #     # #   # # #          #       #    #     # #   # #       #
+ * #       #     # #    ## #     #    #       #    #     # #    ## #     #
+ * #        #####  #     #  #####     #      ###   ####### #     #  #####
+******************************************************************************/
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+static inline uint32_t
+radixheap_bucket( uint64_t key,
+                  uint64_t last )
+{
+    uint64_t diff = key ^ last;
+
+    return diff ? (uint32_t) (64 - __builtin_clzll(diff)) : 0;
+} /* radixheap_bucket() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+static inline bool
+radixheap_node_is_member( radixheap_t      *p_rh,
+                          radixheap_node_t *p_node )
+{
+    uint32_t bucket = p_node->bucket;
+
+    return ((bucket < RADIXHEAP_BUCKETS) &&
+            (p_node->idx < p_rh->bucket[bucket].elems) &&
+            (p_rh->bucket[bucket].p_entries[p_node->idx].p_node == p_node));
+} /* radixheap_node_is_member() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Ensure room for elems more entries, doubling.
+ *
+ ****************************************************************************
+ */
+static int32_t
+radixheap_reserve( radixheap_t *p_rh,
+                   uint32_t     bucket,
+                   size_t       elems )
+{
+    int32_t             rc       = 0;
+    radixheap_bucket_t *p_bucket = &(p_rh->bucket[bucket]);
+    size_t              limit    = MAX(p_bucket->limit, RADIXHEAP_BUCKET_ELEMS);
+    radixheap_entry_t  *p_new    = NULL;
+
+    if (likely((p_bucket->elems + elems) <= p_bucket->limit)) {
+        goto exception;
+    }
+
+    while (limit < (p_bucket->elems + elems)) {
+        limit *= 2;
+    }
+
+    if (unlikely(limit > UINT32_MAX)) {
+        rc = ENOMEM;
+        goto exception;
+    }
+
+    p_new = adts_mem_resize(&(p_rh->mem), p_bucket->p_entries,
+                            p_bucket->limit * sizeof(*p_new),
+                            limit * sizeof(*p_new));
+    if (NULL == p_new) {
+        rc = ENOMEM;
+        goto exception;
+    }
+
+    p_bucket->p_entries = p_new;
+    p_bucket->limit     = (uint32_t) limit;
+
+exception:
+    return rc;
+} /* radixheap_reserve() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Room must have been reserved.
+ *
+ ****************************************************************************
+ */
+static inline void
+radixheap_append( radixheap_t      *p_rh,
+                  uint32_t          bucket,
+                  uint64_t          key,
+                  radixheap_node_t *p_node )
+{
+    radixheap_bucket_t *p_bucket = &(p_rh->bucket[bucket]);
+    uint32_t            idx      = p_bucket->elems++;
+
+    p_bucket->p_entries[idx].key    = key;
+    p_bucket->p_entries[idx].p_node = p_node;
+    p_node->bucket                  = bucket;
+    p_node->idx                     = idx;
+
+    if (bucket) {
+        p_rh->occupied |= 1ULL << (bucket - 1);
+    }
+
+    return;
+} /* radixheap_append() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   The last entry fills the hole.
+ *
+ ****************************************************************************
+ */
+static inline void
+radixheap_unlink( radixheap_t      *p_rh,
+                  radixheap_node_t *p_node )
+{
+    uint32_t            bucket   = p_node->bucket;
+    radixheap_bucket_t *p_bucket = &(p_rh->bucket[bucket]);
+    uint32_t            tail     = --p_bucket->elems;
+
+    if (p_node->idx != tail) {
+        p_bucket->p_entries[p_node->idx]             = p_bucket->p_entries[tail];
+        p_bucket->p_entries[p_node->idx].p_node->idx = p_node->idx;
+    }
+
+    if (bucket && (0 == tail)) {
+        p_rh->occupied &= ~(1ULL << (bucket - 1));
+    }
+
+    p_node->bucket = RADIXHEAP_BUCKETS;
+
+    return;
+} /* radixheap_unlink() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Ensure bucket 0 is populated when not empty.  last advances to the
+ *   least key of the lowest occupied bucket b, whose entries then all
+ *   belong to buckets below b, which are all empty.  Room is reserved
+ *   in each target first, thus an ENOMEM leaves the heap unchanged.
+ *
+ ****************************************************************************
+ */
+static int32_t
+radixheap_settle( radixheap_t *p_rh )
+{
+    int32_t             rc       = 0;
+    uint32_t            bucket   = 0;
+    uint64_t            least    = UINT64_MAX;
+    radixheap_bucket_t *p_bucket = NULL;
+    uint32_t            count[ RADIXHEAP_BUCKETS ];
+
+    if (likely(p_rh->bucket[0].elems || (0 == p_rh->occupied))) {
+        goto exception;
+    }
+
+    bucket   = 1 + (uint32_t) __builtin_ctzll(p_rh->occupied);
+    p_bucket = &(p_rh->bucket[bucket]);
+
+    for (uint32_t idx = 0; idx < p_bucket->elems; idx++) {
+        least = MIN(least, p_bucket->p_entries[idx].key);
+    }
+
+    memset(count, 0, bucket * sizeof(count[0]));
+    for (uint32_t idx = 0; idx < p_bucket->elems; idx++) {
+        count[radixheap_bucket(p_bucket->p_entries[idx].key, least)]++;
+    }
+
+    for (uint32_t target = 0; target < bucket; target++) {
+        if (count[target]) {
+            rc = radixheap_reserve(p_rh, target, count[target]);
+            if (rc) {
+                goto exception;
+            }
+        }
+    }
+
+    p_rh->last = least;
+    for (uint32_t idx = 0; idx < p_bucket->elems; idx++) {
+        radixheap_entry_t *p_entry = &(p_bucket->p_entries[idx]);
+
+        radixheap_append(p_rh, radixheap_bucket(p_entry->key, least),
+                         p_entry->key, p_entry->p_node);
+    }
+
+    p_bucket->elems  = 0;
+    p_rh->occupied  &= ~(1ULL << (bucket - 1));
+
+exception:
+    return rc;
+} /* radixheap_settle() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+int32_t
+adts_radixheap_push( adts_radixheap_t      *p_adts_radixheap,
+                     adts_radixheap_node_t *p_adts_node,
+                     void                  *p_data,
+                     size_t                 bytes,
+                     uint64_t               key )
+{
+    int32_t           rc     = 0;
+    uint32_t          bucket = 0;
+    radixheap_t      *p_rh   = (radixheap_t *) p_adts_radixheap;
+    radixheap_node_t *p_node = (radixheap_node_t *) p_adts_node;
+
+    adts_sanity_entry(&(p_rh->sanity));
+
+    /* Duplicates allowed */
+    assert(p_node);
+    assert(p_data);
+    assert(bytes);
+
+    if (unlikely(key < p_rh->last)) {
+        rc = EINVAL;
+        goto exception;
+    }
+
+    bucket = radixheap_bucket(key, p_rh->last);
+    rc     = radixheap_reserve(p_rh, bucket, 1);
+    if (rc) {
+        goto exception;
+    }
+
+    p_node->p_data = p_data;
+    p_node->bytes  = bytes;
+    p_node->key    = key;
+    radixheap_append(p_rh, bucket, key, p_node);
+    p_rh->elems++;
+
+exception:
+    adts_sanity_exit(&(p_rh->sanity));
+    return rc;
+} /* adts_radixheap_push() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+int32_t
+adts_radixheap_update_key( adts_radixheap_t      *p_adts_radixheap,
+                           adts_radixheap_node_t *p_adts_node,
+                           uint64_t               key )
+{
+    int32_t           rc     = 0;
+    uint32_t          bucket = 0;
+    radixheap_t      *p_rh   = (radixheap_t *) p_adts_radixheap;
+    radixheap_node_t *p_node = (radixheap_node_t *) p_adts_node;
+
+    adts_sanity_entry(&(p_rh->sanity));
+
+    if ((false == radixheap_node_is_member(p_rh, p_node)) || (key < p_rh->last)) {
+        rc = EINVAL;
+        goto exception;
+    }
+
+    bucket = radixheap_bucket(key, p_rh->last);
+    if (bucket != p_node->bucket) {
+        rc = radixheap_reserve(p_rh, bucket, 1);
+        if (rc) {
+            goto exception;
+        }
+
+        radixheap_unlink(p_rh, p_node);
+        radixheap_append(p_rh, bucket, key, p_node);
+    }else {
+        p_rh->bucket[bucket].p_entries[p_node->idx].key = key;
+    }
+    p_node->key = key;
+
+exception:
+    adts_sanity_exit(&(p_rh->sanity));
+    return rc;
+} /* adts_radixheap_update_key() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+int32_t
+adts_radixheap_remove( adts_radixheap_t      *p_adts_radixheap,
+                       adts_radixheap_node_t *p_adts_node )
+{
+    int32_t           rc     = 0;
+    radixheap_t      *p_rh   = (radixheap_t *) p_adts_radixheap;
+    radixheap_node_t *p_node = (radixheap_node_t *) p_adts_node;
+
+    adts_sanity_entry(&(p_rh->sanity));
+
+    if (false == radixheap_node_is_member(p_rh, p_node)) {
+        rc = EINVAL;
+        goto exception;
+    }
+
+    radixheap_unlink(p_rh, p_node);
+    p_rh->elems--;
+
+exception:
+    adts_sanity_exit(&(p_rh->sanity));
+    return rc;
+} /* adts_radixheap_remove() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+adts_radixheap_node_t *
+adts_radixheap_peek( adts_radixheap_t *p_adts_radixheap )
+{
+    radixheap_t      *p_rh   = (radixheap_t *) p_adts_radixheap;
+    radixheap_node_t *p_node = NULL;
+
+    adts_sanity_entry(&(p_rh->sanity));
+
+    if ((0 == radixheap_settle(p_rh)) && p_rh->bucket[0].elems) {
+        p_node = p_rh->bucket[0].p_entries[p_rh->bucket[0].elems - 1].p_node;
+    }
+
+    adts_sanity_exit(&(p_rh->sanity));
+
+    return (adts_radixheap_node_t *) p_node;
+} /* adts_radixheap_peek() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Bucket 0 is consumed from its tail, no entry moves.
+ *
+ ****************************************************************************
+ */
+adts_radixheap_node_t *
+adts_radixheap_pop( adts_radixheap_t *p_adts_radixheap )
+{
+    radixheap_t      *p_rh   = (radixheap_t *) p_adts_radixheap;
+    radixheap_node_t *p_node = NULL;
+
+    adts_sanity_entry(&(p_rh->sanity));
+
+    if ((0 == radixheap_settle(p_rh)) && p_rh->bucket[0].elems) {
+        p_node         = p_rh->bucket[0].p_entries[--p_rh->bucket[0].elems].p_node;
+        p_node->bucket = RADIXHEAP_BUCKETS;
+        p_rh->elems--;
+    }
+
+    adts_sanity_exit(&(p_rh->sanity));
+
+    return (adts_radixheap_node_t *) p_node;
+} /* adts_radixheap_pop() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+bool
+adts_radixheap_is_empty( adts_radixheap_t *p_adts_radixheap )
+{
+    radixheap_t *p_rh = (radixheap_t *) p_adts_radixheap;
+
+    return (0 == p_rh->elems);
+} /* adts_radixheap_is_empty() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+size_t
+adts_radixheap_entries( adts_radixheap_t *p_adts_radixheap )
+{
+    radixheap_t *p_rh = (radixheap_t *) p_adts_radixheap;
+
+    return p_rh->elems;
+} /* adts_radixheap_entries() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+uint64_t
+adts_radixheap_last( adts_radixheap_t *p_adts_radixheap )
+{
+    radixheap_t *p_rh = (radixheap_t *) p_adts_radixheap;
+
+    return p_rh->last;
+} /* adts_radixheap_last() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_radixheap_mem_usage( adts_radixheap_t *p_adts_radixheap,
+                          adts_mem_stats_t *p_out )
+{
+    radixheap_t *p_rh = (radixheap_t *) p_adts_radixheap;
+
+    adts_mem_usage(&(p_rh->mem), p_out);
+
+    return;
+} /* adts_radixheap_mem_usage() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Remaining nodes belong to the consumer and are abandoned.
+ *
+ ****************************************************************************
+ */
+void
+adts_radixheap_destroy( adts_radixheap_t *p_adts_radixheap )
+{
+    radixheap_t *p_rh = (radixheap_t *) p_adts_radixheap;
+    adts_mem_t   mem  = p_rh->mem;
+
+    adts_sanity_entry(&(p_rh->sanity));
+
+    for (uint32_t bucket = 0; bucket < RADIXHEAP_BUCKETS; bucket++) {
+        if (p_rh->bucket[bucket].p_entries) {
+            adts_mem_put(&(mem), p_rh->bucket[bucket].p_entries,
+                         p_rh->bucket[bucket].limit * sizeof(radixheap_entry_t));
+        }
+    }
+    adts_mem_put(&(mem), p_adts_radixheap, sizeof(*p_adts_radixheap));
+
+    /* No adts_sanity_exit() since we've freed the memory */
+
+    return;
+} /* adts_radixheap_destroy() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+adts_radixheap_t *
+adts_radixheap_create( void )
+{
+    adts_radixheap_create_t op = {0};
+
+    return adts_radixheap_create_ext(&(op));
+} /* adts_radixheap_create() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Buckets are allocated on first use.
+ *
+ ****************************************************************************
+ */
+adts_radixheap_t *
+adts_radixheap_create_ext( const adts_radixheap_create_t *p_op )
+{
+    radixheap_t      *p_rh             = NULL;
+    adts_mem_t        mem              = {0};
+    adts_radixheap_t *p_adts_radixheap = NULL;
+
+    assert(p_op);
+
+    adts_mem_init_ext(&(mem), ADTS_MEM_TYPE_RADIXHEAP, p_op->p_allocator);
+
+    p_adts_radixheap = adts_mem_get(&(mem), sizeof(*p_adts_radixheap));
+    if (NULL == p_adts_radixheap) {
+        goto exception;
+    }
+    p_rh = (radixheap_t *) p_adts_radixheap;
+
+    p_rh->mem = mem;
+
+exception:
+    return p_adts_radixheap;
+} /* adts_radixheap_create_ext() */
+
+
+/******************************************************************************
+ * #     # #     #   ###   ####### ####### #######  #####  #######  #####
+ * #     # ##    #    #       #       #    #       #     #    #    #     #
+ * #     # # #   #    #       #       #    #       #          #    #
+ * #     # #  #  #    #       #       #    #####    #####     #     #####
+ * #     # #   # #    #       #       #    #             #    #          #
+ * #     # #    ##    #       #       #    #       #     #    #    #     #
+ *  #####  #     #   ###      #       #    #######  #####     #     #####
+******************************************************************************/
+
+/**
+ **************************************************************************
+ * \brief
+ *   Compile time structure sanity
+ *
+ * \details
+ *   Sanitize the abstract data type interface.  Enforced in header file so
+ *   as to catch improper usage/include by unauthorized callers.
+ *
+ **************************************************************************
+ */
+static void
+utest_radixheap_bytes( void )
+{
+    CDISPLAY("[%u]", sizeof(radixheap_t));
+    CDISPLAY("[%u]", sizeof(adts_radixheap_t));
+    CDISPLAY("[%u]", sizeof(radixheap_node_t));
+    CDISPLAY("[%u]", sizeof(adts_radixheap_node_t));
+
+    _Static_assert(sizeof(radixheap_t) <= sizeof(adts_radixheap_t),
+        "Mismatch structs detected");
+    _Static_assert(sizeof(radixheap_node_t) <= sizeof(adts_radixheap_node_t),
+        "Mismatch structs detected");
+    _Static_assert(offsetof(radixheap_node_t, key) ==
+                   offsetof(adts_radixheap_node_public_t, key),
+        "Mismatch structs detected");
+
+    return;
+} /* utest_radixheap_bytes() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Small PRNG for key generation, xorshift64.
+ *
+ ****************************************************************************
+ */
+static inline uint64_t
+utest_radixheap_rand( uint64_t *p_state )
+{
+    uint64_t x = *p_state;
+
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *p_state = x;
+
+    return x;
+} /* utest_radixheap_rand() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Random monotone trace of pushes, pops, key updates and removals,
+ *   checked against a shadow of the live keys.  Every pop must return
+ *   the least live key.  Spreads from a few to the full 64 bit range.
+ *
+ ****************************************************************************
+ */
+static void
+utest_radixheap_trace( void )
+{
+    size_t                 elems  = 1024;
+    uint64_t               seed   = 0x9e3779b97f4a7c15ULL;
+    adts_radixheap_node_t *p_node = NULL;
+
+    p_node = calloc(elems, sizeof(*p_node));
+    assert(p_node);
+
+    for (uint32_t bits = 2; bits <= 64; bits += 6) {
+        uint64_t          range = (64 == bits) ? UINT64_MAX : ((1ULL << bits) - 1);
+        adts_radixheap_t *p_rh  = NULL;
+        size_t            live  = 0;
+
+        p_rh = adts_radixheap_create();
+        assert(p_rh);
+        assert(NULL == adts_radixheap_pop(p_rh));
+        assert(NULL == adts_radixheap_peek(p_rh));
+        assert(adts_radixheap_is_empty(p_rh));
+
+        for (size_t op = 0; op < 8 * elems; op++) {
+            uint64_t               r      = utest_radixheap_rand(&(seed));
+            adts_radixheap_node_t *p_this = &(p_node[r % elems]);
+            uint64_t               last   = adts_radixheap_last(p_rh);
+            uint64_t               span   = range - last;
+            uint64_t               key    = utest_radixheap_rand(&(seed));
+            bool                   member = radixheap_node_is_member((radixheap_t *) p_rh,
+                                                                     (radixheap_node_t *) p_this);
+
+            key = last + ((UINT64_MAX == span) ? key : (key % (span + 1)));
+
+            switch ((r >> 32) % 8) {
+            case 0:
+            case 1:
+            case 2:
+                if (false == member) {
+                    assert(0 == adts_radixheap_push(p_rh, p_this, p_this, 1, key));
+                    live++;
+                }else {
+                    assert(0 == adts_radixheap_update_key(p_rh, p_this, key));
+                }
+                break;
+
+            case 3:
+                if (member) {
+                    assert(0 == adts_radixheap_remove(p_rh, p_this));
+                    live--;
+                }else {
+                    assert(EINVAL == adts_radixheap_remove(p_rh, p_this));
+                    assert(EINVAL == adts_radixheap_update_key(p_rh, p_this, key));
+                }
+                break;
+
+            default:
+                {
+                    adts_radixheap_node_t *p_peek = adts_radixheap_peek(p_rh);
+                    adts_radixheap_node_t *p_pop  = adts_radixheap_pop(p_rh);
+                    uint64_t               least  = UINT64_MAX;
+
+                    assert(p_peek == p_pop);
+                    if (NULL == p_pop) {
+                        assert(0 == live);
+                        break;
+                    }
+                    live--;
+
+                    /* least of the remaining, and the popped, live keys */
+                    for (size_t idx = 0; idx < elems; idx++) {
+                        if (radixheap_node_is_member((radixheap_t *) p_rh, (radixheap_node_t *) &(p_node[idx]))) {
+                            least = MIN(least, p_node[idx].pub.key);
+                        }
+                    }
+                    assert(p_pop->pub.key <= least);
+                    assert(p_pop->pub.key == adts_radixheap_last(p_rh));
+                    assert(p_pop->pub.p_data == p_pop);
+
+                    /* below the floor */
+                    if (p_pop->pub.key) {
+                        assert(EINVAL == adts_radixheap_push(p_rh, p_pop, p_pop, 1,
+                                                             p_pop->pub.key - 1));
+                    }
+                }
+                break;
+            }
+
+            assert(live == adts_radixheap_entries(p_rh));
+        }
+
+        /* drain */
+        for (uint64_t prev = 0; live; live--) {
+            adts_radixheap_node_t *p_pop = adts_radixheap_pop(p_rh);
+
+            assert(p_pop && (prev <= p_pop->pub.key));
+            prev = p_pop->pub.key;
+        }
+        assert(NULL == adts_radixheap_pop(p_rh));
+
+        adts_radixheap_destroy(p_rh);
+        memset(p_node, 0, elems * sizeof(*p_node));
+    }
+
+    free(p_node);
+
+    return;
+} /* utest_radixheap_trace() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Dijkstra benchmark, random directed graph in compressed sparse rows,
+ *   UTEST_RADIXHEAP_DEGREE out edges per vertex.  The same search is run
+ *   with adts_heap and adts_radixheap, both using decrease key, and the
+ *   distances compared.  Edge weights span 1 .. C for several C.
+ *
+ ****************************************************************************
+ */
+#ifndef UTEST_RADIXHEAP_VERTICES
+#define UTEST_RADIXHEAP_VERTICES (1 << 20)
+#endif
+
+#ifndef UTEST_RADIXHEAP_DEGREE
+#define UTEST_RADIXHEAP_DEGREE (8)
+#endif
+
+typedef struct {
+    size_t    vertices;
+    uint32_t *p_dst;    /**< edges of v at [v * degree, (v + 1) * degree) */
+    uint32_t *p_weight;
+} utest_radixheap_graph_t;
+
+
+static uint64_t
+utest_radixheap_dijkstra_heap( const utest_radixheap_graph_t *p_graph,
+                               uint64_t                      *p_dist,
+                               adts_heap_node_t              *p_node )
+{
+    uint64_t     start  = 0;
+    adts_heap_t *p_heap = NULL;
+
+    p_heap = adts_heap_create(ADTS_HEAP_MIN);
+    assert(p_heap);
+
+    memset(p_dist, 0xff, p_graph->vertices * sizeof(*p_dist));
+    memset(p_node, 0, p_graph->vertices * sizeof(*p_node));
+
+    start     = adts_tstamp();
+    p_dist[0] = 0;
+    (void) adts_heap_push(p_heap, &(p_node[0]), p_node, 1, 0);
+
+    while (adts_heap_is_not_empty(p_heap)) {
+        adts_heap_node_t *p_pop = adts_heap_pop(p_heap);
+        size_t            v     = (size_t) (p_pop - p_node);
+        size_t            edge  = v * UTEST_RADIXHEAP_DEGREE;
+
+        for (size_t e = edge; e < (edge + UTEST_RADIXHEAP_DEGREE); e++) {
+            uint32_t u    = p_graph->p_dst[e];
+            uint64_t dist = p_dist[v] + p_graph->p_weight[e];
+
+            if (dist < p_dist[u]) {
+                if (UINT64_MAX == p_dist[u]) {
+                    (void) adts_heap_push(p_heap, &(p_node[u]), p_node, 1, (int64_t) dist);
+                }else {
+                    (void) adts_heap_update_key(p_heap, &(p_node[u]), (int64_t) dist);
+                }
+                p_dist[u] = dist;
+            }
+        }
+    }
+
+    start = adts_tstamp() - start;
+    adts_heap_destroy(p_heap);
+
+    return start;
+} /* utest_radixheap_dijkstra_heap() */
+
+
+static uint64_t
+utest_radixheap_dijkstra_radix( const utest_radixheap_graph_t *p_graph,
+                                uint64_t                      *p_dist,
+                                adts_radixheap_node_t         *p_node )
+{
+    uint64_t          start = 0;
+    adts_radixheap_t *p_rh  = NULL;
+
+    p_rh = adts_radixheap_create();
+    assert(p_rh);
+
+    memset(p_dist, 0xff, p_graph->vertices * sizeof(*p_dist));
+    memset(p_node, 0, p_graph->vertices * sizeof(*p_node));
+
+    start     = adts_tstamp();
+    p_dist[0] = 0;
+    (void) adts_radixheap_push(p_rh, &(p_node[0]), p_node, 1, 0);
+
+    while (false == adts_radixheap_is_empty(p_rh)) {
+        adts_radixheap_node_t *p_pop = adts_radixheap_pop(p_rh);
+        size_t                 v     = (size_t) (p_pop - p_node);
+        size_t                 edge  = v * UTEST_RADIXHEAP_DEGREE;
+
+        for (size_t e = edge; e < (edge + UTEST_RADIXHEAP_DEGREE); e++) {
+            uint32_t u    = p_graph->p_dst[e];
+            uint64_t dist = p_dist[v] + p_graph->p_weight[e];
+
+            if (dist < p_dist[u]) {
+                if (UINT64_MAX == p_dist[u]) {
+                    (void) adts_radixheap_push(p_rh, &(p_node[u]), p_node, 1, dist);
+                }else {
+                    (void) adts_radixheap_update_key(p_rh, &(p_node[u]), dist);
+                }
+                p_dist[u] = dist;
+            }
+        }
+    }
+
+    start = adts_tstamp() - start;
+    adts_radixheap_destroy(p_rh);
+
+    return start;
+} /* utest_radixheap_dijkstra_radix() */
+
+
+static void
+utest_radixheap_dijkstra( void )
+{
+    size_t                   vertices = UTEST_RADIXHEAP_VERTICES;
+    size_t                   edges    = vertices * UTEST_RADIXHEAP_DEGREE;
+    uint64_t                 seed     = 0x2545f4914f6cdd1dULL;
+    uint64_t                *p_heap   = NULL;
+    uint64_t                *p_radix  = NULL;
+    adts_heap_node_t        *p_hnode  = NULL;
+    adts_radixheap_node_t   *p_rnode  = NULL;
+    utest_radixheap_graph_t  graph    = {0};
+
+    graph.vertices = vertices;
+    graph.p_dst    = malloc(edges * sizeof(*graph.p_dst));
+    graph.p_weight = malloc(edges * sizeof(*graph.p_weight));
+    p_heap         = malloc(vertices * sizeof(*p_heap));
+    p_radix        = malloc(vertices * sizeof(*p_radix));
+    p_hnode        = malloc(vertices * sizeof(*p_hnode));
+    p_rnode        = malloc(vertices * sizeof(*p_rnode));
+    assert(graph.p_dst && graph.p_weight && p_heap && p_radix && p_hnode && p_rnode);
+
+    for (size_t e = 0; e < edges; e++) {
+        graph.p_dst[e] = (uint32_t) (utest_radixheap_rand(&(seed)) % vertices);
+    }
+
+    for (uint32_t c_bits = 4; c_bits <= 28; c_bits += 8) {
+        uint64_t heap  = 0;
+        uint64_t radix = 0;
+
+        for (size_t e = 0; e < edges; e++) {
+            graph.p_weight[e] = 1 + (uint32_t) (utest_radixheap_rand(&(seed)) & ((1ULL << c_bits) - 1));
+        }
+
+        heap  = utest_radixheap_dijkstra_heap(&(graph), p_heap, p_hnode);
+        radix = utest_radixheap_dijkstra_radix(&(graph), p_radix, p_rnode);
+        assert(0 == memcmp(p_heap, p_radix, vertices * sizeof(*p_heap)));
+
+        CDISPLAY("vertices: %8zu  edges: %9zu  C: 2^%-2u  heap: %8.2fms  radixheap: %8.2fms",
+                 vertices, edges, c_bits,
+                 (double) heap / 1000000.0,
+                 (double) radix / 1000000.0);
+    }
+
+    free(p_rnode);
+    free(p_hnode);
+    free(p_radix);
+    free(p_heap);
+    free(graph.p_weight);
+    free(graph.p_dst);
+
+    return;
+} /* utest_radixheap_dijkstra() */
+
+
+/*
+ ****************************************************************************
+ * test entrypoint
+ *
+ ****************************************************************************
+ */
+void
+utest_adts_radixheap( void )
+{
+    utest_radixheap_bytes();
+    utest_radixheap_trace();
+    utest_radixheap_dijkstra();
+
+    return;
+} /* utest_adts_radixheap() */
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <adts_memory.h>
+
+
+/******************************************************************************
+ #####  ####### ######  #     #  #####  ####### #     # ######  #######  #####
+#     #    #    #     # #     # #     #    #    #     # #     # #       #     #
+#          #    #     # #     # #          #    #     # #     # #       #
+ #####     #    ######  #     # #          #    #     # ######  #####    #####
+      #    #    #   #   #     # #          #    #     # #   #   #             #
+#     #    #    #    #  #     # #     #    #    #     # #    #  #       #     #
+ #####     #    #     #  #####   #####     #     #####  #     # #######  #####
+******************************************************************************/
+
+/**
+ **************************************************************************
+ * \details
+ *   Monotone min priority queue of consumer owned nodes, uint64 keys
+ *   (radix heap).  A key may never be less than the last popped key,
+ *   e.g. Dijkstra distances or simulation event times.
+ *
+ *   Nodes are bucketed by the highest bit in which their key differs
+ *   from the last popped key, 65 buckets.  Buckets are arrays of key and
+ *   node, grown by doubling, thus push is O(1) amortized.  A pop which
+ *   finds bucket 0 empty redistributes the lowest occupied bucket, each
+ *   entry moving to a strictly lower bucket, thus O(log C) amortized with
+ *   C the largest key spread.
+ *
+ *   ADTS consumer is responsible for serialization.
+ *
+ **************************************************************************
+ */
+#define ADTS_RADIXHEAP_BYTES      (1152)
+#define ADTS_RADIXHEAP_NODE_BYTES (32)
+
+typedef struct {
+    const char reserved[ ADTS_RADIXHEAP_BYTES ];
+} adts_radixheap_t;
+
+typedef struct {
+    void     *p_data;
+    size_t    bytes;
+    uint64_t  key;
+} adts_radixheap_node_public_t;
+
+typedef union {
+    const char                         reserved[ ADTS_RADIXHEAP_NODE_BYTES ];
+    const adts_radixheap_node_public_t pub; /**< read only */
+} adts_radixheap_node_t;
+
+
+/**
+ **************************************************************************
+ * \details
+ *   radixheap create options
+ *
+ **************************************************************************
+ */
+typedef struct {
+    const adts_allocator_t *p_allocator; /**< NULL selects the default */
+} adts_radixheap_create_t;
+
+
+
+/******************************************************************************
+ #####   #####    ####    #####   ####    #####   #   #  #####   ######   ####
+ #    #  #    #  #    #     #    #    #     #      # #   #    #  #       #
+ #    #  #    #  #    #     #    #    #     #       #    #    #  #####    ####
+ #####   #####   #    #     #    #    #     #       #    #####   #            #
+ #       #   #   #    #     #    #    #     #       #    #       #       #    #
+ #       #    #   ####      #     ####      #       #    #       ######   ####
+*******************************************************************************/
+
+/**
+ **************************************************************************
+ * \brief
+ *   Queue services
+ *
+ * \details
+ *   - adts_radixheap_push()        EINVAL when key < adts_radixheap_last(),
+ *                                  ENOMEM when a bucket fails to grow
+ *   - adts_radixheap_update_key()  EINVAL when not a member or key <
+ *                                  adts_radixheap_last(), the key may move
+ *                                  either way.  ENOMEM as push.
+ *   - adts_radixheap_remove()      EINVAL when not a member
+ *   - adts_radixheap_peek()/pop()  least key, NULL when empty, or when a
+ *                                  redistribution fails to grow a bucket,
+ *                                  the heap is then unchanged.  Equal keys
+ *                                  are returned in no particular order.
+ *   - adts_radixheap_last()        floor for new keys, the last key popped
+ *                                  or peeked, 0 initially
+ *
+ **************************************************************************
+ */
+int32_t
+adts_radixheap_push( adts_radixheap_t      *p_adts_radixheap,
+                     adts_radixheap_node_t *p_adts_node,
+                     void                  *p_data,
+                     size_t                 bytes,
+                     uint64_t               key );
+
+int32_t
+adts_radixheap_update_key( adts_radixheap_t      *p_adts_radixheap,
+                           adts_radixheap_node_t *p_adts_node,
+                           uint64_t               key );
+
+int32_t
+adts_radixheap_remove( adts_radixheap_t      *p_adts_radixheap,
+                       adts_radixheap_node_t *p_adts_node );
+
+adts_radixheap_node_t *
+adts_radixheap_peek( adts_radixheap_t *p_adts_radixheap );
+
+adts_radixheap_node_t *
+adts_radixheap_pop( adts_radixheap_t *p_adts_radixheap );
+
+bool
+adts_radixheap_is_empty( adts_radixheap_t *p_adts_radixheap );
+
+size_t
+adts_radixheap_entries( adts_radixheap_t *p_adts_radixheap );
+
+uint64_t
+adts_radixheap_last( adts_radixheap_t *p_adts_radixheap );
+
+void
+adts_radixheap_mem_usage( adts_radixheap_t *p_adts_radixheap,
+                          adts_mem_stats_t *p_out );
+
+void
+adts_radixheap_destroy( adts_radixheap_t *p_adts_radixheap );
+
+adts_radixheap_t *
+adts_radixheap_create( void );
+
+adts_radixheap_t *
+adts_radixheap_create_ext( const adts_radixheap_create_t *p_op );
+
+
+/**
+ **************************************************************************
+ * \details
+ *   Unit Test prototypes
+ *
+ **************************************************************************
+ */
+void
+utest_adts_radixheap( void );
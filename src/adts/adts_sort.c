@@ -10,6 +10,7 @@
 
 /* Toolbox */
 #include <adts_sort.h>
+#include <adts_memory.h>
 #include <adts_private.h>
 #include <adts_display.h>
 
@@ -205,7 +206,7 @@ adts_sort_insertion_ext( int32_t arr[],
                          size_t  lo,
                          size_t  hi )
 {
-    size_t elems = hi - lo;
+    size_t elems = hi - lo + 1; /* hi is inclusive */
 
     adts_sort_insertion(&arr[lo], elems);
 
@@ -259,7 +260,7 @@ adts_sort_shell_ext( int32_t arr[],
                      size_t  lo,
                      size_t  hi )
 {
-    size_t elems = hi - lo;
+    size_t elems = hi - lo + 1; /* hi is inclusive */
 
     adts_sort_shell(&arr[lo], elems);
 
@@ -293,7 +294,7 @@ sort_merge_merge( int32_t arr[],
             arr[k] = aux[j++];
         }else if (j > hi) {
             arr[k] = aux[i++];
-        }else if (aux[j] < arr[i]) {
+        }else if (aux[j] < aux[i]) {
             arr[k] = aux[j++];
         }else {
             arr[k] = aux[i++];
@@ -348,11 +349,32 @@ int32_t
 adts_sort_merge( int32_t arr[],
                  size_t  elems )
 {
-    int32_t  rc    = 0;
-    int32_t *p_tmp = NULL;
+    return adts_sort_merge_ext(arr, elems, NULL);
+} /* adts_sort_merge() */
+
 
-    /* Merge sort requires O(n) space, thus allocate here */
-    p_tmp = calloc(elems, sizeof(arr[0]));
+/*
+ ****************************************************************************
+ *
+ *  Time:  O(n*log(n)
+ *  Space: O(n)
+ ****************************************************************************
+ */
+int32_t
+adts_sort_merge_ext( int32_t                 arr[],
+                     size_t                  elems,
+                     const adts_allocator_t *p_allocator )
+{
+    int32_t     rc    = 0;
+    size_t      bytes = elems * sizeof(arr[0]);
+    int32_t    *p_tmp = NULL;
+    adts_mem_t  mem   = {0};
+
+    adts_mem_init_ext(&(mem), ADTS_MEM_TYPE_SORT, p_allocator);
+
+    /* Merge sort requires O(n) space, thus allocate here.  Every element
+     * is written prior to read, thus no zero fill. */
+    p_tmp = adts_mem_alloc(&(mem), bytes);
     if (NULL == p_tmp) {
         rc = EINVAL;
         goto exception;
@@ -362,12 +384,10 @@ adts_sort_merge( int32_t arr[],
     sort_merge_sort(arr, p_tmp, 0, (elems - 1));
 
 exception:
-    if (p_tmp) {
-        free(p_tmp);
-    }
+    adts_mem_put(&(mem), p_tmp, bytes);
 
     return rc;
-} /* adts_sort_merge() */
+} /* adts_sort_merge_ext() */
 
 
 
@@ -3,6 +3,7 @@
 #include <string.h>
 #include <stdbool.h>
 #include <inttypes.h>
+#include <adts_memory.h>
 
 
 /*!
@@ -153,6 +154,15 @@ int32_t
 adts_sort_merge( int32_t arr[],
                  size_t  elems );
 
+/*!
+ * \brief merge sort with the O(n) auxiliary buffer from p_allocator, NULL
+ *        selects the default
+ */
+int32_t
+adts_sort_merge_ext( int32_t                 arr[],
+                     size_t                  elems,
+                     const adts_allocator_t *p_allocator );
+
 /*!
  * \brief Array sort using the merge algorithm.
  *
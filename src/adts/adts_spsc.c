@@ -0,0 +1,793 @@
+#define _GNU_SOURCE /* pthread_setaffinity_np() */
+#include <sched.h>
+#include <errno.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <inttypes.h>
+
+/* Toolbox */
+#include <adts_math.h>
+#include <adts_spsc.h>
+#include <adts_time.h>
+#include <adts_wait.h>
+#include <adts_memory.h>
+#include <adts_private.h>
+#include <adts_display.h>
+
+
+/******************************************************************************
+ #####  ####### ######  #     #  #####  ####### #     # ######  #######  #####
+#     #    #    #     # #     # #     #    #    #     # #     # #       #     #
+#          #    #     # #     # #          #    #     # #     # #       #
+ #####     #    ######  #     # #          #    #     # ######  #####    #####
+      #    #    #   #   #     # #          #    #     # #   #   #             #
+#     #    #    #    #  #     # #     #    #    #     # #    #  #       #     #
+ #####     #    #     #  #####   #####     #     #####  #     # #######  #####
+******************************************************************************/
+
+/*
+ ****************************************************************************
+ * \details
+ *   Four cache lines:
+ *   - ring:  written at create / destroy only, read by both sides
+ *   - prod:  written by the producer only
+ *   - cons:  written by the consumer only
+ *   - wait:  consumer park / producer wake, written only while parking
+ *
+ *   tail and head are free running.  The producer publishes slots with a
+ *   release store of tail, and the consumer acquires tail before reading
+ *   them.  Symmetrically the consumer releases slots with a store of
+ *   head.  Each side caches the last observed value of the opposite
+ *   index, thus the shared line is only read when the cached value is
+ *   insufficient for the request.
+ *
+ ****************************************************************************
+ */
+typedef struct {
+    struct {
+        void       **p_slots;
+        size_t       slots;
+        size_t       mask;
+        adts_mem_t   mem;
+    } ADTS_CACHELINE_ALIGN ring;
+
+    struct {
+        size_t       tail;       /**< next slot to fill */
+        size_t       head_cache; /**< last observed cons.head */
+    } ADTS_CACHELINE_ALIGN prod;
+
+    struct {
+        size_t       head;       /**< next slot to drain */
+        size_t       tail_cache; /**< last observed prod.tail */
+    } ADTS_CACHELINE_ALIGN cons;
+
+    adts_wait_t      ADTS_CACHELINE_ALIGN wait;
+} spsc_t;
+
+
+/******************************************************************************
+ * ####### #     # #     #  #####  #######   ###   ####### #     #  #####
+ * #       #     # ##    # #     #    #       #    #     # ##    # #     #
+ * #       #     # # #   # #          #       #    #     # # #   # #
+ * #####   #     # #  #  # #          #       #    #     # #  #  #  #####
+ * #       #     # #   # # #          #       #    #     # #   # #       #
+ * #       #     # #    ## #     #    #       #    #     # #    ## #     #
+ * #        #####  #     #  #####     #      ###   ####### #     #  #####
+******************************************************************************/
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+size_t
+adts_spsc_enqueue_n( adts_spsc_t *p_adts_spsc,
+                     void *const *pp_data,
+                     size_t       n )
+{
+    spsc_t *p_spsc = (spsc_t *) p_adts_spsc;
+    size_t  tail   = p_spsc->prod.tail;
+    size_t  avail  = p_spsc->ring.slots - (tail - p_spsc->prod.head_cache);
+
+    if (avail < n) {
+        p_spsc->prod.head_cache = __atomic_load_n(&(p_spsc->cons.head),
+                                                  __ATOMIC_ACQUIRE);
+        avail = p_spsc->ring.slots - (tail - p_spsc->prod.head_cache);
+        n     = MIN(n, avail);
+        if (0 == n) {
+            goto exception;
+        }
+    }
+
+    for (size_t idx = 0; idx < n; idx++) {
+        p_spsc->ring.p_slots[(tail + idx) & p_spsc->ring.mask] = pp_data[idx];
+    }
+
+    __atomic_store_n(&(p_spsc->prod.tail), tail + n, __ATOMIC_RELEASE);
+    adts_wait_notify(&(p_spsc->wait));
+
+exception:
+    return n;
+} /* adts_spsc_enqueue_n() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+int32_t
+adts_spsc_enqueue( adts_spsc_t *p_adts_spsc,
+                   void        *p_data )
+{
+    int32_t rc = 0;
+
+    if (unlikely(0 == adts_spsc_enqueue_n(p_adts_spsc, &(p_data), 1))) {
+        rc = EAGAIN;
+    }
+
+    return rc;
+} /* adts_spsc_enqueue() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+size_t
+adts_spsc_dequeue_n( adts_spsc_t  *p_adts_spsc,
+                     void        **pp_data,
+                     size_t        n )
+{
+    spsc_t *p_spsc = (spsc_t *) p_adts_spsc;
+    size_t  head   = p_spsc->cons.head;
+    size_t  avail  = p_spsc->cons.tail_cache - head;
+
+    if (avail < n) {
+        p_spsc->cons.tail_cache = __atomic_load_n(&(p_spsc->prod.tail),
+                                                  __ATOMIC_ACQUIRE);
+        avail = p_spsc->cons.tail_cache - head;
+        n     = MIN(n, avail);
+        if (0 == n) {
+            goto exception;
+        }
+    }
+
+    for (size_t idx = 0; idx < n; idx++) {
+        pp_data[idx] = p_spsc->ring.p_slots[(head + idx) & p_spsc->ring.mask];
+    }
+
+    __atomic_store_n(&(p_spsc->cons.head), head + n, __ATOMIC_RELEASE);
+
+exception:
+    return n;
+} /* adts_spsc_dequeue_n() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+int32_t
+adts_spsc_dequeue( adts_spsc_t  *p_adts_spsc,
+                   void        **pp_data )
+{
+    int32_t rc = 0;
+
+    if (unlikely(0 == adts_spsc_dequeue_n(p_adts_spsc, pp_data, 1))) {
+        rc = EAGAIN;
+    }
+
+    return rc;
+} /* adts_spsc_dequeue() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   adts_wait_until() condition.
+ *
+ ****************************************************************************
+ */
+typedef struct {
+    adts_spsc_t *p_spsc;
+    void        *p_data;
+} spsc_wait_ctx_t;
+
+static bool
+spsc_wait_try( void *p_arg )
+{
+    spsc_wait_ctx_t *p_ctx = p_arg;
+
+    return (1 == adts_spsc_dequeue_n(p_ctx->p_spsc, &(p_ctx->p_data), 1));
+} /* spsc_wait_try() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void *
+adts_spsc_dequeue_wait( adts_spsc_t *p_adts_spsc )
+{
+    spsc_t          *p_spsc = (spsc_t *) p_adts_spsc;
+    spsc_wait_ctx_t  ctx    = { .p_spsc = p_adts_spsc };
+
+    if (unlikely(0 == adts_spsc_dequeue_n(p_adts_spsc, &(ctx.p_data), 1))) {
+        adts_wait_until(&(p_spsc->wait), spsc_wait_try, &(ctx));
+    }
+
+    return ctx.p_data;
+} /* adts_spsc_dequeue_wait() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+size_t
+adts_spsc_entries( adts_spsc_t *p_adts_spsc )
+{
+    spsc_t *p_spsc = (spsc_t *) p_adts_spsc;
+    size_t  head   = __atomic_load_n(&(p_spsc->cons.head), __ATOMIC_ACQUIRE);
+    size_t  tail   = __atomic_load_n(&(p_spsc->prod.tail), __ATOMIC_ACQUIRE);
+
+    return (tail - head);
+} /* adts_spsc_entries() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+size_t
+adts_spsc_capacity( adts_spsc_t *p_adts_spsc )
+{
+    spsc_t *p_spsc = (spsc_t *) p_adts_spsc;
+
+    return p_spsc->ring.slots;
+} /* adts_spsc_capacity() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_spsc_wait_stats( adts_spsc_t       *p_adts_spsc,
+                      adts_wait_stats_t *p_out )
+{
+    spsc_t *p_spsc = (spsc_t *) p_adts_spsc;
+
+    adts_wait_stats(&(p_spsc->wait), p_out);
+
+    return;
+} /* adts_spsc_wait_stats() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_spsc_mem_usage( adts_spsc_t      *p_adts_spsc,
+                     adts_mem_stats_t *p_out )
+{
+    spsc_t *p_spsc = (spsc_t *) p_adts_spsc;
+
+    adts_mem_usage(&(p_spsc->ring.mem), p_out);
+
+    return;
+} /* adts_spsc_mem_usage() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Both threads must have quiesced.  Undrained entries are dropped, the
+ *   consumer data is not owned by the ring.
+ *
+ ****************************************************************************
+ */
+void
+adts_spsc_destroy( adts_spsc_t *p_adts_spsc )
+{
+    spsc_t     *p_spsc = (spsc_t *) p_adts_spsc;
+    adts_mem_t  mem    = p_spsc->ring.mem;
+
+    adts_mem_put(&(mem), p_spsc->ring.p_slots,
+                 p_spsc->ring.slots * sizeof(*(p_spsc->ring.p_slots)));
+    adts_mem_put_aligned(&(mem), p_adts_spsc, sizeof(*p_adts_spsc));
+
+    return;
+} /* adts_spsc_destroy() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+adts_spsc_t *
+adts_spsc_create( const adts_spsc_create_t *p_op )
+{
+    size_t       slots       = 0;
+    spsc_t      *p_spsc      = NULL;
+    adts_mem_t   mem         = {0};
+    adts_spsc_t *p_adts_spsc = NULL;
+
+    assert(p_op);
+    if ((0 == p_op->elems) || (p_op->elems > (UINT32_MAX >> 1))) {
+        goto exception;
+    }
+    slots = adts_pow2_round_up(p_op->elems);
+
+    adts_mem_init_ext(&(mem), ADTS_MEM_TYPE_SPSC, p_op->p_allocator);
+
+    p_adts_spsc = adts_mem_get_aligned(&(mem), sizeof(*p_adts_spsc));
+    if (NULL == p_adts_spsc) {
+        goto exception;
+    }
+
+    p_spsc                = (spsc_t *) p_adts_spsc;
+    p_spsc->ring.p_slots  = adts_mem_get(&(mem), slots * sizeof(void *));
+    if (NULL == p_spsc->ring.p_slots) {
+        adts_mem_put_aligned(&(mem), p_adts_spsc, sizeof(*p_adts_spsc));
+        p_adts_spsc = NULL;
+        goto exception;
+    }
+    p_spsc->ring.slots    = slots;
+    p_spsc->ring.mask     = slots - 1;
+    p_spsc->ring.mem      = mem;
+    adts_wait_init(&(p_spsc->wait), p_op->spins);
+
+exception:
+    return p_adts_spsc;
+} /* adts_spsc_create() */
+
+
+
+/******************************************************************************
+ * #     # #     #   ###   ####### ####### #######  #####  #######  #####
+ * #     # ##    #    #       #       #    #       #     #    #    #     #
+ * #     # # #   #    #       #       #    #       #          #    #
+ * #     # #  #  #    #       #       #    #####    #####     #     #####
+ * #     # #   # #    #       #       #    #             #    #          #
+ * #     # #    ##    #       #       #    #       #     #    #    #     #
+ *  #####  #     #   ###      #       #    #######  #####     #     #####
+******************************************************************************/
+
+/**
+ **************************************************************************
+ * \brief
+ *   Compile time structure sanity
+ *
+ * \details
+ *   Sanitize the abstract data type interface.  Enforced in header file so
+ *   as to catch improper usage/include by unauthorized callers.
+ *
+ **************************************************************************
+ */
+static void
+utest_spsc_bytes( void )
+{
+    CDISPLAY("[%u]", sizeof(spsc_t));
+    CDISPLAY("[%u]", sizeof(adts_spsc_t));
+
+    _Static_assert(sizeof(spsc_t) <= sizeof(adts_spsc_t),
+        "Mismatch structs detected");
+
+    return;
+} /* utest_spsc_bytes() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Benchmark parameters.  Items moved by the throughput run, round trips
+ *   timed by the latency run, and the ring capacity of both.
+ *
+ ****************************************************************************
+ */
+#ifndef UTEST_SPSC_ITEMS
+#define UTEST_SPSC_ITEMS (1 << 23)
+#endif
+
+#ifndef UTEST_SPSC_PINGS
+#define UTEST_SPSC_PINGS (1 << 14)
+#endif
+
+#ifndef UTEST_SPSC_ELEMS
+#define UTEST_SPSC_ELEMS (1 << 12)
+#endif
+
+#define UTEST_SPSC_BATCH (32)
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Shared benchmark context.  The peer thread runs on cpu, taken modulo
+ *   the online cpu count, such that a single cpu system still completes.
+ *
+ ****************************************************************************
+ */
+typedef struct {
+    adts_spsc_t *p_fwd;
+    adts_spsc_t *p_rev;
+    size_t       items;
+    size_t       batch;
+    int32_t      cpu;
+    bool         wait;
+    size_t       sum;
+} utest_spsc_ctx_t;
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+static void
+utest_spsc_pin( int32_t cpu )
+{
+    cpu_set_t set   = {0};
+    long      ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+    CPU_ZERO(&(set));
+    CPU_SET(cpu % ((0 < ncpus) ? ncpus : 1), &(set));
+    (void) pthread_setaffinity_np(pthread_self(), sizeof(set), &(set));
+
+    return;
+} /* utest_spsc_pin() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Throughput consumer, drains items in batches and sums the payload.
+ *
+ ****************************************************************************
+ */
+static void *
+utest_spsc_consumer( void *p_arg )
+{
+    utest_spsc_ctx_t *p_ctx = p_arg;
+    size_t            recv  = 0;
+    size_t            cnt   = 0;
+    void             *data[ UTEST_SPSC_BATCH ];
+
+    utest_spsc_pin(p_ctx->cpu);
+
+    while (recv < p_ctx->items) {
+        cnt = adts_spsc_dequeue_n(p_ctx->p_fwd, data, p_ctx->batch);
+        if (0 == cnt) {
+            sched_yield();
+            continue;
+        }
+
+        for (size_t idx = 0; idx < cnt; idx++) {
+            assert((void *) (recv + idx + 1) == data[idx]);
+            p_ctx->sum += (size_t) data[idx];
+        }
+        recv += cnt;
+    }
+
+    return NULL;
+} /* utest_spsc_consumer() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Latency echo, returns each item on the reverse ring.  Waits for the
+ *   ping by polling with a yield, or by adts_spsc_dequeue_wait().
+ *
+ ****************************************************************************
+ */
+static void *
+utest_spsc_echo( void *p_arg )
+{
+    utest_spsc_ctx_t *p_ctx  = p_arg;
+    void             *p_data = NULL;
+
+    utest_spsc_pin(p_ctx->cpu);
+
+    for (size_t idx = 0; idx < p_ctx->items; idx++) {
+        if (p_ctx->wait) {
+            p_data = adts_spsc_dequeue_wait(p_ctx->p_fwd);
+        }else {
+            while (adts_spsc_dequeue(p_ctx->p_fwd, &(p_data))) {
+                sched_yield();
+            }
+        }
+        while (adts_spsc_enqueue(p_ctx->p_rev, p_data)) {
+            sched_yield();
+        }
+    }
+
+    return NULL;
+} /* utest_spsc_echo() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Producer on cpu 0 and consumer on cpu 1, reported as items/s for a
+ *   single item and a batched handoff.
+ *
+ ****************************************************************************
+ */
+static void
+utest_spsc_rate( size_t batch )
+{
+    int32_t             rc       = 0;
+    size_t              sent     = 0;
+    size_t              cnt      = 0;
+    uint64_t            start    = 0;
+    uint64_t            delta    = 0;
+    pthread_t           thread;
+    adts_spsc_create_t  op       = {0};
+    utest_spsc_ctx_t    ctx      = {0};
+    void               *data[ UTEST_SPSC_BATCH ];
+
+    op.elems   = UTEST_SPSC_ELEMS;
+    ctx.p_fwd  = adts_spsc_create(&(op));
+    ctx.items  = UTEST_SPSC_ITEMS;
+    ctx.batch  = batch;
+    ctx.cpu    = 1;
+    assert(ctx.p_fwd);
+
+    utest_spsc_pin(0);
+
+    start = adts_tstamp();
+    rc    = pthread_create(&(thread), NULL, utest_spsc_consumer, &(ctx));
+    assert(0 == rc);
+
+    while (sent < ctx.items) {
+        size_t want = MIN(batch, ctx.items - sent);
+
+        for (size_t idx = 0; idx < want; idx++) {
+            data[idx] = (void *) (sent + idx + 1);
+        }
+        for (size_t done = 0; done < want; done += cnt) {
+            cnt = adts_spsc_enqueue_n(ctx.p_fwd, &(data[done]), want - done);
+            if (0 == cnt) {
+                sched_yield();
+            }
+        }
+        sent += want;
+    }
+
+    (void) pthread_join(thread, NULL);
+    delta = adts_tstamp() - start;
+
+    assert(ctx.sum == (ctx.items * (ctx.items + 1)) / 2);
+    assert(0 == adts_spsc_entries(ctx.p_fwd));
+    adts_spsc_destroy(ctx.p_fwd);
+
+    CDISPLAY("batch: %3zu  items: %zu  ns/item: %6.2f  items/s: %12.0f",
+             batch,
+             ctx.items,
+             (double) delta / (double) ctx.items,
+             (double) ctx.items * 1e9 / (double) (delta ? delta : 1));
+
+    return;
+} /* utest_spsc_rate() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+static int
+utest_spsc_cmp( const void *p_a,
+                const void *p_b )
+{
+    uint64_t a = *(const uint64_t *) p_a;
+    uint64_t b = *(const uint64_t *) p_b;
+
+    return (a > b) - (a < b);
+} /* utest_spsc_cmp() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Round trip latency, ping on the forward ring and echo on the reverse
+ *   ring between pinned threads.  With wait set both sides block in
+ *   adts_spsc_dequeue_wait(), thus report the spin / park split.
+ *
+ ****************************************************************************
+ */
+static void
+utest_spsc_latency( bool wait )
+{
+    int32_t             rc        = 0;
+    size_t              pings     = UTEST_SPSC_PINGS;
+    uint64_t           *p_samples = NULL;
+    uint64_t            start     = 0;
+    uint64_t            total     = 0;
+    void               *p_data    = NULL;
+    pthread_t           thread;
+    adts_spsc_create_t  op        = {0};
+    utest_spsc_ctx_t    ctx       = {0};
+    adts_wait_stats_t   fwd       = {0};
+    adts_wait_stats_t   rev       = {0};
+
+    op.elems  = 64;
+    ctx.p_fwd = adts_spsc_create(&(op));
+    ctx.p_rev = adts_spsc_create(&(op));
+    ctx.items = pings;
+    ctx.cpu   = 1;
+    ctx.wait  = wait;
+    assert(ctx.p_fwd && ctx.p_rev);
+
+    p_samples = calloc(pings, sizeof(*p_samples));
+    assert(p_samples);
+
+    utest_spsc_pin(0);
+    rc = pthread_create(&(thread), NULL, utest_spsc_echo, &(ctx));
+    assert(0 == rc);
+
+    for (size_t idx = 0; idx < pings; idx++) {
+        start = adts_tstamp();
+        while (adts_spsc_enqueue(ctx.p_fwd, (void *) (idx + 1))) {
+            sched_yield();
+        }
+        if (wait) {
+            p_data = adts_spsc_dequeue_wait(ctx.p_rev);
+        }else {
+            while (adts_spsc_dequeue(ctx.p_rev, &(p_data))) {
+                sched_yield();
+            }
+        }
+        p_samples[idx] = adts_tstamp() - start;
+        total         += p_samples[idx];
+        assert((void *) (idx + 1) == p_data);
+    }
+
+    (void) pthread_join(thread, NULL);
+
+    adts_spsc_wait_stats(ctx.p_fwd, &(fwd));
+    adts_spsc_wait_stats(ctx.p_rev, &(rev));
+
+    qsort(p_samples, pings, sizeof(*p_samples), utest_spsc_cmp);
+    CDISPLAY("wait: %d  round trips: %zu  mean: %8.1fns  p50: %8"PRIu64"ns  p99: %8"PRIu64"ns  spins: %zu  parks: %zu  wakes: %zu",
+             wait,
+             pings,
+             (double) total / (double) pings,
+             p_samples[pings / 2],
+             p_samples[(pings * 99) / 100],
+             fwd.spins + rev.spins,
+             fwd.parks + rev.parks,
+             fwd.wakes + rev.wakes);
+
+    free(p_samples);
+    adts_spsc_destroy(ctx.p_rev);
+    adts_spsc_destroy(ctx.p_fwd);
+
+    return;
+} /* utest_spsc_latency() */
+
+
+/*
+ ****************************************************************************
+ * test control
+ *
+ ****************************************************************************
+ */
+static void
+utest_control( void )
+{
+    cpu_set_t affinity = {0};
+
+    utest_spsc_bytes();
+
+    /* benchmarks pin the calling thread, restored on completion */
+    (void) pthread_getaffinity_np(pthread_self(), sizeof(affinity), &(affinity));
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: invalid create");
+
+        adts_spsc_create_t op = {0};
+
+        assert(NULL == adts_spsc_create(&(op)));
+    }
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: single thread FIFO, full / empty and wrap");
+
+        size_t              cnt       = 0;
+        void               *p_data    = NULL;
+        adts_spsc_t        *p_spsc    = NULL;
+        adts_spsc_create_t  op        = {0};
+        adts_mem_stats_t    before    = {0};
+        adts_mem_stats_t    after     = {0};
+        void               *in[ 8 ]   = {0};
+        void               *out[ 8 ]  = {0};
+
+        (void) adts_mem_stats(ADTS_MEM_TYPE_SPSC, &(before));
+
+        op.elems = 5;
+        p_spsc   = adts_spsc_create(&(op));
+        assert(p_spsc);
+        assert(8 == adts_spsc_capacity(p_spsc));
+        assert(EAGAIN == adts_spsc_dequeue(p_spsc, &(p_data)));
+
+        for (size_t idx = 0; idx < 8; idx++) {
+            in[idx] = (void *) (idx + 1);
+            assert(0 == adts_spsc_enqueue(p_spsc, in[idx]));
+        }
+        assert(EAGAIN == adts_spsc_enqueue(p_spsc, in[0]));
+        assert(8 == adts_spsc_entries(p_spsc));
+
+        /* partial drain, then a batch which wraps and is truncated */
+        assert(3 == adts_spsc_dequeue_n(p_spsc, out, 3));
+        assert((in[0] == out[0]) && (in[2] == out[2]));
+        cnt = adts_spsc_enqueue_n(p_spsc, in, 8);
+        assert(3 == cnt);
+
+        assert(8 == adts_spsc_dequeue_n(p_spsc, out, 8));
+        for (size_t idx = 0; idx < 5; idx++) {
+            assert(in[idx + 3] == out[idx]);
+        }
+        for (size_t idx = 0; idx < 3; idx++) {
+            assert(in[idx] == out[idx + 5]);
+        }
+        assert(0 == adts_spsc_dequeue_n(p_spsc, out, 8));
+
+        adts_spsc_destroy(p_spsc);
+
+        (void) adts_mem_stats(ADTS_MEM_TYPE_SPSC, &(after));
+        assert(before.bytes_curr == after.bytes_curr);
+    }
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: two thread throughput");
+
+        utest_spsc_rate(1);
+        utest_spsc_rate(UTEST_SPSC_BATCH);
+    }
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: two thread round trip latency");
+
+        utest_spsc_latency(false);
+        utest_spsc_latency(true);
+    }
+
+    (void) pthread_setaffinity_np(pthread_self(), sizeof(affinity), &(affinity));
+
+    return;
+} /* utest_control() */
+
+
+/*
+ ****************************************************************************
+ * test entrypoint
+ *
+ ****************************************************************************
+ */
+void
+utest_adts_spsc( void )
+{
+    utest_control();
+
+    return;
+} /* utest_adts_spsc() */
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <adts_wait.h>
+#include <adts_memory.h>
+
+
+/******************************************************************************
+ #####  ####### ######  #     #  #####  ####### #     # ######  #######  #####
+#     #    #    #     # #     # #     #    #    #     # #     # #       #     #
+#          #    #     # #     # #          #    #     # #     # #       #
+ #####     #    ######  #     # #          #    #     # ######  #####    #####
+      #    #    #   #   #     # #          #    #     # #   #   #             #
+#     #    #    #    #  #     # #     #    #    #     # #    #  #       #     #
+ #####     #    #     #  #####   #####     #     #####  #     # #######  #####
+******************************************************************************/
+
+/**
+ **************************************************************************
+ * \details
+ *   Bounded single producer / single consumer ring of pointers.  Unlike
+ *   the other ADTs the producer and consumer may run concurrently without
+ *   consumer provided locking, provided there is exactly one of each.
+ *
+ *   The producer and consumer indices reside on separate cache lines, and
+ *   each side keeps a private copy of the opposite index which is only
+ *   refreshed when the ring appears full / empty.
+ *
+ **************************************************************************
+ */
+#define ADTS_SPSC_BYTES (256)
+
+typedef struct {
+    const char reserved[ ADTS_SPSC_BYTES ];
+} adts_spsc_t;
+
+
+/**
+ **************************************************************************
+ * \details
+ *   elems is rounded up to a power of two.  spins is the spin budget of
+ *   adts_spsc_dequeue_wait() before parking, 0 selects the default.
+ *
+ **************************************************************************
+ */
+typedef struct {
+    size_t                  elems;       /**< ring capacity */
+    uint32_t                spins;       /**< dequeue_wait spin budget */
+    const adts_allocator_t *p_allocator; /**< NULL selects the default */
+} adts_spsc_create_t;
+
+
+
+/******************************************************************************
+ #####   #####    ####    #####   ####    #####   #   #  #####   ######   ####
+ #    #  #    #  #    #     #    #    #     #      # #   #    #  #       #
+ #    #  #    #  #    #     #    #    #     #       #    #    #  #####    ####
+ #####   #####   #    #     #    #    #     #       #    #####   #            #
+ #       #   #   #    #     #    #    #     #       #    #       #       #    #
+ #       #    #   ####      #     ####      #       #    #       ######   ####
+*******************************************************************************/
+
+/**
+ **************************************************************************
+ * \brief
+ *   Producer services, call from the producer thread only
+ *
+ * \details
+ *   - adts_spsc_enqueue()   EAGAIN when full
+ *   - adts_spsc_enqueue_n() enqueue up to n, returns the number enqueued
+ *
+ **************************************************************************
+ */
+int32_t
+adts_spsc_enqueue( adts_spsc_t *p_adts_spsc,
+                   void        *p_data );
+
+size_t
+adts_spsc_enqueue_n( adts_spsc_t *p_adts_spsc,
+                     void *const *pp_data,
+                     size_t       n );
+
+
+/**
+ **************************************************************************
+ * \brief
+ *   Consumer services, call from the consumer thread only
+ *
+ * \details
+ *   - adts_spsc_dequeue()      EAGAIN when empty
+ *   - adts_spsc_dequeue_n()    dequeue up to n, returns the number dequeued
+ *   - adts_spsc_dequeue_wait() spin, then park while empty
+ *
+ **************************************************************************
+ */
+int32_t
+adts_spsc_dequeue( adts_spsc_t  *p_adts_spsc,
+                   void        **pp_data );
+
+size_t
+adts_spsc_dequeue_n( adts_spsc_t  *p_adts_spsc,
+                     void        **pp_data,
+                     size_t        n );
+
+void *
+adts_spsc_dequeue_wait( adts_spsc_t *p_adts_spsc );
+
+
+/**
+ **************************************************************************
+ * \details
+ *   adts_spsc_entries() is a snapshot when called concurrently with the
+ *   producer or consumer.
+ *
+ **************************************************************************
+ */
+size_t
+adts_spsc_entries( adts_spsc_t *p_adts_spsc );
+
+size_t
+adts_spsc_capacity( adts_spsc_t *p_adts_spsc );
+
+void
+adts_spsc_wait_stats( adts_spsc_t       *p_adts_spsc,
+                      adts_wait_stats_t *p_out );
+
+void
+adts_spsc_mem_usage( adts_spsc_t      *p_adts_spsc,
+                     adts_mem_stats_t *p_out );
+
+void
+adts_spsc_destroy( adts_spsc_t *p_adts_spsc );
+
+adts_spsc_t *
+adts_spsc_create( const adts_spsc_create_t *p_op );
+
+
+/**
+ **************************************************************************
+ * \details
+ *   Unit Test prototypes
+ *
+ **************************************************************************
+ */
+void
+utest_adts_spsc( void );
@@ -1,13 +1,17 @@
 
 #include <errno.h>
 #include <assert.h>
+#include <stdlib.h>
 #include <string.h>
 #include <limits.h>
 #include <stdbool.h>
 #include <inttypes.h>
 
 /* Toolbox */
+#include <adts_math.h>
+#include <adts_time.h>
 #include <adts_stack.h>
+#include <adts_memory.h>
 #include <adts_sanity.h>
 #include <adts_private.h>
 #include <adts_display.h>
@@ -118,6 +122,32 @@ typedef struct {
 
 /*
  ****************************************************************************
+ * \details
+ *   Segmented mode building block, the oldest segment has no p_prev.
+ *
+ ****************************************************************************
+ */
+typedef struct stack_seg_s {
+    struct stack_seg_s *p_prev;
+    stack_node_t        nodes[];
+} stack_seg_t;
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   workspace always holds the top of stack.  In contiguous mode it is
+ *   the whole stack and base is 0.  In segmented mode it is the nodes of
+ *   p_seg, elems_limit is the segment size and base counts the entries
+ *   held in the older segments.  Thus the top entry is always
+ *   workspace[elems_curr - base - 1].
+ *
+ *   A vacated segment is retired lazily, on the pop which finds it empty,
+ *   into p_spare.  An alternating push / pop at a boundary thus never
+ *   allocates.
+ *
+ *   An embedded stack is contiguous, its workspace follows the control
+ *   block in caller memory and never resizes.
  *
  ****************************************************************************
  */
@@ -128,6 +158,13 @@ typedef struct {
     adts_sanity_t   sanity;
     stack_stats_t   stats;
     stack_resize_t  resize;
+    adts_mem_t      mem;
+    size_t                 base;
+    stack_seg_t           *p_seg;
+    stack_seg_t           *p_spare;
+    adts_stack_overflow_t  p_overflow;
+    void                  *p_overflow_ctx;
+    bool                   embedded;
 } stack_t;
 
 
@@ -176,17 +213,28 @@ typedef struct {
 static void
 stack_display_workspace( stack_t *p_stack )
 {
-    size_t elems  = p_stack->elems_curr;
-    size_t digits = 0;
+    size_t        elems  = p_stack->elems_curr - p_stack->base;
+    size_t        base   = p_stack->base;
+    size_t        digits = 0;
+    stack_node_t *p_node = p_stack->workspace;
+    stack_seg_t  *p_seg  = p_stack->p_seg;
+
+    /* display the entire stack with dynamic width formatting, segments
+     * are displayed newest first */
+    digits = adts_digits_decimal(p_stack->elems_curr);
+    while (p_node) {
+        for (size_t idx = 0; idx < elems; idx++) {
+            printf("[%*d]  data: %16p  bytes: %8d \n",
+                    digits,
+                    base + idx,
+                    p_node[idx].p_data,
+                    p_node[idx].bytes);
+        }
 
-    /* display the entire stack with dynamic width formatting */
-    digits = adts_digits_decimal(elems);
-    for (size_t idx = 0; idx < elems; idx++) {
-        printf("[%*d]  data: %16p  bytes: %8d \n",
-                digits,
-                idx,
-                p_stack->workspace[idx].p_data,
-                p_stack->workspace[idx].bytes);
+        p_seg  = p_seg ? p_seg->p_prev : NULL;
+        p_node = p_seg ? p_seg->nodes : NULL;
+        elems  = p_stack->elems_limit;
+        base  -= p_seg ? elems : 0;
     }
 
     return;
@@ -204,8 +252,9 @@ stack_display_worker( stack_t         *p_stack,
                       adts_snapshot_t *p_snap,
                       bool             private )
 {
-    stack_stats_t  *p_stats  = &(p_stack->stats);
-    stack_resize_t *p_resize = &(p_stack->resize);
+    stack_stats_t    *p_stats  = &(p_stack->stats);
+    stack_resize_t   *p_resize = &(p_stack->resize);
+    adts_mem_stats_t *p_mem    = &(p_stack->mem.stats);
 
     printf("\n");
     printf("---------------------------------------------------------------\n");
@@ -225,8 +274,12 @@ stack_display_worker( stack_t         *p_stack,
     printf("resize.shrink        = %i\n", p_resize->shrink);
     printf("resize.error         = %i\n", p_resize->error);
 
+    printf("mem.bytes_curr       = %zu\n", p_mem->bytes_curr);
+    printf("mem.bytes_peak       = %zu\n", p_mem->bytes_peak);
+
     printf("elems_curr           = %i\n", p_stack->elems_curr);
     printf("elems_limit          = %i\n", p_stack->elems_limit);
+    printf("base                 = %zu\n", p_stack->base);
 
     if (private) {
         printf("p_stack->workspace   = %i\n", p_stack->workspace);
@@ -285,33 +338,124 @@ stack_resize( stack_t          *p_stack,
 {
     size_t        limit_new = stack_resize_limit(p_stack->elems_limit, op);
     size_t        bytes     = 0;
+    size_t        bytes_old = 0;
     int32_t       rc        = 0;
-    stack_node_t *p_old     = NULL;
     stack_node_t *p_tmp     = NULL;
+    adts_mem_t   *p_mem     = &(p_stack->mem);
 
-    /* p_tmp used to handle error case and preserve the workspace */
-    bytes = limit_new * sizeof(p_stack->workspace[0]);
-    p_tmp = adts_mem_zalloc(bytes);
+    /* p_tmp used to handle error case and preserve the workspace.  Large
+     * workspaces are remapped rather than copied. */
+    bytes     = limit_new * sizeof(p_stack->workspace[0]);
+    bytes_old = p_stack->elems_limit * sizeof(p_stack->workspace[0]);
+    p_tmp     = adts_mem_resize(p_mem, p_stack->workspace, bytes_old, bytes);
     if (NULL == p_tmp) {
         rc = ENOMEM;
         goto exception;
     }
 
-    /* copy _current_ elements into new workspace */
-    bytes = p_stack->elems_curr * sizeof(p_stack->workspace[0]);
-    memcpy(p_tmp, p_stack->workspace, bytes);
-
-    /* Set new stack properties fast by deferring free() */
-    p_old                = p_stack->workspace;
     p_stack->workspace   = p_tmp;
     p_stack->elems_limit = limit_new;
-    free(p_old);
 
 exception:
     return rc;
 } /* stack_resize() */
 
 
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+static inline size_t
+stack_segment_bytes( stack_t *p_stack )
+{
+    return sizeof(stack_seg_t) + (p_stack->elems_limit * sizeof(stack_node_t));
+} /* stack_segment_bytes() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Link a fresh segment above the full top segment, the spare is used
+ *   when cached.  Existing entries are never moved.
+ *
+ ****************************************************************************
+ */
+static int32_t
+stack_segment_advance( stack_t *p_stack )
+{
+    int32_t      rc    = 0;
+    stack_seg_t *p_seg = p_stack->p_spare;
+
+    if (p_seg) {
+        p_stack->p_spare = NULL;
+    }else {
+        p_seg = adts_mem_alloc(&(p_stack->mem), stack_segment_bytes(p_stack));
+        if (NULL == p_seg) {
+            rc = ENOMEM;
+            goto exception;
+        }
+    }
+
+    p_seg->p_prev       = p_stack->p_seg;
+    p_stack->p_seg      = p_seg;
+    p_stack->workspace  = p_seg->nodes;
+    p_stack->base      += p_stack->elems_limit;
+
+exception:
+    return rc;
+} /* stack_segment_advance() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Step down from the empty top segment, which becomes the spare.  Only
+ *   one spare is kept, a previous one is released.
+ *
+ ****************************************************************************
+ */
+static void
+stack_segment_retreat( stack_t *p_stack )
+{
+    stack_seg_t    *p_seg    = p_stack->p_seg;
+    stack_resize_t *p_resize = &(p_stack->resize);
+
+    if (p_stack->p_spare) {
+        adts_mem_put(&(p_stack->mem), p_stack->p_spare,
+                     stack_segment_bytes(p_stack));
+    }
+
+    p_stack->p_spare    = p_seg;
+    p_stack->p_seg      = p_seg->p_prev;
+    p_stack->workspace  = p_stack->p_seg->nodes;
+    p_stack->base      -= p_stack->elems_limit;
+    p_resize->shrink++;
+
+    return;
+} /* stack_segment_retreat() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Top entry of a non-empty stack.
+ *
+ ****************************************************************************
+ */
+static inline stack_node_t *
+stack_top( stack_t *p_stack )
+{
+    if (unlikely((p_stack->elems_curr == p_stack->base) &&
+                 p_stack->p_seg && p_stack->elems_curr)) {
+        /* segmented, the top segment was vacated by the previous pop */
+        stack_segment_retreat(p_stack);
+    }
+
+    return &(p_stack->workspace[p_stack->elems_curr - p_stack->base - 1]);
+} /* stack_top() */
+
+
 /*
  ****************************************************************************
  *
@@ -350,6 +494,27 @@ exception:
 } /* stack_resize_check_shrink() */
 
 
+/*
+ ****************************************************************************
+ * \details
+ *   Report a rejected push, returns rc for the caller to propagate.
+ *
+ ****************************************************************************
+ */
+static int32_t
+stack_overflow( stack_t *p_stack,
+                int32_t  rc,
+                void    *p_data,
+                size_t   bytes )
+{
+    if (p_stack->p_overflow) {
+        p_stack->p_overflow(p_stack->p_overflow_ctx, p_data, bytes);
+    }
+
+    return rc;
+} /* stack_overflow() */
+
+
 /*
  ****************************************************************************
  *
@@ -362,8 +527,17 @@ stack_resize_check_grow( stack_t *p_stack )
     stack_stats_t  *p_stats  = &(p_stack->stats);
     stack_resize_t *p_resize = &(p_stack->resize);
 
-    if (unlikely(p_stack->elems_curr == p_stack->elems_limit)) {
-        rc = stack_resize(p_stack, STACK_GROW);
+    if (unlikely((p_stack->elems_curr - p_stack->base) == p_stack->elems_limit)) {
+        if (p_stack->embedded) {
+            rc = ENOSPC;
+            goto exception;
+        }
+
+        if (p_stack->p_seg) {
+            rc = stack_segment_advance(p_stack);
+        }else {
+            rc = stack_resize(p_stack, STACK_GROW);
+        }
         if (rc) {
             p_resize->error++;
             goto exception;
@@ -416,6 +590,23 @@ adts_stack_entries( adts_stack_t *p_adts_stack )
 } /* adts_stack_entries() */
 
 
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_stack_mem_usage( adts_stack_t     *p_adts_stack,
+                      adts_mem_stats_t *p_out )
+{
+    stack_t *p_stack = (stack_t *) p_adts_stack;
+
+    adts_mem_usage(&(p_stack->mem), p_out);
+
+    return;
+} /* adts_stack_mem_usage() */
+
+
 
 /*
  ****************************************************************************
@@ -448,18 +639,22 @@ void *
 adts_stack_peek( adts_stack_t *p_adts_stack )
 {
     stack_t       *p_stack  = (stack_t *) p_adts_stack;
+    void          *p_data   = NULL;
     stack_stats_t *p_stats  = &(p_stack->stats);
     adts_sanity_t *p_sanity = &(p_stack->sanity);
 
     adts_sanity_entry(p_sanity);
 
-    int32_t       idx     = p_stack->elems_curr - 1;
-    stack_node_t *p_elem  = &(p_stack->workspace[idx]);
-    void         *p_data  = p_elem->p_data;
+    if (unlikely(0 == p_stack->elems_curr)) {
+        /* empty stack */
+        goto exception;
+    }
 
+    p_data = stack_top(p_stack)->p_data;
     p_stats->peek++;
-    adts_sanity_exit(p_sanity);
 
+exception:
+    adts_sanity_exit(p_sanity);
     return p_data;
 } /* adts_stack_peek() */
 
@@ -476,7 +671,6 @@ adts_stack_pop( adts_stack_t *p_adts_stack )
 {
     stack_t       *p_stack  = (stack_t *) p_adts_stack;
     void          *p_data   = NULL;
-    int32_t        idx      = 0;
     stack_node_t  *p_elem   = NULL;
     stack_stats_t *p_stats  = &(p_stack->stats);
     adts_sanity_t *p_sanity = &(p_stack->sanity);
@@ -488,8 +682,7 @@ adts_stack_pop( adts_stack_t *p_adts_stack )
         goto exception;
     }
 
-    idx    = p_stack->elems_curr - 1;
-    p_elem = &(p_stack->workspace[idx]);
+    p_elem = stack_top(p_stack);
 
     p_stack->elems_curr--;
     p_stats->pop++;
@@ -498,7 +691,9 @@ adts_stack_pop( adts_stack_t *p_adts_stack )
     p_data = p_elem->p_data;
     memset(p_elem, 0, sizeof(*p_elem));
 
-    stack_resize_check_shrink(p_stack);
+    if ((NULL == p_stack->p_seg) && !p_stack->embedded) {
+        stack_resize_check_shrink(p_stack);
+    }
 
 exception:
     adts_sanity_exit(p_sanity);
@@ -527,10 +722,11 @@ adts_stack_push( adts_stack_t *p_adts_stack,
 
     rc = stack_resize_check_grow(p_stack);
     if (rc) {
+        rc = stack_overflow(p_stack, rc, p_data, bytes);
         goto exception;
     }
 
-    idx            = p_stack->elems_curr;
+    idx            = p_stack->elems_curr - p_stack->base;
     p_elem         = &(p_stack->workspace[idx]);
     p_elem->p_data = p_data;
     p_elem->bytes  = bytes;
@@ -546,6 +742,73 @@ exception:
 } /* adts_stack_push() */
 
 
+/*
+ ****************************************************************************
+ * \details
+ *   Embedded stacks only, base is 0 and the workspace never resizes.
+ *
+ ****************************************************************************
+ */
+int32_t
+adts_stack_push_fast( adts_stack_t *p_adts_stack,
+                      void         *p_data,
+                      size_t        bytes )
+{
+    int32_t        rc      = 0;
+    stack_t       *p_stack = (stack_t *) p_adts_stack;
+    stack_node_t  *p_elem  = NULL;
+    stack_stats_t *p_stats = &(p_stack->stats);
+
+    assert(p_stack->embedded);
+
+    if (unlikely(p_stack->elems_curr == p_stack->elems_limit)) {
+        rc = stack_overflow(p_stack, ENOSPC, p_data, bytes);
+        goto exception;
+    }
+
+    p_elem         = &(p_stack->workspace[p_stack->elems_curr++]);
+    p_elem->p_data = p_data;
+    p_elem->bytes  = bytes;
+
+    p_stats->push++;
+    p_stats->height++;
+    p_stats->height_max = MAX(p_stats->height, p_stats->height_max);
+
+exception:
+    return rc;
+} /* adts_stack_push_fast() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Embedded stacks only, the popped entry is left in place.
+ *
+ ****************************************************************************
+ */
+void *
+adts_stack_pop_fast( adts_stack_t *p_adts_stack )
+{
+    void          *p_data  = NULL;
+    stack_t       *p_stack = (stack_t *) p_adts_stack;
+    stack_stats_t *p_stats = &(p_stack->stats);
+
+    assert(p_stack->embedded);
+
+    if (unlikely(0 == p_stack->elems_curr)) {
+        goto exception;
+    }
+
+    p_data = p_stack->workspace[--(p_stack->elems_curr)].p_data;
+
+    p_stats->pop++;
+    p_stats->height--;
+
+exception:
+    return p_data;
+} /* adts_stack_pop_fast() */
+
+
 /*
  ****************************************************************************
  *
@@ -554,16 +817,38 @@ exception:
 void
 adts_stack_destroy( adts_stack_t *p_adts_stack )
 {
+    size_t         bytes    = 0;
     stack_t       *p_stack  = (stack_t *) p_adts_stack;
+    adts_mem_t     mem      = p_stack->mem;
     adts_sanity_t *p_sanity = &(p_stack->sanity);
 
+    if (p_stack->embedded) {
+        adts_stack_destroy_embedded(p_adts_stack);
+        goto exception;
+    }
+
     adts_sanity_entry(p_sanity);
 
-    free(p_stack->workspace);
-    free(p_stack);
+    if (p_stack->p_seg) {
+        bytes = stack_segment_bytes(p_stack);
+        if (p_stack->p_spare) {
+            adts_mem_put(&(mem), p_stack->p_spare, bytes);
+        }
+        for (stack_seg_t *p_seg = p_stack->p_seg; p_seg; ) {
+            stack_seg_t *p_prev = p_seg->p_prev;
+
+            adts_mem_put(&(mem), p_seg, bytes);
+            p_seg = p_prev;
+        }
+    }else {
+        bytes = p_stack->elems_limit * sizeof(p_stack->workspace[0]);
+        adts_mem_put(&(mem), p_stack->workspace, bytes);
+    }
+    adts_mem_put(&(mem), p_stack, sizeof(*p_adts_stack));
 
     /* No adts_sanity_exit() since we've freed the memory */
 
+exception:
     return;
 } /* adts_stack_destroy() */
 
@@ -576,44 +861,167 @@ adts_stack_destroy( adts_stack_t *p_adts_stack )
  */
 adts_stack_t *
 adts_stack_create( void )
+{
+    adts_stack_create_t op = {0};
+
+    return adts_stack_create_ext(&(op));
+} /* adts_stack_create() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+adts_stack_t *
+adts_stack_create_ext( const adts_stack_create_t *p_op )
 {
     int32_t       rc           = 0;
     stack_t      *p_stack      = NULL;
-    const size_t  elems        = STACK_DEFAULT_ELEMS;
+    size_t        elems        = STACK_DEFAULT_ELEMS;
+    size_t        bytes        = 0;
+    adts_mem_t    mem          = {0};
     stack_node_t *p_elems      = NULL;
+    stack_seg_t  *p_seg        = NULL;
     adts_stack_t *p_adts_stack = NULL;
 
-    p_adts_stack = adts_mem_zalloc(sizeof(*p_adts_stack));
+    assert(p_op);
+    adts_mem_init_ext(&(mem), ADTS_MEM_TYPE_STACK, p_op->p_allocator);
+
+    p_adts_stack = adts_mem_get(&(mem), sizeof(*p_adts_stack));
     if (NULL == p_adts_stack) {
         rc = ENOMEM;
         goto exception;
     }
 
-    p_elems = adts_mem_zalloc(elems * sizeof(*p_elems));
-    if (NULL == p_elems) {
-        rc = ENOMEM;
-        goto exception;
+    if (p_op->segment_elems) {
+        elems = p_op->segment_elems;
+        bytes = sizeof(*p_seg) + (elems * sizeof(*p_elems));
+        p_seg = adts_mem_alloc(&(mem), bytes);
+        if (NULL == p_seg) {
+            rc = ENOMEM;
+            goto exception;
+        }
+        p_seg->p_prev = NULL;
+        p_elems       = p_seg->nodes;
+    }else {
+        bytes   = elems * sizeof(*p_elems);
+        p_elems = adts_mem_get(&(mem), bytes);
+        if (NULL == p_elems) {
+            rc = ENOMEM;
+            goto exception;
+        }
     }
 
     p_stack              = (stack_t *) p_adts_stack;
     p_stack->workspace   = p_elems;
     p_stack->elems_limit = elems;
+    p_stack->p_seg       = p_seg;
+    p_stack->mem         = mem;
 
 exception:
     if (rc) {
-        if (p_elems) {
-            free(p_elems);
+        if (p_seg) {
+            adts_mem_put(&(mem), p_seg, bytes);
+            p_seg = NULL;
+        }else if (p_elems) {
+            adts_mem_put(&(mem), p_elems, bytes);
 			p_elems = NULL;
         }
 
         if (p_adts_stack) {
-            free(p_adts_stack);
+            adts_mem_put(&(mem), p_adts_stack, sizeof(*p_adts_stack));
 			p_adts_stack = NULL;
         }
     }
 
     return p_adts_stack;
-} /* adts_stack_create() */
+} /* adts_stack_create_ext() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_stack_overflow_set( adts_stack_t          *p_adts_stack,
+                         adts_stack_overflow_t  p_overflow,
+                         void                  *p_ctx )
+{
+    stack_t       *p_stack  = (stack_t *) p_adts_stack;
+    adts_sanity_t *p_sanity = &(p_stack->sanity);
+
+    adts_sanity_entry(p_sanity);
+
+    p_stack->p_overflow     = p_overflow;
+    p_stack->p_overflow_ctx = p_ctx;
+
+    adts_sanity_exit(p_sanity);
+
+    return;
+} /* adts_stack_overflow_set() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Uses the memory passed in by the caller, thus can only fail on
+ *   invalid input.  The control block occupies the first
+ *   sizeof(adts_stack_t) bytes, the workspace the remainder.
+ *
+ ****************************************************************************
+ */
+adts_stack_t *
+adts_stack_create_embedded( void   *p_mem,
+                            size_t  bytes )
+{
+    stack_t      *p_stack      = NULL;
+    size_t        elems        = 0;
+    adts_stack_t *p_adts_stack = NULL;
+
+    if ((NULL == p_mem) || ((uintptr_t) p_mem & 0x7)) {
+        goto exception;
+    }
+
+    if (bytes < ADTS_STACK_EMBEDDED_BYTES(1)) {
+        goto exception;
+    }
+    elems = (bytes - sizeof(*p_adts_stack)) / sizeof(stack_node_t);
+
+    memset(p_mem, 0, sizeof(*p_adts_stack));
+
+    p_adts_stack         = p_mem;
+    p_stack              = (stack_t *) p_adts_stack;
+    p_stack->workspace   = (stack_node_t *) ((char *) p_mem + sizeof(*p_adts_stack));
+    p_stack->elems_limit = elems;
+    p_stack->embedded    = true;
+    adts_mem_init(&(p_stack->mem), ADTS_MEM_TYPE_STACK);
+
+exception:
+    return p_adts_stack;
+} /* adts_stack_create_embedded() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_stack_destroy_embedded( adts_stack_t *p_adts_stack )
+{
+    stack_t       *p_stack  = (stack_t *) p_adts_stack;
+    adts_sanity_t *p_sanity = &(p_stack->sanity);
+
+    assert(p_stack->embedded);
+    adts_sanity_entry(p_sanity);
+
+    /* scrub the control block, no sanity exit as it is gone */
+    memset(p_adts_stack, 0, sizeof(*p_adts_stack));
+
+    return;
+} /* adts_stack_destroy_embedded() */
 
 
 
@@ -651,6 +1059,379 @@ utest_stack_bytes( void )
 } /* utest_stack_bytes() */
 
 
+/*
+ ****************************************************************************
+ * \details
+ *   Report the instance footprint, including workspace slack, as the
+ *   stack height increases.
+ *
+ ****************************************************************************
+ */
+static void
+utest_stack_footprint( void )
+{
+    size_t            elems   = 1 << 20;
+    adts_stack_t     *p_stack = NULL;
+    adts_mem_stats_t  inst    = {0};
+    adts_mem_stats_t  before  = {0};
+    adts_mem_stats_t  family  = {0};
+
+    (void) adts_mem_stats(ADTS_MEM_TYPE_STACK, &(before));
+
+    p_stack = adts_stack_create();
+    assert(p_stack);
+
+    for (size_t idx = 1; idx <= elems; idx++) {
+        (void) adts_stack_push(p_stack, (void *) idx, sizeof(idx));
+        if (0 == (idx & (idx - 1))) {
+            adts_stack_mem_usage(p_stack, &(inst));
+            CDISPLAY("elems: %8zu  bytes: %10zu  peak: %10zu  bytes/elem: %8.2f",
+                     idx,
+                     inst.bytes_curr,
+                     inst.bytes_peak,
+                     (double) inst.bytes_curr / (double) idx);
+        }
+    }
+
+    while (adts_stack_is_not_empty(p_stack)) {
+        (void) adts_stack_pop(p_stack);
+    }
+    adts_stack_mem_usage(p_stack, &(inst));
+    CDISPLAY("drained  bytes: %10zu  peak: %10zu",
+             inst.bytes_curr, inst.bytes_peak);
+
+    adts_stack_destroy(p_stack);
+
+    /* Every byte of every instance must be returned on destroy */
+    (void) adts_mem_stats(ADTS_MEM_TYPE_STACK, &(family));
+    CDISPLAY("family   bytes: %10zu  peak: %10zu",
+             family.bytes_curr, family.bytes_peak);
+    assert(before.bytes_curr == family.bytes_curr);
+
+    return;
+} /* utest_stack_footprint() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Elements pushed by the resize cost benchmark, 1 << 22 is a 64MB
+ *   workspace at the final grow.
+ *
+ ****************************************************************************
+ */
+#ifndef UTEST_STACK_RESIZE_ELEMS
+#define UTEST_STACK_RESIZE_ELEMS (1 << 22)
+#endif
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Grow cost with and without mremap() of the mapped workspace.  Only
+ *   the pushes which trigger a grow are timed.
+ *
+ ****************************************************************************
+ */
+static void
+utest_stack_resize_cost( void )
+{
+    size_t                elems   = UTEST_STACK_RESIZE_ELEMS;
+    adts_stack_t         *p_stack = NULL;
+    adts_mem_config_t     config  = {0};
+    adts_mem_config_t     bench   = {0};
+    adts_mem_map_stats_t  before  = {0};
+    adts_mem_map_stats_t  after   = {0};
+
+    adts_mem_config_get(&(config));
+
+    for (int32_t remap = 0; remap <= 1; remap++) {
+        uint64_t start = 0;
+        uint64_t delta = 0;
+        uint64_t total = 0;
+        uint64_t last  = 0;
+
+        bench       = config;
+        bench.remap = remap;
+        assert(0 == adts_mem_config_set(&(bench)));
+        adts_mem_map_stats(&(before));
+
+        p_stack = adts_stack_create();
+        assert(p_stack);
+
+        for (size_t idx = 1; idx <= elems; idx++) {
+            /* grow occurs on the push following a full pow2 workspace */
+            if ((idx > STACK_DEFAULT_ELEMS) && (0 == ((idx - 1) & (idx - 2)))) {
+                start  = adts_tstamp();
+                (void) adts_stack_push(p_stack, (void *) idx, sizeof(idx));
+                delta  = adts_tstamp() - start;
+                total += delta;
+                last   = delta;
+            }else {
+                (void) adts_stack_push(p_stack, (void *) idx, sizeof(idx));
+            }
+        }
+
+        adts_stack_destroy(p_stack);
+        adts_mem_map_stats(&(after));
+
+        CDISPLAY("remap: %d  elems: %zu  grow total: %10"PRIu64"ns  final grow: %10"PRIu64"ns  remaps: %zu",
+                 remap, elems, total, last, after.remaps - before.remaps);
+    }
+
+    assert(0 == adts_mem_config_set(&(config)));
+
+    return;
+} /* utest_stack_resize_cost() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Depth and segment size of the worst case push benchmark.
+ *
+ ****************************************************************************
+ */
+#ifndef UTEST_STACK_SEGMENT_DEPTH
+#define UTEST_STACK_SEGMENT_DEPTH (1 << 22)
+#endif
+
+#ifndef UTEST_STACK_SEGMENT_ELEMS
+#define UTEST_STACK_SEGMENT_ELEMS (4096)
+#endif
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Deep push, as a DFS would, timing every push.  The contiguous stack
+ *   stalls on each doubling copy, the segmented stack is bounded by one
+ *   segment allocation.  Pushes which grew the stack are reported apart
+ *   from the rest, whose worst case is scheduler / page fault noise.  A
+ *   boundary oscillation follows, which must be served from the spare
+ *   segment without allocating.
+ *
+ ****************************************************************************
+ */
+static void
+utest_stack_segment_latency( void )
+{
+    size_t               depth    = UTEST_STACK_SEGMENT_DEPTH;
+    adts_stack_t        *p_stack  = NULL;
+    stack_t             *p_priv   = NULL;
+    adts_stack_create_t  op       = {0};
+    adts_mem_stats_t     inst     = {0};
+
+    for (int32_t segmented = 0; segmented <= 1; segmented++) {
+        uint64_t start      = 0;
+        uint64_t delta      = 0;
+        uint64_t total      = 0;
+        uint64_t worst      = 0;
+        uint64_t worst_grow = 0;
+        size_t   grows      = 0;
+        size_t   bytes      = 0;
+
+        op.segment_elems = segmented ? UTEST_STACK_SEGMENT_ELEMS : 0;
+        p_stack = adts_stack_create_ext(&(op));
+        p_priv  = (stack_t *) p_stack;
+        assert(p_stack);
+
+        for (size_t idx = 1; idx <= depth; idx++) {
+            start  = adts_tstamp();
+            (void) adts_stack_push(p_stack, (void *) idx, sizeof(idx));
+            delta  = adts_tstamp() - start;
+            total += delta;
+
+            if (grows != p_priv->resize.grow) {
+                grows      = p_priv->resize.grow;
+                worst_grow = MAX(worst_grow, delta);
+            }else {
+                worst      = MAX(worst, delta);
+            }
+        }
+        adts_stack_mem_usage(p_stack, &(inst));
+
+        CDISPLAY("%s  depth: %zu  ns/push: %6.2f  grows: %6zu  worst grow: %10"PRIu64"ns  worst other: %10"PRIu64"ns  bytes: %zu",
+                 segmented ? "segmented " : "contiguous",
+                 depth, (double) total / (double) depth, grows, worst_grow,
+                 worst, inst.bytes_curr);
+
+        if (segmented) {
+            /* pop into the next lower segment, then oscillate */
+            for (size_t idx = 0; idx <= UTEST_STACK_SEGMENT_ELEMS; idx++) {
+                (void) adts_stack_pop(p_stack);
+            }
+            adts_stack_mem_usage(p_stack, &(inst));
+            bytes = inst.bytes_curr;
+
+            for (size_t lap = 0; lap < 1024; lap++) {
+                (void) adts_stack_push(p_stack, (void *) lap, 0);
+                (void) adts_stack_push(p_stack, (void *) lap, 0);
+                assert((void *) lap == adts_stack_pop(p_stack));
+                assert((void *) lap == adts_stack_pop(p_stack));
+            }
+            adts_stack_mem_usage(p_stack, &(inst));
+            assert(bytes == inst.bytes_curr);
+            assert(p_priv->p_spare);
+        }
+
+        for (size_t idx = adts_stack_entries(p_stack); idx > 0; idx--) {
+            assert((void *) idx == adts_stack_pop(p_stack));
+        }
+        assert(adts_stack_is_empty(p_stack));
+
+        adts_stack_destroy(p_stack);
+    }
+
+    return;
+} /* utest_stack_segment_latency() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Push / pop pairs timed by the embedded rate benchmark.
+ *
+ ****************************************************************************
+ */
+#ifndef UTEST_STACK_FAST_OPS
+#define UTEST_STACK_FAST_OPS (1 << 24)
+#endif
+
+#define UTEST_STACK_FAST_DEPTH (64)
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Push / pop at a shallow depth, as an interrupt style handler would:
+ *   heap stack, embedded stack via the checked API, and embedded fast
+ *   path.
+ *
+ ****************************************************************************
+ */
+static void
+utest_stack_embedded_rate( void )
+{
+    uint64_t      start    = 0;
+    uint64_t      delta    = 0;
+    adts_stack_t *p_stack  = NULL;
+    uint64_t      mem[ ADTS_STACK_EMBEDDED_BYTES(UTEST_STACK_FAST_DEPTH) / sizeof(uint64_t) ];
+
+    for (int32_t mode = 0; mode < 3; mode++) {
+        p_stack = mode ? adts_stack_create_embedded(mem, sizeof(mem))
+                       : adts_stack_create();
+        assert(p_stack);
+
+        /* warm to the test depth such that the heap stack has grown */
+        for (size_t idx = 1; idx < UTEST_STACK_FAST_DEPTH; idx++) {
+            assert(0 == adts_stack_push(p_stack, (void *) idx, 0));
+        }
+
+        start = adts_tstamp();
+        if (2 == mode) {
+            for (size_t idx = 1; idx <= UTEST_STACK_FAST_OPS; idx++) {
+                (void) adts_stack_push_fast(p_stack, (void *) idx, 0);
+                (void) adts_stack_pop_fast(p_stack);
+            }
+        }else {
+            for (size_t idx = 1; idx <= UTEST_STACK_FAST_OPS; idx++) {
+                (void) adts_stack_push(p_stack, (void *) idx, 0);
+                (void) adts_stack_pop(p_stack);
+            }
+        }
+        delta = adts_tstamp() - start;
+
+        CDISPLAY("%s  ns/pair: %6.2f",
+                 (0 == mode) ? "heap         " :
+                 (1 == mode) ? "embedded     " : "embedded fast",
+                 (double) delta / (double) UTEST_STACK_FAST_OPS);
+
+        assert((UTEST_STACK_FAST_DEPTH - 1) == adts_stack_entries(p_stack));
+        adts_stack_destroy(p_stack);
+    }
+
+    return;
+} /* utest_stack_embedded_rate() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Overflow callback, counts the rejected entries and records the last.
+ *
+ ****************************************************************************
+ */
+static void
+utest_stack_overflow( void   *p_ctx,
+                      void   *p_data,
+                      size_t  bytes )
+{
+    size_t *p_count = p_ctx;
+
+    p_count[0]++;
+    p_count[1] = (size_t) p_data;
+    p_count[2] = bytes;
+
+    return;
+} /* utest_stack_overflow() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Consumer allocator which tracks live bytes in its context.
+ *
+ ****************************************************************************
+ */
+static void *
+utest_stack_zalloc( void   *p_ctx,
+                    size_t  bytes )
+{
+    *(size_t *) p_ctx += bytes;
+
+    return calloc(1, bytes);
+} /* utest_stack_zalloc() */
+
+
+static void *
+utest_stack_alloc( void   *p_ctx,
+                   size_t  bytes )
+{
+    *(size_t *) p_ctx += bytes;
+
+    return malloc(bytes);
+} /* utest_stack_alloc() */
+
+
+static void *
+utest_stack_realloc( void   *p_ctx,
+                     void   *p_old,
+                     size_t  bytes_old,
+                     size_t  bytes_new )
+{
+    void *p_buf = realloc(p_old, bytes_new);
+
+    if (p_buf) {
+        *(size_t *) p_ctx += bytes_new - bytes_old;
+    }
+
+    return p_buf;
+} /* utest_stack_realloc() */
+
+
+static void
+utest_stack_free( void   *p_ctx,
+                  void   *p_buf,
+                  size_t  bytes )
+{
+    *(size_t *) p_ctx -= bytes;
+    free(p_buf);
+
+    return;
+} /* utest_stack_free() */
+
+
 /*
  ****************************************************************************
  *
@@ -731,6 +1512,7 @@ utest_control( void )
 
         p_stack = adts_stack_create();
         assert(p_stack);
+        assert(NULL == adts_stack_peek(p_stack));
 
         for (size_t idx = 0; idx < elems; idx++) {
             rc = adts_stack_push(p_stack, key[idx], sizeof(key[idx]));
@@ -743,8 +1525,172 @@ utest_control( void )
             (void) adts_stack_pop(p_stack);
             adts_stack_display(p_stack, NULL);
         }
+        assert(NULL == adts_stack_peek(p_stack));
+        assert(NULL == adts_stack_pop(p_stack));
+
+        adts_stack_destroy(p_stack);
+    }
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: consumer allocator");
+
+        size_t               live    = 0;
+        adts_stack_t        *p_stack = NULL;
+        adts_mem_stats_t     inst    = {0};
+        adts_stack_create_t  op      = {0};
+        adts_allocator_t     alloc   = {
+            .p_alloc   = utest_stack_alloc,
+            .p_zalloc  = utest_stack_zalloc,
+            .p_realloc = utest_stack_realloc,
+            .p_free    = utest_stack_free,
+            .p_ctx     = &(live),
+        };
+
+        op.p_allocator = &(alloc);
+        p_stack = adts_stack_create_ext(&(op));
+        assert(p_stack);
+
+        for (size_t idx = 1; idx <= 1024; idx++) {
+            (void) adts_stack_push(p_stack, (void *) idx, sizeof(idx));
+        }
+
+        /* Every accounted byte is served by the consumer allocator */
+        adts_stack_mem_usage(p_stack, &(inst));
+        CDISPLAY("live: %zu  accounted: %zu", live, inst.bytes_curr);
+        assert(live == inst.bytes_curr);
+
+        adts_stack_destroy(p_stack);
+        assert(0 == live);
+    }
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: segmented push / pop / peek across boundaries");
+
+        size_t               depth   = 64;
+        adts_stack_t        *p_stack = NULL;
+        stack_t             *p_priv  = NULL;
+        adts_stack_create_t  op      = {0};
+        adts_mem_stats_t     before  = {0};
+        adts_mem_stats_t     family  = {0};
+
+        (void) adts_mem_stats(ADTS_MEM_TYPE_STACK, &(before));
+
+        op.segment_elems = 4;
+        p_stack = adts_stack_create_ext(&(op));
+        p_priv  = (stack_t *) p_stack;
+        assert(p_stack);
+        assert(NULL == adts_stack_peek(p_stack));
+        assert(NULL == adts_stack_pop(p_stack));
+
+        for (size_t idx = 1; idx <= depth; idx++) {
+            assert(0 == adts_stack_push(p_stack, (void *) idx, idx));
+            assert((void *) idx == adts_stack_peek(p_stack));
+        }
+        assert(depth == adts_stack_entries(p_stack));
+        assert((depth / 4 - 1) == p_priv->resize.grow);
+        assert(depth == p_priv->stats.height_max);
+        adts_stack_display(p_stack, NULL);
+
+        /* peek / pop at each boundary, the vacated segment is the spare */
+        for (size_t idx = depth; idx > 0; idx--) {
+            assert((void *) idx == adts_stack_peek(p_stack));
+            assert((void *) idx == adts_stack_pop(p_stack));
+        }
+        assert(NULL == adts_stack_peek(p_stack));
+        assert(NULL == adts_stack_pop(p_stack));
+        assert(adts_stack_is_empty(p_stack));
+        assert(0 == p_priv->base);
+        assert(p_priv->p_spare);
+        assert((depth == p_priv->stats.push) && (depth == p_priv->stats.pop));
+
+        /* refill through the spare */
+        for (size_t idx = 1; idx <= 9; idx++) {
+            assert(0 == adts_stack_push(p_stack, (void *) idx, idx));
+        }
+        adts_stack_display(p_stack, NULL);
 
         adts_stack_destroy(p_stack);
+
+        (void) adts_mem_stats(ADTS_MEM_TYPE_STACK, &(family));
+        assert(before.bytes_curr == family.bytes_curr);
+    }
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: embedded stack, capacity / overflow / fast path");
+
+        size_t            overflow[ 3 ] = {0};
+        adts_stack_t     *p_stack       = NULL;
+        stack_t          *p_priv        = NULL;
+        adts_mem_stats_t  before        = {0};
+        adts_mem_stats_t  after         = {0};
+        adts_mem_stats_t  inst          = {0};
+        uint64_t          mem[ ADTS_STACK_EMBEDDED_BYTES(8) / sizeof(uint64_t) ];
+
+        (void) adts_mem_stats(ADTS_MEM_TYPE_STACK, &(before));
+
+        /* invalid caller memory */
+        assert(NULL == adts_stack_create_embedded(NULL, sizeof(mem)));
+        assert(NULL == adts_stack_create_embedded((char *) mem + 1, sizeof(mem) - 8));
+        assert(NULL == adts_stack_create_embedded(mem, ADTS_STACK_EMBEDDED_BYTES(1) - 1));
+
+        p_stack = adts_stack_create_embedded(mem, sizeof(mem));
+        p_priv  = (stack_t *) p_stack;
+        assert((void *) p_stack == (void *) mem);
+        assert(8 == p_priv->elems_limit);
+        assert(NULL == adts_stack_peek(p_stack));
+        adts_stack_overflow_set(p_stack, utest_stack_overflow, overflow);
+
+        for (size_t idx = 1; idx <= 8; idx++) {
+            assert(0 == adts_stack_push(p_stack, (void *) idx, idx));
+        }
+        assert(ENOSPC == adts_stack_push(p_stack, (void *) 9, 9));
+        assert((1 == overflow[0]) && (9 == overflow[1]) && (9 == overflow[2]));
+        assert(ENOSPC == adts_stack_push_fast(p_stack, (void *) 10, 10));
+        assert((2 == overflow[0]) && (10 == overflow[1]) && (10 == overflow[2]));
+        assert(0 == p_priv->resize.grow);
+        adts_stack_display(p_stack, NULL);
+
+        /* checked and fast paths interleave */
+        assert((void *) 8 == adts_stack_pop_fast(p_stack));
+        assert((void *) 7 == adts_stack_pop(p_stack));
+        assert(0 == adts_stack_push_fast(p_stack, (void *) 11, 11));
+        assert((void *) 11 == adts_stack_peek(p_stack));
+        assert((void *) 11 == adts_stack_pop_fast(p_stack));
+        for (size_t idx = 6; idx > 0; idx--) {
+            assert((void *) idx == adts_stack_pop_fast(p_stack));
+        }
+        assert(NULL == adts_stack_pop_fast(p_stack));
+        assert(NULL == adts_stack_peek(p_stack));
+        assert(NULL == adts_stack_pop(p_stack));
+        assert((9 == p_priv->stats.push) && (9 == p_priv->stats.pop));
+        assert((0 == p_priv->stats.height) && (8 == p_priv->stats.height_max));
+        assert(0 == p_priv->resize.shrink);
+
+        /* nothing is ever allocated */
+        adts_stack_mem_usage(p_stack, &(inst));
+        assert(0 == inst.bytes_peak);
+        adts_stack_destroy_embedded(p_stack);
+
+        (void) adts_mem_stats(ADTS_MEM_TYPE_STACK, &(after));
+        assert(before.bytes_curr == after.bytes_curr);
+        assert(before.bytes_peak == after.bytes_peak);
+    }
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: embedded push / pop rate");
+
+        utest_stack_embedded_rate();
+    }
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: stack footprint");
+
+        utest_stack_footprint();
     }
 
     return;
@@ -761,6 +1707,8 @@ void
 utest_adts_stack( void )
 {
     utest_control();
+    utest_stack_resize_cost();
+    utest_stack_segment_latency();
 
     return;
 } /* utest_adts_stack() */
@@ -3,6 +3,7 @@
 #include <string.h>
 #include <stdbool.h>
 #include <inttypes.h>
+#include <adts_memory.h>
 #include <adts_snapshot.h>
 
 
@@ -12,7 +13,7 @@
  *
  **************************************************************************
  */
-#define ADTS_STACK_BYTES (128)
+#define ADTS_STACK_BYTES (192)
 
 
 /**
@@ -26,6 +27,50 @@ typedef struct {
 } adts_stack_t;
 
 
+/**
+ **************************************************************************
+ * \details
+ *   stack create options
+ *
+ *   segment_elems of 0 selects one contiguous workspace, which doubles
+ *   with a copy when full.  Otherwise the stack is a chain of fixed size
+ *   segments of segment_elems entries: a push never copies existing
+ *   entries, thus its worst case is a single segment allocation.  One
+ *   vacated segment is cached to absorb push / pop at a boundary.
+ *
+ **************************************************************************
+ */
+typedef struct {
+    const adts_allocator_t *p_allocator;   /**< NULL selects the default */
+    size_t                  segment_elems; /**< 0 for contiguous */
+} adts_stack_create_t;
+
+
+/**
+ **************************************************************************
+ * \details
+ *   Called with the rejected entry when a push fails: an embedded stack
+ *   at capacity, or a heap stack which failed to grow.  The callback may
+ *   not operate on the stack.
+ *
+ **************************************************************************
+ */
+typedef void (*adts_stack_overflow_t)( void   *p_ctx,
+                                       void   *p_data,
+                                       size_t  bytes );
+
+
+/**
+ **************************************************************************
+ * \details
+ *   Caller memory required by an embedded stack of elems entries.
+ *
+ **************************************************************************
+ */
+#define ADTS_STACK_EMBEDDED_BYTES( _elems ) \
+    (ADTS_STACK_BYTES + ((_elems) * (sizeof(void *) + sizeof(size_t))))
+
+
 
 /**
  **************************************************************************
@@ -68,6 +113,10 @@ adts_stack_is_not_empty( adts_stack_t *p_adts_stack );
 size_t
 adts_stack_entries( adts_stack_t *p_adts_stack );
 
+void
+adts_stack_mem_usage( adts_stack_t     *p_adts_stack,
+                      adts_mem_stats_t *p_out );
+
 void *
 adts_stack_peek( adts_stack_t *p_adts_stack );
 
@@ -85,6 +134,50 @@ adts_stack_destroy( adts_stack_t *p_adts_stack );
 adts_stack_t *
 adts_stack_create( void );
 
+adts_stack_t *
+adts_stack_create_ext( const adts_stack_create_t *p_op );
+
+void
+adts_stack_overflow_set( adts_stack_t          *p_adts_stack,
+                         adts_stack_overflow_t  p_overflow,
+                         void                  *p_ctx );
+
+
+/**
+ **************************************************************************
+ * \brief
+ *   Embedded stack, built within caller memory
+ *
+ * \details
+ *   The control block and a fixed capacity workspace reside in p_mem,
+ *   e.g. a caller stack frame or a static region, thus no allocation is
+ *   ever made.  p_mem must be 8 byte aligned and hold at least
+ *   ADTS_STACK_EMBEDDED_BYTES(1), NULL is returned otherwise.  A push at
+ *   capacity is rejected with ENOSPC and reported to the overflow
+ *   callback.
+ *
+ *   - adts_stack_push_fast() / adts_stack_pop_fast() omit the sanity and
+ *     resize checks and the popped entry scrub, embedded stacks only
+ *   - adts_stack_destroy_embedded() invalidates the control block, p_mem
+ *     may be reused on return
+ *
+ **************************************************************************
+ */
+adts_stack_t *
+adts_stack_create_embedded( void   *p_mem,
+                            size_t  bytes );
+
+void
+adts_stack_destroy_embedded( adts_stack_t *p_adts_stack );
+
+int32_t
+adts_stack_push_fast( adts_stack_t *p_adts_stack,
+                      void         *p_data,
+                      size_t        bytes );
+
+void *
+adts_stack_pop_fast( adts_stack_t *p_adts_stack );
+
 
 
 /**
@@ -0,0 +1,327 @@
+#include <errno.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <adts_heap.h>
+#include <adts_time.h>
+#include <adts_theap.h>
+#include <adts_memory.h>
+#include <adts_private.h>
+#include <adts_display.h>
+
+
+/******************************************************************************
+ * #     # #     #   ###   ####### ####### #######  #####  #######  #####
+ * #     # ##    #    #       #       #    #       #     #    #    #     #
+ * #     # # #   #    #       #       #    #       #          #    #
+ * #     # #  #  #    #       #       #    #####    #####     #     #####
+ * #     # #   # #    #       #       #    #             #    #          #
+ * #     # #    ##    #       #       #    #       #     #    #    #     #
+ *  #####  #     #   ###      #       #    #######  #####     #     #####
+******************************************************************************/
+
+/*
+ ****************************************************************************
+ * \details
+ *   Typed heaps under test.  utest_theap_item_t carries what an adts_heap
+ *   entry does, a key and a data pointer.
+ *
+ ****************************************************************************
+ */
+typedef struct {
+    int64_t  key;
+    void    *p_data;
+} utest_theap_item_t;
+
+#define UTEST_THEAP_ITEM_KEY( _v ) ((_v).key)
+#define UTEST_THEAP_SELF_KEY( _v ) (_v)
+
+ADTS_HEAP_DEFINE( utest_theap_min, utest_theap_item_t, UTEST_THEAP_ITEM_KEY, ADTS_THEAP_MIN )
+ADTS_HEAP_DEFINE( utest_theap_max, utest_theap_item_t, UTEST_THEAP_ITEM_KEY, ADTS_THEAP_MAX )
+ADTS_HEAP_DEFINE( utest_theap_u32, uint32_t, UTEST_THEAP_SELF_KEY, ADTS_THEAP_MIN )
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Small PRNG for key generation, xorshift64.
+ *
+ ****************************************************************************
+ */
+static inline uint64_t
+utest_theap_rand( uint64_t *p_state )
+{
+    uint64_t x = *p_state;
+
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *p_state = x;
+
+    return x;
+} /* utest_theap_rand() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Random push, pop and replace_top sequences against adts_heap, keys
+ *   compared pop for pop, duplicates frequent.  Then build, and a self
+ *   keyed scalar heap.
+ *
+ ****************************************************************************
+ */
+static void
+utest_theap_order( void )
+{
+    size_t              elems   = 1 << 14;
+    uint64_t            seed    = 0x9e3779b97f4a7c15ULL;
+    adts_heap_node_t   *p_node  = NULL;
+    adts_heap_node_t  **pp_free = NULL;
+    utest_theap_item_t  item    = {0};
+
+    p_node  = calloc(elems, sizeof(*p_node));
+    pp_free = calloc(elems, sizeof(*pp_free));
+    assert(p_node && pp_free);
+
+    for (uint32_t max = 0; max < 2; max++) {
+        adts_heap_t       *p_ref  = NULL;
+        utest_theap_min_t  heap_n = {0};
+        utest_theap_max_t  heap_x = {0};
+        size_t             live   = 0;
+
+        /* reference nodes not in use */
+        for (size_t idx = 0; idx < elems; idx++) {
+            pp_free[idx] = &(p_node[idx]);
+        }
+
+        p_ref = adts_heap_create(max ? ADTS_HEAP_MAX : ADTS_HEAP_MIN);
+        assert(p_ref);
+        assert(0 == utest_theap_min_init(&(heap_n), 1, NULL));
+        assert(0 == utest_theap_max_init(&(heap_x), 1, NULL));
+        assert(false == utest_theap_min_pop(&(heap_n), &(item)));
+        assert(NULL == utest_theap_max_peek(&(heap_x)));
+
+        for (size_t op = 0; op < (8 * elems); op++) {
+            uint64_t r   = utest_theap_rand(&(seed));
+            int64_t  key = (int64_t) (utest_theap_rand(&(seed)) % 512) - 256;
+            adts_heap_node_t *p_ref_node = NULL;
+
+            if (((r % 3) || (0 == live)) && (live < elems)) {
+                p_ref_node  = pp_free[elems - 1 - live];
+                item.key    = key;
+                item.p_data = p_ref_node;
+                assert(0 == (max ? utest_theap_max_push(&(heap_x), item) :
+                                   utest_theap_min_push(&(heap_n), item)));
+                (void) adts_heap_push(p_ref, p_ref_node, p_ref_node, 1, key);
+                live++;
+                continue;
+            }
+
+            p_ref_node = adts_heap_pop(p_ref);
+            if (r & 0x100) {
+                /* replace, the reference pops then pushes */
+                utest_theap_item_t in = {key, p_ref_node};
+
+                assert(max ? utest_theap_max_replace_top(&(heap_x), in, &(item)) :
+                             utest_theap_min_replace_top(&(heap_n), in, &(item)));
+                assert(item.key == p_ref_node->pub.key);
+                (void) adts_heap_push(p_ref, p_ref_node, p_ref_node, 1, key);
+            }else {
+                assert(max ? utest_theap_max_pop(&(heap_x), &(item)) :
+                             utest_theap_min_pop(&(heap_n), &(item)));
+                assert(item.key == p_ref_node->pub.key);
+                live--;
+                pp_free[elems - 1 - live] = p_ref_node;
+            }
+        }
+
+        assert(live == (max ? utest_theap_max_entries(&(heap_x)) :
+                              utest_theap_min_entries(&(heap_n))));
+
+        adts_heap_destroy(p_ref);
+        utest_theap_max_fini(&(heap_x));
+        utest_theap_min_fini(&(heap_n));
+    }
+
+    /* build, in two appends */
+    {
+        utest_theap_u32_t  heap   = {0};
+        uint32_t          *p_vals = NULL;
+        uint32_t           prev   = 0;
+        uint32_t           val    = 0;
+
+        p_vals = malloc(elems * sizeof(*p_vals));
+        assert(p_vals);
+        for (size_t idx = 0; idx < elems; idx++) {
+            p_vals[idx] = (uint32_t) utest_theap_rand(&(seed));
+        }
+
+        assert(0 == utest_theap_u32_init(&(heap), 0, NULL));
+        assert(0 == utest_theap_u32_build(&(heap), p_vals, 1));
+        assert(0 == utest_theap_u32_build(&(heap), &(p_vals[1]), elems - 1));
+        assert(elems == utest_theap_u32_entries(&(heap)));
+
+        for (size_t idx = 0; idx < elems; idx++) {
+            assert(utest_theap_u32_pop(&(heap), &(val)));
+            assert(prev <= val);
+            prev = val;
+        }
+        assert(utest_theap_u32_is_empty(&(heap)));
+
+        utest_theap_u32_fini(&(heap));
+        free(p_vals);
+    }
+
+    free(pp_free);
+    free(p_node);
+
+    return;
+} /* utest_theap_order() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Population range, as for the adts_heap rate benchmark.
+ *
+ ****************************************************************************
+ */
+#ifndef UTEST_THEAP_RATE_ELEMS_MIN
+#define UTEST_THEAP_RATE_ELEMS_MIN (10000)
+#endif
+
+#ifndef UTEST_THEAP_RATE_ELEMS_MAX
+#define UTEST_THEAP_RATE_ELEMS_MAX (10000000)
+#endif
+
+#ifndef UTEST_THEAP_HOLD_OPS
+#define UTEST_THEAP_HOLD_OPS (1 << 22)
+#endif
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Against adts_heap at its default arity, same random keys:
+ *     - push n then pop n, ns per push and per pop
+ *     - hold, a steady population of n with pop then push of a later
+ *       key, the classic priority queue benchmark, replace_top for the
+ *       typed heap
+ *
+ ****************************************************************************
+ */
+static void
+utest_theap_rate( void )
+{
+    adts_heap_node_t *p_node = NULL;
+
+    p_node = calloc(UTEST_THEAP_RATE_ELEMS_MAX, sizeof(*p_node));
+    assert(p_node);
+
+    for (size_t elems = UTEST_THEAP_RATE_ELEMS_MIN;
+         elems <= UTEST_THEAP_RATE_ELEMS_MAX;
+         elems *= 10) {
+        uint64_t ns[ 2 ][ 3 ] = {{0}};
+
+        for (uint32_t typed = 0; typed < 2; typed++) {
+            adts_heap_t        *p_heap = NULL;
+            utest_theap_min_t   heap   = {0};
+            utest_theap_item_t  item   = {0};
+            uint64_t            seed   = 0x2545f4914f6cdd1dULL;
+            uint64_t            start  = 0;
+            int64_t             prev   = INT64_MIN;
+
+            if (typed) {
+                assert(0 == utest_theap_min_init(&(heap), 0, NULL));
+            }else {
+                p_heap = adts_heap_create(ADTS_HEAP_MIN);
+                assert(p_heap);
+            }
+
+            start = adts_tstamp();
+            for (size_t idx = 0; idx < elems; idx++) {
+                int64_t key = (int64_t) (utest_theap_rand(&(seed)) >> 2);
+
+                if (typed) {
+                    item.key    = key;
+                    item.p_data = &(p_node[idx]);
+                    (void) utest_theap_min_push(&(heap), item);
+                }else {
+                    (void) adts_heap_push(p_heap, &(p_node[idx]), &(p_node[idx]), 1, key);
+                }
+            }
+            ns[typed][0] = adts_tstamp() - start;
+
+            /* hold, keys advance past the current top */
+            start = adts_tstamp();
+            for (size_t idx = 0; idx < UTEST_THEAP_HOLD_OPS; idx++) {
+                int64_t step = (int64_t) (utest_theap_rand(&(seed)) >> 3);
+
+                if (typed) {
+                    utest_theap_item_t in = {0};
+
+                    in.key    = utest_theap_min_peek(&(heap))->key + step;
+                    in.p_data = utest_theap_min_peek(&(heap))->p_data;
+                    (void) utest_theap_min_replace_top(&(heap), in, &(item));
+                }else {
+                    adts_heap_node_t *p_pop = adts_heap_pop(p_heap);
+
+                    (void) adts_heap_push(p_heap, p_pop, p_pop->pub.p_data, 1,
+                                          p_pop->pub.key + step);
+                }
+            }
+            ns[typed][2] = adts_tstamp() - start;
+
+            start = adts_tstamp();
+            for (size_t idx = 0; idx < elems; idx++) {
+                int64_t key = 0;
+
+                if (typed) {
+                    (void) utest_theap_min_pop(&(heap), &(item));
+                    key = item.key;
+                }else {
+                    key = adts_heap_pop(p_heap)->pub.key;
+                }
+                assert(prev <= key);
+                prev = key;
+            }
+            ns[typed][1] = adts_tstamp() - start;
+
+            if (typed) {
+                utest_theap_min_fini(&(heap));
+            }else {
+                adts_heap_destroy(p_heap);
+            }
+        }
+
+        CDISPLAY("elems: %10zu  push: %7.2f / %7.2fns  pop: %7.2f / %7.2fns  hold: %7.2f / %7.2fns  (adts_heap / theap)",
+                 elems,
+                 (double) ns[0][0] / (double) elems, (double) ns[1][0] / (double) elems,
+                 (double) ns[0][1] / (double) elems, (double) ns[1][1] / (double) elems,
+                 (double) ns[0][2] / (double) UTEST_THEAP_HOLD_OPS,
+                 (double) ns[1][2] / (double) UTEST_THEAP_HOLD_OPS);
+    }
+
+    free(p_node);
+
+    return;
+} /* utest_theap_rate() */
+
+
+/*
+ ****************************************************************************
+ * test entrypoint
+ *
+ ****************************************************************************
+ */
+void
+utest_adts_theap( void )
+{
+    utest_theap_order();
+    utest_theap_rate();
+
+    return;
+} /* utest_adts_theap() */
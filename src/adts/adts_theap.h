@@ -0,0 +1,376 @@
+#pragma once
+
+#include <errno.h>
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <adts_memory.h>
+
+
+/******************************************************************************
+ #####  ####### ######  #     #  #####  ####### #     # ######  #######  #####
+#     #    #    #     # #     # #     #    #    #     # #     # #       #     #
+#          #    #     # #     # #          #    #     # #     # #       #
+ #####     #    ######  #     # #          #    #     # ######  #####    #####
+      #    #    #   #   #     # #          #    #     # #   #   #             #
+#     #    #    #    #  #     # #     #    #    #     # #    #  #       #     #
+ #####     #    #     #  #####   #####     #     #####  #     # #######  #####
+******************************************************************************/
+
+/**
+ **************************************************************************
+ * \details
+ *   Typed heap template.  ADTS_HEAP_DEFINE() generates a 4-ary heap of
+ *   values of a given type, held by value in one contiguous array, with
+ *   the key and ordering fixed at compile time.
+ *
+ *   adts_heap keeps a key and a consumer node pointer per entry, and a
+ *   pop or handle service reaches through that pointer to the node.  A
+ *   typed heap stores the payload and key themselves, so sifting moves
+ *   the values directly and a pop returns a copy.  No node is dereferenced
+ *   and none is kept, so it suits small values, e.g. a key and an index or
+ *   pointer.
+ *
+ *   ADTS consumer is responsible for serialization.
+ *
+ **************************************************************************
+ */
+#define ADTS_THEAP_ARITY_SHIFT   (2)
+#define ADTS_THEAP_ARITY         (1 << ADTS_THEAP_ARITY_SHIFT)
+#define ADTS_THEAP_ELEMS_DEFAULT (256)
+
+
+/**
+ **************************************************************************
+ * \details
+ *   The array is placed such that element 1, the first sibling group,
+ *   starts a cacheline, thus four 16 byte values share one line.  The
+ *   allocation carries the alignment slack.
+ *
+ **************************************************************************
+ */
+#define ADTS_THEAP_ALIGN (64)
+
+#define ADTS_THEAP_RAW_BYTES( _elems, _bytes ) \
+    (((_elems) * (_bytes)) + ADTS_THEAP_ALIGN)
+
+
+/**
+ **************************************************************************
+ * \details
+ *   Orderings for ADTS_HEAP_DEFINE(), _cmp( a, b ) is true when key a
+ *   belongs above key b.
+ *
+ **************************************************************************
+ */
+#define ADTS_THEAP_MIN( _a, _b ) ((_a) < (_b))
+#define ADTS_THEAP_MAX( _a, _b ) ((_a) > (_b))
+
+
+
+/******************************************************************************
+ #####   #####    ####    #####   ####    #####   #   #  #####   ######   ####
+ #    #  #    #  #    #     #    #    #     #      # #   #    #  #       #
+ #    #  #    #  #    #     #    #    #     #       #    #    #  #####    ####
+ #####   #####   #    #     #    #    #     #       #    #####   #            #
+ #       #   #   #    #     #    #    #     #       #    #       #       #    #
+ #       #    #   ####      #     ####      #       #    #       ######   ####
+*******************************************************************************/
+
+/**
+ **************************************************************************
+ * \brief
+ *   Typed heap generator
+ *
+ * \details
+ *   ADTS_HEAP_DEFINE( _name, _type, _key, _cmp ) at file scope defines
+ *   _name_t and its services:
+ *     - _name_init()         elems initial capacity, 0 selects the
+ *                            default, ENOMEM
+ *     - _name_fini()         release the array
+ *     - _name_push()         ENOMEM when a full array fails to grow
+ *     - _name_pop()          copy out the top, false when empty
+ *     - _name_peek()         the top in place, NULL when empty
+ *     - _name_replace_top()  pop then push in one sift, false when empty
+ *     - _name_build()        append an array then heapify, O(n), ENOMEM
+ *     - _name_entries(), _name_is_empty(), _name_mem_usage()
+ *
+ *   _key is a function like macro, or function, of one _type value
+ *   yielding its key.  _cmp is ADTS_THEAP_MIN, ADTS_THEAP_MAX or any
+ *   strict ordering of two keys.  The array doubles when full and keeps
+ *   its capacity until fini.
+ *
+ *   e.g.
+ *     typedef struct { uint64_t deadline; uint32_t task; } event_t;
+ *     #define EVENT_KEY( _v ) ((_v).deadline)
+ *     ADTS_HEAP_DEFINE( event_heap, event_t, EVENT_KEY, ADTS_THEAP_MIN )
+ *
+ **************************************************************************
+ */
+#define ADTS_HEAP_DEFINE( _name, _type, _key, _cmp )                          \
+                                                                              \
+typedef struct {                                                              \
+    _type      *p_elems;                                                      \
+    size_t      elems;                                                        \
+    size_t      limit;                                                        \
+    void       *p_raw;                                                        \
+    adts_mem_t  mem;                                                          \
+} _name##_t;                                                                  \
+                                                                              \
+static inline _type *                                                         \
+_name##_align( void *p_raw )                                                  \
+{                                                                             \
+    uintptr_t first = (uintptr_t) p_raw + sizeof(_type);                      \
+                                                                              \
+    first  = first + ADTS_THEAP_ALIGN - 1;                                    \
+    first &= ~((uintptr_t) ADTS_THEAP_ALIGN - 1);                             \
+                                                                              \
+    return (_type *) (first - sizeof(_type));                                 \
+}                                                                             \
+                                                                              \
+static inline bool                                                            \
+_name##_above( const _type *p_a,                                              \
+               const _type *p_b )                                             \
+{                                                                             \
+    return _cmp(_key(*p_a), _key(*p_b));                                      \
+}                                                                             \
+                                                                              \
+static inline void                                                            \
+_name##_sift_up( _name##_t *p_heap,                                           \
+                 size_t     idx,                                              \
+                 _type      value )                                           \
+{                                                                             \
+    _type *p_elems = p_heap->p_elems;                                         \
+                                                                              \
+    while (idx) {                                                             \
+        size_t parent = (idx - 1) >> ADTS_THEAP_ARITY_SHIFT;                  \
+                                                                              \
+        if (!_name##_above(&(value), &(p_elems[parent]))) {                   \
+            break;                                                            \
+        }                                                                     \
+        p_elems[idx] = p_elems[parent];                                       \
+        idx          = parent;                                                \
+    }                                                                         \
+    p_elems[idx] = value;                                                     \
+}                                                                             \
+                                                                              \
+static inline void                                                            \
+_name##_sift_down( _name##_t *p_heap,                                         \
+                   size_t     idx,                                            \
+                   _type      value )                                         \
+{                                                                             \
+    _type  *p_elems = p_heap->p_elems;                                        \
+    size_t  elems   = p_heap->elems;                                          \
+                                                                              \
+    for (;;) {                                                                \
+        size_t child = (idx << ADTS_THEAP_ARITY_SHIFT) + 1;                   \
+        size_t best  = child;                                                 \
+                                                                              \
+        if (child >= elems) {                                                 \
+            break;                                                            \
+        }                                                                     \
+                                                                              \
+        if ((child + ADTS_THEAP_ARITY) <= elems) {                            \
+            /* full sibling group, pairwise, without branches */              \
+            _type  *p_c = &(p_elems[child]);                                  \
+            size_t  lo  = child + _name##_above(&(p_c[1]), &(p_c[0]));        \
+            size_t  hi  = child + 2 + _name##_above(&(p_c[3]), &(p_c[2]));    \
+                                                                              \
+            size_t  pick = -(size_t) _name##_above(&(p_elems[hi]),            \
+                                                   &(p_elems[lo]));           \
+                                                                              \
+            best = lo ^ ((lo ^ hi) & pick);                                   \
+        }else {                                                               \
+            for (size_t c = child + 1; c < elems; c++) {                      \
+                best = _name##_above(&(p_elems[c]), &(p_elems[best])) ?       \
+                       c : best;                                              \
+            }                                                                 \
+        }                                                                     \
+                                                                              \
+        if (!_name##_above(&(p_elems[best]), &(value))) {                     \
+            break;                                                            \
+        }                                                                     \
+        p_elems[idx] = p_elems[best];                                         \
+        idx          = best;                                                  \
+    }                                                                         \
+    p_elems[idx] = value;                                                     \
+}                                                                             \
+                                                                              \
+static inline int32_t                                                         \
+_name##_reserve( _name##_t *p_heap,                                           \
+                 size_t     elems )                                           \
+{                                                                             \
+    size_t  bytes   = sizeof(_type);                                          \
+    size_t  limit   = p_heap->limit;                                          \
+    size_t  pad     = (size_t) ((char *) p_heap->p_elems -                    \
+                                (char *) p_heap->p_raw);                      \
+    void   *p_raw   = NULL;                                                   \
+    _type  *p_elems = NULL;                                                   \
+                                                                              \
+    if ((p_heap->elems + elems) <= limit) {                                   \
+        return 0;                                                             \
+    }                                                                         \
+                                                                              \
+    limit = limit ? limit : ADTS_THEAP_ELEMS_DEFAULT;                         \
+                                                                              \
+    while (limit < (p_heap->elems + elems)) {                                 \
+        limit *= 2;                                                           \
+    }                                                                         \
+                                                                              \
+    p_raw = adts_mem_resize(&(p_heap->mem), p_heap->p_raw,                    \
+                            ADTS_THEAP_RAW_BYTES(p_heap->limit, bytes),       \
+                            ADTS_THEAP_RAW_BYTES(limit, bytes));              \
+    if (NULL == p_raw) {                                                      \
+        return ENOMEM;                                                        \
+    }                                                                         \
+                                                                              \
+    /* The alignment pad may differ at the new address */                     \
+    p_elems = _name##_align(p_raw);                                           \
+    if ((char *) p_elems != ((char *) p_raw + pad)) {                         \
+        memmove(p_elems, (char *) p_raw + pad, p_heap->elems * bytes);        \
+    }                                                                         \
+                                                                              \
+    p_heap->p_raw   = p_raw;                                                  \
+    p_heap->p_elems = p_elems;                                                \
+    p_heap->limit   = limit;                                                  \
+                                                                              \
+    return 0;                                                                 \
+}                                                                             \
+                                                                              \
+static inline int32_t                                                         \
+_name##_push( _name##_t *p_heap,                                              \
+              _type      value )                                              \
+{                                                                             \
+    if (__builtin_expect(p_heap->elems == p_heap->limit, 0)) {                \
+        if (_name##_reserve(p_heap, 1)) {                                     \
+            return ENOMEM;                                                    \
+        }                                                                     \
+    }                                                                         \
+                                                                              \
+    _name##_sift_up(p_heap, p_heap->elems++, value);                          \
+                                                                              \
+    return 0;                                                                 \
+}                                                                             \
+                                                                              \
+static inline bool                                                            \
+_name##_pop( _name##_t *p_heap,                                               \
+             _type     *p_out )                                               \
+{                                                                             \
+    if (0 == p_heap->elems) {                                                 \
+        return false;                                                         \
+    }                                                                         \
+                                                                              \
+    *p_out = p_heap->p_elems[0];                                              \
+    if (--p_heap->elems) {                                                    \
+        _name##_sift_down(p_heap, 0, p_heap->p_elems[p_heap->elems]);         \
+    }                                                                         \
+                                                                              \
+    return true;                                                              \
+}                                                                             \
+                                                                              \
+static inline _type *                                                         \
+_name##_peek( _name##_t *p_heap )                                             \
+{                                                                             \
+    return p_heap->elems ? &(p_heap->p_elems[0]) : NULL;                      \
+}                                                                             \
+                                                                              \
+static inline bool                                                            \
+_name##_replace_top( _name##_t *p_heap,                                       \
+                     _type      value,                                        \
+                     _type     *p_out )                                       \
+{                                                                             \
+    if (0 == p_heap->elems) {                                                 \
+        return false;                                                         \
+    }                                                                         \
+                                                                              \
+    *p_out = p_heap->p_elems[0];                                              \
+    _name##_sift_down(p_heap, 0, value);                                      \
+                                                                              \
+    return true;                                                              \
+}                                                                             \
+                                                                              \
+static inline int32_t                                                         \
+_name##_build( _name##_t   *p_heap,                                           \
+               const _type *p_src,                                            \
+               size_t       elems )                                           \
+{                                                                             \
+    if (_name##_reserve(p_heap, elems)) {                                     \
+        return ENOMEM;                                                        \
+    }                                                                         \
+                                                                              \
+    memcpy(&(p_heap->p_elems[p_heap->elems]), p_src, elems * sizeof(_type));  \
+    p_heap->elems += elems;                                                   \
+                                                                              \
+    /* Floyd, sift down every parent, last first */                           \
+    for (size_t idx = (p_heap->elems > 1) ?                                   \
+                      (((p_heap->elems - 2) >> ADTS_THEAP_ARITY_SHIFT) + 1) : \
+                      0;                                                      \
+         idx > 0;                                                             \
+         idx--) {                                                             \
+        _name##_sift_down(p_heap, idx - 1, p_heap->p_elems[idx - 1]);         \
+    }                                                                         \
+                                                                              \
+    return 0;                                                                 \
+}                                                                             \
+                                                                              \
+static inline size_t                                                          \
+_name##_entries( const _name##_t *p_heap )                                    \
+{                                                                             \
+    return p_heap->elems;                                                     \
+}                                                                             \
+                                                                              \
+static inline bool                                                            \
+_name##_is_empty( const _name##_t *p_heap )                                   \
+{                                                                             \
+    return (0 == p_heap->elems);                                              \
+}                                                                             \
+                                                                              \
+static inline void                                                            \
+_name##_mem_usage( const _name##_t  *p_heap,                                  \
+                   adts_mem_stats_t *p_out )                                  \
+{                                                                             \
+    adts_mem_usage(&(p_heap->mem), p_out);                                    \
+}                                                                             \
+                                                                              \
+static inline void                                                            \
+_name##_fini( _name##_t *p_heap )                                             \
+{                                                                             \
+    adts_mem_put(&(p_heap->mem), p_heap->p_raw,                               \
+                 ADTS_THEAP_RAW_BYTES(p_heap->limit, sizeof(_type)));         \
+    p_heap->p_raw   = NULL;                                                   \
+    p_heap->p_elems = NULL;                                                   \
+    p_heap->elems   = 0;                                                      \
+    p_heap->limit   = 0;                                                      \
+}                                                                             \
+                                                                              \
+static inline int32_t                                                         \
+_name##_init( _name##_t              *p_heap,                                 \
+              size_t                  elems,                                  \
+              const adts_allocator_t *p_allocator )                           \
+{                                                                             \
+    size_t limit = elems ? elems : ADTS_THEAP_ELEMS_DEFAULT;                  \
+    size_t bytes = ADTS_THEAP_RAW_BYTES(limit, sizeof(_type));                \
+                                                                              \
+    memset(p_heap, 0, sizeof(*p_heap));                                       \
+    adts_mem_init_ext(&(p_heap->mem), ADTS_MEM_TYPE_THEAP, p_allocator);      \
+                                                                              \
+    p_heap->p_raw = adts_mem_alloc(&(p_heap->mem), bytes);                    \
+    if (NULL == p_heap->p_raw) {                                              \
+        return ENOMEM;                                                        \
+    }                                                                         \
+    p_heap->p_elems = _name##_align(p_heap->p_raw);                           \
+    p_heap->limit   = limit;                                                  \
+                                                                              \
+    return 0;                                                                 \
+}
+
+
+/**
+ **************************************************************************
+ * \details
+ *   Unit Test prototypes
+ *
+ **************************************************************************
+ */
+void
+utest_adts_theap( void );
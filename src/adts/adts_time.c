@@ -97,7 +97,7 @@ adts_tstamp( void )
     struct timespec *p_ts   = &(ts);
 
     clock_gettime(CLOCK_MONOTONIC_RAW, p_ts);
-    tsval = p_ts->tv_sec + p_ts->tv_nsec;
+    tsval = (p_ts->tv_sec * 1000000000ull) + p_ts->tv_nsec;
 
     return tsval;
 } /* adts_tstamp() */
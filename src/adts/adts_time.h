@@ -24,6 +24,16 @@ typedef struct {
 } adts_time_t;
 
 
+/**
+ **************************************************************************
+ * \brief
+ *   Monotonic raw timestamp in nanoseconds
+ *
+ **************************************************************************
+ */
+uint64_t
+adts_tstamp( void );
+
 
 void
 utest_adts_time( void );
@@ -0,0 +1,1181 @@
+#include <errno.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <inttypes.h>
+
+/* Toolbox */
+#include <adts_heap.h>
+#include <adts_time.h>
+#include <adts_memory.h>
+#include <adts_sanity.h>
+#include <adts_private.h>
+#include <adts_display.h>
+#include <adts_timerwheel.h>
+
+
+/******************************************************************************
+ #####  ####### ######  #     #  #####  ####### #     # ######  #######  #####
+#     #    #    #     # #     # #     #    #    #     # #     # #       #     #
+#          #    #     # #     # #          #    #     # #     # #       #
+ #####     #    ######  #     # #          #    #     # ######  #####    #####
+      #    #    #   #   #     # #          #    #     # #   #   #             #
+#     #    #    #    #  #     # #     #    #    #     # #    #  #       #     #
+ #####     #    #     #  #####   #####     #     #####  #     # #######  #####
+******************************************************************************/
+
+/*
+ ****************************************************************************
+ * \details
+ *   Level L slot s holds timers due within the 2^(8 * L) tick span whose
+ *   bits [8 * L, 8 * L + 8) equal s.  The wheel spans 2^32 ticks.
+ *
+ ****************************************************************************
+ */
+#define TIMERWHEEL_LEVELS        (4)
+#define TIMERWHEEL_SLOT_BITS     (8)
+#define TIMERWHEEL_SLOTS         (1 << TIMERWHEEL_SLOT_BITS)
+#define TIMERWHEEL_SLOT_MASK     (TIMERWHEEL_SLOTS - 1)
+#define TIMERWHEEL_WORDS         (TIMERWHEEL_SLOTS / 64)
+#define TIMERWHEEL_SPAN          (1ULL << (TIMERWHEEL_LEVELS * TIMERWHEEL_SLOT_BITS))
+#define TIMERWHEEL_BATCH_DEFAULT (64)
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Circular doubly linked list link.  A slot is a sentinel link, a
+ *   node is armed while its link is on a list.
+ *
+ ****************************************************************************
+ */
+typedef struct timerwheel_link_s {
+    struct timerwheel_link_s *p_next;
+    struct timerwheel_link_s *p_prev;
+} timerwheel_link_t;
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+typedef struct {
+    /**< public data  - consumer visible */
+    adts_timerwheel_node_public_t pub;
+
+    /**< private data */
+    timerwheel_link_t             link;
+} timerwheel_node_t;
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Slot sentinels and per level occupancy.  An occupancy bit is a hint,
+ *   set on insert and cleared when the slot is drained.  A slot emptied
+ *   by cancels is found empty and cleared when next visited.
+ *
+ ****************************************************************************
+ */
+typedef struct {
+    uint64_t          occupied[ TIMERWHEEL_LEVELS ][ TIMERWHEEL_WORDS ];
+    timerwheel_link_t slot[ TIMERWHEEL_LEVELS ][ TIMERWHEEL_SLOTS ];
+} timerwheel_slots_t;
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   tick is the next tick to process, every timer due before it has been
+ *   collected.  Collected timers wait on the expired list, pending counts
+ *   them, until handed to the consumer.
+ *
+ ****************************************************************************
+ */
+typedef struct {
+    uint64_t                  tick;
+    size_t                    armed;
+    size_t                    pending;
+    size_t                    batch;
+    timerwheel_slots_t       *p_slots;
+    adts_timerwheel_node_t  **pp_batch;
+    timerwheel_link_t         expired;
+    adts_timerwheel_fire_t    p_fire;
+    void                     *p_ctx;
+    adts_timerwheel_stats_t   stats;
+    adts_sanity_t             sanity;
+    adts_mem_t                mem;
+} timerwheel_t;
+
+
+
+/******************************************************************************
+ * ####### #     # #     #  #####  #######   ###   ####### #     #  #####
+ * #       #     # ##    # #     #    #       #    #     # ##    # #     #
+ * #       #     # # #   # #          #       #    #     # # #   # #
+ * #####   #     # #  #  # #          #       #    #     # #  #  #  #####
+ * #       #     # #   # # #          #       #    #     # #   # #       #
+ * #       #     # #    ## #     #    #       #    #     # #    ## #     #
+ * #        #####  #     #  #####     #      ###   ####### #     #  #####
+******************************************************************************/
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+static inline timerwheel_node_t *
+timerwheel_node( timerwheel_link_t *p_link )
+{
+    return (timerwheel_node_t *) ((char *) p_link - offsetof(timerwheel_node_t, link));
+} /* timerwheel_node() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+static inline void
+timerwheel_list_init( timerwheel_link_t *p_head )
+{
+    p_head->p_next = p_head;
+    p_head->p_prev = p_head;
+
+    return;
+} /* timerwheel_list_init() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+static inline bool
+timerwheel_list_is_empty( const timerwheel_link_t *p_head )
+{
+    return (p_head->p_next == p_head);
+} /* timerwheel_list_is_empty() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+static inline void
+timerwheel_list_append( timerwheel_link_t *p_head,
+                        timerwheel_link_t *p_link )
+{
+    p_link->p_next         = p_head;
+    p_link->p_prev         = p_head->p_prev;
+    p_head->p_prev->p_next = p_link;
+    p_head->p_prev         = p_link;
+
+    return;
+} /* timerwheel_list_append() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Unlink and mark disarmed.
+ *
+ ****************************************************************************
+ */
+static inline void
+timerwheel_list_remove( timerwheel_link_t *p_link )
+{
+    p_link->p_prev->p_next = p_link->p_next;
+    p_link->p_next->p_prev = p_link->p_prev;
+    p_link->p_next         = NULL;
+    p_link->p_prev         = NULL;
+
+    return;
+} /* timerwheel_list_remove() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Move every link of p_from onto p_to, p_from becomes empty.
+ *
+ ****************************************************************************
+ */
+static inline void
+timerwheel_list_take( timerwheel_link_t *p_to,
+                      timerwheel_link_t *p_from )
+{
+    if (timerwheel_list_is_empty(p_from)) {
+        timerwheel_list_init(p_to);
+    }else {
+        *p_to                  = *p_from;
+        p_to->p_next->p_prev   = p_to;
+        p_to->p_prev->p_next   = p_to;
+        timerwheel_list_init(p_from);
+    }
+
+    return;
+} /* timerwheel_list_take() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Splice every link of p_from onto the tail of p_to, p_from becomes
+ *   empty.  Returns the number of links moved.
+ *
+ ****************************************************************************
+ */
+static inline size_t
+timerwheel_list_splice( timerwheel_link_t *p_to,
+                        timerwheel_link_t *p_from )
+{
+    size_t             count  = 0;
+    timerwheel_link_t *p_link = NULL;
+
+    if (timerwheel_list_is_empty(p_from)) {
+        goto exception;
+    }
+
+    for (p_link = p_from->p_next; p_link != p_from; p_link = p_link->p_next) {
+        count++;
+    }
+
+    p_from->p_next->p_prev = p_to->p_prev;
+    p_to->p_prev->p_next   = p_from->p_next;
+    p_from->p_prev->p_next = p_to;
+    p_to->p_prev           = p_from->p_prev;
+    timerwheel_list_init(p_from);
+
+exception:
+    return count;
+} /* timerwheel_list_splice() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Lowest occupied slot at or after idx within a level, TIMERWHEEL_SLOTS
+ *   when none.
+ *
+ ****************************************************************************
+ */
+static inline uint32_t
+timerwheel_occupied_next( const uint64_t *p_map,
+                          uint32_t        idx )
+{
+    for (uint32_t w = idx / 64; w < TIMERWHEEL_WORDS; w++) {
+        uint64_t bits = p_map[w];
+
+        if (w == (idx / 64)) {
+            bits &= ~0ULL << (idx % 64);
+        }
+        if (bits) {
+            return (w * 64) + (uint32_t) __builtin_ctzll(bits);
+        }
+    }
+
+    return TIMERWHEEL_SLOTS;
+} /* timerwheel_occupied_next() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Place an armed node by its distance from the current tick.  The level
+ *   is the index of the highest non zero slot sized digit of the distance,
+ *   the slot is the matching digit of the due tick.  A due tick in the
+ *   past is due now, one beyond the span is parked at its far edge and
+ *   re-placed by a later cascade.
+ *
+ ****************************************************************************
+ */
+static inline void
+timerwheel_insert( timerwheel_t      *p_tw,
+                   timerwheel_node_t *p_node )
+{
+    uint64_t  when  = MAX(p_node->pub.expiry, p_tw->tick);
+    uint64_t  delta = when - p_tw->tick;
+    uint32_t  level = 0;
+    uint32_t  idx   = 0;
+
+    if (unlikely(delta >= TIMERWHEEL_SPAN)) {
+        when  = p_tw->tick + (TIMERWHEEL_SPAN - 1);
+        delta = TIMERWHEEL_SPAN - 1;
+    }
+
+    if (delta) {
+        level = (uint32_t) (63 - __builtin_clzll(delta)) / TIMERWHEEL_SLOT_BITS;
+    }
+
+    idx = (uint32_t) (when >> (level * TIMERWHEEL_SLOT_BITS)) & TIMERWHEEL_SLOT_MASK;
+    timerwheel_list_append(&(p_tw->p_slots->slot[level][idx]), &(p_node->link));
+    p_tw->p_slots->occupied[level][idx / 64] |= 1ULL << (idx % 64);
+
+    return;
+} /* timerwheel_insert() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Re-place every node of an outer level slot relative to the current
+ *   tick, they land at least one level inward.
+ *
+ ****************************************************************************
+ */
+static void
+timerwheel_cascade( timerwheel_t *p_tw,
+                    uint32_t      level,
+                    uint32_t      idx )
+{
+    timerwheel_link_t  list;
+    timerwheel_link_t *p_link = NULL;
+
+    p_tw->p_slots->occupied[level][idx / 64] &= ~(1ULL << (idx % 64));
+    timerwheel_list_take(&(list), &(p_tw->p_slots->slot[level][idx]));
+
+    /* insert rewrites both links, thus no unlink from the detached list */
+    p_link = list.p_next;
+    while (p_link != &(list)) {
+        timerwheel_link_t *p_next = p_link->p_next;
+
+        timerwheel_insert(p_tw, timerwheel_node(p_link));
+        p_tw->stats.cascades++;
+        p_link = p_next;
+    }
+
+    return;
+} /* timerwheel_cascade() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Hand the expired list to the consumer, batch timers per call.  The
+ *   callback may arm and cancel, thus serialization sanity is released
+ *   across the call, and each timer is taken off the expired list only
+ *   as its batch is formed.  A timer cancelled by an earlier callback is
+ *   therefore never delivered.
+ *
+ ****************************************************************************
+ */
+static size_t
+timerwheel_flush( timerwheel_t *p_tw )
+{
+    size_t fired = 0;
+
+    while (false == timerwheel_list_is_empty(&(p_tw->expired))) {
+        size_t count = 0;
+
+        while ((count < p_tw->batch) &&
+               (false == timerwheel_list_is_empty(&(p_tw->expired)))) {
+            timerwheel_link_t *p_link = p_tw->expired.p_next;
+
+            timerwheel_list_remove(p_link);
+            p_tw->pp_batch[count++] = (adts_timerwheel_node_t *) timerwheel_node(p_link);
+        }
+
+        p_tw->armed        -= count;
+        p_tw->stats.fires  += count;
+        p_tw->stats.batches++;
+        fired              += count;
+
+        adts_sanity_exit(&(p_tw->sanity));
+        p_tw->p_fire(p_tw->p_ctx, p_tw->pp_batch, count);
+        adts_sanity_entry(&(p_tw->sanity));
+    }
+
+    p_tw->pending = 0;
+
+    return fired;
+} /* timerwheel_flush() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Next tick at which work may exist, given level 0 holds nothing at or
+ *   after the slot of tick.  That is the level 0 wrap, unless level 0 is
+ *   entirely empty, in which case it is the start of the next occupied
+ *   level 1 slot, or the level 1 wrap, and so on outward while each level
+ *   is entirely empty.
+ *
+ ****************************************************************************
+ */
+static inline uint64_t
+timerwheel_skip( const timerwheel_t *p_tw,
+                 uint64_t            tick )
+{
+    uint64_t due = (tick | TIMERWHEEL_SLOT_MASK) + 1;
+
+    for (uint32_t level = 0; level < (TIMERWHEEL_LEVELS - 1); level++) {
+        const uint64_t *p_map = p_tw->p_slots->occupied[level];
+        uint32_t        shift = (level + 1) * TIMERWHEEL_SLOT_BITS;
+        uint32_t        wrap  = shift + TIMERWHEEL_SLOT_BITS;
+        uint32_t        idx   = (uint32_t) (tick >> shift) & TIMERWHEEL_SLOT_MASK;
+        uint32_t        next  = TIMERWHEEL_SLOTS;
+        bool            empty = true;
+
+        for (uint32_t w = 0; w < TIMERWHEEL_WORDS; w++) {
+            empty = empty && (0 == p_map[w]);
+        }
+        if (false == empty) {
+            break;
+        }
+
+        /* level is empty, the next event is outward */
+        if (idx < TIMERWHEEL_SLOT_MASK) {
+            next = timerwheel_occupied_next(p_tw->p_slots->occupied[level + 1], idx + 1);
+        }
+        if (next < TIMERWHEEL_SLOTS) {
+            due = ((tick >> wrap) << wrap) | ((uint64_t) next << shift);
+            break;
+        }
+        due = ((tick >> wrap) + 1) << wrap;
+    }
+
+    return due;
+} /* timerwheel_skip() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_timerwheel_arm( adts_timerwheel_t      *p_adts_timerwheel,
+                     adts_timerwheel_node_t *p_adts_node,
+                     void                   *p_data,
+                     size_t                  bytes,
+                     uint64_t                expiry )
+{
+    timerwheel_t      *p_tw   = (timerwheel_t *) p_adts_timerwheel;
+    timerwheel_node_t *p_node = (timerwheel_node_t *) p_adts_node;
+
+    adts_sanity_entry(&(p_tw->sanity));
+
+    if (p_node->link.p_next) {
+        /* re-arm, move */
+        timerwheel_list_remove(&(p_node->link));
+    }else {
+        p_tw->armed++;
+    }
+
+    p_node->pub.p_data = p_data;
+    p_node->pub.bytes  = bytes;
+    p_node->pub.expiry = expiry;
+    timerwheel_insert(p_tw, p_node);
+    p_tw->stats.arms++;
+
+    adts_sanity_exit(&(p_tw->sanity));
+
+    return;
+} /* adts_timerwheel_arm() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   A slot emptied here keeps its occupancy bit until next visited.
+ *
+ ****************************************************************************
+ */
+int32_t
+adts_timerwheel_cancel( adts_timerwheel_t      *p_adts_timerwheel,
+                        adts_timerwheel_node_t *p_adts_node )
+{
+    int32_t            rc     = 0;
+    timerwheel_t      *p_tw   = (timerwheel_t *) p_adts_timerwheel;
+    timerwheel_node_t *p_node = (timerwheel_node_t *) p_adts_node;
+
+    adts_sanity_entry(&(p_tw->sanity));
+
+    if (NULL == p_node->link.p_next) {
+        rc = ENOENT;
+        goto exception;
+    }
+
+    timerwheel_list_remove(&(p_node->link));
+    p_tw->armed--;
+    p_tw->stats.cancels++;
+
+exception:
+    adts_sanity_exit(&(p_tw->sanity));
+    return rc;
+} /* adts_timerwheel_cancel() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Per tick:
+ *     - on a level 0 wrap, cascade the now current slot of level 1, and
+ *       of each further level whose lower level also wrapped,
+ *     - collect the level 0 slot, every timer within is due this tick.
+ *
+ *   Ticks whose level 0 slot is unoccupied are skipped, see
+ *   timerwheel_skip(), thus the cost is bounded by occupied slots plus
+ *   one step per wrap of a non empty level.  Collected timers are
+ *   delivered once a batch is pending and at the end.
+ *
+ ****************************************************************************
+ */
+size_t
+adts_timerwheel_advance( adts_timerwheel_t *p_adts_timerwheel,
+                         uint64_t           now )
+{
+    size_t        fired = 0;
+    timerwheel_t *p_tw  = (timerwheel_t *) p_adts_timerwheel;
+
+    adts_sanity_entry(&(p_tw->sanity));
+
+    /* tick is now + 1 on return */
+    now = MIN(now, UINT64_MAX - 1);
+
+    while (p_tw->tick <= now) {
+        uint64_t           tick   = p_tw->tick;
+        uint32_t           idx    = (uint32_t) tick & TIMERWHEEL_SLOT_MASK;
+        uint32_t           next   = 0;
+        uint64_t           due    = 0;
+        timerwheel_link_t *p_slot = NULL;
+
+        if (0 == idx) {
+            for (uint32_t level = 1; level < TIMERWHEEL_LEVELS; level++) {
+                uint32_t lidx = (uint32_t) (tick >> (level * TIMERWHEEL_SLOT_BITS)) &
+                                TIMERWHEEL_SLOT_MASK;
+
+                timerwheel_cascade(p_tw, level, lidx);
+                if (lidx) {
+                    break;
+                }
+            }
+        }
+
+        next = timerwheel_occupied_next(p_tw->p_slots->occupied[0], idx);
+        if (TIMERWHEEL_SLOTS == next) {
+            /* nothing further this rotation, skip ahead */
+            due        = timerwheel_skip(p_tw, tick);
+            p_tw->tick = MIN(due, now + 1);
+            continue;
+        }
+
+        due = (tick & ~((uint64_t) TIMERWHEEL_SLOT_MASK)) + next;
+        if (due > now) {
+            p_tw->tick = now + 1;
+            break;
+        }
+
+        /* tick moves first, a callback re-arm lands on a future tick */
+        p_tw->tick = due + 1;
+        p_tw->p_slots->occupied[0][next / 64] &= ~(1ULL << (next % 64));
+        p_slot        = &(p_tw->p_slots->slot[0][next]);
+        p_tw->pending += timerwheel_list_splice(&(p_tw->expired), p_slot);
+
+        if (p_tw->pending >= p_tw->batch) {
+            fired += timerwheel_flush(p_tw);
+        }
+    }
+
+    fired += timerwheel_flush(p_tw);
+
+    adts_sanity_exit(&(p_tw->sanity));
+
+    return fired;
+} /* adts_timerwheel_advance() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+bool
+adts_timerwheel_is_armed( adts_timerwheel_node_t *p_adts_node )
+{
+    timerwheel_node_t *p_node = (timerwheel_node_t *) p_adts_node;
+
+    return (NULL != p_node->link.p_next);
+} /* adts_timerwheel_is_armed() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Time of the most recent advance, or the create time.
+ *
+ ****************************************************************************
+ */
+uint64_t
+adts_timerwheel_now( adts_timerwheel_t *p_adts_timerwheel )
+{
+    timerwheel_t *p_tw = (timerwheel_t *) p_adts_timerwheel;
+
+    return p_tw->tick - 1;
+} /* adts_timerwheel_now() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+size_t
+adts_timerwheel_entries( adts_timerwheel_t *p_adts_timerwheel )
+{
+    timerwheel_t *p_tw = (timerwheel_t *) p_adts_timerwheel;
+
+    return p_tw->armed;
+} /* adts_timerwheel_entries() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_timerwheel_stats( adts_timerwheel_t       *p_adts_timerwheel,
+                       adts_timerwheel_stats_t *p_out )
+{
+    timerwheel_t *p_tw = (timerwheel_t *) p_adts_timerwheel;
+
+    *p_out = p_tw->stats;
+
+    return;
+} /* adts_timerwheel_stats() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_timerwheel_mem_usage( adts_timerwheel_t *p_adts_timerwheel,
+                           adts_mem_stats_t  *p_out )
+{
+    timerwheel_t *p_tw = (timerwheel_t *) p_adts_timerwheel;
+
+    adts_mem_usage(&(p_tw->mem), p_out);
+
+    return;
+} /* adts_timerwheel_mem_usage() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Timers still armed belong to the consumer and are abandoned, their
+ *   nodes must not be passed to this instance again.
+ *
+ ****************************************************************************
+ */
+void
+adts_timerwheel_destroy( adts_timerwheel_t *p_adts_timerwheel )
+{
+    timerwheel_t *p_tw = (timerwheel_t *) p_adts_timerwheel;
+    adts_mem_t    mem  = p_tw->mem;
+
+    adts_sanity_entry(&(p_tw->sanity));
+
+    adts_mem_put(&(mem), p_tw->pp_batch, p_tw->batch * sizeof(p_tw->pp_batch[0]));
+    adts_mem_put(&(mem), p_tw->p_slots, sizeof(*(p_tw->p_slots)));
+    adts_mem_put(&(mem), p_adts_timerwheel, sizeof(*p_adts_timerwheel));
+
+    /* No adts_sanity_exit() since we've freed the memory */
+
+    return;
+} /* adts_timerwheel_destroy() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+adts_timerwheel_t *
+adts_timerwheel_create( const adts_timerwheel_create_t *p_op )
+{
+    size_t               batch             = TIMERWHEEL_BATCH_DEFAULT;
+    int32_t              rc                = 0;
+    timerwheel_t        *p_tw              = NULL;
+    timerwheel_slots_t  *p_slots           = NULL;
+    adts_mem_t           mem               = {0};
+    adts_timerwheel_t   *p_adts_timerwheel = NULL;
+
+    assert(p_op);
+
+    if ((NULL == p_op->p_fire) || (UINT64_MAX == p_op->now)) {
+        rc = EINVAL;
+        goto exception;
+    }
+
+    if (p_op->batch) {
+        batch = p_op->batch;
+    }
+
+    adts_mem_init_ext(&(mem), ADTS_MEM_TYPE_TIMERWHEEL, p_op->p_allocator);
+
+    p_adts_timerwheel = adts_mem_get(&(mem), sizeof(*p_adts_timerwheel));
+    if (NULL == p_adts_timerwheel) {
+        rc = ENOMEM;
+        goto exception;
+    }
+    p_tw = (timerwheel_t *) p_adts_timerwheel;
+
+    p_slots = adts_mem_get(&(mem), sizeof(*p_slots));
+    if (NULL == p_slots) {
+        rc = ENOMEM;
+        goto exception;
+    }
+
+    p_tw->pp_batch = adts_mem_get(&(mem), batch * sizeof(p_tw->pp_batch[0]));
+    if (NULL == p_tw->pp_batch) {
+        rc = ENOMEM;
+        goto exception;
+    }
+
+    for (uint32_t level = 0; level < TIMERWHEEL_LEVELS; level++) {
+        for (uint32_t idx = 0; idx < TIMERWHEEL_SLOTS; idx++) {
+            timerwheel_list_init(&(p_slots->slot[level][idx]));
+        }
+    }
+    timerwheel_list_init(&(p_tw->expired));
+
+    p_tw->tick    = p_op->now + 1;
+    p_tw->batch   = batch;
+    p_tw->p_slots = p_slots;
+    p_tw->p_fire  = p_op->p_fire;
+    p_tw->p_ctx   = p_op->p_ctx;
+    p_tw->mem     = mem;
+
+exception:
+    if (rc) {
+        if (p_slots) {
+            adts_mem_put(&(mem), p_slots, sizeof(*p_slots));
+            p_slots = NULL;
+        }
+
+        if (p_adts_timerwheel) {
+            adts_mem_put(&(mem), p_adts_timerwheel, sizeof(*p_adts_timerwheel));
+            p_adts_timerwheel = NULL;
+        }
+    }
+
+    return p_adts_timerwheel;
+} /* adts_timerwheel_create() */
+
+
+
+/******************************************************************************
+ * #     # #     #   ###   ####### ####### #######  #####  #######  #####
+ * #     # ##    #    #       #       #    #       #     #    #    #     #
+ * #     # # #   #    #       #       #    #       #          #    #
+ * #     # #  #  #    #       #       #    #####    #####     #     #####
+ * #     # #   # #    #       #       #    #             #    #          #
+ * #     # #    ##    #       #       #    #       #     #    #    #     #
+ *  #####  #     #   ###      #       #    #######  #####     #     #####
+******************************************************************************/
+
+/**
+ **************************************************************************
+ * \brief
+ *   Compile time structure sanity
+ *
+ * \details
+ *   Sanitize the abstract data type interface.  Enforced in header file so
+ *   as to catch improper usage/include by unauthorized callers.
+ *
+ **************************************************************************
+ */
+static void
+utest_timerwheel_bytes( void )
+{
+    CDISPLAY("[%u]", sizeof(timerwheel_t));
+    CDISPLAY("[%u]", sizeof(adts_timerwheel_t));
+    CDISPLAY("[%u]", sizeof(timerwheel_node_t));
+    CDISPLAY("[%u]", sizeof(adts_timerwheel_node_t));
+
+    _Static_assert(sizeof(timerwheel_t) <= sizeof(adts_timerwheel_t),
+        "Mismatch structs detected");
+    _Static_assert(sizeof(timerwheel_node_t) <= sizeof(adts_timerwheel_node_t),
+        "Mismatch structs detected");
+
+    return;
+} /* utest_timerwheel_bytes() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Small PRNG for expiry generation, xorshift64.
+ *
+ ****************************************************************************
+ */
+static inline uint64_t
+utest_timerwheel_rand( uint64_t *p_state )
+{
+    uint64_t x = *p_state;
+
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *p_state = x;
+
+    return x;
+} /* utest_timerwheel_rand() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Functional test context.  prev and now are the first and last tick
+ *   of the advance in progress, every delivered timer must be due within
+ *   it, or earlier when armed in the past.  A timer whose
+ *   data is a non zero period is re-armed from the callback.
+ *
+ ****************************************************************************
+ */
+typedef struct {
+    adts_timerwheel_t      *p_tw;
+    uint64_t                prev;
+    uint64_t                now;
+    size_t                  fired;
+    size_t                  rearmed;
+    size_t                  batch_max;
+    uint8_t                *p_fired; /**< per node fire count */
+    adts_timerwheel_node_t *p_base;
+} utest_timerwheel_ctx_t;
+
+
+static void
+utest_timerwheel_fire( void                          *p_arg,
+                       adts_timerwheel_node_t *const *pp_nodes,
+                       size_t                         count )
+{
+    utest_timerwheel_ctx_t *p_ctx = p_arg;
+    uint64_t                last  = 0;
+
+    assert(count && (count <= p_ctx->batch_max));
+
+    for (size_t idx = 0; idx < count; idx++) {
+        const adts_timerwheel_node_public_t *p_pub = &(pp_nodes[idx]->pub);
+        size_t                               n     = (size_t) (pp_nodes[idx] - p_ctx->p_base);
+
+        /* due within this advance, unless armed in the past */
+        assert(p_pub->expiry <= p_ctx->now);
+        assert(false == adts_timerwheel_is_armed(pp_nodes[idx]));
+        /* oldest first within a batch */
+        assert(last <= MAX(p_pub->expiry, p_ctx->prev));
+        last = MAX(p_pub->expiry, p_ctx->prev);
+
+        p_ctx->p_fired[n]++;
+        p_ctx->fired++;
+
+        if ((uintptr_t) p_pub->p_data) {
+            adts_timerwheel_arm(p_ctx->p_tw, pp_nodes[idx], p_pub->p_data, 1,
+                                p_pub->expiry + (uintptr_t) p_pub->p_data);
+            p_ctx->rearmed++;
+        }
+    }
+
+    return;
+} /* utest_timerwheel_fire() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Timers at every level, past, beyond the span, cancelled and re-armed,
+ *   advanced in random steps.  Each one shot timer must fire exactly once,
+ *   within the advance that first reaches its expiry.
+ *
+ ****************************************************************************
+ */
+static void
+utest_timerwheel_expiry( void )
+{
+    #define UTEST_TW_ELEMS (1 << 14)
+    size_t                    elems  = UTEST_TW_ELEMS;
+    uint64_t                  seed   = 0x9e3779b97f4a7c15ULL;
+    uint64_t                  start  = (1ULL << 40) - 12345;
+    uint64_t                  end    = 0;
+    adts_timerwheel_t        *p_tw   = NULL;
+    adts_timerwheel_node_t   *p_node = NULL;
+    adts_timerwheel_create_t  op     = {0};
+    adts_timerwheel_stats_t   stats  = {0};
+    utest_timerwheel_ctx_t    ctx    = {0};
+    size_t                    armed  = 0;
+    size_t                    cancel = 0;
+
+    p_node      = calloc(elems, sizeof(*p_node));
+    ctx.p_fired = calloc(elems, sizeof(*ctx.p_fired));
+    assert(p_node && ctx.p_fired);
+
+    op.p_fire = NULL;
+    assert(NULL == adts_timerwheel_create(&(op)));
+
+    op.now    = start;
+    op.batch  = 7;
+    op.p_fire = utest_timerwheel_fire;
+    op.p_ctx  = &(ctx);
+    p_tw      = adts_timerwheel_create(&(op));
+    assert(p_tw);
+    assert(start == adts_timerwheel_now(p_tw));
+
+    ctx.p_tw      = p_tw;
+    ctx.p_base    = p_node;
+    ctx.batch_max = op.batch;
+
+    /* spread over every level, the past and beyond the span */
+    for (size_t idx = 0; idx < elems; idx++) {
+        uint64_t r      = utest_timerwheel_rand(&(seed));
+        uint64_t expiry = 0;
+
+        switch (idx % 8) {
+            case 0:  expiry = start - (r % 1000);            break;
+            case 1:  expiry = start + (r % (1ULL << 8));     break;
+            case 2:  expiry = start + (r % (1ULL << 16));    break;
+            case 3:  expiry = start + (r % (1ULL << 24));    break;
+            case 4:  expiry = start + (r % (1ULL << 32));    break;
+            case 5:  expiry = start + (1ULL << 32) + (r % (1ULL << 34)); break;
+            default: expiry = start + (r % (1ULL << 20));    break;
+        }
+        adts_timerwheel_arm(p_tw, &(p_node[idx]), NULL, 1, expiry);
+        end = MAX(end, expiry);
+    }
+    armed = elems;
+    assert(armed == adts_timerwheel_entries(p_tw));
+
+    /* cancel every 5th, twice is ENOENT, re-arm every 7th elsewhere */
+    for (size_t idx = 0; idx < elems; idx += 5) {
+        assert(0 == adts_timerwheel_cancel(p_tw, &(p_node[idx])));
+        assert(ENOENT == adts_timerwheel_cancel(p_tw, &(p_node[idx])));
+        cancel++;
+    }
+    for (size_t idx = 3; idx < elems; idx += 7) {
+        if (adts_timerwheel_is_armed(&(p_node[idx]))) {
+            adts_timerwheel_arm(p_tw, &(p_node[idx]), NULL, 1,
+                                p_node[idx].pub.expiry + 1000);
+            end = MAX(end, p_node[idx].pub.expiry);
+        }
+    }
+    assert((armed - cancel) == adts_timerwheel_entries(p_tw));
+
+    /* one periodic timer, every 2^16 ticks until cancelled */
+    adts_timerwheel_arm(p_tw, &(p_node[0]), (void *) (1 << 16), 1, start + 1000);
+
+    ctx.prev = start + 1;
+    while (ctx.prev <= end) {
+        uint64_t r    = utest_timerwheel_rand(&(seed));
+        uint64_t step = (r & 1) ? (r % 300) : (r % (1ULL << 28));
+
+        ctx.now = MIN(ctx.prev + step, end);
+        (void) adts_timerwheel_advance(p_tw, ctx.now);
+        assert(ctx.now == adts_timerwheel_now(p_tw));
+
+        /* everything due has fired, nothing early */
+        for (size_t idx = 1; idx < elems; idx += 97) {
+            if (adts_timerwheel_is_armed(&(p_node[idx]))) {
+                assert(p_node[idx].pub.expiry > ctx.now);
+            }
+        }
+        ctx.prev = ctx.now + 1;
+    }
+
+    assert(0 == adts_timerwheel_cancel(p_tw, &(p_node[0])));
+    assert(0 == adts_timerwheel_entries(p_tw));
+
+    for (size_t idx = 1; idx < elems; idx++) {
+        assert(((0 == (idx % 5)) ? 0 : 1) == ctx.p_fired[idx]);
+    }
+
+    adts_timerwheel_stats(p_tw, &(stats));
+    CDISPLAY("arms: %zu  cancels: %zu  fires: %zu  batches: %zu  cascades: %zu  rearmed: %zu",
+             stats.arms, stats.cancels, stats.fires, stats.batches,
+             stats.cascades, ctx.rearmed);
+    assert(stats.fires == ctx.fired);
+
+    adts_timerwheel_destroy(p_tw);
+    free(ctx.p_fired);
+    free(p_node);
+
+    return;
+} /* utest_timerwheel_expiry() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Connection timeout workload against adts_heap keyed by deadline.
+ *   Timers are armed with random deadlines within the window, half are
+ *   cancelled, e.g. the connection completed, and time then advances one
+ *   tick at a time across the window expiring the remainder.
+ *
+ ****************************************************************************
+ */
+#ifndef UTEST_TIMERWHEEL_ELEMS_MIN
+#define UTEST_TIMERWHEEL_ELEMS_MIN (1000000)
+#endif
+
+#ifndef UTEST_TIMERWHEEL_ELEMS_MAX
+#define UTEST_TIMERWHEEL_ELEMS_MAX (10000000)
+#endif
+
+#ifndef UTEST_TIMERWHEEL_WINDOW
+#define UTEST_TIMERWHEEL_WINDOW (1 << 20)
+#endif
+
+
+static void
+utest_timerwheel_fire_count( void                          *p_arg,
+                             adts_timerwheel_node_t *const *pp_nodes,
+                             size_t                         count )
+{
+    size_t *p_fired = p_arg;
+
+    (void) pp_nodes;
+    *p_fired += count;
+
+    return;
+} /* utest_timerwheel_fire_count() */
+
+
+static void
+utest_timerwheel_rate( void )
+{
+    for (size_t elems = UTEST_TIMERWHEEL_ELEMS_MIN;
+         elems <= UTEST_TIMERWHEEL_ELEMS_MAX;
+         elems *= 10) {
+        uint64_t *p_expiry = NULL;
+        uint64_t  seed     = 0x2545f4914f6cdd1dULL;
+        uint64_t  arm[2]   = {0};
+        uint64_t  cancel[2] = {0};
+        uint64_t  expire[2] = {0};
+        size_t    fired[2]  = {0};
+
+        p_expiry = calloc(elems, sizeof(*p_expiry));
+        assert(p_expiry);
+        for (size_t idx = 0; idx < elems; idx++) {
+            p_expiry[idx] = 1 + (utest_timerwheel_rand(&(seed)) % UTEST_TIMERWHEEL_WINDOW);
+        }
+
+        /* timing wheel */
+        {
+            adts_timerwheel_t        *p_tw   = NULL;
+            adts_timerwheel_node_t   *p_node = NULL;
+            adts_timerwheel_create_t  op     = {0};
+            uint64_t                  start  = 0;
+
+            /* prefault, page faults are not part of arm */
+            p_node = malloc(elems * sizeof(*p_node));
+            assert(p_node);
+            memset(p_node, 0, elems * sizeof(*p_node));
+
+            op.p_fire = utest_timerwheel_fire_count;
+            op.p_ctx  = &(fired[0]);
+            p_tw      = adts_timerwheel_create(&(op));
+            assert(p_tw);
+
+            start = adts_tstamp();
+            for (size_t idx = 0; idx < elems; idx++) {
+                adts_timerwheel_arm(p_tw, &(p_node[idx]), NULL, 1, p_expiry[idx]);
+            }
+            arm[0] = adts_tstamp() - start;
+
+            start = adts_tstamp();
+            for (size_t idx = 0; idx < elems; idx += 2) {
+                (void) adts_timerwheel_cancel(p_tw, &(p_node[idx]));
+            }
+            cancel[0] = adts_tstamp() - start;
+
+            start = adts_tstamp();
+            for (uint64_t now = 1; now <= UTEST_TIMERWHEEL_WINDOW; now++) {
+                (void) adts_timerwheel_advance(p_tw, now);
+            }
+            expire[0] = adts_tstamp() - start;
+
+            adts_timerwheel_destroy(p_tw);
+            free(p_node);
+        }
+
+        /* heap keyed by deadline */
+        {
+            adts_heap_t      *p_heap = NULL;
+            adts_heap_node_t *p_node = NULL;
+            uint64_t          start  = 0;
+
+            p_node = malloc(elems * sizeof(*p_node));
+            assert(p_node);
+            memset(p_node, 0, elems * sizeof(*p_node));
+
+            p_heap = adts_heap_create(ADTS_HEAP_MIN);
+            assert(p_heap);
+
+            start = adts_tstamp();
+            for (size_t idx = 0; idx < elems; idx++) {
+                (void) adts_heap_push(p_heap, &(p_node[idx]), p_expiry, 1,
+                                      (int64_t) p_expiry[idx]);
+            }
+            arm[1] = adts_tstamp() - start;
+
+            start = adts_tstamp();
+            for (size_t idx = 0; idx < elems; idx += 2) {
+                (void) adts_heap_remove(p_heap, &(p_node[idx]));
+            }
+            cancel[1] = adts_tstamp() - start;
+
+            start = adts_tstamp();
+            for (uint64_t now = 1; now <= UTEST_TIMERWHEEL_WINDOW; now++) {
+                adts_heap_node_t *p_top = adts_heap_peek(p_heap);
+
+                while (p_top && (p_expiry[p_top - p_node] <= now)) {
+                    (void) adts_heap_pop(p_heap);
+                    fired[1]++;
+                    p_top = adts_heap_peek(p_heap);
+                }
+            }
+            expire[1] = adts_tstamp() - start;
+
+            adts_heap_destroy(p_heap);
+            free(p_node);
+        }
+
+        assert(fired[0] == fired[1]);
+        for (size_t m = 0; m < 2; m++) {
+            CDISPLAY("elems: %9zu  %-10s arm: %7.2fns  cancel: %7.2fns  expire: %7.2fns  (per timer)",
+                     elems,
+                     m ? "heap" : "timerwheel",
+                     (double) arm[m]    / (double) elems,
+                     (double) cancel[m] / (double) (elems / 2),
+                     (double) expire[m] / (double) fired[m]);
+        }
+
+        free(p_expiry);
+    }
+
+    return;
+} /* utest_timerwheel_rate() */
+
+
+/*
+ ****************************************************************************
+ * test entrypoint
+ *
+ ****************************************************************************
+ */
+void
+utest_adts_timerwheel( void )
+{
+    utest_timerwheel_bytes();
+    utest_timerwheel_expiry();
+    utest_timerwheel_rate();
+
+    return;
+} /* utest_adts_timerwheel() */
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <adts_memory.h>
+
+
+/******************************************************************************
+ #####  ####### ######  #     #  #####  ####### #     # ######  #######  #####
+#     #    #    #     # #     # #     #    #    #     # #     # #       #     #
+#          #    #     # #     # #          #    #     # #     # #       #
+ #####     #    ######  #     # #          #    #     # ######  #####    #####
+      #    #    #   #   #     # #          #    #     # #   #   #             #
+#     #    #    #    #  #     # #     #    #    #     # #    #  #       #     #
+ #####     #    #     #  #####   #####     #     #####  #     # #######  #####
+******************************************************************************/
+
+/**
+ **************************************************************************
+ * \details
+ *   Hierarchical timing wheel of intrusive timers, 4 levels of 256 slots.
+ *   Time is in consumer defined ticks, e.g. milliseconds.  Arm and cancel
+ *   are O(1) and never allocate.  A timer further out than 2^32 ticks is
+ *   parked in the outermost level and re-placed as time advances.
+ *
+ *   adts_timerwheel_advance() moves time forward, cascading outer level
+ *   slots inward as their span comes due, and hands expired timers to
+ *   the consumer callback in batches.  Empty slots are skipped, thus a
+ *   large advance over a sparse wheel is cheap.
+ *
+ *   ADTS consumer is responsible for serialization.
+ *
+ **************************************************************************
+ */
+#define ADTS_TIMERWHEEL_BYTES      (256)
+#define ADTS_TIMERWHEEL_NODE_BYTES (64)
+
+typedef struct {
+    const char reserved[ ADTS_TIMERWHEEL_BYTES ];
+} adts_timerwheel_t;
+
+typedef struct {
+    void     *p_data;
+    size_t    bytes;
+    uint64_t  expiry; /**< tick at which the timer fires */
+} adts_timerwheel_node_public_t;
+
+typedef union {
+    const char                          reserved[ ADTS_TIMERWHEEL_NODE_BYTES ];
+    const adts_timerwheel_node_public_t pub; /**< read only */
+} adts_timerwheel_node_t;
+
+
+/**
+ **************************************************************************
+ * \details
+ *   Expiry callback, count expired timers, oldest expiry first.  The
+ *   timers are disarmed prior to the call, thus the callback may re-arm
+ *   them.  It may also arm or cancel any other timer, but must not
+ *   advance the wheel.
+ *
+ **************************************************************************
+ */
+typedef void (*adts_timerwheel_fire_t)( void                          *p_ctx,
+                                        adts_timerwheel_node_t *const *pp_nodes,
+                                        size_t                         count );
+
+
+/**
+ **************************************************************************
+ * \details
+ *   now is the initial time, batch the most timers per callback, 0
+ *   selects the default.
+ *
+ **************************************************************************
+ */
+typedef struct {
+    uint64_t                now;         /**< initial time in ticks */
+    size_t                  batch;       /**< timers per callback */
+    adts_timerwheel_fire_t  p_fire;      /**< expiry callback */
+    void                   *p_ctx;       /**< callback context */
+    const adts_allocator_t *p_allocator; /**< NULL selects the default */
+} adts_timerwheel_create_t;
+
+
+/**
+ **************************************************************************
+ * \details
+ *   Counters since create.
+ *
+ **************************************************************************
+ */
+typedef struct {
+    size_t arms;     /**< arm calls */
+    size_t cancels;  /**< timers cancelled while armed */
+    size_t fires;    /**< timers expired */
+    size_t batches;  /**< callbacks */
+    size_t cascades; /**< timers moved inward a level */
+} adts_timerwheel_stats_t;
+
+
+
+/******************************************************************************
+ #####   #####    ####    #####   ####    #####   #   #  #####   ######   ####
+ #    #  #    #  #    #     #    #    #     #      # #   #    #  #       #
+ #    #  #    #  #    #     #    #    #     #       #    #    #  #####    ####
+ #####   #####   #    #     #    #    #     #       #    #####   #            #
+ #       #   #   #    #     #    #    #     #       #    #       #       #    #
+ #       #    #   ####      #     ####      #       #    #       ######   ####
+*******************************************************************************/
+
+/**
+ **************************************************************************
+ * \brief
+ *   Timer services
+ *
+ * \details
+ *   - adts_timerwheel_arm()      fire at expiry, an expiry already passed
+ *                                fires on the next advance.  Re-arming an
+ *                                armed timer moves it.
+ *   - adts_timerwheel_cancel()   ENOENT when not armed
+ *   - adts_timerwheel_advance()  fire every timer with expiry <= now,
+ *                                returns the number fired
+ *
+ **************************************************************************
+ */
+void
+adts_timerwheel_arm( adts_timerwheel_t      *p_adts_timerwheel,
+                     adts_timerwheel_node_t *p_adts_node,
+                     void                   *p_data,
+                     size_t                  bytes,
+                     uint64_t                expiry );
+
+int32_t
+adts_timerwheel_cancel( adts_timerwheel_t      *p_adts_timerwheel,
+                        adts_timerwheel_node_t *p_adts_node );
+
+size_t
+adts_timerwheel_advance( adts_timerwheel_t *p_adts_timerwheel,
+                         uint64_t           now );
+
+bool
+adts_timerwheel_is_armed( adts_timerwheel_node_t *p_adts_node );
+
+uint64_t
+adts_timerwheel_now( adts_timerwheel_t *p_adts_timerwheel );
+
+size_t
+adts_timerwheel_entries( adts_timerwheel_t *p_adts_timerwheel );
+
+void
+adts_timerwheel_stats( adts_timerwheel_t       *p_adts_timerwheel,
+                       adts_timerwheel_stats_t *p_out );
+
+void
+adts_timerwheel_mem_usage( adts_timerwheel_t *p_adts_timerwheel,
+                           adts_mem_stats_t  *p_out );
+
+void
+adts_timerwheel_destroy( adts_timerwheel_t *p_adts_timerwheel );
+
+adts_timerwheel_t *
+adts_timerwheel_create( const adts_timerwheel_create_t *p_op );
+
+
+/**
+ **************************************************************************
+ * \details
+ *   Unit Test prototypes
+ *
+ **************************************************************************
+ */
+void
+utest_adts_timerwheel( void );
@@ -0,0 +1,1160 @@
+#include <errno.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <adts_heap.h>
+#include <adts_time.h>
+#include <adts_topk.h>
+#include <adts_memory.h>
+#include <adts_sanity.h>
+#include <adts_private.h>
+#include <adts_display.h>
+
+
+/******************************************************************************
+ #####  ####### ######  #     #  #####  ####### #     # ######  #######  #####
+#     #    #    #     # #     # #     #    #    #     # #     # #       #     #
+#          #    #     # #     # #          #    #     # #     # #       #
+ #####     #    ######  #     # #          #    #     # ######  #####    #####
+      #    #    #   #   #     # #          #    #     # #   #   #             #
+#     #    #    #    #  #     # #     #    #    #     # #    #  #       #     #
+ #####     #    #     #  #####   #####     #     #####  #     # #######  #####
+******************************************************************************/
+
+/*
+ ****************************************************************************
+ * \details
+ *   Keys are held as unsigned ordering keys, ord = key ^ key_mask, such
+ *   that a better key has a greater ord for either type, as adts_heap
+ *   does.  The heap is a 4-ary min heap of ord, its root the worst
+ *   retained entry.
+ *
+ ****************************************************************************
+ */
+#define TOPK_SIGN_BIT    (1ULL << 63)
+#define TOPK_ARITY_SHIFT (2)
+#define TOPK_ARITY       (1 << TOPK_ARITY_SHIFT)
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Batch screening block, keys compared per vector test.
+ *
+ ****************************************************************************
+ */
+#define TOPK_BLOCK (8)
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Least keys per thread for a batch to be split, and the thread limit.
+ *
+ ****************************************************************************
+ */
+#define TOPK_THREAD_ELEMS_MIN (1 << 16)
+#define TOPK_THREADS_MAX      (64)
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+typedef struct {
+    uint64_t  ord;
+    void     *p_data;
+} topk_entry_t;
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   An offer is retained when ord >= accept.  accept is floor until k
+ *   entries are held, then one past the root.  floor is raised for a
+ *   private instance of a parallel batch, an entry which could not enter
+ *   the target is not worth holding.
+ *
+ ****************************************************************************
+ */
+typedef struct {
+    uint64_t           accept;
+    uint64_t           floor;
+    uint64_t           key_mask;
+    size_t             k;
+    size_t             elems;
+    topk_entry_t      *p_heap;
+    adts_heap_type_t   type;
+    adts_topk_stats_t  stats;
+    adts_sanity_t      sanity;
+    adts_mem_t         mem;
+} topk_t;
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+typedef int64_t topk_vec_t __attribute__((vector_size(32)));
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Parallel batch worker context.
+ *
+ ****************************************************************************
+ */
+typedef struct {
+    topk_t        *p_tk;
+    const int64_t *p_keys;
+    void *const   *pp_data;
+    size_t         elems;
+} topk_worker_t;
+
+
+
+/******************************************************************************
+ * ####### #     # #     #  #####  #######   ###   ####### #     #  #####
+ * #       #     # ##    # #     #    #       #    #     # ##    # #     #
+ * #       #     # # #   # #          #       #    #     # # #   # #
+ * #####   #     # #  #  # #          #       #    #     # #  #  #  #####
+ * #       #     # #   # # #          #       #    #     # #   # #       #
+ * #       #     # #    ## #     #    #       #    #     # #    ## #     #
+ * #        #####  #     #  #####     #      ###   ####### #     #  #####
+******************************************************************************/
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+static inline void
+topk_accept_update( topk_t *p_tk )
+{
+    uint64_t root = p_tk->p_heap[0].ord;
+
+    if (p_tk->elems == p_tk->k) {
+        p_tk->accept = MAX(p_tk->floor, root + (UINT64_MAX != root));
+    }
+
+    return;
+} /* topk_accept_update() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Insert below k, else replace the root.  Both move a hole rather than
+ *   swap.
+ *
+ ****************************************************************************
+ */
+static inline void
+topk_insert( topk_t   *p_tk,
+             uint64_t  ord,
+             void     *p_data )
+{
+    topk_entry_t *p_heap = p_tk->p_heap;
+    size_t        idx    = 0;
+
+    if (p_tk->elems < p_tk->k) {
+        idx = p_tk->elems++;
+        while (idx) {
+            size_t parent = (idx - 1) >> TOPK_ARITY_SHIFT;
+
+            if (p_heap[parent].ord <= ord) {
+                break;
+            }
+            p_heap[idx] = p_heap[parent];
+            idx         = parent;
+        }
+    }else {
+        for (;;) {
+            size_t child = (idx << TOPK_ARITY_SHIFT) + 1;
+            size_t last  = MIN(child + TOPK_ARITY, p_tk->elems);
+            size_t least = child;
+
+            if (child >= p_tk->elems) {
+                break;
+            }
+
+            for (size_t c = child + 1; c < last; c++) {
+                least = (p_heap[c].ord < p_heap[least].ord) ? c : least;
+            }
+
+            if (ord <= p_heap[least].ord) {
+                break;
+            }
+            p_heap[idx] = p_heap[least];
+            idx         = least;
+        }
+    }
+
+    p_heap[idx].ord    = ord;
+    p_heap[idx].p_data = p_data;
+    topk_accept_update(p_tk);
+    p_tk->stats.retained++;
+
+    return;
+} /* topk_insert() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   The reject test, one compare against the threshold.
+ *
+ ****************************************************************************
+ */
+static inline bool
+topk_offer( topk_t   *p_tk,
+            uint64_t  ord,
+            void     *p_data )
+{
+    if (likely(ord < p_tk->accept)) {
+        return false;
+    }
+
+    topk_insert(p_tk, ord, p_data);
+
+    return true;
+} /* topk_offer() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Screen blocks of TOPK_BLOCK keys against the threshold in the key
+ *   domain, ord >= accept being key >= bound for MAX and key <= bound for
+ *   MIN.  Only a block with a candidate is offered key by key.
+ *
+ ****************************************************************************
+ */
+static inline __attribute__((always_inline)) size_t
+topk_batch_body( topk_t        *p_tk,
+                 const int64_t *p_keys,
+                 void *const   *pp_data,
+                 size_t         elems )
+{
+    size_t retained = 0;
+    size_t idx      = 0;
+    bool   max      = (ADTS_HEAP_MAX == p_tk->type);
+
+    for (; (idx + TOPK_BLOCK) <= elems; idx += TOPK_BLOCK) {
+        int64_t    bound = (int64_t) (p_tk->accept ^ p_tk->key_mask);
+        topk_vec_t vb    = {bound, bound, bound, bound};
+        topk_vec_t lo;
+        topk_vec_t hi;
+        topk_vec_t pass;
+
+        memcpy(&(lo), &(p_keys[idx]), sizeof(lo));
+        memcpy(&(hi), &(p_keys[idx + 4]), sizeof(hi));
+
+        if (max) {
+            pass = (lo >= vb) | (hi >= vb);
+        }else {
+            pass = (lo <= vb) | (hi <= vb);
+        }
+
+        if (likely(0 == (pass[0] | pass[1] | pass[2] | pass[3]))) {
+            continue;
+        }
+
+        for (size_t blk = idx; blk < (idx + TOPK_BLOCK); blk++) {
+            void *p_data = pp_data ? pp_data[blk] : (void *) (uintptr_t) &(p_keys[blk]);
+
+            retained += topk_offer(p_tk, (uint64_t) p_keys[blk] ^ p_tk->key_mask, p_data);
+        }
+    }
+
+    for (; idx < elems; idx++) {
+        void *p_data = pp_data ? pp_data[idx] : (void *) (uintptr_t) &(p_keys[idx]);
+
+        retained += topk_offer(p_tk, (uint64_t) p_keys[idx] ^ p_tk->key_mask, p_data);
+    }
+
+    p_tk->stats.offered += elems;
+
+    return retained;
+} /* topk_batch_body() */
+
+
+#if defined(__x86_64__)
+__attribute__((target("avx2")))
+static size_t
+topk_batch_avx2( topk_t        *p_tk,
+                 const int64_t *p_keys,
+                 void *const   *pp_data,
+                 size_t         elems )
+{
+    return topk_batch_body(p_tk, p_keys, pp_data, elems);
+} /* topk_batch_avx2() */
+#endif
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   The build carries no -march, thus the AVX2 clone is selected at run
+ *   time.
+ *
+ ****************************************************************************
+ */
+static size_t
+topk_batch( topk_t        *p_tk,
+            const int64_t *p_keys,
+            void *const   *pp_data,
+            size_t         elems )
+{
+#if defined(__x86_64__)
+    if (__builtin_cpu_supports("avx2")) {
+        return topk_batch_avx2(p_tk, p_keys, pp_data, elems);
+    }
+#endif
+
+    return topk_batch_body(p_tk, p_keys, pp_data, elems);
+} /* topk_batch() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+static void *
+topk_batch_worker( void *p_arg )
+{
+    topk_worker_t *p_worker = p_arg;
+
+    (void) topk_batch(p_worker->p_tk, p_worker->p_keys,
+                      p_worker->pp_data, p_worker->elems);
+
+    return NULL;
+} /* topk_batch_worker() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+static void
+topk_merge( topk_t       *p_tk,
+            const topk_t *p_src )
+{
+    for (size_t idx = 0; idx < p_src->elems; idx++) {
+        (void) topk_offer(p_tk, p_src->p_heap[idx].ord, p_src->p_heap[idx].p_data);
+    }
+
+    return;
+} /* topk_merge() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+bool
+adts_topk_push( adts_topk_t *p_adts_topk,
+                int64_t      key,
+                void        *p_data )
+{
+    bool    retained = false;
+    topk_t *p_tk     = (topk_t *) p_adts_topk;
+
+    adts_sanity_entry(&(p_tk->sanity));
+
+    retained = topk_offer(p_tk, (uint64_t) key ^ p_tk->key_mask, p_data);
+    p_tk->stats.offered++;
+
+    adts_sanity_exit(&(p_tk->sanity));
+
+    return retained;
+} /* adts_topk_push() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+size_t
+adts_topk_push_batch( adts_topk_t   *p_adts_topk,
+                      const int64_t *p_keys,
+                      void *const   *pp_data,
+                      size_t         elems )
+{
+    size_t  retained = 0;
+    topk_t *p_tk     = (topk_t *) p_adts_topk;
+
+    adts_sanity_entry(&(p_tk->sanity));
+
+    retained = topk_batch(p_tk, p_keys, pp_data, elems);
+
+    adts_sanity_exit(&(p_tk->sanity));
+
+    return retained;
+} /* adts_topk_push_batch() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   The calling thread selects the first slice directly into the
+ *   instance, every other slice into a private instance whose floor is
+ *   the instance's threshold at the start.  A slice whose thread fails to
+ *   start is selected by the calling thread.
+ *
+ ****************************************************************************
+ */
+int32_t
+adts_topk_push_batch_ext( adts_topk_t             *p_adts_topk,
+                          const adts_topk_batch_t *p_op )
+{
+    int32_t             rc      = 0;
+    size_t              slice   = 0;
+    uint32_t            threads = 1;
+    topk_t             *p_tk    = (topk_t *) p_adts_topk;
+    adts_topk_create_t  cop     = {0};
+    adts_topk_t        *p_priv[ TOPK_THREADS_MAX ] = {0};
+    pthread_t           tids[ TOPK_THREADS_MAX ];
+    bool                started[ TOPK_THREADS_MAX ] = {0};
+    topk_worker_t       worker[ TOPK_THREADS_MAX ];
+
+    adts_sanity_entry(&(p_tk->sanity));
+
+    assert(p_op);
+
+    if (p_op->threads > 1) {
+        threads = MIN(p_op->threads, TOPK_THREADS_MAX);
+        threads = (uint32_t) MIN(threads, MAX(1, p_op->elems / TOPK_THREAD_ELEMS_MIN));
+    }
+
+    if (1 == threads) {
+        (void) topk_batch(p_tk, p_op->p_keys, p_op->pp_data, p_op->elems);
+        goto exception;
+    }
+
+    cop.type        = p_tk->type;
+    cop.k           = p_tk->k;
+    cop.p_allocator = p_tk->mem.p_allocator;
+    for (uint32_t idx = 1; idx < threads; idx++) {
+        p_priv[idx] = adts_topk_create(&(cop));
+        if (NULL == p_priv[idx]) {
+            rc = ENOMEM;
+            goto exception;
+        }
+        ((topk_t *) p_priv[idx])->floor  = p_tk->accept;
+        ((topk_t *) p_priv[idx])->accept = p_tk->accept;
+    }
+
+    slice = p_op->elems / threads;
+    for (uint32_t idx = 0; idx < threads; idx++) {
+        size_t first = idx * slice;
+
+        worker[idx].p_tk    = idx ? (topk_t *) p_priv[idx] : p_tk;
+        worker[idx].p_keys  = &(p_op->p_keys[first]);
+        worker[idx].pp_data = p_op->pp_data ? &(p_op->pp_data[first]) : NULL;
+        worker[idx].elems   = ((threads - 1) == idx) ? (p_op->elems - first) : slice;
+    }
+
+    for (uint32_t idx = 1; idx < threads; idx++) {
+        started[idx] = (0 == pthread_create(&(tids[idx]), NULL,
+                                            topk_batch_worker, &(worker[idx])));
+    }
+
+    (void) topk_batch_worker(&(worker[0]));
+    for (uint32_t idx = 1; idx < threads; idx++) {
+        if (started[idx]) {
+            (void) pthread_join(tids[idx], NULL);
+        }else {
+            (void) topk_batch_worker(&(worker[idx]));
+        }
+    }
+
+    /* Keys offered to a private instance count as offered here */
+    for (uint32_t idx = 1; idx < threads; idx++) {
+        topk_merge(p_tk, (topk_t *) p_priv[idx]);
+        p_tk->stats.offered += worker[idx].elems;
+    }
+
+exception:
+    for (uint32_t idx = 1; idx < threads; idx++) {
+        if (p_priv[idx]) {
+            adts_topk_destroy(p_priv[idx]);
+        }
+    }
+
+    adts_sanity_exit(&(p_tk->sanity));
+    return rc;
+} /* adts_topk_push_batch_ext() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+int32_t
+adts_topk_merge( adts_topk_t *p_adts_topk,
+                 adts_topk_t *p_adts_topk_src )
+{
+    int32_t  rc    = 0;
+    topk_t  *p_tk  = (topk_t *) p_adts_topk;
+    topk_t  *p_src = (topk_t *) p_adts_topk_src;
+
+    adts_sanity_entry(&(p_tk->sanity));
+
+    if (p_tk->type != p_src->type) {
+        rc = EINVAL;
+        goto exception;
+    }
+
+    topk_merge(p_tk, p_src);
+    p_tk->stats.offered += p_src->elems;
+
+exception:
+    adts_sanity_exit(&(p_tk->sanity));
+    return rc;
+} /* adts_topk_merge() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+bool
+adts_topk_threshold( adts_topk_t *p_adts_topk,
+                     int64_t     *p_key )
+{
+    topk_t *p_tk = (topk_t *) p_adts_topk;
+
+    if (p_tk->elems < p_tk->k) {
+        return false;
+    }
+
+    *p_key = (int64_t) (p_tk->p_heap[0].ord ^ p_tk->key_mask);
+
+    return true;
+} /* adts_topk_threshold() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Heap sort in place, the worst entry moving to the tail each round,
+ *   leaving the array best first.  Reversed, the ascending array is again
+ *   a valid min heap, thus no scratch memory is required.
+ *
+ ****************************************************************************
+ */
+size_t
+adts_topk_results( adts_topk_t       *p_adts_topk,
+                   adts_topk_entry_t *p_out,
+                   size_t             elems )
+{
+    topk_t       *p_tk   = (topk_t *) p_adts_topk;
+    topk_entry_t *p_heap = p_tk->p_heap;
+    size_t        held   = p_tk->elems;
+    size_t        count  = MIN(elems, held);
+
+    adts_sanity_entry(&(p_tk->sanity));
+
+    for (size_t tail = held; tail > 1; tail--) {
+        topk_entry_t worst = p_heap[0];
+        topk_entry_t move  = p_heap[tail - 1];
+        size_t       idx   = 0;
+
+        for (;;) {
+            size_t child = (idx << TOPK_ARITY_SHIFT) + 1;
+            size_t last  = MIN(child + TOPK_ARITY, tail - 1);
+            size_t least = child;
+
+            if (child >= (tail - 1)) {
+                break;
+            }
+
+            for (size_t c = child + 1; c < last; c++) {
+                least = (p_heap[c].ord < p_heap[least].ord) ? c : least;
+            }
+
+            if (move.ord <= p_heap[least].ord) {
+                break;
+            }
+            p_heap[idx] = p_heap[least];
+            idx         = least;
+        }
+        p_heap[idx]      = move;
+        p_heap[tail - 1] = worst;
+    }
+
+    for (size_t idx = 0; idx < count; idx++) {
+        p_out[idx].key    = (int64_t) (p_heap[idx].ord ^ p_tk->key_mask);
+        p_out[idx].p_data = p_heap[idx].p_data;
+    }
+
+    for (size_t lo = 0, hi = held ? (held - 1) : 0; lo < hi; lo++, hi--) {
+        topk_entry_t swap = p_heap[lo];
+
+        p_heap[lo] = p_heap[hi];
+        p_heap[hi] = swap;
+    }
+
+    adts_sanity_exit(&(p_tk->sanity));
+
+    return count;
+} /* adts_topk_results() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+size_t
+adts_topk_entries( adts_topk_t *p_adts_topk )
+{
+    topk_t *p_tk = (topk_t *) p_adts_topk;
+
+    return p_tk->elems;
+} /* adts_topk_entries() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+size_t
+adts_topk_k( adts_topk_t *p_adts_topk )
+{
+    topk_t *p_tk = (topk_t *) p_adts_topk;
+
+    return p_tk->k;
+} /* adts_topk_k() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_topk_reset( adts_topk_t *p_adts_topk )
+{
+    topk_t *p_tk = (topk_t *) p_adts_topk;
+
+    adts_sanity_entry(&(p_tk->sanity));
+
+    p_tk->elems  = 0;
+    p_tk->floor  = 0;
+    p_tk->accept = 0;
+    memset(&(p_tk->stats), 0, sizeof(p_tk->stats));
+
+    adts_sanity_exit(&(p_tk->sanity));
+
+    return;
+} /* adts_topk_reset() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_topk_stats( adts_topk_t       *p_adts_topk,
+                 adts_topk_stats_t *p_out )
+{
+    topk_t *p_tk = (topk_t *) p_adts_topk;
+
+    *p_out = p_tk->stats;
+
+    return;
+} /* adts_topk_stats() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_topk_mem_usage( adts_topk_t      *p_adts_topk,
+                     adts_mem_stats_t *p_out )
+{
+    topk_t *p_tk = (topk_t *) p_adts_topk;
+
+    adts_mem_usage(&(p_tk->mem), p_out);
+
+    return;
+} /* adts_topk_mem_usage() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_topk_destroy( adts_topk_t *p_adts_topk )
+{
+    topk_t     *p_tk = (topk_t *) p_adts_topk;
+    adts_mem_t  mem  = p_tk->mem;
+
+    adts_sanity_entry(&(p_tk->sanity));
+
+    adts_mem_put(&(mem), p_tk->p_heap, p_tk->k * sizeof(*(p_tk->p_heap)));
+    adts_mem_put(&(mem), p_adts_topk, sizeof(*p_adts_topk));
+
+    /* No adts_sanity_exit() since we've freed the memory */
+
+    return;
+} /* adts_topk_destroy() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+adts_topk_t *
+adts_topk_create( const adts_topk_create_t *p_op )
+{
+    int32_t      rc          = 0;
+    topk_t      *p_tk        = NULL;
+    adts_mem_t   mem         = {0};
+    adts_topk_t *p_adts_topk = NULL;
+
+    assert(p_op);
+
+    if ((0 == p_op->k) ||
+        ((ADTS_HEAP_MIN != p_op->type) && (ADTS_HEAP_MAX != p_op->type))) {
+        rc = EINVAL;
+        goto exception;
+    }
+
+    adts_mem_init_ext(&(mem), ADTS_MEM_TYPE_TOPK, p_op->p_allocator);
+
+    p_adts_topk = adts_mem_get(&(mem), sizeof(*p_adts_topk));
+    if (NULL == p_adts_topk) {
+        rc = ENOMEM;
+        goto exception;
+    }
+    p_tk = (topk_t *) p_adts_topk;
+
+    p_tk->p_heap = adts_mem_alloc(&(mem), p_op->k * sizeof(*(p_tk->p_heap)));
+    if (NULL == p_tk->p_heap) {
+        rc = ENOMEM;
+        goto exception;
+    }
+
+    p_tk->k        = p_op->k;
+    p_tk->type     = p_op->type;
+    p_tk->key_mask = (ADTS_HEAP_MAX == p_op->type) ? TOPK_SIGN_BIT : ~TOPK_SIGN_BIT;
+    p_tk->mem      = mem;
+
+exception:
+    if (rc && p_adts_topk) {
+        adts_mem_put(&(mem), p_adts_topk, sizeof(*p_adts_topk));
+        p_adts_topk = NULL;
+    }
+
+    return p_adts_topk;
+} /* adts_topk_create() */
+
+
+
+/******************************************************************************
+ * #     # #     #   ###   ####### ####### #######  #####  #######  #####
+ * #     # ##    #    #       #       #    #       #     #    #    #     #
+ * #     # # #   #    #       #       #    #       #          #    #
+ * #     # #  #  #    #       #       #    #####    #####     #     #####
+ * #     # #   # #    #       #       #    #             #    #          #
+ * #     # #    ##    #       #       #    #       #     #    #    #     #
+ *  #####  #     #   ###      #       #    #######  #####     #     #####
+******************************************************************************/
+
+/**
+ **************************************************************************
+ * \brief
+ *   Compile time structure sanity
+ *
+ * \details
+ *   Sanitize the abstract data type interface.  Enforced in header file so
+ *   as to catch improper usage/include by unauthorized callers.
+ *
+ **************************************************************************
+ */
+static void
+utest_topk_bytes( void )
+{
+    CDISPLAY("[%u]", sizeof(topk_t));
+    CDISPLAY("[%u]", sizeof(adts_topk_t));
+
+    _Static_assert(sizeof(topk_t) <= sizeof(adts_topk_t),
+        "Mismatch structs detected");
+
+    return;
+} /* utest_topk_bytes() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Small PRNG for key generation, xorshift64.
+ *
+ ****************************************************************************
+ */
+static inline uint64_t
+utest_topk_rand( uint64_t *p_state )
+{
+    uint64_t x = *p_state;
+
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *p_state = x;
+
+    return x;
+} /* utest_topk_rand() */
+
+
+static int
+utest_topk_cmp_desc( const void *p_a,
+                     const void *p_b )
+{
+    int64_t a = *(const int64_t *) p_a;
+    int64_t b = *(const int64_t *) p_b;
+
+    return (a < b) - (a > b);
+} /* utest_topk_cmp_desc() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   The k best of p_keys, by sorting a copy, against the results of
+ *   p_topk, best first.  Data must be the address of the key.
+ *
+ ****************************************************************************
+ */
+static void
+utest_topk_verify( adts_topk_t      *p_topk,
+                   adts_heap_type_t  type,
+                   const int64_t    *p_keys,
+                   int64_t          *p_sorted,
+                   size_t            elems )
+{
+    size_t             k     = adts_topk_k(p_topk);
+    size_t             count = MIN(k, elems);
+    adts_topk_entry_t *p_out = NULL;
+
+    p_out = calloc(k, sizeof(*p_out));
+    assert(p_out);
+
+    memcpy(p_sorted, p_keys, elems * sizeof(*p_sorted));
+    qsort(p_sorted, elems, sizeof(*p_sorted), utest_topk_cmp_desc);
+    if (ADTS_HEAP_MIN == type) {
+        for (size_t idx = 0; idx < (elems / 2); idx++) {
+            int64_t swap = p_sorted[idx];
+
+            p_sorted[idx]             = p_sorted[elems - 1 - idx];
+            p_sorted[elems - 1 - idx] = swap;
+        }
+    }
+
+    assert(count == adts_topk_entries(p_topk));
+    assert(count == adts_topk_results(p_topk, p_out, k));
+    for (size_t idx = 0; idx < count; idx++) {
+        assert(p_out[idx].key == p_sorted[idx]);
+        assert(*(const int64_t *) p_out[idx].p_data == p_out[idx].key);
+    }
+
+    /* results leave the instance intact, and a short read is the best */
+    assert(1 == adts_topk_results(p_topk, p_out, 1));
+    assert(p_out[0].key == p_sorted[0]);
+    assert(count == adts_topk_results(p_topk, p_out, k));
+    assert(p_out[count - 1].key == p_sorted[count - 1]);
+
+    free(p_out);
+
+    return;
+} /* utest_topk_verify() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Every offer mode against a sorted reference, both types, a k below,
+ *   at and above the stream length, distinct and heavily duplicated keys,
+ *   ascending streams for which every key is retained.
+ *
+ ****************************************************************************
+ */
+static void
+utest_topk_select( void )
+{
+    size_t              elems    = 200000;
+    uint64_t            seed     = 0x9e3779b97f4a7c15ULL;
+    int64_t            *p_keys   = NULL;
+    int64_t            *p_sorted = NULL;
+    adts_heap_type_t    types[]  = {ADTS_HEAP_MAX, ADTS_HEAP_MIN};
+    size_t              ks[]     = {1, 7, 100, 4096};
+    adts_topk_create_t  op       = {0};
+    adts_topk_batch_t   bop      = {0};
+    adts_topk_stats_t   stats    = {0};
+
+    p_keys   = malloc(elems * sizeof(*p_keys));
+    p_sorted = malloc(elems * sizeof(*p_sorted));
+    assert(p_keys && p_sorted);
+
+    op.type = ADTS_HEAP_MAX;
+    op.k    = 0;
+    assert(NULL == adts_topk_create(&(op)));
+    op.type = 0;
+    op.k    = 1;
+    assert(NULL == adts_topk_create(&(op)));
+
+    for (uint32_t dist = 0; dist < 3; dist++) {
+        for (size_t idx = 0; idx < elems; idx++) {
+            uint64_t r = utest_topk_rand(&(seed));
+
+            if (0 == dist) {
+                p_keys[idx] = (int64_t) r;
+            }else if (1 == dist) {
+                p_keys[idx] = (int64_t) (r % 64) - 32;
+            }else {
+                p_keys[idx] = (int64_t) idx - (int64_t) (elems / 2);
+            }
+        }
+        p_keys[elems / 3] = INT64_MIN;
+        p_keys[elems / 5] = INT64_MAX;
+
+        for (size_t t = 0; t < (sizeof(types) / sizeof(types[0])); t++) {
+            for (size_t kidx = 0; kidx < (sizeof(ks) / sizeof(ks[0])); kidx++) {
+                for (uint32_t mode = 0; mode < 4; mode++) {
+                    adts_topk_t *p_topk = NULL;
+                    int64_t      thresh = 0;
+                    size_t       len    = (3 == mode) ? (ks[kidx] / 2) : elems;
+
+                    op.type = types[t];
+                    op.k    = ks[kidx];
+                    p_topk  = adts_topk_create(&(op));
+                    assert(p_topk);
+                    assert(false == adts_topk_threshold(p_topk, &(thresh)));
+
+                    bop.p_keys  = p_keys;
+                    bop.pp_data = NULL;
+                    bop.elems   = len;
+                    bop.threads = 3;
+
+                    if ((0 == mode) || (3 == mode)) {
+                        for (size_t idx = 0; idx < len; idx++) {
+                            (void) adts_topk_push(p_topk, p_keys[idx], &(p_keys[idx]));
+                        }
+                    }else if (1 == mode) {
+                        (void) adts_topk_push_batch(p_topk, p_keys, NULL, len);
+                    }else {
+                        assert(0 == adts_topk_push_batch_ext(p_topk, &(bop)));
+                    }
+
+                    adts_topk_stats(p_topk, &(stats));
+                    assert(len == stats.offered);
+                    if (len) {
+                        utest_topk_verify(p_topk, types[t], p_keys, p_sorted, len);
+                    }
+
+                    if (len >= ks[kidx]) {
+                        assert(adts_topk_threshold(p_topk, &(thresh)));
+                        assert(thresh == p_sorted[ks[kidx] - 1]);
+                    }
+
+                    adts_topk_reset(p_topk);
+                    assert(0 == adts_topk_entries(p_topk));
+                    assert(false == adts_topk_threshold(p_topk, &(thresh)));
+                    adts_topk_destroy(p_topk);
+                }
+            }
+        }
+    }
+
+    /* merge, halves selected apart */
+    {
+        adts_topk_t *p_a = NULL;
+        adts_topk_t *p_b = NULL;
+        adts_topk_t *p_c = NULL;
+
+        op.type = ADTS_HEAP_MAX;
+        op.k    = 100;
+        p_a     = adts_topk_create(&(op));
+        p_b     = adts_topk_create(&(op));
+        op.type = ADTS_HEAP_MIN;
+        p_c     = adts_topk_create(&(op));
+        assert(p_a && p_b && p_c);
+
+        (void) adts_topk_push_batch(p_a, p_keys, NULL, elems / 2);
+        (void) adts_topk_push_batch(p_b, &(p_keys[elems / 2]), NULL, elems - (elems / 2));
+        assert(EINVAL == adts_topk_merge(p_a, p_c));
+        assert(0 == adts_topk_merge(p_a, p_b));
+        utest_topk_verify(p_a, ADTS_HEAP_MAX, p_keys, p_sorted, elems);
+
+        adts_topk_destroy(p_c);
+        adts_topk_destroy(p_b);
+        adts_topk_destroy(p_a);
+    }
+
+    free(p_sorted);
+    free(p_keys);
+
+    return;
+} /* utest_topk_select() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Top UTEST_TOPK_K of UTEST_TOPK_ELEMS random keys.  The adts_heap
+ *   approach, push every key into an ADTS_HEAP_MAX heap then pop k, runs
+ *   over the first UTEST_TOPK_HEAP_ELEMS keys only, its memory being
+ *   O(n).  Reports ns per key and peak bytes.
+ *
+ ****************************************************************************
+ */
+#ifndef UTEST_TOPK_ELEMS
+#define UTEST_TOPK_ELEMS (1 << 26)
+#endif
+
+#ifndef UTEST_TOPK_HEAP_ELEMS
+#define UTEST_TOPK_HEAP_ELEMS (1 << 23)
+#endif
+
+#ifndef UTEST_TOPK_K
+#define UTEST_TOPK_K (100)
+#endif
+
+#ifndef UTEST_TOPK_THREADS
+#define UTEST_TOPK_THREADS (4)
+#endif
+
+static void
+utest_topk_rate( void )
+{
+    uint64_t            seed   = 0x2545f4914f6cdd1dULL;
+    int64_t            *p_keys = NULL;
+    adts_heap_node_t   *p_node = NULL;
+    adts_topk_create_t  op     = {0};
+    adts_topk_entry_t   best[ UTEST_TOPK_K ];
+    int64_t             heap_best[ UTEST_TOPK_K ];
+
+    p_keys = malloc(UTEST_TOPK_ELEMS * sizeof(*p_keys));
+    p_node = calloc(UTEST_TOPK_HEAP_ELEMS, sizeof(*p_node));
+    assert(p_keys && p_node);
+
+    for (size_t idx = 0; idx < UTEST_TOPK_ELEMS; idx++) {
+        p_keys[idx] = (int64_t) utest_topk_rand(&(seed));
+    }
+
+    /* baseline */
+    {
+        adts_heap_t      *p_heap = NULL;
+        adts_mem_stats_t  mem    = {0};
+        uint64_t          start  = 0;
+
+        p_heap = adts_heap_create(ADTS_HEAP_MAX);
+        assert(p_heap);
+
+        start = adts_tstamp();
+        for (size_t idx = 0; idx < UTEST_TOPK_HEAP_ELEMS; idx++) {
+            (void) adts_heap_push(p_heap, &(p_node[idx]), &(p_keys[idx]), 1, p_keys[idx]);
+        }
+        for (size_t idx = 0; idx < UTEST_TOPK_K; idx++) {
+            heap_best[idx] = adts_heap_pop(p_heap)->pub.key;
+        }
+        start = adts_tstamp() - start;
+        adts_heap_mem_usage(p_heap, &(mem));
+
+        CDISPLAY("%-14s threads: %2u  elems: %10zu  per key: %6.2fns  peak: %12zu bytes",
+                 "heap push/pop", 1, (size_t) UTEST_TOPK_HEAP_ELEMS,
+                 (double) start / (double) UTEST_TOPK_HEAP_ELEMS,
+                 mem.bytes_peak + (UTEST_TOPK_HEAP_ELEMS * sizeof(*p_node)));
+
+        adts_heap_destroy(p_heap);
+    }
+
+    for (uint32_t mode = 0; mode < 3; mode++) {
+        for (uint32_t threads = 1; threads <= ((2 == mode) ? UTEST_TOPK_THREADS : 1); threads *= 2) {
+            adts_topk_t       *p_topk = NULL;
+            adts_topk_batch_t  bop    = {0};
+            adts_mem_stats_t   mem    = {0};
+            uint64_t           start  = 0;
+            const char        *p_name = (0 == mode) ? "topk push" :
+                                        (1 == mode) ? "topk batch" : "topk batch_ext";
+
+            op.type = ADTS_HEAP_MAX;
+            op.k    = UTEST_TOPK_K;
+            p_topk  = adts_topk_create(&(op));
+            assert(p_topk);
+
+            bop.p_keys  = p_keys;
+            bop.elems   = UTEST_TOPK_ELEMS;
+            bop.threads = threads;
+
+            start = adts_tstamp();
+            if (0 == mode) {
+                for (size_t idx = 0; idx < UTEST_TOPK_ELEMS; idx++) {
+                    (void) adts_topk_push(p_topk, p_keys[idx], &(p_keys[idx]));
+                }
+            }else if (1 == mode) {
+                (void) adts_topk_push_batch(p_topk, p_keys, NULL, UTEST_TOPK_ELEMS);
+            }else {
+                assert(0 == adts_topk_push_batch_ext(p_topk, &(bop)));
+            }
+            assert(UTEST_TOPK_K == adts_topk_results(p_topk, best, UTEST_TOPK_K));
+            start = adts_tstamp() - start;
+            adts_topk_mem_usage(p_topk, &(mem));
+
+            CDISPLAY("%-14s threads: %2u  elems: %10zu  per key: %6.2fns  peak: %12zu bytes",
+                     p_name, threads, (size_t) UTEST_TOPK_ELEMS,
+                     (double) start / (double) UTEST_TOPK_ELEMS,
+                     mem.bytes_peak);
+
+            /* the whole stream's best can be no worse than its prefix's */
+            for (size_t idx = 0; idx < UTEST_TOPK_K; idx++) {
+                assert(best[idx].key >= heap_best[idx]);
+            }
+
+            adts_topk_destroy(p_topk);
+        }
+    }
+
+    free(p_node);
+    free(p_keys);
+
+    return;
+} /* utest_topk_rate() */
+
+
+/*
+ ****************************************************************************
+ * test entrypoint
+ *
+ ****************************************************************************
+ */
+void
+utest_adts_topk( void )
+{
+    utest_topk_bytes();
+    utest_topk_select();
+    utest_topk_rate();
+
+    return;
+} /* utest_adts_topk() */
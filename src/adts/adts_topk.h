@@ -0,0 +1,186 @@
+#pragma once
+
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <adts_heap.h>
+#include <adts_memory.h>
+
+
+/******************************************************************************
+ #####  ####### ######  #     #  #####  ####### #     # ######  #######  #####
+#     #    #    #     # #     # #     #    #    #     # #     # #       #     #
+#          #    #     # #     # #          #    #     # #     # #       #
+ #####     #    ######  #     # #          #    #     # ######  #####    #####
+      #    #    #   #   #     # #          #    #     # #   #   #             #
+#     #    #    #    #  #     # #     #    #    #     # #    #  #       #     #
+ #####     #    #     #  #####   #####     #     #####  #     # #######  #####
+******************************************************************************/
+
+/**
+ **************************************************************************
+ * \details
+ *   Streaming top k selection.  Retains the k best keys offered, with
+ *   their data, in a bounded heap whose root is the threshold.  Once k
+ *   keys are held, an offer not better than the threshold is rejected
+ *   with a single compare, thus a long stream costs little more than a
+ *   scan.  Memory is O(k) regardless of the stream length.
+ *
+ *   ADTS_HEAP_MAX retains the k largest keys, ADTS_HEAP_MIN the k
+ *   smallest.  A key equal to the threshold is rejected.
+ *
+ *   ADTS consumer is responsible for serialization.
+ *
+ **************************************************************************
+ */
+#define ADTS_TOPK_BYTES (128)
+
+typedef struct {
+    const char reserved[ ADTS_TOPK_BYTES ];
+} adts_topk_t;
+
+typedef struct {
+    int64_t  key;
+    void    *p_data;
+} adts_topk_entry_t;
+
+
+/**
+ **************************************************************************
+ * \details
+ *   topk create options, k must not be 0, EINVAL otherwise.
+ *
+ **************************************************************************
+ */
+typedef struct {
+    adts_heap_type_t        type;        /**< largest (MAX) or smallest (MIN) */
+    size_t                  k;           /**< entries retained */
+    const adts_allocator_t *p_allocator; /**< NULL selects the default */
+} adts_topk_create_t;
+
+
+/**
+ **************************************************************************
+ * \details
+ *   Batch offer.  pp_data may be NULL, each retained entry's data is then
+ *   the address of its key within p_keys.  threads > 1 splits the batch,
+ *   each thread selecting into a private k entry instance which is then
+ *   merged, 0 and 1 select the calling thread only.
+ *
+ **************************************************************************
+ */
+typedef struct {
+    const int64_t *p_keys;  /**< elems keys */
+    void *const   *pp_data; /**< elems data, or NULL */
+    size_t         elems;
+    uint32_t       threads; /**< worker threads */
+} adts_topk_batch_t;
+
+
+/**
+ **************************************************************************
+ * \details
+ *   Counters since create or reset.
+ *
+ **************************************************************************
+ */
+typedef struct {
+    size_t offered;  /**< keys offered */
+    size_t retained; /**< keys which entered the heap */
+} adts_topk_stats_t;
+
+
+
+/******************************************************************************
+ #####   #####    ####    #####   ####    #####   #   #  #####   ######   ####
+ #    #  #    #  #    #     #    #    #     #      # #   #    #  #       #
+ #    #  #    #  #    #     #    #    #     #       #    #    #  #####    ####
+ #####   #####   #    #     #    #    #     #       #    #####   #            #
+ #       #   #   #    #     #    #    #     #       #    #       #       #    #
+ #       #    #   ####      #     ####      #       #    #       ######   ####
+*******************************************************************************/
+
+/**
+ **************************************************************************
+ * \brief
+ *   Selection services
+ *
+ * \details
+ *   - adts_topk_push()            true when the key was retained
+ *   - adts_topk_push_batch()      keys are screened in vector blocks
+ *                                 against the threshold, returns the number
+ *                                 retained
+ *   - adts_topk_push_batch_ext()  ENOMEM when a thread's private instance
+ *                                 or the thread itself fails to create, no
+ *                                 key is then offered
+ *   - adts_topk_merge()           offer every entry held by p_src, which is
+ *                                 unchanged.  EINVAL when the types differ.
+ *   - adts_topk_threshold()       false until k entries are held, else the
+ *                                 key an offer must beat
+ *   - adts_topk_results()         up to elems retained entries, best first,
+ *                                 returns the number written
+ *   - adts_topk_reset()           empty, ready for another stream
+ *
+ **************************************************************************
+ */
+bool
+adts_topk_push( adts_topk_t *p_adts_topk,
+                int64_t      key,
+                void        *p_data );
+
+size_t
+adts_topk_push_batch( adts_topk_t   *p_adts_topk,
+                      const int64_t *p_keys,
+                      void *const   *pp_data,
+                      size_t         elems );
+
+int32_t
+adts_topk_push_batch_ext( adts_topk_t             *p_adts_topk,
+                          const adts_topk_batch_t *p_op );
+
+int32_t
+adts_topk_merge( adts_topk_t *p_adts_topk,
+                 adts_topk_t *p_adts_topk_src );
+
+bool
+adts_topk_threshold( adts_topk_t *p_adts_topk,
+                     int64_t     *p_key );
+
+size_t
+adts_topk_results( adts_topk_t       *p_adts_topk,
+                   adts_topk_entry_t *p_out,
+                   size_t             elems );
+
+size_t
+adts_topk_entries( adts_topk_t *p_adts_topk );
+
+size_t
+adts_topk_k( adts_topk_t *p_adts_topk );
+
+void
+adts_topk_reset( adts_topk_t *p_adts_topk );
+
+void
+adts_topk_stats( adts_topk_t       *p_adts_topk,
+                 adts_topk_stats_t *p_out );
+
+void
+adts_topk_mem_usage( adts_topk_t      *p_adts_topk,
+                     adts_mem_stats_t *p_out );
+
+void
+adts_topk_destroy( adts_topk_t *p_adts_topk );
+
+adts_topk_t *
+adts_topk_create( const adts_topk_create_t *p_op );
+
+
+/**
+ **************************************************************************
+ * \details
+ *   Unit Test prototypes
+ *
+ **************************************************************************
+ */
+void
+utest_adts_topk( void );
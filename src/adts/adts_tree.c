@@ -2,6 +2,7 @@
 
 #include <errno.h>
 #include <assert.h>
+#include <stdlib.h>
 #include <string.h>
 #include <limits.h>
 #include <stdbool.h>
@@ -9,6 +10,7 @@
 
 /* Toolbox */
 #include <adts_tree.h>
+#include <adts_memory.h>
 #include <adts_stack.h>
 #include <adts_queue.h>
 #include <adts_sanity.h>
@@ -54,6 +56,7 @@ typedef struct tree_s {
     tree_node_t      *p_root;
     adts_sanity_t     sanity;
     adts_tree_type_t  type;
+    adts_mem_t        mem;
 } tree_t;
 
 
@@ -270,15 +273,23 @@ adts_tree_bst_invalid( adts_tree_t *p_adts_tree )
 {
     assert(p_adts_tree);
 
-    bool           rc       = false;
-    tree_t        *p_tree   = (tree_t *) p_adts_tree;
-    int64_t        lastval  = -1;
-    tree_node_t   *p_node   = p_tree->p_root;
-    adts_stack_t  *p_stack  = adts_stack_create();
-    adts_sanity_t *p_sanity = &(p_tree->sanity);
+    bool                 rc       = false;
+    tree_t              *p_tree   = (tree_t *) p_adts_tree;
+    int64_t              lastval  = -1;
+    tree_node_t         *p_node   = p_tree->p_root;
+    adts_stack_t        *p_stack  = NULL;
+    adts_sanity_t       *p_sanity = &(p_tree->sanity);
+    adts_stack_create_t  op       = {0};
 
     adts_sanity_entry(p_sanity);
 
+    /* traversal workspace follows the tree allocator */
+    op.p_allocator = p_tree->mem.p_allocator;
+    p_stack        = adts_stack_create_ext(&(op));
+    if (NULL == p_stack) {
+        goto exception;
+    }
+
     while (p_node || adts_stack_is_not_empty(p_stack)) {
         if (p_node) {
             (void) adts_stack_push(p_stack, p_node, sizeof(*p_node));
@@ -441,11 +452,12 @@ void
 adts_tree_destroy( adts_tree_t *p_adts_tree )
 {
     tree_t        *p_tree   = (tree_t *) p_adts_tree;
+    adts_mem_t     mem      = p_tree->mem;
     adts_sanity_t *p_sanity = &(p_tree->sanity);
 
     adts_sanity_entry(p_sanity);
 
-    free(p_tree);
+    adts_mem_put(&(mem), p_tree, sizeof(*p_adts_tree));
 
     /* No adts_sanity_exit() since we've freed the memory */
 
@@ -461,21 +473,39 @@ adts_tree_destroy( adts_tree_t *p_adts_tree )
  */
 adts_tree_t *
 adts_tree_create( adts_tree_type_t  type )
+{
+    return adts_tree_create_ext(type, NULL);
+} /* adts_tree_create() */
+
+
+/**
+ **************************************************************************
+ * \details
+ *
+ *************************************************************************
+ */
+adts_tree_t *
+adts_tree_create_ext( adts_tree_type_t        type,
+                      const adts_allocator_t *p_allocator )
 {
     tree_t      *p_tree      = NULL;
+    adts_mem_t   mem         = {0};
     adts_tree_t *p_adts_tree = NULL;
 
-    p_adts_tree = adts_mem_zalloc(sizeof(*p_adts_tree));
+    adts_mem_init_ext(&(mem), ADTS_MEM_TYPE_TREE, p_allocator);
+
+    p_adts_tree = adts_mem_get(&(mem), sizeof(*p_adts_tree));
     if (NULL == p_adts_tree) {
         goto exception;
     }
 
     p_tree       = (tree_t *) p_adts_tree;
     p_tree->type = type;
+    p_tree->mem  = mem;
 
 exception:
     return p_adts_tree;
-} /* adts_tree_create() */
+} /* adts_tree_create_ext() */
 
 
 
@@ -3,6 +3,7 @@
 #include <string.h>
 #include <stdbool.h>
 #include <inttypes.h>
+#include <adts_memory.h>
 
 
 /**
@@ -42,6 +43,24 @@ typedef struct {
 
 
 
+/**
+ **************************************************************************
+ * \details
+ *   The allocator backs the tree control block and traversal workspace.
+ *
+ **************************************************************************
+ */
+void
+adts_tree_destroy( adts_tree_t *p_adts_tree );
+
+adts_tree_t *
+adts_tree_create( adts_tree_type_t type );
+
+adts_tree_t *
+adts_tree_create_ext( adts_tree_type_t        type,
+                      const adts_allocator_t *p_allocator );
+
+
 /**
  **************************************************************************
  * \details
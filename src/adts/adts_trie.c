@@ -9,6 +9,7 @@
 
 /* Toolbox */
 #include <adts_trie.h>
+#include <adts_memory.h>
 #include <adts_sanity.h>
 #include <adts_private.h>
 #include <adts_hexdump.h>
@@ -59,6 +60,7 @@ typedef struct trie_s {
     size_t            elems_max;
     adts_sanity_t     sanity;
     trie_node_t      *p_root;
+    adts_mem_t        mem;
 } trie_t;
 
 
@@ -142,14 +144,29 @@ adts_trie_insert( adts_trie_t  *p_adts_trie,
  */
 void
 adts_trie_initialize( adts_trie_t *p_adts_trie )
+{
+    adts_trie_initialize_ext(p_adts_trie, NULL);
+
+    return;
+} /* adts_trie_initialize() */
+
+
+/**
+ **************************************************************************
+ *
+ *************************************************************************
+ */
+void
+adts_trie_initialize_ext( adts_trie_t            *p_adts_trie,
+                          const adts_allocator_t *p_allocator )
 {
     trie_t  *p_trie = (trie_t *) p_adts_trie;
 
     memset(p_adts_trie, 0, sizeof(*p_adts_trie));
-
+    adts_mem_init_ext(&(p_trie->mem), ADTS_MEM_TYPE_TRIE, p_allocator);
 
     return;
-} /* adts_trie_initialize() */
+} /* adts_trie_initialize_ext() */
 
 
 
@@ -3,6 +3,7 @@
 #include <string.h>
 #include <stdbool.h>
 #include <inttypes.h>
+#include <adts_memory.h>
 
 
 
@@ -32,6 +33,22 @@ typedef struct {
 } adts_trie_node_t;
 
 
+/**
+ **************************************************************************
+ * \details
+ *   The trie control block is consumer resident, the allocator backs
+ *   the trie nodes.
+ *
+ **************************************************************************
+ */
+void
+adts_trie_initialize( adts_trie_t *p_adts_trie );
+
+void
+adts_trie_initialize_ext( adts_trie_t            *p_adts_trie,
+                          const adts_allocator_t *p_allocator );
+
+
 
 /**
  **************************************************************************
@@ -0,0 +1,568 @@
+#define _GNU_SOURCE /* syscall(), RUSAGE_THREAD */
+#include <errno.h>
+#include <assert.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sched.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <sys/resource.h>
+
+/* Toolbox */
+#include <adts_wait.h>
+#include <adts_time.h>
+#include <adts_private.h>
+#include <adts_display.h>
+
+
+/******************************************************************************
+ * ####### #     # #     #  #####  #######   ###   ####### #     #  #####
+ * #       #     # ##    # #     #    #       #    #     # ##    # #     #
+ * #       #     # # #   # #          #       #    #     # # #   # #
+ * #####   #     # #  #  # #          #       #    #     # #  #  #  #####
+ * #       #     # #   # # #          #       #    #     # #   # #       #
+ * #       #     # #    ## #     #    #       #    #     # #    ## #     #
+ * #        #####  #     #  #####     #      ###   ####### #     #  #####
+******************************************************************************/
+
+/*
+ ****************************************************************************
+ * \details
+ *   Sleep while the futex word equals val.  Spurious returns are benign,
+ *   the caller re-evaluates its condition.
+ *
+ ****************************************************************************
+ */
+static inline void
+wait_futex_wait( uint32_t *p_word,
+                 uint32_t  val )
+{
+    (void) syscall(SYS_futex, p_word, FUTEX_WAIT_PRIVATE, val, NULL, NULL, 0);
+
+    return;
+} /* wait_futex_wait() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+static inline void
+wait_futex_wake( uint32_t *p_word,
+                 int32_t   count )
+{
+    (void) syscall(SYS_futex, p_word, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+
+    return;
+} /* wait_futex_wake() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Advance the futex word and wake when a waiter is registered.  The
+ *   fence orders the caller's publish before the waiters load, pairing
+ *   with the registration in adts_wait_until(): either the notifier sees
+ *   the waiter, or the waiter's final p_try() sees the publish.
+ *
+ *   While a wake is pending, i.e. the woken thread has yet to run, later
+ *   notifies are absorbed.  The woken thread passes the wake on.
+ *
+ ****************************************************************************
+ */
+static inline void
+wait_wake( adts_wait_t *p_wait,
+           int32_t      count )
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    if (__atomic_load_n(&(p_wait->waiters), __ATOMIC_RELAXED) &&
+        (0 == __atomic_exchange_n(&(p_wait->pending), 1, __ATOMIC_ACQ_REL))) {
+        __atomic_add_fetch(&(p_wait->seq), 1, __ATOMIC_SEQ_CST);
+        wait_futex_wake(&(p_wait->seq), count);
+        __atomic_add_fetch(&(p_wait->stats.wakes), 1, __ATOMIC_RELAXED);
+    }
+
+    return;
+} /* wait_wake() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_wait_notify( adts_wait_t *p_wait )
+{
+    wait_wake(p_wait, 1);
+
+    return;
+} /* adts_wait_notify() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_wait_notify_all( adts_wait_t *p_wait )
+{
+    wait_wake(p_wait, INT_MAX);
+
+    return;
+} /* adts_wait_notify_all() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   The futex key is sampled after registering and before the final
+ *   p_try(), thus a wake issued after that p_try() changes the word and
+ *   the park returns immediately.
+ *
+ *   A thread returning from a park clears the pending wake, then, once
+ *   p_try() succeeds, wakes the next waiter for any notify absorbed in
+ *   the meantime.  So does a registered thread whose final p_try()
+ *   succeeds, a notify may have set pending without it ever parking.
+ *
+ *   A notifier may also set pending after the waiter it saw has left,
+ *   leaving it set with no waiter.  Each registration therefore clears
+ *   pending before sampling the key, a stale gate never outlives the
+ *   next thread to park.
+ *
+ ****************************************************************************
+ */
+void
+adts_wait_until( adts_wait_t *p_wait,
+                 bool       (*p_try)( void *p_ctx ),
+                 void        *p_ctx )
+{
+    bool     parked = false;
+    uint32_t key    = 0;
+    uint32_t spins  = p_wait->spins;
+
+    for (;;) {
+        for (uint32_t idx = 0; idx < spins; idx++) {
+            if (p_try(p_ctx)) {
+                __atomic_add_fetch(&(p_wait->stats.spins), idx,
+                                   __ATOMIC_RELAXED);
+                goto exception;
+            }
+            adts_cpu_pause();
+        }
+        __atomic_add_fetch(&(p_wait->stats.spins), spins, __ATOMIC_RELAXED);
+
+        __atomic_add_fetch(&(p_wait->waiters), 1, __ATOMIC_SEQ_CST);
+
+        /* A notifier which saw an earlier waiter may set pending after
+         * that waiter left, with no one to clear it.  Re-arm before
+         * sampling the key, a wake issued from here on changes seq */
+        __atomic_store_n(&(p_wait->pending), 0, __ATOMIC_SEQ_CST);
+        key = __atomic_load_n(&(p_wait->seq), __ATOMIC_SEQ_CST);
+
+        if (p_try(p_ctx)) {
+            __atomic_sub_fetch(&(p_wait->waiters), 1, __ATOMIC_SEQ_CST);
+
+            /* A notify since registering may have set pending on this
+             * thread's account, it will not park to clear it.  Clear it
+             * and pass the wake on, a surplus wake is benign */
+            if (__atomic_exchange_n(&(p_wait->pending), 0, __ATOMIC_ACQ_REL)) {
+                parked = true;
+            }
+            goto exception;
+        }
+
+        __atomic_add_fetch(&(p_wait->stats.parks), 1, __ATOMIC_RELAXED);
+        wait_futex_wait(&(p_wait->seq), key);
+        __atomic_sub_fetch(&(p_wait->waiters), 1, __ATOMIC_RELAXED);
+        __atomic_store_n(&(p_wait->pending), 0, __ATOMIC_RELEASE);
+        parked = true;
+    }
+
+exception:
+    if (parked) {
+        wait_wake(p_wait, 1);
+    }
+
+    return;
+} /* adts_wait_until() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_wait_stats( const adts_wait_t *p_wait,
+                 adts_wait_stats_t *p_out )
+{
+    p_out->spins = __atomic_load_n(&(p_wait->stats.spins), __ATOMIC_RELAXED);
+    p_out->parks = __atomic_load_n(&(p_wait->stats.parks), __ATOMIC_RELAXED);
+    p_out->wakes = __atomic_load_n(&(p_wait->stats.wakes), __ATOMIC_RELAXED);
+
+    return;
+} /* adts_wait_stats() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_wait_init( adts_wait_t *p_wait,
+                uint32_t     spins )
+{
+    memset(p_wait, 0, sizeof(*p_wait));
+    p_wait->spins = spins ? spins : ADTS_WAIT_SPINS_DEFAULT;
+
+    /* spinning cannot observe progress without a second cpu */
+    if (1 >= sysconf(_SC_NPROCESSORS_ONLN)) {
+        p_wait->spins = 1;
+    }
+
+    return;
+} /* adts_wait_init() */
+
+
+
+/******************************************************************************
+ * #     # #     #   ###   ####### ####### #######  #####  #######  #####
+ * #     # ##    #    #       #       #    #       #     #    #    #     #
+ * #     # # #   #    #       #       #    #       #          #    #
+ * #     # #  #  #    #       #       #    #####    #####     #     #####
+ * #     # #   # #    #       #       #    #             #    #          #
+ * #     # #    ##    #       #       #    #       #     #    #    #     #
+ *  #####  #     #   ###      #       #    #######  #####     #     #####
+******************************************************************************/
+
+/*
+ ****************************************************************************
+ * \details
+ *   Test condition, a counter of posted events which a waiter consumes.
+ *
+ ****************************************************************************
+ */
+typedef struct {
+    adts_wait_t wait;
+    size_t      posted;
+    size_t      taken;
+    size_t      events;
+    uint64_t    cpu_ns;
+} utest_wait_ctx_t;
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+static bool
+utest_wait_try( void *p_arg )
+{
+    utest_wait_ctx_t *p_ctx  = p_arg;
+    size_t            posted = __atomic_load_n(&(p_ctx->posted),
+                                               __ATOMIC_ACQUIRE);
+
+    return (posted > p_ctx->taken);
+} /* utest_wait_try() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Consume events, recording the thread cpu time spent doing so.
+ *
+ ****************************************************************************
+ */
+static void *
+utest_wait_waiter( void *p_arg )
+{
+    utest_wait_ctx_t *p_ctx = p_arg;
+    struct rusage     usage = {0};
+
+    while (p_ctx->taken < p_ctx->events) {
+        adts_wait_until(&(p_ctx->wait), utest_wait_try, p_ctx);
+        p_ctx->taken++;
+    }
+
+    (void) getrusage(RUSAGE_THREAD, &(usage));
+    p_ctx->cpu_ns = ((uint64_t) usage.ru_utime.tv_sec  * 1000000000ull) +
+                    ((uint64_t) usage.ru_utime.tv_usec * 1000ull) +
+                    ((uint64_t) usage.ru_stime.tv_sec  * 1000000000ull) +
+                    ((uint64_t) usage.ru_stime.tv_usec * 1000ull);
+
+    return NULL;
+} /* utest_wait_waiter() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Post events with an idle gap between each.  The waiter must park
+ *   through each gap, i.e. consume almost no cpu while idle.
+ *
+ ****************************************************************************
+ */
+static void
+utest_wait_idle( void )
+{
+    int32_t           rc     = 0;
+    uint64_t          gap    = 20 * 1000 * 1000;
+    pthread_t         thread;
+    utest_wait_ctx_t  ctx    = {0};
+    adts_wait_stats_t stats  = {0};
+
+    adts_wait_init(&(ctx.wait), 0);
+    ctx.events = 5;
+
+    rc = pthread_create(&(thread), NULL, utest_wait_waiter, &(ctx));
+    assert(0 == rc);
+
+    for (size_t idx = 0; idx < ctx.events; idx++) {
+        (void) usleep(gap / 1000);
+        __atomic_add_fetch(&(ctx.posted), 1, __ATOMIC_RELEASE);
+        adts_wait_notify(&(ctx.wait));
+    }
+
+    (void) pthread_join(thread, NULL);
+    adts_wait_stats(&(ctx.wait), &(stats));
+
+    CDISPLAY("events: %zu  idle: %"PRIu64"ms  waiter cpu: %"PRIu64"us  spins: %zu  parks: %zu  wakes: %zu",
+             ctx.events,
+             (ctx.events * gap) / 1000000,
+             ctx.cpu_ns / 1000,
+             stats.spins,
+             stats.parks,
+             stats.wakes);
+
+    assert(ctx.events == ctx.taken);
+    assert(stats.parks >= ctx.events);
+    assert(ctx.cpu_ns < ((ctx.events * gap) / 10));
+
+    return;
+} /* utest_wait_idle() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Event handoff shared by several consumers, each take claims one
+ *   posted event.  stop releases the consumers once the run is over.
+ *
+ ****************************************************************************
+ */
+typedef struct {
+    adts_wait_t wait;
+    size_t      posted;
+    size_t      taken;
+    size_t      calls;
+    bool        stop;
+} utest_wait_race_t;
+
+#define UTEST_WAIT_RACE_CONSUMERS (3)
+#define UTEST_WAIT_RACE_EVENTS    (100000)
+#define UTEST_WAIT_RACE_DEADLINE  (2ull * 1000 * 1000 * 1000)
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+static bool
+utest_wait_race_try( void *p_arg )
+{
+    utest_wait_race_t *p_race = p_arg;
+    size_t             taken  = __atomic_load_n(&(p_race->taken), __ATOMIC_ACQUIRE);
+
+    while (taken < __atomic_load_n(&(p_race->posted), __ATOMIC_ACQUIRE)) {
+        if (__atomic_compare_exchange_n(&(p_race->taken), &(taken), taken + 1,
+                                        false, __ATOMIC_ACQ_REL,
+                                        __ATOMIC_ACQUIRE)) {
+            return true;
+        }
+    }
+
+    return __atomic_load_n(&(p_race->stop), __ATOMIC_ACQUIRE);
+} /* utest_wait_race_try() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   With one spin, the second call is the final p_try() after
+ *   registration.  A notify issued from within it lands exactly in the
+ *   window, deterministically.
+ *
+ ****************************************************************************
+ */
+static bool
+utest_wait_race_inject( void *p_arg )
+{
+    utest_wait_race_t *p_race = p_arg;
+
+    if (2 == ++(p_race->calls)) {
+        adts_wait_notify(&(p_race->wait));
+        return true;
+    }
+
+    return false;
+} /* utest_wait_race_inject() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+static void *
+utest_wait_race_consumer( void *p_arg )
+{
+    utest_wait_race_t *p_race = p_arg;
+
+    while (false == __atomic_load_n(&(p_race->stop), __ATOMIC_ACQUIRE)) {
+        adts_wait_until(&(p_race->wait), utest_wait_race_try, p_race);
+    }
+
+    return NULL;
+} /* utest_wait_race_consumer() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   A notify injected between registration and the final p_try(), and a
+ *   pending gate left set with no waiter, then one event at a time, each
+ *   notified once, to consumers which neither spin nor sleep in between.
+ *   A notify absorbed without a parked thread to pass it on strands
+ *   every later event, each event must be taken within the deadline.
+ *
+ ****************************************************************************
+ */
+static void
+utest_wait_race( void )
+{
+    int32_t           rc     = 0;
+    pthread_t         thread[ UTEST_WAIT_RACE_CONSUMERS ];
+    utest_wait_race_t race   = {0};
+    adts_wait_stats_t stats  = {0};
+
+    adts_wait_init(&(race.wait), 1);
+
+    /* the injected notify must not be left pending */
+    adts_wait_until(&(race.wait), utest_wait_race_inject, &(race));
+    assert(2 == race.calls);
+
+    /* replay: a notifier saw a waiter which then took its event and
+     * left, the notifier's pending exchange lands with no waiter */
+    __atomic_store_n(&(race.wait.pending), 1, __ATOMIC_SEQ_CST);
+
+    for (uint32_t idx = 0; idx < UTEST_WAIT_RACE_CONSUMERS; idx++) {
+        rc = pthread_create(&(thread[idx]), NULL, utest_wait_race_consumer, &(race));
+        assert(0 == rc);
+    }
+
+    for (size_t event = 1; event <= UTEST_WAIT_RACE_EVENTS; event++) {
+        uint64_t start = adts_tstamp();
+
+        __atomic_store_n(&(race.posted), event, __ATOMIC_RELEASE);
+        adts_wait_notify(&(race.wait));
+
+        while (__atomic_load_n(&(race.taken), __ATOMIC_ACQUIRE) < event) {
+            /* a lost wakeup leaves the event untaken indefinitely */
+            assert((adts_tstamp() - start) < UTEST_WAIT_RACE_DEADLINE);
+            (void) sched_yield();
+        }
+    }
+
+    __atomic_store_n(&(race.stop), true, __ATOMIC_RELEASE);
+    adts_wait_notify_all(&(race.wait));
+    for (uint32_t idx = 0; idx < UTEST_WAIT_RACE_CONSUMERS; idx++) {
+        (void) pthread_join(thread[idx], NULL);
+    }
+
+    adts_wait_stats(&(race.wait), &(stats));
+    CDISPLAY("events: %zu  consumers: %u  parks: %zu  wakes: %zu",
+             (size_t) UTEST_WAIT_RACE_EVENTS,
+             UTEST_WAIT_RACE_CONSUMERS,
+             stats.parks,
+             stats.wakes);
+
+    assert(UTEST_WAIT_RACE_EVENTS == race.taken);
+
+    return;
+} /* utest_wait_race() */
+
+
+/*
+ ****************************************************************************
+ * test control
+ *
+ ****************************************************************************
+ */
+static void
+utest_control( void )
+{
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: ready condition, no spin / park / wake");
+
+        utest_wait_ctx_t  ctx   = {0};
+        adts_wait_stats_t stats = {0};
+
+        adts_wait_init(&(ctx.wait), 0);
+        assert((ADTS_WAIT_SPINS_DEFAULT == ctx.wait.spins) ||
+               (1 == sysconf(_SC_NPROCESSORS_ONLN)));
+
+        ctx.posted = 1;
+        adts_wait_until(&(ctx.wait), utest_wait_try, &(ctx));
+
+        /* notify without waiters never enters the kernel */
+        adts_wait_notify(&(ctx.wait));
+        adts_wait_notify_all(&(ctx.wait));
+
+        adts_wait_stats(&(ctx.wait), &(stats));
+        assert(0 == (stats.spins + stats.parks + stats.wakes));
+    }
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: park while idle");
+
+        utest_wait_idle();
+    }
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: notify against registration, no lost wakeup");
+
+        utest_wait_race();
+    }
+
+    return;
+} /* utest_control() */
+
+
+/*
+ ****************************************************************************
+ * test entrypoint
+ *
+ ****************************************************************************
+ */
+void
+utest_adts_wait( void )
+{
+    utest_control();
+
+    return;
+} /* utest_adts_wait() */
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+
+
+/******************************************************************************
+ #####  ####### ######  #     #  #####  ####### #     # ######  #######  #####
+#     #    #    #     # #     # #     #    #    #     # #     # #       #     #
+#          #    #     # #     # #          #    #     # #     # #       #
+ #####     #    ######  #     # #          #    #     # ######  #####    #####
+      #    #    #   #   #     # #          #    #     # #   #   #             #
+#     #    #    #    #  #     # #     #    #    #     # #    #  #       #     #
+ #####     #    #     #  #####   #####     #     #####  #     # #######  #####
+******************************************************************************/
+
+/**
+ **************************************************************************
+ * \details
+ *   Default spin rounds, each a cpu pause and a retry, before a waiter
+ *   parks in the kernel.
+ *
+ **************************************************************************
+ */
+#define ADTS_WAIT_SPINS_DEFAULT (2048)
+
+
+/**
+ **************************************************************************
+ * \details
+ *   Lifetime waiter counters.
+ *
+ **************************************************************************
+ */
+typedef struct {
+    size_t spins; /**< spin rounds across all waits */
+    size_t parks; /**< futex sleeps */
+    size_t wakes; /**< futex wake calls, issued only with waiters present */
+} adts_wait_stats_t;
+
+
+/**
+ **************************************************************************
+ * \details
+ *   Event count, embedded in a concurrent ADT such that consumers may
+ *   block on a condition such as "not empty" without a lock.  Members are
+ *   private to adts_wait.
+ *
+ *   A waiter spins for a bounded number of rounds, then registers and
+ *   parks on a Linux futex.  The notifier only enters the kernel when a
+ *   waiter is registered and no earlier wake is still pending, thus the
+ *   uncontended cost of a notify is a full memory barrier and a load.
+ *   A woken waiter passes the wake on once it has made progress, such
+ *   that a burst of notifies wakes every parked waiter in turn.
+ *
+ **************************************************************************
+ */
+typedef struct {
+    uint32_t          seq;     /**< futex word, advanced by each wake */
+    uint32_t          waiters; /**< threads registered to park */
+    uint32_t          pending; /**< wake issued, not yet observed */
+    uint32_t          spins;   /**< spin budget */
+    adts_wait_stats_t stats;
+} adts_wait_t;
+
+
+
+/******************************************************************************
+ #####   #####    ####    #####   ####    #####   #   #  #####   ######   ####
+ #    #  #    #  #    #     #    #    #     #      # #   #    #  #       #
+ #    #  #    #  #    #     #    #    #     #       #    #    #  #####    ####
+ #####   #####   #    #     #    #    #     #       #    #####   #            #
+ #       #   #   #    #     #    #    #     #       #    #       #       #    #
+ #       #    #   ####      #     ####      #       #    #       ######   ####
+*******************************************************************************/
+
+/**
+ **************************************************************************
+ * \brief
+ *   Event count services
+ *
+ * \details
+ *   - adts_wait_init()       spins of 0 selects ADTS_WAIT_SPINS_DEFAULT,
+ *                            a single cpu system does not spin
+ *   - adts_wait_until()      return once p_try() succeeds, p_try() is
+ *                            retried after every spin round and before
+ *                            each park
+ *   - adts_wait_notify()     call after publishing, wakes one waiter
+ *   - adts_wait_notify_all() wakes every waiter
+ *
+ **************************************************************************
+ */
+void
+adts_wait_init( adts_wait_t *p_wait,
+                uint32_t     spins );
+
+void
+adts_wait_until( adts_wait_t *p_wait,
+                 bool       (*p_try)( void *p_ctx ),
+                 void        *p_ctx );
+
+void
+adts_wait_notify( adts_wait_t *p_wait );
+
+void
+adts_wait_notify_all( adts_wait_t *p_wait );
+
+void
+adts_wait_stats( const adts_wait_t *p_wait,
+                 adts_wait_stats_t *p_out );
+
+
+/**
+ **************************************************************************
+ * \details
+ *   Unit Test prototypes
+ *
+ **************************************************************************
+ */
+void
+utest_adts_wait( void );
@@ -0,0 +1,895 @@
+#include <sched.h>
+#include <errno.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <inttypes.h>
+
+/* Toolbox */
+#include <adts_math.h>
+#include <adts_time.h>
+#include <adts_memory.h>
+#include <adts_wsdeque.h>
+#include <adts_private.h>
+#include <adts_display.h>
+
+
+/******************************************************************************
+ #####  ####### ######  #     #  #####  ####### #     # ######  #######  #####
+#     #    #    #     # #     # #     #    #    #     # #     # #       #     #
+#          #    #     # #     # #          #    #     # #     # #       #
+ #####     #    ######  #     # #          #    #     # ######  #####    #####
+      #    #    #   #   #     # #          #    #     # #   #   #             #
+#     #    #    #    #  #     # #     #    #    #     # #    #  #       #     #
+ #####     #    #     #  #####   #####     #     #####  #     # #######  #####
+******************************************************************************/
+
+/*
+ ****************************************************************************
+ * \details
+ *   Default initial capacity, in entries.
+ *
+ ****************************************************************************
+ */
+#define WSDEQUE_ELEMS_DEFAULT (64)
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Circular array.  p_retired links the arrays it has outgrown, newest
+ *   first.  Slots are accessed with relaxed atomics, ordering is carried
+ *   by top / bottom.
+ *
+ ****************************************************************************
+ */
+typedef struct wsdeque_array_s {
+    struct wsdeque_array_s *p_retired;
+    size_t                  mask;
+    void                   *p_slots[];
+} wsdeque_array_t;
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Two cache lines:
+ *   - steal: top, advanced by a compare and swap from thieves, and from
+ *            the owner when it takes the last entry
+ *   - owner: bottom and the array, written by the owner only
+ *
+ *   top and bottom are signed such that the owner may transiently move
+ *   bottom below top while taking the last entry.  The entries are
+ *   [top, bottom).
+ *
+ *   Memory ordering follows Le, Pop, Cohen and Zappa Nardelli, "Correct
+ *   and Efficient Work-Stealing for Weak Memory Models" (PPoPP 2013).
+ *
+ ****************************************************************************
+ */
+typedef struct {
+    struct {
+        int64_t               top;
+    } ADTS_CACHELINE_ALIGN steal;
+
+    struct {
+        int64_t               bottom;
+        wsdeque_array_t      *p_array;
+        adts_wsdeque_stats_t  stats;
+        adts_mem_t            mem;
+    } ADTS_CACHELINE_ALIGN owner;
+} wsdeque_t;
+
+
+/******************************************************************************
+ * ####### #     # #     #  #####  #######   ###   ####### #     #  #####
+ * #       #     # ##    # #     #    #       #    #     # ##    # #     #
+ * #       #     # # #   # #          #       #    #     # # #   # #
+ * #####   #     # #  #  # #          #       #    #     # #  #  #  #####
+ * #       #     # #   # # #          #       #    #     # #   # #       #
+ * #       #     # #    ## #     #    #       #    #     # #    ## #     #
+ * #        #####  #     #  #####     #      ###   ####### #     #  #####
+******************************************************************************/
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+static inline size_t
+wsdeque_array_bytes( size_t slots )
+{
+    return sizeof(wsdeque_array_t) + (slots * sizeof(void *));
+} /* wsdeque_array_bytes() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Double the array.  Live entries keep their index, thus are copied to
+ *   the slot that index masks to in the new array.  The new array is
+ *   published with a release store such that a thief observing it also
+ *   observes the copied slots.
+ *
+ ****************************************************************************
+ */
+static int32_t
+wsdeque_grow( wsdeque_t       *p_wsdeque,
+              int64_t          top,
+              int64_t          bottom,
+              wsdeque_array_t **pp_array )
+{
+    int32_t          rc      = 0;
+    wsdeque_array_t *p_old   = *pp_array;
+    wsdeque_array_t *p_new   = NULL;
+    size_t           slots   = (p_old->mask + 1) << 1;
+
+    p_new = adts_mem_alloc(&(p_wsdeque->owner.mem), wsdeque_array_bytes(slots));
+    if (unlikely(NULL == p_new)) {
+        rc = ENOMEM;
+        goto exception;
+    }
+
+    p_new->p_retired = p_old;
+    p_new->mask      = slots - 1;
+    for (int64_t idx = top; idx < bottom; idx++) {
+        p_new->p_slots[idx & p_new->mask] =
+            __atomic_load_n(&(p_old->p_slots[idx & p_old->mask]), __ATOMIC_RELAXED);
+    }
+
+    __atomic_store_n(&(p_wsdeque->owner.p_array), p_new, __ATOMIC_RELEASE);
+    p_wsdeque->owner.stats.grows++;
+    *pp_array = p_new;
+
+exception:
+    return rc;
+} /* wsdeque_grow() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+int32_t
+adts_wsdeque_push( adts_wsdeque_t *p_adts_wsdeque,
+                   void           *p_data )
+{
+    int32_t          rc        = 0;
+    wsdeque_t       *p_wsdeque = (wsdeque_t *) p_adts_wsdeque;
+    int64_t          bottom    = p_wsdeque->owner.bottom;
+    int64_t          top       = __atomic_load_n(&(p_wsdeque->steal.top),
+                                                 __ATOMIC_ACQUIRE);
+    wsdeque_array_t *p_array   = p_wsdeque->owner.p_array;
+
+    if (unlikely((bottom - top) > (int64_t) p_array->mask)) {
+        rc = wsdeque_grow(p_wsdeque, top, bottom, &(p_array));
+        if (unlikely(rc)) {
+            goto exception;
+        }
+    }
+
+    __atomic_store_n(&(p_array->p_slots[bottom & p_array->mask]), p_data,
+                     __ATOMIC_RELAXED);
+    /* the slot is visible before the entry is counted */
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&(p_wsdeque->owner.bottom), bottom + 1, __ATOMIC_RELAXED);
+    p_wsdeque->owner.stats.pushes++;
+
+exception:
+    return rc;
+} /* adts_wsdeque_push() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   bottom is reserved first, then top is read.  The full fence orders
+ *   the two such that the owner and a thief cannot both miss each other
+ *   on the last entry; that entry alone is contended with a compare and
+ *   swap of top.
+ *
+ ****************************************************************************
+ */
+void *
+adts_wsdeque_pop( adts_wsdeque_t *p_adts_wsdeque )
+{
+    void            *p_data    = NULL;
+    wsdeque_t       *p_wsdeque = (wsdeque_t *) p_adts_wsdeque;
+    int64_t          bottom    = p_wsdeque->owner.bottom - 1;
+    wsdeque_array_t *p_array   = p_wsdeque->owner.p_array;
+    int64_t          top       = 0;
+
+    __atomic_store_n(&(p_wsdeque->owner.bottom), bottom, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    top = __atomic_load_n(&(p_wsdeque->steal.top), __ATOMIC_RELAXED);
+
+    if (unlikely(top > bottom)) {
+        /* empty, restore */
+        __atomic_store_n(&(p_wsdeque->owner.bottom), bottom + 1,
+                         __ATOMIC_RELAXED);
+        goto exception;
+    }
+
+    p_data = __atomic_load_n(&(p_array->p_slots[bottom & p_array->mask]),
+                             __ATOMIC_RELAXED);
+
+    if (unlikely(top == bottom)) {
+        /* last entry, race the thieves for it */
+        if (!__atomic_compare_exchange_n(&(p_wsdeque->steal.top), &(top),
+                                         top + 1, false,
+                                         __ATOMIC_SEQ_CST,
+                                         __ATOMIC_RELAXED)) {
+            p_wsdeque->owner.stats.pop_races++;
+            p_data = NULL;
+        }
+        __atomic_store_n(&(p_wsdeque->owner.bottom), bottom + 1,
+                         __ATOMIC_RELAXED);
+    }
+
+    if (p_data) {
+        p_wsdeque->owner.stats.pops++;
+    }
+
+exception:
+    return p_data;
+} /* adts_wsdeque_pop() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   top is read before bottom, fenced, then the slot is read before the
+ *   swap claims it.  Should the swap fail the read value is discarded, a
+ *   slot overwritten after a wrap is thus never returned.
+ *
+ ****************************************************************************
+ */
+int32_t
+adts_wsdeque_steal( adts_wsdeque_t  *p_adts_wsdeque,
+                    void           **pp_data )
+{
+    int32_t          rc        = ENOENT;
+    void            *p_data    = NULL;
+    wsdeque_t       *p_wsdeque = (wsdeque_t *) p_adts_wsdeque;
+    int64_t          top       = 0;
+    int64_t          bottom    = 0;
+    wsdeque_array_t *p_array   = NULL;
+
+    top = __atomic_load_n(&(p_wsdeque->steal.top), __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    bottom = __atomic_load_n(&(p_wsdeque->owner.bottom), __ATOMIC_ACQUIRE);
+
+    if (top >= bottom) {
+        goto exception;
+    }
+
+    p_array = __atomic_load_n(&(p_wsdeque->owner.p_array), __ATOMIC_ACQUIRE);
+    p_data  = __atomic_load_n(&(p_array->p_slots[top & p_array->mask]),
+                              __ATOMIC_RELAXED);
+
+    if (!__atomic_compare_exchange_n(&(p_wsdeque->steal.top), &(top),
+                                     top + 1, false,
+                                     __ATOMIC_SEQ_CST,
+                                     __ATOMIC_RELAXED)) {
+        rc = EAGAIN;
+        goto exception;
+    }
+
+    *pp_data = p_data;
+    rc       = 0;
+
+exception:
+    return rc;
+} /* adts_wsdeque_steal() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+size_t
+adts_wsdeque_entries( adts_wsdeque_t *p_adts_wsdeque )
+{
+    wsdeque_t *p_wsdeque = (wsdeque_t *) p_adts_wsdeque;
+    int64_t    top       = __atomic_load_n(&(p_wsdeque->steal.top),
+                                           __ATOMIC_ACQUIRE);
+    int64_t    bottom    = __atomic_load_n(&(p_wsdeque->owner.bottom),
+                                           __ATOMIC_ACQUIRE);
+
+    return (bottom > top) ? (size_t) (bottom - top) : 0;
+} /* adts_wsdeque_entries() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+size_t
+adts_wsdeque_capacity( adts_wsdeque_t *p_adts_wsdeque )
+{
+    wsdeque_t       *p_wsdeque = (wsdeque_t *) p_adts_wsdeque;
+    wsdeque_array_t *p_array   = __atomic_load_n(&(p_wsdeque->owner.p_array),
+                                                 __ATOMIC_ACQUIRE);
+
+    return p_array->mask + 1;
+} /* adts_wsdeque_capacity() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_wsdeque_stats( adts_wsdeque_t       *p_adts_wsdeque,
+                    adts_wsdeque_stats_t *p_out )
+{
+    wsdeque_t *p_wsdeque = (wsdeque_t *) p_adts_wsdeque;
+
+    *p_out = p_wsdeque->owner.stats;
+
+    return;
+} /* adts_wsdeque_stats() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+void
+adts_wsdeque_mem_usage( adts_wsdeque_t   *p_adts_wsdeque,
+                        adts_mem_stats_t *p_out )
+{
+    wsdeque_t *p_wsdeque = (wsdeque_t *) p_adts_wsdeque;
+
+    adts_mem_usage(&(p_wsdeque->owner.mem), p_out);
+
+    return;
+} /* adts_wsdeque_mem_usage() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   All threads must have quiesced.  The current and every retired array
+ *   are released, remaining entries belong to the consumer.
+ *
+ ****************************************************************************
+ */
+void
+adts_wsdeque_destroy( adts_wsdeque_t *p_adts_wsdeque )
+{
+    wsdeque_t       *p_wsdeque = (wsdeque_t *) p_adts_wsdeque;
+    adts_mem_t       mem       = p_wsdeque->owner.mem;
+    wsdeque_array_t *p_array   = p_wsdeque->owner.p_array;
+    wsdeque_array_t *p_retired = NULL;
+
+    while (p_array) {
+        p_retired = p_array->p_retired;
+        adts_mem_put(&(mem), p_array, wsdeque_array_bytes(p_array->mask + 1));
+        p_array   = p_retired;
+    }
+
+    adts_mem_put_aligned(&(mem), p_adts_wsdeque, sizeof(*p_adts_wsdeque));
+
+    return;
+} /* adts_wsdeque_destroy() */
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+adts_wsdeque_t *
+adts_wsdeque_create( const adts_wsdeque_create_t *p_op )
+{
+    size_t           slots          = WSDEQUE_ELEMS_DEFAULT;
+    wsdeque_t       *p_wsdeque      = NULL;
+    wsdeque_array_t *p_array        = NULL;
+    adts_mem_t       mem            = {0};
+    adts_wsdeque_t  *p_adts_wsdeque = NULL;
+
+    assert(p_op);
+    if (p_op->elems > (UINT32_MAX >> 1)) {
+        goto exception;
+    }
+    if (p_op->elems) {
+        slots = MAX(2, adts_pow2_round_up(p_op->elems));
+    }
+
+    adts_mem_init_ext(&(mem), ADTS_MEM_TYPE_WSDEQUE, p_op->p_allocator);
+
+    p_adts_wsdeque = adts_mem_get_aligned(&(mem), sizeof(*p_adts_wsdeque));
+    if (NULL == p_adts_wsdeque) {
+        goto exception;
+    }
+
+    p_array = adts_mem_get(&(mem), wsdeque_array_bytes(slots));
+    if (NULL == p_array) {
+        adts_mem_put_aligned(&(mem), p_adts_wsdeque, sizeof(*p_adts_wsdeque));
+        p_adts_wsdeque = NULL;
+        goto exception;
+    }
+    p_array->mask = slots - 1;
+
+    p_wsdeque                = (wsdeque_t *) p_adts_wsdeque;
+    p_wsdeque->owner.p_array = p_array;
+    p_wsdeque->owner.mem     = mem;
+
+exception:
+    return p_adts_wsdeque;
+} /* adts_wsdeque_create() */
+
+
+
+/******************************************************************************
+ * #     # #     #   ###   ####### ####### #######  #####  #######  #####
+ * #     # ##    #    #       #       #    #       #     #    #    #     #
+ * #     # # #   #    #       #       #    #       #          #    #
+ * #     # #  #  #    #       #       #    #####    #####     #     #####
+ * #     # #   # #    #       #       #    #             #    #          #
+ * #     # #    ##    #       #       #    #       #     #    #    #     #
+ *  #####  #     #   ###      #       #    #######  #####     #     #####
+******************************************************************************/
+
+/**
+ **************************************************************************
+ * \brief
+ *   Compile time structure sanity
+ *
+ * \details
+ *   Sanitize the abstract data type interface.  Enforced in header file so
+ *   as to catch improper usage/include by unauthorized callers.
+ *
+ **************************************************************************
+ */
+static void
+utest_wsdeque_bytes( void )
+{
+    CDISPLAY("[%u]", sizeof(wsdeque_t));
+    CDISPLAY("[%u]", sizeof(adts_wsdeque_t));
+
+    _Static_assert(sizeof(wsdeque_t) <= sizeof(adts_wsdeque_t),
+        "Mismatch structs detected");
+
+    return;
+} /* utest_wsdeque_bytes() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Benchmark parameters.  Tasks spawned by the stress run, handoffs
+ *   timed by the steal latency run, and owner operations timed by the
+ *   rate run.
+ *
+ ****************************************************************************
+ */
+#ifndef UTEST_WSDEQUE_TASKS
+#define UTEST_WSDEQUE_TASKS (1 << 20)
+#endif
+
+#ifndef UTEST_WSDEQUE_THIEVES_MAX
+#define UTEST_WSDEQUE_THIEVES_MAX (8)
+#endif
+
+#ifndef UTEST_WSDEQUE_HANDOFFS
+#define UTEST_WSDEQUE_HANDOFFS (1 << 13)
+#endif
+
+#ifndef UTEST_WSDEQUE_OPS
+#define UTEST_WSDEQUE_OPS (1 << 23)
+#endif
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+typedef struct {
+    adts_wsdeque_t *p_wsdeque;
+    uint8_t        *p_seen;
+    uint64_t       *p_samples;
+    size_t          samples;
+    bool            done;
+    size_t          steals;
+    size_t          aborts;
+} utest_wsdeque_ctx_t;
+
+
+/*
+ ****************************************************************************
+ *
+ ****************************************************************************
+ */
+static int
+utest_wsdeque_cmp( const void *p_a,
+                   const void *p_b )
+{
+    uint64_t a = *(const uint64_t *) p_a;
+    uint64_t b = *(const uint64_t *) p_b;
+
+    return (a > b) - (a < b);
+} /* utest_wsdeque_cmp() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Steal until the owner is done and the deque is drained.  Each task
+ *   id is marked, a task taken twice trips the owner's final check.
+ *
+ ****************************************************************************
+ */
+static void *
+utest_wsdeque_thief( void *p_arg )
+{
+    utest_wsdeque_ctx_t *p_shared = p_arg;
+    utest_wsdeque_ctx_t *p_ctx    = NULL;
+    void                *p_data   = NULL;
+    int32_t              rc       = 0;
+
+    p_ctx = calloc(1, sizeof(*p_ctx));
+    assert(p_ctx);
+
+    while (true) {
+        rc = adts_wsdeque_steal(p_shared->p_wsdeque, &(p_data));
+        if (0 == rc) {
+            __atomic_add_fetch(&(p_shared->p_seen[(size_t) p_data - 1]), 1,
+                               __ATOMIC_RELAXED);
+            p_ctx->steals++;
+            continue;
+        }
+
+        if (EAGAIN == rc) {
+            p_ctx->aborts++;
+            continue;
+        }
+
+        if (__atomic_load_n(&(p_shared->done), __ATOMIC_ACQUIRE)) {
+            break;
+        }
+        sched_yield();
+    }
+
+    return p_ctx;
+} /* utest_wsdeque_thief() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Fork / join shape: the owner spawns tasks in bursts into a deque
+ *   created at 2 entries, thus growing under theft, and runs part of
+ *   each burst itself.  Every task must be taken exactly once.
+ *
+ ****************************************************************************
+ */
+static void
+utest_wsdeque_stress( size_t thieves )
+{
+    int32_t                rc       = 0;
+    size_t                 tasks    = UTEST_WSDEQUE_TASKS;
+    size_t                 pops     = 0;
+    size_t                 steals   = 0;
+    size_t                 aborts   = 0;
+    uint64_t               start    = 0;
+    uint64_t               delta    = 0;
+    void                  *p_data   = NULL;
+    utest_wsdeque_ctx_t   *p_ret    = NULL;
+    adts_wsdeque_create_t  op       = {0};
+    adts_wsdeque_stats_t   stats    = {0};
+    utest_wsdeque_ctx_t    ctx      = {0};
+    pthread_t              tids[ UTEST_WSDEQUE_THIEVES_MAX ];
+
+    op.elems      = 2;
+    ctx.p_wsdeque = adts_wsdeque_create(&(op));
+    ctx.p_seen    = calloc(tasks, sizeof(*ctx.p_seen));
+    assert(ctx.p_wsdeque && ctx.p_seen);
+
+    start = adts_tstamp();
+    for (size_t idx = 0; idx < thieves; idx++) {
+        rc = pthread_create(&(tids[idx]), NULL, utest_wsdeque_thief, &(ctx));
+        assert(0 == rc);
+    }
+
+    for (size_t id = 1; id <= tasks; ) {
+        size_t burst = 1 + (id % 61);
+
+        for (size_t idx = 0; (idx < burst) && (id <= tasks); idx++, id++) {
+            rc = adts_wsdeque_push(ctx.p_wsdeque, (void *) id);
+            assert(0 == rc);
+        }
+        for (size_t idx = 0; idx < (burst / 2); idx++) {
+            p_data = adts_wsdeque_pop(ctx.p_wsdeque);
+            if (p_data) {
+                ctx.p_seen[(size_t) p_data - 1]++;
+            }
+        }
+    }
+
+    /* join: run whatever the thieves left */
+    while (NULL != (p_data = adts_wsdeque_pop(ctx.p_wsdeque))) {
+        ctx.p_seen[(size_t) p_data - 1]++;
+    }
+    __atomic_store_n(&(ctx.done), true, __ATOMIC_RELEASE);
+
+    for (size_t idx = 0; idx < thieves; idx++) {
+        (void) pthread_join(tids[idx], (void **) &(p_ret));
+        steals += p_ret->steals;
+        aborts += p_ret->aborts;
+        free(p_ret);
+    }
+    delta = adts_tstamp() - start;
+
+    for (size_t idx = 0; idx < tasks; idx++) {
+        assert(1 == ctx.p_seen[idx]);
+    }
+    adts_wsdeque_stats(ctx.p_wsdeque, &(stats));
+    pops = stats.pops;
+    assert((pops + steals) == tasks);
+    assert(stats.pushes == tasks);
+    assert(0 == adts_wsdeque_entries(ctx.p_wsdeque));
+
+    CDISPLAY("thieves: %zu  tasks: %zu  ns/task: %6.2f  pops: %8zu  steals: %8zu  aborts: %6zu  pop races: %4zu  grows: %zu",
+             thieves, tasks, (double) delta / (double) tasks,
+             pops, steals, aborts, stats.pop_races, stats.grows);
+
+    free(ctx.p_seen);
+    adts_wsdeque_destroy(ctx.p_wsdeque);
+
+    return;
+} /* utest_wsdeque_stress() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   The task carries its push time stamp, the thief records the time to
+ *   steal it.
+ *
+ ****************************************************************************
+ */
+static void *
+utest_wsdeque_latency_thief( void *p_arg )
+{
+    utest_wsdeque_ctx_t *p_ctx  = p_arg;
+    uint64_t            *p_task = NULL;
+
+    for (size_t idx = 0; idx < p_ctx->samples; ) {
+        if (adts_wsdeque_steal(p_ctx->p_wsdeque, (void **) &(p_task))) {
+            sched_yield();
+            continue;
+        }
+        p_ctx->p_samples[idx++] = adts_tstamp() - *p_task;
+        __atomic_store_n(&(p_ctx->steals), idx, __ATOMIC_RELEASE);
+    }
+
+    return NULL;
+} /* utest_wsdeque_latency_thief() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Push to steal latency, one task in flight.  The owner waits for each
+ *   steal before the next push.  Both sides yield while idle such that a
+ *   single cpu system completes, where the latency is then a context
+ *   switch.
+ *
+ ****************************************************************************
+ */
+static void
+utest_wsdeque_latency( void )
+{
+    int32_t                rc     = 0;
+    size_t                 count  = UTEST_WSDEQUE_HANDOFFS;
+    uint64_t               total  = 0;
+    uint64_t               task   = 0;
+    pthread_t              tid;
+    adts_wsdeque_create_t  op     = {0};
+    utest_wsdeque_ctx_t    ctx    = {0};
+
+    ctx.p_wsdeque = adts_wsdeque_create(&(op));
+    ctx.p_samples = calloc(count, sizeof(*ctx.p_samples));
+    ctx.samples   = count;
+    assert(ctx.p_wsdeque && ctx.p_samples);
+
+    rc = pthread_create(&(tid), NULL, utest_wsdeque_latency_thief, &(ctx));
+    assert(0 == rc);
+
+    for (size_t idx = 0; idx < count; idx++) {
+        task = adts_tstamp();
+        rc   = adts_wsdeque_push(ctx.p_wsdeque, &(task));
+        assert(0 == rc);
+
+        while ((idx + 1) != __atomic_load_n(&(ctx.steals), __ATOMIC_ACQUIRE)) {
+            sched_yield();
+        }
+    }
+    (void) pthread_join(tid, NULL);
+
+    for (size_t idx = 0; idx < count; idx++) {
+        total += ctx.p_samples[idx];
+    }
+    qsort(ctx.p_samples, count, sizeof(*ctx.p_samples), utest_wsdeque_cmp);
+
+    CDISPLAY("handoffs: %zu  mean: %8.1fns  p50: %8"PRIu64"ns  p99: %8"PRIu64"ns",
+             count,
+             (double) total / (double) count,
+             ctx.p_samples[count / 2],
+             ctx.p_samples[(count * 99) / 100]);
+
+    free(ctx.p_samples);
+    adts_wsdeque_destroy(ctx.p_wsdeque);
+
+    return;
+} /* utest_wsdeque_latency() */
+
+
+/*
+ ****************************************************************************
+ * \details
+ *   Uncontended cost of the owner push / pop pair and of a steal.
+ *
+ ****************************************************************************
+ */
+static void
+utest_wsdeque_rate( void )
+{
+    size_t                 ops        = UTEST_WSDEQUE_OPS;
+    uint64_t               start      = 0;
+    uint64_t               delta      = 0;
+    void                  *p_data     = NULL;
+    adts_wsdeque_t        *p_wsdeque  = NULL;
+    adts_wsdeque_create_t  op         = {0};
+
+    op.elems  = 1024;
+    p_wsdeque = adts_wsdeque_create(&(op));
+    assert(p_wsdeque);
+
+    start = adts_tstamp();
+    for (size_t idx = 1; idx <= ops; idx++) {
+        (void) adts_wsdeque_push(p_wsdeque, (void *) idx);
+        (void) adts_wsdeque_push(p_wsdeque, (void *) idx);
+        p_data = adts_wsdeque_pop(p_wsdeque);
+        assert((void *) idx == p_data);
+        p_data = adts_wsdeque_pop(p_wsdeque);
+    }
+    delta = adts_tstamp() - start;
+    CDISPLAY("owner push / pop  ns/op: %6.2f", (double) delta / (double) (4 * ops));
+
+    for (size_t idx = 1; idx <= 1024; idx++) {
+        (void) adts_wsdeque_push(p_wsdeque, (void *) idx);
+    }
+    start = adts_tstamp();
+    for (size_t lap = 0; lap < (ops / 1024); lap++) {
+        for (size_t idx = 1; idx <= 1024; idx++) {
+            (void) adts_wsdeque_steal(p_wsdeque, &(p_data));
+            (void) adts_wsdeque_push(p_wsdeque, p_data);
+        }
+    }
+    delta = adts_tstamp() - start;
+    CDISPLAY("steal / push      ns/op: %6.2f", (double) delta / (double) (2 * ops));
+
+    adts_wsdeque_destroy(p_wsdeque);
+
+    return;
+} /* utest_wsdeque_rate() */
+
+
+/*
+ ****************************************************************************
+ * test control
+ *
+ ****************************************************************************
+ */
+static void
+utest_control( void )
+{
+    utest_wsdeque_bytes();
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: single thread LIFO pop / FIFO steal and grow");
+
+        void                  *p_data    = NULL;
+        adts_wsdeque_t        *p_wsdeque = NULL;
+        adts_wsdeque_create_t  op        = {0};
+        adts_wsdeque_stats_t   stats     = {0};
+        adts_mem_stats_t       before    = {0};
+        adts_mem_stats_t       after     = {0};
+
+        (void) adts_mem_stats(ADTS_MEM_TYPE_WSDEQUE, &(before));
+
+        op.elems  = 3;
+        p_wsdeque = adts_wsdeque_create(&(op));
+        assert(p_wsdeque);
+        assert(4 == adts_wsdeque_capacity(p_wsdeque));
+        assert(NULL == adts_wsdeque_pop(p_wsdeque));
+        assert(ENOENT == adts_wsdeque_steal(p_wsdeque, &(p_data)));
+
+        /* wrap the array before growing it */
+        for (size_t idx = 1; idx <= 3; idx++) {
+            assert(0 == adts_wsdeque_push(p_wsdeque, (void *) idx));
+        }
+        assert(0 == adts_wsdeque_steal(p_wsdeque, &(p_data)));
+        assert((void *) 1 == p_data);
+        assert(0 == adts_wsdeque_steal(p_wsdeque, &(p_data)));
+        assert((void *) 2 == p_data);
+
+        for (size_t idx = 4; idx <= 20; idx++) {
+            assert(0 == adts_wsdeque_push(p_wsdeque, (void *) idx));
+        }
+        assert(18 == adts_wsdeque_entries(p_wsdeque));
+        assert(32 == adts_wsdeque_capacity(p_wsdeque));
+
+        /* owner takes newest, thieves take oldest */
+        assert((void *) 20 == adts_wsdeque_pop(p_wsdeque));
+        assert(0 == adts_wsdeque_steal(p_wsdeque, &(p_data)));
+        assert((void *) 3 == p_data);
+        for (size_t idx = 19; idx >= 4; idx--) {
+            assert((void *) idx == adts_wsdeque_pop(p_wsdeque));
+        }
+        assert(NULL == adts_wsdeque_pop(p_wsdeque));
+        assert(ENOENT == adts_wsdeque_steal(p_wsdeque, &(p_data)));
+        assert(0 == adts_wsdeque_entries(p_wsdeque));
+
+        adts_wsdeque_stats(p_wsdeque, &(stats));
+        assert((20 == stats.pushes) && (17 == stats.pops));
+        assert((3 == stats.grows) && (0 == stats.pop_races));
+
+        adts_wsdeque_destroy(p_wsdeque);
+
+        (void) adts_mem_stats(ADTS_MEM_TYPE_WSDEQUE, &(after));
+        assert(before.bytes_curr == after.bytes_curr);
+    }
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: uncontended owner / steal rate");
+
+        utest_wsdeque_rate();
+    }
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: fork / join stress, exactly once under theft");
+
+        for (size_t thieves = 1; thieves <= UTEST_WSDEQUE_THIEVES_MAX; thieves <<= 1) {
+            utest_wsdeque_stress(thieves);
+        }
+    }
+
+    CDISPLAY("=========================================================");
+    {
+        CDISPLAY("Test: push to steal latency");
+
+        utest_wsdeque_latency();
+    }
+
+    return;
+} /* utest_control() */
+
+
+/*
+ ****************************************************************************
+ * test entrypoint
+ *
+ ****************************************************************************
+ */
+void
+utest_adts_wsdeque( void )
+{
+    utest_control();
+
+    return;
+} /* utest_adts_wsdeque() */
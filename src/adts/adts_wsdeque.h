@@ -0,0 +1,152 @@
+#pragma once
+
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <adts_memory.h>
+
+
+/******************************************************************************
+ #####  ####### ######  #     #  #####  ####### #     # ######  #######  #####
+#     #    #    #     # #     # #     #    #    #     # #     # #       #     #
+#          #    #     # #     # #          #    #     # #     # #       #
+ #####     #    ######  #     # #          #    #     # ######  #####    #####
+      #    #    #   #   #     # #          #    #     # #   #   #             #
+#     #    #    #    #  #     # #     #    #    #     # #    #  #       #     #
+ #####     #    #     #  #####   #####     #     #####  #     # #######  #####
+******************************************************************************/
+
+/**
+ **************************************************************************
+ * \details
+ *   Unbounded work stealing deque of pointers (Chase-Lev).  One owner
+ *   thread pushes and pops at the bottom, LIFO, without an atomic read-
+ *   modify-write except when taking the last entry.  Any number of thief
+ *   threads steal from the top, FIFO, with a compare and swap.
+ *
+ *   The circular array doubles when full.  An outgrown array may still be
+ *   read by a thief, thus it is retired rather than released, and freed
+ *   on destroy.  Retired arrays total less than the current array.
+ *
+ **************************************************************************
+ */
+#define ADTS_WSDEQUE_BYTES (256)
+
+typedef struct {
+    const char reserved[ ADTS_WSDEQUE_BYTES ];
+} adts_wsdeque_t;
+
+
+/**
+ **************************************************************************
+ * \details
+ *   elems is the initial capacity, rounded up to a power of two, 0
+ *   selects the default.
+ *
+ **************************************************************************
+ */
+typedef struct {
+    size_t                  elems;       /**< initial capacity */
+    const adts_allocator_t *p_allocator; /**< NULL selects the default */
+} adts_wsdeque_create_t;
+
+
+/**
+ **************************************************************************
+ * \details
+ *   Owner side counters, a snapshot when read by another thread.
+ *
+ **************************************************************************
+ */
+typedef struct {
+    size_t pushes;    /**< accepted entries */
+    size_t pops;      /**< entries taken by the owner */
+    size_t pop_races; /**< last entry lost to a thief */
+    size_t grows;     /**< array doublings */
+} adts_wsdeque_stats_t;
+
+
+
+/******************************************************************************
+ #####   #####    ####    #####   ####    #####   #   #  #####   ######   ####
+ #    #  #    #  #    #     #    #    #     #      # #   #    #  #       #
+ #    #  #    #  #    #     #    #    #     #       #    #    #  #####    ####
+ #####   #####   #    #     #    #    #     #       #    #####   #            #
+ #       #   #   #    #     #    #    #     #       #    #       #       #    #
+ #       #    #   ####      #     ####      #       #    #       ######   ####
+*******************************************************************************/
+
+/**
+ **************************************************************************
+ * \brief
+ *   Owner services, call from the owner thread only
+ *
+ * \details
+ *   - adts_wsdeque_push() ENOMEM when a full array fails to grow, p_data
+ *                         must not be NULL
+ *   - adts_wsdeque_pop()  newest entry, NULL when empty
+ *
+ **************************************************************************
+ */
+int32_t
+adts_wsdeque_push( adts_wsdeque_t *p_adts_wsdeque,
+                   void           *p_data );
+
+void *
+adts_wsdeque_pop( adts_wsdeque_t *p_adts_wsdeque );
+
+
+/**
+ **************************************************************************
+ * \brief
+ *   Thief services, safe from any thread
+ *
+ * \details
+ *   adts_wsdeque_steal() takes the oldest entry.  ENOENT when empty,
+ *   EAGAIN when the entry was lost to the owner or another thief, in
+ *   which case the deque may still hold work.
+ *
+ **************************************************************************
+ */
+int32_t
+adts_wsdeque_steal( adts_wsdeque_t  *p_adts_wsdeque,
+                    void           **pp_data );
+
+
+/**
+ **************************************************************************
+ * \details
+ *   adts_wsdeque_entries() is a snapshot when called concurrently.
+ *
+ **************************************************************************
+ */
+size_t
+adts_wsdeque_entries( adts_wsdeque_t *p_adts_wsdeque );
+
+size_t
+adts_wsdeque_capacity( adts_wsdeque_t *p_adts_wsdeque );
+
+void
+adts_wsdeque_stats( adts_wsdeque_t       *p_adts_wsdeque,
+                    adts_wsdeque_stats_t *p_out );
+
+void
+adts_wsdeque_mem_usage( adts_wsdeque_t   *p_adts_wsdeque,
+                        adts_mem_stats_t *p_out );
+
+void
+adts_wsdeque_destroy( adts_wsdeque_t *p_adts_wsdeque );
+
+adts_wsdeque_t *
+adts_wsdeque_create( const adts_wsdeque_create_t *p_op );
+
+
+/**
+ **************************************************************************
+ * \details
+ *   Unit Test prototypes
+ *
+ **************************************************************************
+ */
+void
+utest_adts_wsdeque( void );
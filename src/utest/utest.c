@@ -27,8 +27,23 @@ utest_adts( void )
     //utest_adts_time();
       utest_adts_cycles();
 	//utest_adts_meas();
+    //utest_adts_wait();
+    //utest_adts_mpmc();
+    //utest_adts_mcast();
+    //utest_adts_mpsc();
+    //utest_adts_spsc();
     //utest_adts_stack();
+    //utest_adts_lfstack();
+    //utest_adts_wsdeque();
+    //utest_adts_timerwheel();
+    //utest_adts_multiqueue();
+    //utest_adts_radixheap();
+    //utest_adts_topk();
+    //utest_adts_theap();
+    //utest_adts_minmaxheap();
     //utest_adts_queue();
+    //utest_adts_memory();
+    //utest_adts_mem_file();
     //utest_adts_graph();
     //utest_adts_hexdump();
     //utest_adts_snapshot();